@@ -473,16 +473,11 @@ sound_write_buf_pstereo( libspectrum_signed_word * out, int c )
 
 void AY8913::sound_ay_overlay()
 {
-  int tone_level[3];
-  int mixer, envshape;
-  int f, g, level, count;
+  int f, count;
 //  libspectrum_signed_word *ptr;
   struct ay_change_tag *change_ptr = ay_change;
   int changes_left = ay_change_count;
   int reg, r;
-  int is_low;
-  int chan1, chan2, chan3;
-  unsigned int tone_count, noise_count;
   libspectrum_dword sfreq, cpufreq;
 
 ///* If no AY chip, don't produce any AY sound (!) */
@@ -516,8 +511,10 @@ void AY8913::sound_ay_overlay()
   libspectrum_signed_word* pBuf2 = ppSoundBuffers[1];
   libspectrum_signed_word* pBuf3 = ppSoundBuffers[2];
 
-//  for( f = 0, ptr = sound_buf; f < sound_generator_framesiz; f++ ) {
-  for( f = 0; f < sound_generator_framesiz; f++ ) {
+  /* [AppleWin] Synthesise whole blocks of samples between register
+   * changes (the registers are constant within a block).
+   */
+  for( f = 0; f < sound_generator_framesiz; f += count ) {
     /* update ay registers. All this sub-frame change stuff
      * is pretty hairy, but how else would you handle the
      * samples in Robocop? :-) It also clears up some other
@@ -568,162 +565,254 @@ void AY8913::sound_ay_overlay()
       }
     }
 
+    count = ( changes_left ? change_ptr->ofs : sound_generator_framesiz ) - f;
+    sound_ay_block( count, pBuf1 + f, pBuf2 + f, pBuf3 + f );
+  }
+}
+
+/* [AppleWin] one sample of a channel whose output can change */
+#define AY_DO_CHANNEL( g, buf ) \
+  if( !is_static[ g ] ) {						\
+    chan = level = env_mode[ g ] ? env_level : fixed_level[ g ];	\
+    if( tone_on[ g ] ) {						\
+      AY_DO_TONE( chan, g );						\
+    }									\
+    if( noise_on[ g ] && noise_toggle )					\
+      chan = 0;								\
+									\
+    ( buf )[ f ] = chan;						\
+  }
+
+/* [AppleWin] Generate 'samples' samples with constant registers.
+ *
+ * A channel whose output can't change during the block (volume 0, or
+ * tone & noise both disabled in the mixer) is filled with its constant
+ * level, and its tone generator is advanced in one go. The envelope and
+ * noise generators are only stepped per-sample if an audible channel
+ * uses them; otherwise they are advanced in one go at the end of the
+ * block. The output & the generators' state are identical to stepping
+ * everything per-sample.
+ */
+void AY8913::sound_ay_block( int samples, libspectrum_signed_word *pBuf1,
+			     libspectrum_signed_word *pBuf2, libspectrum_signed_word *pBuf3 )
+{
+  libspectrum_signed_word *buf[3] = { pBuf1, pBuf2, pBuf3 };
+  int fixed_level[3], env_mode[3], tone_on[3], noise_on[3], is_static[3];
+  int num_chans = 0;	/* channels whose output can change */
+  int use_env = 0, use_noise = 0;
+  int mixer = sound_ay_registers[7];
+  int envshape = sound_ay_registers[13];
+  int f, g, chan, level, count, is_low, env_level;
+  unsigned int tone_count, noise_count;
+  unsigned int tone_ticks = 0, env_ticks = 0;
+
+  for( g = 0; g < 3; g++ ) {
     /* the tone level if no enveloping is being used */
-    for( g = 0; g < 3; g++ )
-      tone_level[g] = ay_tone_levels[ sound_ay_registers[ 8 + g ] & 15 ];
+    fixed_level[g] = ay_tone_levels[ sound_ay_registers[ 8 + g ] & 15 ];
+    env_mode[g] = sound_ay_registers[ 8 + g ] & 16;
+    tone_on[g] = ( mixer & ( 1 << g ) ) == 0;
+    noise_on[g] = ( mixer & ( 8 << g ) ) == 0;
+
+    /* if no tone/noise is selected, the chip just shoves the level out */
+    is_static[g] = !env_mode[g] && ( !fixed_level[g] || ( !tone_on[g] && !noise_on[g] ) );
+
+    if( is_static[g] ) {
+      std::fill_n( buf[g], samples, (libspectrum_signed_word) fixed_level[g] );
+      continue;
+    }
 
-    /* envelope */
-    envshape = sound_ay_registers[13];
-    level = ay_tone_levels[ env_counter ];
+    num_chans++;
+    if( env_mode[g] )
+      use_env = 1;
+    if( noise_on[g] )
+      use_noise = 1;
+  }
 
-    for( g = 0; g < 3; g++ )
-      if( sound_ay_registers[ 8 + g ] & 16 )
-	tone_level[g] = level;
+  for( f = 0; num_chans && f < samples; f++ ) {
+    /* envelope: the level before this sample's update */
+    env_level = ay_tone_levels[ env_counter ];
 
     /* envelope output counter gets incr'd every 16 AY cycles.
      * Has to be a while, as this is sub-output-sample res.
      */
-    ay_env_subcycles += ay_tick_incr;
     noise_count = 0;
-    while( ay_env_subcycles >= ( 16 << 16 ) ) {
-      ay_env_subcycles -= ( 16 << 16 );
-      noise_count++;
-      ay_env_tick++;
-      while( ay_env_tick >= ay_env_period ) {
-	ay_env_tick -= ay_env_period;
-
-	/* do a 1/16th-of-period incr/decr if needed */
-	if( env_first ||
-	    ( ( envshape & AY_ENV_CONT ) && !( envshape & AY_ENV_HOLD ) ) ) {
-	  if( env_rev )
-	    env_counter -= ( envshape & AY_ENV_ATTACK ) ? 1 : -1;
-	  else
-	    env_counter += ( envshape & AY_ENV_ATTACK ) ? 1 : -1;
-	  if( env_counter < 0 )
-	    env_counter = 0;
-	  if( env_counter > 15 )
-	    env_counter = 15;
+    if( use_env || use_noise ) {
+      ay_env_subcycles += ay_tick_incr;
+      while( ay_env_subcycles >= ( 16 << 16 ) ) {
+	ay_env_subcycles -= ( 16 << 16 );
+	noise_count++;
+	if( use_env ) {
+	  ay_env_tick++;
+	  while( ay_env_tick >= ay_env_period ) {
+	    ay_env_tick -= ay_env_period;
+	    sound_ay_env_step( envshape );
+
+	    /* don't keep trying if period is zero */
+	    if( !ay_env_period )
+	      break;
+	  }
 	}
+      }
+      env_ticks += noise_count;
+    }
 
-	ay_env_internal_tick++;
-	while( ay_env_internal_tick >= 16 ) {
-	  ay_env_internal_tick -= 16;
-
-	  /* end of cycle */
-	  if( !( envshape & AY_ENV_CONT ) )
-	    env_counter = 0;
-	  else {
-	    if( envshape & AY_ENV_HOLD ) {
-	      if( env_first && ( envshape & AY_ENV_ALT ) )
-		env_counter = ( env_counter ? 0 : 15 );
-	    } else {
-	      /* non-hold */
-	      if( envshape & AY_ENV_ALT )
-		env_rev = !env_rev;
-	      else
-		env_counter = ( envshape & AY_ENV_ATTACK ) ? 0 : 15;
-	    }
-	  }
+    ay_tone_subcycles += ay_tick_incr;
+    tone_count = ay_tone_subcycles >> ( 3 + 16 );
+    ay_tone_subcycles &= ( 8 << 16 ) - 1;
+    tone_ticks += tone_count;
 
-	  env_first = 0;
-	}
+    /* generate tone+noise... or neither. */
+    AY_DO_CHANNEL( 0, pBuf1 );
+    AY_DO_CHANNEL( 1, pBuf2 );
+    AY_DO_CHANNEL( 2, pBuf3 );
+
+    /* update noise RNG/filter */
+    if( use_noise ) {
+      ay_noise_tick += noise_count;
+      while( ay_noise_tick >= ay_noise_period ) {
+	ay_noise_tick -= ay_noise_period;
+	sound_ay_noise_step();
 
 	/* don't keep trying if period is zero */
-	if( !ay_env_period )
+	if( !ay_noise_period )
 	  break;
       }
     }
+  }
 
-    /* generate tone+noise... or neither.
-     * (if no tone/noise is selected, the chip just shoves the
-     * level out unmodified. This is used by some sample-playing
-     * stuff.)
-     */
-    chan1 = tone_level[0];
-    chan2 = tone_level[1];
-    chan3 = tone_level[2];
-    mixer = sound_ay_registers[7];
+  /* advance whatever wasn't stepped per-sample */
+  if( !num_chans ) {
+    UINT64 subcycles = ay_tone_subcycles + (UINT64) samples * ay_tick_incr;
+    tone_ticks = (unsigned int) ( subcycles >> ( 3 + 16 ) );
+    ay_tone_subcycles = (unsigned int) subcycles & ( ( 8 << 16 ) - 1 );
+  }
 
-    ay_tone_subcycles += ay_tick_incr;
-    tone_count = ay_tone_subcycles >> ( 3 + 16 );
-    ay_tone_subcycles &= ( 8 << 16 ) - 1;
+  if( !use_env && !use_noise ) {
+    UINT64 subcycles = ay_env_subcycles + (UINT64) samples * ay_tick_incr;
+    env_ticks = (unsigned int) ( subcycles / ( 16 << 16 ) );
+    ay_env_subcycles = (unsigned int) ( subcycles % ( 16 << 16 ) );
+  }
 
-    if( ( mixer & 1 ) == 0 ) {
-      level = chan1;
-      AY_DO_TONE( chan1, 0 );
-    }
-    if( ( mixer & 0x08 ) == 0 && noise_toggle )
-      chan1 = 0;
+  for( g = 0; g < 3; g++ )
+    if( is_static[g] && tone_on[g] )
+      sound_ay_tone_advance( g, tone_ticks );
 
-    if( ( mixer & 2 ) == 0 ) {
-      level = chan2;
-      AY_DO_TONE( chan2, 1 );
-    }
-    if( ( mixer & 0x10 ) == 0 && noise_toggle )
-      chan2 = 0;
+  if( !use_env )
+    sound_ay_env_advance( envshape, env_ticks );
 
-    if( ( mixer & 4 ) == 0 ) {
-      level = chan3;
-      AY_DO_TONE( chan3, 2 );
-    }
-    if( ( mixer & 0x20 ) == 0 && noise_toggle )
-      chan3 = 0;
+  if( !use_noise )
+    sound_ay_noise_advance( env_ticks, samples );
+}
 
-    /* write the sample(s) */
-	*pBuf1++ = chan1;	// [TC]
-	*pBuf2++ = chan2;	// [TC]
-	*pBuf3++ = chan3;	// [TC]
-#if 0
-    if( !sound_stereo ) {
-      /* mono */
-      ( *ptr++ ) += chan1 + chan2 + chan3;
-    } else {
-      if( !sound_stereo_ay ) {
-	/* stereo output, but mono AY sound; still,
-	 * incr separately in case of beeper pseudostereo.
-	 */
-	( *ptr++ ) += chan1 + chan2 + chan3;
-	( *ptr++ ) += chan1 + chan2 + chan3;
+/* do a 1/16th-of-period envelope step */
+void AY8913::sound_ay_env_step( int envshape )
+{
+  /* do a 1/16th-of-period incr/decr if needed */
+  if( env_first ||
+      ( ( envshape & AY_ENV_CONT ) && !( envshape & AY_ENV_HOLD ) ) ) {
+    if( env_rev )
+      env_counter -= ( envshape & AY_ENV_ATTACK ) ? 1 : -1;
+    else
+      env_counter += ( envshape & AY_ENV_ATTACK ) ? 1 : -1;
+    if( env_counter < 0 )
+      env_counter = 0;
+    if( env_counter > 15 )
+      env_counter = 15;
+  }
+
+  ay_env_internal_tick++;
+  while( ay_env_internal_tick >= 16 ) {
+    ay_env_internal_tick -= 16;
+
+    /* end of cycle */
+    if( !( envshape & AY_ENV_CONT ) )
+      env_counter = 0;
+    else {
+      if( envshape & AY_ENV_HOLD ) {
+	if( env_first && ( envshape & AY_ENV_ALT ) )
+	  env_counter = ( env_counter ? 0 : 15 );
       } else {
-	/* stereo with ACB/ABC AY positioning.
-	 * Here we use real stereo positions for the channels.
-	 * Just because, y'know, it's cool and stuff. No, really. :-)
-	 * This is a little tricky, as it works by delaying sounds
-	 * on the left or right channels to model the delay you get
-	 * in the real world when sounds originate at different places.
-	 */
-	GEN_STEREO( rchan1pos, chan1 );
-	GEN_STEREO( rchan2pos, chan2 );
-	GEN_STEREO( rchan3pos, chan3 );
-	( *ptr++ ) += rstereobuf_l[ rstereopos ];
-	( *ptr++ ) += rstereobuf_r[ rstereopos ];
-	rstereobuf_l[ rstereopos ] = rstereobuf_r[ rstereopos ] = 0;
-	rstereopos++;
-	if( rstereopos >= STEREO_BUF_SIZE )
-	  rstereopos = 0;
+	/* non-hold */
+	if( envshape & AY_ENV_ALT )
+	  env_rev = !env_rev;
+	else
+	  env_counter = ( envshape & AY_ENV_ATTACK ) ? 0 : 15;
       }
     }
-#endif
 
-    /* update noise RNG/filter */
-    ay_noise_tick += noise_count;
-    while( ay_noise_tick >= ay_noise_period ) {
-      ay_noise_tick -= ay_noise_period;
+    env_first = 0;
+  }
+}
 
-      if( ( rng & 1 ) ^ ( ( rng & 2 ) ? 1 : 0 ) )
-	noise_toggle = !noise_toggle;
+/* advance the envelope by 'ticks' 16-AY-cycle ticks */
+void AY8913::sound_ay_env_advance( int envshape, unsigned int ticks )
+{
+  unsigned int steps;
 
-      /* rng is 17-bit shift reg, bit 0 is output.
-       * input is bit 0 xor bit 2.
-       */
-      rng |= ( ( rng & 1 ) ^ ( ( rng & 4 ) ? 1 : 0 ) ) ? 0x20000 : 0;
-      rng >>= 1;
+  if( !ticks )
+    return;
 
-      /* don't keep trying if period is zero */
-      if( !ay_noise_period )
-	break;
-    }
+  if( ay_env_period ) {
+    steps = ( ay_env_tick + ticks ) / ay_env_period;
+    ay_env_tick = ( ay_env_tick + ticks ) % ay_env_period;
+  } else {
+    /* one step per tick if period is zero */
+    steps = ticks;
+    ay_env_tick += ticks;
+  }
+
+  while( steps && env_first ) {
+    sound_ay_env_step( envshape );
+    steps--;
+  }
+
+  /* after the 1st cycle, every shape settles within 2 cycles (32 steps)
+   * & then repeats every 2 cycles.
+   */
+  if( steps >= 64 )
+    steps = 32 + steps % 32;
+  while( steps-- )
+    sound_ay_env_step( envshape );
+}
+
+void AY8913::sound_ay_noise_step()
+{
+  if( ( rng & 1 ) ^ ( ( rng & 2 ) ? 1 : 0 ) )
+    noise_toggle = !noise_toggle;
+
+  /* rng is 17-bit shift reg, bit 0 is output.
+   * input is bit 0 xor bit 2.
+   */
+  rng |= ( ( rng & 1 ) ^ ( ( rng & 4 ) ? 1 : 0 ) ) ? 0x20000 : 0;
+  rng >>= 1;
+}
+
+/* advance the noise generator by 'ticks' 16-AY-cycle ticks over 'samples' samples */
+void AY8913::sound_ay_noise_advance( unsigned int ticks, int samples )
+{
+  unsigned int steps;
+
+  if( ay_noise_period ) {
+    steps = ( ay_noise_tick + ticks ) / ay_noise_period;
+    ay_noise_tick = ( ay_noise_tick + ticks ) % ay_noise_period;
+  } else {
+    /* one step per sample if period is zero */
+    steps = samples;
+    ay_noise_tick += ticks;
   }
+
+  while( steps-- )
+    sound_ay_noise_step();
+}
+
+/* advance a tone generator by 'ticks' 8-AY-cycle ticks (at least 1 sample) */
+void AY8913::sound_ay_tone_advance( int chan, unsigned int ticks )
+{
+  unsigned int total = ay_tone_tick[ chan ] + ticks;
+
+  if( ( total / ay_tone_period[ chan ] ) & 1 )
+    ay_tone_high[ chan ] = !ay_tone_high[ chan ];
+  ay_tone_tick[ chan ] = total % ay_tone_period[ chan ];
 }
 
 BYTE AY8913::sound_ay_read( int reg )
@@ -36,6 +36,13 @@ private:
 	void init();
 	void sound_end();
 	void sound_ay_overlay();
+	void sound_ay_block( int samples, libspectrum_signed_word *pBuf1,
+			     libspectrum_signed_word *pBuf2, libspectrum_signed_word *pBuf3 );
+	void sound_ay_env_step( int envshape );
+	void sound_ay_env_advance( int envshape, unsigned int ticks );
+	void sound_ay_noise_step();
+	void sound_ay_noise_advance( unsigned int ticks, int samples );
+	void sound_ay_tone_advance( int chan, unsigned int ticks );
 
 private:
 	/* foo_subcycles are fixed-point with low 16 bits as fractional part.
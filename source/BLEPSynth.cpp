@@ -0,0 +1,243 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2025, Tom Charlesworth, Michael Pohoreski
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: Band-limited step (BLEP) synthesiser
+ *
+ * A square-ish wave (eg. the speaker, toggled at arbitrary cycles) is a sum of steps.
+ * Point-sampling or box-averaging it at 44.1KHz aliases all the harmonics above 22KHz back
+ * into the audible range, which is very noticeable for PWM "digital" audio.
+ *
+ * Instead each step is added as its derivative: a windowed-sinc impulse (low-pass at ~20KHz)
+ * positioned to 1/kPhases of a sample, into a delta buffer. Integrating the delta buffer gives
+ * the band-limited wave. The kernels are in fixed-point & each sums to exactly 1.0, so the
+ * integrated level never drifts from the true speaker level.
+ *
+ * A band-limited step overshoots (Gibbs) by ~12%, and the overshoots of close steps can add up:
+ * a full-scale square wave peaks at up to 1.5x its levels. Clipping these would alias again, and
+ * a fixed gain to leave headroom would make the speaker ~4dB quieter. So the output is at the
+ * speaker's level, through a look-ahead limiter: the gain is the min that any sample in a window
+ * of kLookahead samples needs, smoothed over kLookahead samples (so it ramps down ahead of a peak
+ * and back up after it, rather than stepping). It only dips around the edges of a low tone, and
+ * is constant over a high tone (where the window always holds a peak), so adds no aliasing.
+ *
+ * Recording an edge is just a push_back; all per-sample work happens in Render().
+ *
+ * Author: Various
+ */
+
+#include "StdAfx.h"
+
+#include "BLEPSynth.h"
+
+BLEPSynth::BLEPSynth(void)
+	: m_accum(0),
+	m_edgeLevel(0),
+	m_clksPerSample(1.0),
+	m_bufferStartCycle(0.0)
+{
+	InitKernel();
+	memset(m_delta, 0, sizeof(m_delta));
+	ResetLimiter(0);
+	m_edges.reserve(kMaxEdges);
+}
+
+void BLEPSynth::InitKernel(void)
+{
+	const double kPi = 3.14159265358979323846;
+	const double kCutoff = 0.9;		// Fraction of Nyquist (~19.8KHz at 44.1KHz)
+	const double kHalfWidth = kTaps / 2;
+	const int kUnity = 1 << kUnityBits;
+
+	for (UINT phase = 0; phase < kPhases; phase++)
+	{
+		// Impulse centre is between taps (kTaps/2-1) and (kTaps/2)
+		const double centre = (kHalfWidth - 1) + (double)phase / kPhases;
+
+		double kernel[kTaps];
+		double sum = 0.0;
+		for (UINT i = 0; i < kTaps; i++)
+		{
+			const double x = i - centre;
+			const double sinc = (x == 0.0) ? 1.0 : sin(kPi * kCutoff * x) / (kPi * kCutoff * x);
+			const double w = x / kHalfWidth;	// Blackman window over [-1,+1]
+			const double window = (fabs(w) >= 1.0) ? 0.0 : 0.42 + 0.5 * cos(kPi * w) + 0.08 * cos(2 * kPi * w);
+			kernel[i] = sinc * window;
+			sum += kernel[i];
+		}
+
+		// Quantise, then put the rounding error on the largest tap so that this phase sums to exactly kUnity
+		int total = 0;
+		UINT largest = 0;
+		for (UINT i = 0; i < kTaps; i++)
+		{
+			m_kernel[phase][i] = (int)floor(kernel[i] / sum * kUnity + 0.5);
+			total += m_kernel[phase][i];
+			if (m_kernel[phase][i] > m_kernel[phase][largest])
+				largest = i;
+		}
+		m_kernel[phase][largest] += kUnity - total;
+	}
+}
+
+void BLEPSynth::Initialize(double clksPerSample)
+{
+	_ASSERT(clksPerSample > 0.0);
+	m_clksPerSample = clksPerSample;
+}
+
+// Discard any pending edges and restart the sample clock at 'cycle', with a steady 'level'
+void BLEPSynth::Reset(UINT64 cycle, short level)
+{
+	m_edges.clear();
+	memset(m_delta, 0, sizeof(m_delta));
+	m_accum = (int)level << kUnityBits;
+	ResetLimiter(level);
+	m_edgeLevel = level;
+	m_bufferStartCycle = (double)cycle;
+}
+
+// Change the level of the edge at 'cycle' (if it's already been recorded), else add a new edge
+void BLEPSynth::SetLevel(UINT64 cycle, short level)
+{
+	if (!m_edges.empty() && m_edges.back().cycle == cycle)
+		m_edges.back().level = level;
+	else
+		AddEdge(cycle, level);
+}
+
+// t = time of the step in samples, relative to m_delta[0]
+void BLEPSynth::AddStep(double t, int delta)
+{
+	// Round to the nearest phase
+	const UINT pos = (UINT)(t * kPhases + 0.5);
+	const UINT idx = pos / kPhases;
+	const UINT phase = pos % kPhases;
+	_ASSERT(idx + kTaps <= kBufferSize + kTaps && phase < kPhases);
+
+	const int* pKernel = m_kernel[phase];
+	int* pDelta = &m_delta[idx];
+	for (UINT i = 0; i < kTaps; i++)
+		pDelta[i] += delta * pKernel[i];
+}
+
+void BLEPSynth::ResetLimiter(short level)
+{
+	for (UINT i = 0; i < kLookahead; i++)
+	{
+		m_limitLevel[i] = level;
+		m_limitNeed[i] = kGainUnity;
+		m_limitMin[i] = kGainUnity;
+	}
+	m_limitMinSum = kLookahead * kGainUnity;
+	m_limitIdx = 0;
+}
+
+// Add 'level', and return the level from (kLookahead-1) samples ago with the gain applied
+// . each m_limitMin[] is <= the need of that level, and the gain is the average of the kLookahead
+//   m_limitMin[] since that level was added, so it's never more than the level needs
+int BLEPSynth::Limit(int level)
+{
+	const int peak = (level < 0) ? -level : level;
+	const int fullScale = (level < 0) ? 32768 : 32767;
+	const int need = (peak > fullScale) ? (int)((int64_t)fullScale * kGainUnity / peak) : kGainUnity;
+
+	const UINT idx = m_limitIdx;
+	m_limitIdx = (idx + 1) % kLookahead;
+	m_limitLevel[idx] = level;
+	m_limitNeed[idx] = need;
+
+	int minNeed = need;
+	for (UINT i = 0; i < kLookahead; i++)
+		minNeed = (m_limitNeed[i] < minNeed) ? m_limitNeed[i] : minNeed;
+
+	m_limitMinSum += minNeed - m_limitMin[idx];
+	m_limitMin[idx] = minNeed;
+
+	const int gain = m_limitMinSum / kLookahead;
+	return (int)((int64_t)m_limitLevel[m_limitIdx] * gain / kGainUnity);	// Oldest level
+}
+
+// Output the oldest 'numSamples' samples and shift the delta buffer along
+// . samples beyond 'maxSamples' are dropped (but time still advances)
+void BLEPSynth::Flush(UINT numSamples, short* pOut, UINT& numOut, UINT maxSamples)
+{
+	const UINT numBuffered = (numSamples < kBufferSize + kTaps) ? numSamples : kBufferSize + kTaps;
+
+	for (UINT i = 0; i < numSamples; i++)
+	{
+		if (i < numBuffered)
+			m_accum += m_delta[i];
+
+		if (numOut < maxSamples)
+		{
+			// NB. Don't ">>" as -ve is implementation-defined
+			pOut[numOut++] = (short)Limit(m_accum / (1 << kUnityBits));
+		}
+		else if (i >= numBuffered)
+		{
+			break;	// Nothing more to integrate or output
+		}
+	}
+
+	const UINT numRemaining = kBufferSize + kTaps - numBuffered;
+	memmove(m_delta, &m_delta[numBuffered], numRemaining * sizeof(m_delta[0]));
+	memset(&m_delta[numRemaining], 0, numBuffered * sizeof(m_delta[0]));
+
+	m_bufferStartCycle += numSamples * m_clksPerSample;
+}
+
+// Render all recorded edges, and output all complete samples up to 'cycleEnd'
+// . returns the number of samples written to pOut
+UINT BLEPSynth::Render(UINT64 cycleEnd, short* pOut, UINT maxSamples)
+{
+	UINT numOut = 0;
+
+	for (std::vector<Edge>::const_iterator it = m_edges.begin(); it != m_edges.end(); ++it)
+	{
+		if (it->level == m_edgeLevel)
+			continue;
+
+		double t = ((double)it->cycle - m_bufferStartCycle) / m_clksPerSample;
+		if (t < 0.0)
+			t = 0.0;
+
+		if (t >= kBufferSize - 1)
+		{
+			// Edge is beyond the delta buffer, so output samples to make room
+			const UINT numSamples = (UINT)t;
+			Flush(numSamples, pOut, numOut, maxSamples);
+			t -= numSamples;
+		}
+
+		AddStep(t, (int)it->level - (int)m_edgeLevel);
+		m_edgeLevel = it->level;
+	}
+
+	m_edges.clear();
+
+	const double t = ((double)cycleEnd - m_bufferStartCycle) / m_clksPerSample;
+	if (t >= 1.0)
+		Flush((UINT)t, pOut, numOut, maxSamples);
+
+	return numOut;
+}
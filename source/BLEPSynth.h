@@ -0,0 +1,61 @@
+#pragma once
+
+// Band-limited step (BLEP) synthesiser
+// Level changes are recorded as {cycle, level} edges and rendered to samples in blocks.
+
+class BLEPSynth
+{
+public:
+	BLEPSynth(void);
+	~BLEPSynth(void) {}
+
+	void Initialize(double clksPerSample);
+	void Reset(UINT64 cycle, short level);
+
+	void AddEdge(UINT64 cycle, short level)
+	{
+		m_edges.push_back(Edge(cycle, level));
+	}
+	void SetLevel(UINT64 cycle, short level);
+	bool IsEdgeListFull(void) const { return m_edges.size() >= kMaxEdges; }
+
+	UINT Render(UINT64 cycleEnd, short* pOut, UINT maxSamples);
+
+	static const UINT kTaps = 16;		// Kernel width (samples), so output is delayed by kTaps/2 samples
+	static const UINT kLookahead = 32;	// Limiter window (samples), so output is delayed by a further kLookahead-1 samples
+	static const UINT kPhases = 256;		// Sub-sample resolution of an edge
+	static const UINT kMaxEdges = 0x10000;
+
+private:
+	struct Edge
+	{
+		Edge(UINT64 cycle, short level) : cycle(cycle), level(level) {}
+		UINT64 cycle;
+		short level;
+	};
+
+	void InitKernel(void);
+	void AddStep(double t, int delta);
+	void Flush(UINT numSamples, short* pOut, UINT& numOut, UINT maxSamples);
+	int Limit(int level);
+	void ResetLimiter(short level);
+
+	static const UINT kUnityBits = 12;	// Kernel fixed-point: each phase sums to exactly (1<<kUnityBits)
+	static const int kGainUnity = 1 << 16;	// Limiter gain fixed-point
+	static const UINT kBufferSize = 1024;	// Samples
+
+	int m_kernel[kPhases][kTaps];
+	int m_delta[kBufferSize + kTaps];	// Pending level changes, integrated by Flush()
+	int m_accum;						// Integrated level (fixed-point)
+	int m_limitLevel[kLookahead];		// Limiter ring buffers: the last kLookahead levels,
+	int m_limitNeed[kLookahead];		// . the gain that each level needs to not clip,
+	int m_limitMin[kLookahead];		// . & the min of m_limitNeed[] as each level was added
+	int m_limitMinSum;					// Sum of m_limitMin[]
+	UINT m_limitIdx;
+	short m_edgeLevel;					// Level after the last edge added to m_delta
+
+	double m_clksPerSample;
+	double m_bufferStartCycle;			// Cycle of m_delta[0]
+
+	std::vector<Edge> m_edges;
+};
@@ -103,6 +103,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "YamlHelper.h"
 
+#include "Debugger/Debugger_CallProfile.h"
+#include "Debugger/Debugger_History.h"
+
 #define LOG_IRQ_TAKEN_AND_RTI 0
 
 #define	 SHORTOPCODES  22
@@ -140,6 +143,8 @@ static bool g_interruptInLastExecutionBatch = false;	// Last batch of executed c
 // NB. No need to save to save-state, as IRQ() follows CheckSynchronousInterruptSources(), and IRQ() always sets it to false.
 static bool g_irqOnLastOpcodeCycle = false;
 
+static bool g_bIdleLoopSkip = false;	// set by cmd line
+
 //
 
 static eCpuType g_MainCPU = CPU_65C02;
@@ -211,8 +216,23 @@ void SetIrqOnLastOpcodeCycle()
 		g_irqOnLastOpcodeCycle = true;
 }
 
+void SetIdleLoopSkip(const bool enable)
+{
+	g_bIdleLoopSkip = enable;
+}
+
+bool GetIdleLoopSkip()
+{
+	return g_bIdleLoopSkip;
+}
+
 //
 
+// Execution history (for the debugger's reverse-step): recorded by every CPU variant, unless turned off with HIST OFF
+#define HISTORY_X(uExecutedCycles) if (g_bExecutionHistory) History_Record(g_nCumulativeCycles + (uExecutedCycles - g_nCyclesExecuted));
+#define HISTORY_W(addr, pMem) if (g_bExecutionHistory) History_RecordWrite(addr, *(pMem));
+#define HISTORY_RESET if (g_bExecutionHistory) History_Reset();
+
 #include "CPU/cpu_general.inl"
 #include "CPU/cpu_instructions.inl"
 
@@ -506,9 +526,22 @@ static __forceinline bool IRQ(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn,
 	return irqTaken;
 }
 
+// Only skip polling iterations if no interrupt can be taken between them
+static __forceinline UINT IdleLoop_GetPollCycles(WORD addr, ULONG uExecutedCycles, bool bVideoUpdate, bool bBit7Only)
+{
+	if (GetActiveCpu() == CPU_Z80 || g_bNmiFlank || (g_bmIRQ && !(regs.ps & AF_INTERRUPT)) || g_irqOnLastOpcodeCycle)
+		return 0;
+
+	return MemGetIdlePollCycles(addr, uExecutedCycles, bVideoUpdate, bBit7Only);
+}
+
+#include "CPU/cpu_idleloop.inl"
+
 //===========================================================================
 
 #define HEATMAP_X(address)
+#define CALL_PROFILE(opcode, interrupt)
+#define IDLE_LOOP if (g_bIdleLoopSkip) IdleLoop(uExecutedCycles, uTotalCycles, bVideoUpdate, flagn, flagv, flagz);
 
 // 6502 & no debugger
 #define READ(addr) _READ_WITH_IO_F8xx(addr)
@@ -551,10 +584,14 @@ static __forceinline bool IRQ(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn,
 #undef Fetch
 
 #undef HEATMAP_X
+#undef CALL_PROFILE
+#undef IDLE_LOOP
 
 //-----------------
 
 #define HEATMAP_X(address) Heatmap_X(address)
+#define CALL_PROFILE(opcode, interrupt) if (g_bCallProfiling) CallProfile_Step(opcode, interrupt, uExecutedCycles - uPreviousCycles);
+#define IDLE_LOOP
 #include "CPU/cpu_heatmap.inl"
 
 // 6502 & debugger
@@ -602,6 +639,8 @@ static __forceinline bool IRQ(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn,
 #undef Fetch
 
 #undef HEATMAP_X
+#undef CALL_PROFILE
+#undef IDLE_LOOP
 
 //===========================================================================
 
@@ -693,6 +732,12 @@ void CpuCalcCycles(const ULONG nExecutedCycles)
 	g_nCyclesExecuted = nExecutedCycles;
 }
 
+// As g_nCumulativeCycles after CpuCalcCycles(nExecutedCycles), but without updating it (eg. for a side-effect free query)
+unsigned __int64 CpuGetCumulativeCycles(const ULONG nExecutedCycles)
+{
+	return g_nCumulativeCycles + (nExecutedCycles - g_nCyclesExecuted);
+}
+
 //===========================================================================
 
 // Old method with g_uInternalExecutedCycles runs faster!
@@ -737,6 +782,9 @@ uint32_t CpuExecute(const uint32_t uCycles, const bool bVideoUpdate)
 	//  >0  : Do multi-opcode emulation
 	const uint32_t uExecutedCycles = InternalCpuExecute(uCycles, bVideoUpdate);
 
+	// Wait for the video render thread (if enabled), so the framebuffer is complete for VideoPresentScreen()
+	NTSC_VideoFlush();
+
 	// Update 6522s (NB. Do this before updating g_nCumulativeCycles below)
 	// . Ensures that 6522 regs are up-to-date for any potential save-state
 	// . SyncEvent will trigger the 6522 TIMER1/2 underflow on the correct cycle
@@ -815,6 +863,8 @@ void CpuReset()
 
 	SetActiveCpu(GetMainCpu());
 	z80_reset();
+
+	History_Reset();	// Can't step back past a reset
 }
 
 //===========================================================================
@@ -853,6 +903,64 @@ void CpuSetupBenchmark()
 	}
 }
 
+// Loops that hammer a card's I/O (see VideoBenchmark())
+// . IOBENCH_FLOATING_BUS: LDA from an empty slot's $C0n0-$C0nF, ie. every read is of the floating bus
+// . IOBENCH_DISK2_LATCH: a Disk II's nibble read loop, ie. LDA $C08C,X (with the motor on)
+// . IOBENCH_MOCKINGBOARD: a Mockingboard's 6522 ORA/ORB writes (AY address latches) & timer/IFR reads
+//   - no AY register writes, as they're queued until the end of the audio frame (which the benchmark doesn't run)
+// . returns false if there's no suitable card
+bool CpuSetupIoBenchmark(const IoBenchmark_e type)
+{
+	const SS_CARDTYPE cardType = type == IOBENCH_FLOATING_BUS ? CT_Empty
+		: type == IOBENCH_DISK2_LATCH ? CT_Disk2
+		: CT_MockingboardC;
+
+	UINT slot = SLOT1;
+	while (slot <= SLOT7 && GetCardMgr().QuerySlot(slot) != cardType)
+		slot++;
+	if (slot > SLOT7)
+		return false;
+
+	CpuSetupBenchmark();
+
+	const BYTE c0 = (BYTE)(0x80 + (slot << 4));	// $C0n0
+	const BYTE cn = (BYTE)(0xC0 + slot);		// $Cn00
+	std::vector<BYTE> code;
+
+	if (type == IOBENCH_FLOATING_BUS)
+	{
+		for (BYTE i = 0; i < 16; i++)
+			code.insert(code.end(), { 0xAD, (BYTE)(c0 + i), 0xC0 });					// LDA $C0n0+i
+		code.insert(code.end(), { 0x4C, 0x00, 0x03 });									// JMP $0300
+	}
+	else if (type == IOBENCH_DISK2_LATCH)
+	{
+		code.insert(code.end(), { 0xAD, (BYTE)(c0 + 0xA), 0xC0 });						// LDA $C0nA ; drive 1
+		code.insert(code.end(), { 0xAD, (BYTE)(c0 + 0x9), 0xC0 });						// LDA $C0n9 ; motor on
+		code.insert(code.end(), { 0xAD, (BYTE)(c0 + 0xE), 0xC0 });						// LDA $C0nE ; read mode
+		const BYTE loop = (BYTE)code.size();
+		for (UINT i = 0; i < 16; i++)
+			code.insert(code.end(), { 0xAD, (BYTE)(c0 + 0xC), 0xC0 });					// LDA $C0nC
+		code.insert(code.end(), { 0x4C, loop, 0x03 });									// JMP loop
+	}
+	else
+	{
+		code.insert(code.end(), { 0xA9, 0xFF, 0x8D, 0x03, cn, 0x8D, 0x02, cn });		// LDA #$FF : STA $Cn03 : STA $Cn02 ; DDRA & DDRB
+		const BYTE loop = (BYTE)code.size();
+		code.insert(code.end(), { 0x8E, 0x01, cn });									// STX $Cn01 ; ORA = AY register
+		code.insert(code.end(), { 0xA9, 0x07, 0x8D, 0x00, cn });						// LDA #7 : STA $Cn00 ; ORB = latch address
+		code.insert(code.end(), { 0xA9, 0x04, 0x8D, 0x00, cn });						// LDA #4 : STA $Cn00 ; ORB = inactive
+		code.insert(code.end(), { 0xAD, 0x04, cn, 0xAD, 0x0D, cn });					// LDA $Cn04 : LDA $Cn0D ; T1C-L & IFR
+		code.insert(code.end(), { 0xE8, 0x4C, loop, 0x03 });							// INX : JMP loop
+	}
+
+	WORD addr = 0x300;
+	for (size_t i = 0; i < code.size(); i++)
+		WriteByteToMemory(addr++, code[i]);
+
+	return true;
+}
+
 //===========================================================================
 
 void CpuIrqReset()
@@ -971,5 +1079,7 @@ void CpuLoadSnapshot(YamlLoadHelper& yamlLoadHelper, UINT version)
 	if (version >= 5)
 		g_irqDefer1Opcode = yamlLoadHelper.LoadBool(SS_YAML_KEY_IRQ_DEFER_1_OPCODE);
 
+	History_Reset();
+
 	yamlLoadHelper.PopMap();
 }
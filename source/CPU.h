@@ -30,11 +30,14 @@ extern unsigned __int64 g_nCumulativeCycles;
 
 void    CpuDestroy();
 void    CpuCalcCycles(ULONG nExecutedCycles);
+unsigned __int64 CpuGetCumulativeCycles(ULONG nExecutedCycles);
 uint32_t   CpuExecute(const uint32_t uCycles, const bool bVideoUpdate);
 ULONG   CpuGetCyclesThisVideoFrame(ULONG nExecutedCycles);
 void    CpuCreateCriticalSection();
 void    CpuInitialize();
 void    CpuSetupBenchmark();
+enum IoBenchmark_e {IOBENCH_FLOATING_BUS=0, IOBENCH_DISK2_LATCH, IOBENCH_MOCKINGBOARD, NUM_IOBENCH};
+bool    CpuSetupIoBenchmark(const IoBenchmark_e type);
 void	CpuIrqReset();
 void	CpuIrqAssert(eIRQSRC Device);
 void	CpuIrqDeassert(eIRQSRC Device);
@@ -62,3 +65,5 @@ bool Is6502InterruptEnabled();
 void ResetCyclesExecutedForDebugger();
 bool IsInterruptInLastExecution();
 void SetIrqOnLastOpcodeCycle();
+void SetIdleLoopSkip(const bool enable);
+bool GetIdleLoopSkip();
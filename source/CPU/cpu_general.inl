@@ -54,12 +54,14 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 			*(memshadow[_6502_STACK_PAGE]-_6502_STACK_BEGIN+((regs.sp >= _6502_STACK_END) ? (regs.sp = _6502_STACK_BEGIN) : ++regs.sp)) \
 		)
 
-#define _PUSH(a) *(mem+regs.sp--) = (a);									    \
+#define _PUSH(a) HISTORY_W(regs.sp, mem+regs.sp)								    \
+		 *(mem+regs.sp--) = (a);										    \
 		 if (regs.sp < _6502_STACK_BEGIN)									    \
 		   regs.sp = _6502_STACK_END;
 #define _PUSH_ALT(a) {															\
 			LPBYTE page = memwrite[_6502_STACK_PAGE];							\
 			if (page) {															\
+				HISTORY_W(regs.sp, page+(regs.sp & 0xFF))						\
 				*(page+(regs.sp & 0xFF)) = (BYTE)(a);							\
 			}																	\
 			regs.sp--;															\
@@ -97,8 +99,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 			{																			\
 				memdirty[addr >> 8] = 0xFF;												\
 				LPBYTE page = memwrite[addr >> 8];										\
-				if (page)																\
+				if (page) {																\
+					HISTORY_W(addr, page+(addr & 0xFF))									\
 					*(page+(addr & 0xFF)) = (BYTE)(a);									\
+				}																		\
 				else if ((addr & 0xF000) == APPLE_IO_BEGIN)								\
 					IOWrite[(addr>>4) & 0xFF](regs.pc,addr,1,(BYTE)(a),uExecutedCycles);\
 			}																			\
@@ -108,6 +112,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 				memdirty[addr >> 8] = 0xFF;												\
 				LPBYTE page = memwrite[addr >> 8];										\
 				if (page) {																\
+					HISTORY_W(addr, page+(addr & 0xFF))									\
 					*(page+(addr & 0xFF)) = (BYTE)(a);									\
 					if (memVidHD)											/* GH#997 */\
 						*(memVidHD + addr) = (BYTE)(a);									\
@@ -123,6 +128,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 				memdirty[addr >> 8] = 0xFF;												\
 				LPBYTE page = memwrite[addr >> 8];										\
 				if (page) {																\
+					HISTORY_W(addr, page+(addr & 0xFF))									\
 					*(page+(addr & 0xFF)) = (BYTE)(a);									\
 					if (memVidHD)											/* GH#997 */\
 						*(memVidHD + addr) = (BYTE)(a);									\
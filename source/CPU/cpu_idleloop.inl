@@ -0,0 +1,236 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2025, Tom Charlesworth, Michael Pohoreski
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: Idle-loop detection (cycle-exact fast-forward of soft switch polling loops)
+ *
+ * Recognises a 2-opcode loop at PC that polls a soft switch, eg:
+ *   LOOP: LDA $C000   ; (or LDX/LDY/BIT abs)
+ *         BPL LOOP    ; (or BMI/BVC/BVS/BNE/BEQ)
+ *
+ * If the registers & flags already hold what the next iteration will load (ie. the previous
+ * iteration has just completed) and the branch will be taken, then an iteration only consumes cycles.
+ *
+ * Also recognises a counted loop that waits for bit 7 of a soft switch to change, eg. the Monitor's RDBIT (tape input):
+ *   LOOP: DEY         ; (or DEX/INY/INX)
+ *         LDA $C060
+ *         EOR $2F
+ *         BPL LOOP    ; (or BMI)
+ *
+ * Here an iteration also changes the counter register (which is adjusted for the skipped iterations),
+ * and A & N/Z (which are set as per the last skipped iteration).
+ * Whole iterations are skipped up to (but excluding) the first point where anything else can happen:
+ * . the soft switch value changes (or its read has side-effects) - see IdleLoop_GetPollCycles()
+ * . the next synchronous event fires
+ * . the end of this CpuExecute() batch (when keypresses, cards, etc. get updated)
+ *
+ * Requires the includer to provide:
+ *   UINT IdleLoop_GetPollCycles(WORD addr, ULONG uExecutedCycles, bool bVideoUpdate, bool bBit7Only)
+ * which returns the # of cycles that reads of 'addr' return the same value (or just the same bit 7) without side-effects (0 = don't skip).
+ * It's only a query, so it mustn't have side-effects itself (eg. CpuCalcCycles()).
+ *
+ * Author: Various
+ */
+
+enum
+{
+	IDLE_LOOP_BRANCH_OFFSET = 0xFB,		// -5: back to the 3-byte poll opcode
+	IDLE_LOOP_COUNTED_BRANCH_OFFSET = 0xF8,	// -8: back to the 1-byte counter opcode
+	IDLE_LOOP_COUNTED_READ_OFFSET = 2,	// the poll opcode starts 2 cycles into an iteration (after DEY)
+	IDLE_LOOP_MAX_CYCLES = 0x3FFF		// < 1 video frame, see NTSC_VideoUpdateCycles()
+};
+
+// # of whole iterations that can be skipped, where each iteration reads the soft switch at 'uReadOffset'
+static UINT IdleLoop_GetIterations(const ULONG uExecutedCycles, const ULONG uTotalCycles, const UINT uLoopCycles, const UINT uPollCycles, const UINT uReadOffset)
+{
+	// Bound by the batch: the last skipped iteration must end before uTotalCycles
+	if (uExecutedCycles >= uTotalCycles)
+		return 0;
+	UINT uMaxCycles = uTotalCycles - uExecutedCycles - 1;
+
+	// Bound by the next synchronous event: it must fire during a real opcode
+	if (SyncEvent* pEvent = g_SynchronousEventMgr.GetHead())
+	{
+		if (pEvent->m_cyclesRemaining <= 0)
+			return 0;
+		if ((UINT)pEvent->m_cyclesRemaining - 1 < uMaxCycles)
+			uMaxCycles = (UINT)pEvent->m_cyclesRemaining - 1;
+	}
+
+	if (uMaxCycles > IDLE_LOOP_MAX_CYCLES)
+		uMaxCycles = IDLE_LOOP_MAX_CYCLES;
+
+	// Bound by the soft switch: each skipped read must return the same value
+	if (uPollCycles <= uReadOffset)
+		return 0;
+	UINT uIterations = uMaxCycles / uLoopCycles;
+	const UINT uPollIterations = (uPollCycles - 1 - uReadOffset) / uLoopCycles + 1;
+	if (uPollIterations < uIterations)
+		uIterations = uPollIterations;
+
+	return uIterations;
+}
+
+static void IdleLoop_AddCycles(ULONG& uExecutedCycles, const UINT uCycles, const bool bVideoUpdate)
+{
+	uExecutedCycles += uCycles;
+
+	CheckSynchronousInterruptSources(uCycles, uExecutedCycles);
+
+	if (bVideoUpdate)
+		NTSC_VideoUpdateCycles(uCycles);
+}
+
+static void IdleLoop_Skip(ULONG& uExecutedCycles, const ULONG uTotalCycles, const bool bVideoUpdate, const BOOL flagn, const BOOL flagv, const BOOL flagz)
+{
+	const WORD pc = regs.pc;
+	const BYTE opcode = *(mem + pc);
+	const WORD addr = *(mem + (WORD)(pc + 1)) | (*(mem + (WORD)(pc + 2)) << 8);
+	const BYTE branch = *(mem + (WORD)(pc + 3));
+
+	if ((addr & 0xFF00) != APPLE_IO_BEGIN)	// $C0xx
+		return;
+
+	const UINT uPollCycles = IdleLoop_GetPollCycles(addr, uExecutedCycles, bVideoUpdate, false);
+	if (!uPollCycles)
+		return;
+
+	const BYTE val = IORead[(addr >> 4) & 0xFF](pc + 3, addr, 0, 0, uExecutedCycles);
+
+	// Check that an iteration won't change any register or flag
+	bool n = (val & 0x80) != 0;
+	bool v = flagv != 0;
+	bool z = (val == 0);
+
+	switch (opcode)
+	{
+	case 0xAD: if (regs.a != val) return; break;	// LDA abs
+	case 0xAE: if (regs.x != val) return; break;	// LDX abs
+	case 0xAC: if (regs.y != val) return; break;	// LDY abs
+	case 0x2C:										// BIT abs
+		v = (val & 0x40) != 0;
+		z = (regs.a & val) == 0;
+		break;
+	default:
+		return;
+	}
+
+	if ((flagn != 0) != n || (flagv != 0) != v || (flagz != 0) != z)
+		return;
+
+	bool bTaken;
+	switch (branch)
+	{
+	case 0x10: bTaken = !n; break;	// BPL
+	case 0x30: bTaken =  n; break;	// BMI
+	case 0x50: bTaken = !v; break;	// BVC
+	case 0x70: bTaken =  v; break;	// BVS
+	case 0xD0: bTaken = !z; break;	// BNE
+	case 0xF0: bTaken =  z; break;	// BEQ
+	default: return;
+	}
+
+	if (!bTaken)
+		return;
+
+	// abs read (4) + branch taken (3), +1 if the branch crosses a page
+	const UINT uLoopCycles = 4 + 3 + ((((pc + 5) ^ pc) & 0xFF00) ? 1 : 0);
+
+	// Each skipped read is at the start of an iteration
+	const UINT uIterations = IdleLoop_GetIterations(uExecutedCycles, uTotalCycles, uLoopCycles, uPollCycles, 0);
+	if (!uIterations)
+		return;
+
+	IdleLoop_AddCycles(uExecutedCycles, uIterations * uLoopCycles, bVideoUpdate);
+}
+
+static void IdleLoop_SkipCounted(ULONG& uExecutedCycles, const ULONG uTotalCycles, const bool bVideoUpdate, BOOL& flagn, BOOL& flagz)
+{
+	const WORD pc = regs.pc;
+	const BYTE counter = *(mem + pc);
+	const WORD addr = *(mem + (WORD)(pc + 2)) | (*(mem + (WORD)(pc + 3)) << 8);
+	const BYTE zp = *(mem + (WORD)(pc + 5));
+	const BYTE branch = *(mem + (WORD)(pc + 6));
+
+	if (*(mem + (WORD)(pc + 1)) != 0xAD || *(mem + (WORD)(pc + 4)) != 0x45)	// LDA abs; EOR zp
+		return;
+
+	if ((addr & 0xFF00) != APPLE_IO_BEGIN)	// $C0xx
+		return;
+
+	switch (counter)
+	{
+	case 0x88: case 0xCA: case 0xC8: case 0xE8: break;	// DEY, DEX, INY, INX
+	default: return;
+	}
+
+	// Only bit 7 of the soft switch affects the branch
+	const UINT uPollCycles = IdleLoop_GetPollCycles(addr, uExecutedCycles, bVideoUpdate, true);
+	if (uPollCycles <= IDLE_LOOP_COUNTED_READ_OFFSET)
+		return;
+
+	const BYTE val = IORead[(addr >> 4) & 0xFF](pc + 4, addr, 0, 0, uExecutedCycles);	// bit 7 is the same at the first poll
+	const bool n = ((val ^ *(mem + zp)) & 0x80) != 0;
+
+	bool bTaken;
+	switch (branch)
+	{
+	case 0x10: bTaken = !n; break;	// BPL
+	case 0x30: bTaken =  n; break;	// BMI
+	default: return;
+	}
+
+	if (!bTaken)
+		return;
+
+	// counter (2) + abs read (4) + zp read (3) + branch taken (3), +1 if the branch crosses a page
+	const UINT uLoopCycles = 2 + 4 + 3 + 3 + ((((pc + 8) ^ pc) & 0xFF00) ? 1 : 0);
+
+	const UINT uIterations = IdleLoop_GetIterations(uExecutedCycles, uTotalCycles, uLoopCycles, uPollCycles, IDLE_LOOP_COUNTED_READ_OFFSET);
+	if (!uIterations)
+		return;
+
+	// Up to the last skipped read, so that A is as per the last skipped iteration (its bits 0-6 can be the floating bus)
+	const UINT uLastReadCycles = (uIterations - 1) * uLoopCycles + IDLE_LOOP_COUNTED_READ_OFFSET;
+	IdleLoop_AddCycles(uExecutedCycles, uLastReadCycles, bVideoUpdate);
+	regs.a = IORead[(addr >> 4) & 0xFF](pc + 4, addr, 0, 0, uExecutedCycles) ^ *(mem + zp);
+	flagn = regs.a & 0x80;	// EOR
+	flagz = !regs.a;
+	IdleLoop_AddCycles(uExecutedCycles, uIterations * uLoopCycles - uLastReadCycles, bVideoUpdate);
+
+	switch (counter)
+	{
+	case 0x88: regs.y -= (BYTE)uIterations; break;
+	case 0xCA: regs.x -= (BYTE)uIterations; break;
+	case 0xC8: regs.y += (BYTE)uIterations; break;
+	case 0xE8: regs.x += (BYTE)uIterations; break;
+	}
+}
+
+// Called after every opcode, so only 1-byte tests are inlined
+static __forceinline void IdleLoop(ULONG& uExecutedCycles, const ULONG uTotalCycles, const bool bVideoUpdate, BOOL& flagn, const BOOL flagv, BOOL& flagz)
+{
+	if (*(mem + (WORD)(regs.pc + 4)) == IDLE_LOOP_BRANCH_OFFSET)
+		IdleLoop_Skip(uExecutedCycles, uTotalCycles, bVideoUpdate, flagn, flagv, flagz);
+	else if (*(mem + (WORD)(regs.pc + 7)) == IDLE_LOOP_COUNTED_BRANCH_OFFSET)
+		IdleLoop_SkipCounted(uExecutedCycles, uTotalCycles, bVideoUpdate, flagn, flagz);
+}
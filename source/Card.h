@@ -52,6 +52,12 @@ public:
 	virtual void SaveSnapshot(YamlSaveHelper& yamlSaveHelper) = 0;
 	virtual bool LoadSnapshot(YamlLoadHelper& yamlLoadHelper, UINT version) = 0;
 
+	// Granularity of the periodic Update(): kUpdateNever, kUpdateEveryPeriod (ie. every CardManager::Update()),
+	// or the min # of cycles between calls (the cycles are accumulated and passed to Update())
+	static const UINT kUpdateNever = 0;
+	static const UINT kUpdateEveryPeriod = 1;
+	virtual UINT GetUpdateInterval() { return kUpdateEveryPeriod; }
+
 	SS_CARDTYPE QueryType() { return m_type; }
 
 	static const std::string& GetCardNameEmpty();
@@ -85,6 +91,7 @@ public:
 	virtual void Destroy() {}
 	virtual void Reset(const bool powerCycle) {}
 	virtual void Update(const ULONG nExecutedCycles) {}
+	virtual UINT GetUpdateInterval() { return kUpdateNever; }
 	virtual void SaveSnapshot(YamlSaveHelper& yamlSaveHelper) {}
 	virtual bool LoadSnapshot(YamlLoadHelper& yamlLoadHelper, UINT version) { _ASSERT(0); return false; }
 };
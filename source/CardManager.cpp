@@ -30,6 +30,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "StdAfx.h"
 
 #include "CardManager.h"
+#include "Core.h"
+#include "Log.h"
 #include "Registry.h"
 
 #include "BreakpointCard.h"
@@ -145,6 +147,8 @@ void CardManager::InsertInternal(UINT slot, SS_CARDTYPE type)
 
 	if (m_slot[slot] == NULL)
 		Remove(slot);			// creates a new EmptyCard
+	else
+		UpdateSchedule();
 }
 
 void CardManager::Insert(UINT slot, SS_CARDTYPE type, bool updateRegistry/*=true*/)
@@ -296,18 +300,80 @@ void CardManager::Reset(const bool powerCycle)
 	GetMockingboardCardMgr().Reset(powerCycle);
 }
 
-void CardManager::Update(const ULONG nExecutedCycles)
+// Rebuild the list of cards that need a periodic Update() (eg. excluding empty slots)
+void CardManager::UpdateSchedule()
 {
+	m_numUpdateSlots = 0;
+
 	for (UINT i = SLOT0; i < NUM_SLOTS; ++i)
 	{
-		if (m_slot[i])
+		const UINT interval = m_slot[i] ? m_slot[i]->GetUpdateInterval() : Card::kUpdateNever;
+		if (interval == Card::kUpdateNever)
+			continue;
+
+		m_updateSlot[m_numUpdateSlots++] = i;
+		m_updateInterval[i] = interval;
+		m_updateCycles[i] = 0;
+	}
+}
+
+void CardManager::Update(const ULONG nExecutedCycles)
+{
+	for (UINT n = 0; n < m_numUpdateSlots; ++n)
+	{
+		const UINT i = m_updateSlot[n];
+
+		ULONG cycles = nExecutedCycles;
+		if (m_updateInterval[i] != Card::kUpdateEveryPeriod)
 		{
-			m_slot[i]->Update(nExecutedCycles);
+			m_updateCycles[i] += nExecutedCycles;
+			if (m_updateCycles[i] < m_updateInterval[i])
+				continue;
+
+			cycles = m_updateCycles[i];
+			m_updateCycles[i] = 0;
 		}
+
+#ifdef LOG_PERF_TIMINGS
+		PerfMarker perfMarker(m_timeUpdate[i]);
+#endif
+		m_slot[i]->Update(cycles);
+	}
+
+	{
+#ifdef LOG_PERF_TIMINGS
+		PerfMarker perfMarker(m_timeUpdateMB);
+		m_cyclesUpdate += nExecutedCycles;
+#endif
+		GetMockingboardCardMgr().Update(nExecutedCycles);
+	}
+}
+
+#ifdef LOG_PERF_TIMINGS
+// Host time spent in each card's Update(), per emulated second
+void CardManager::LogPerfTimings()
+{
+	if (!m_cyclesUpdate)
+		return;
+
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	const double emulatedSecs = (double)m_cyclesUpdate / g_fCurrentCLK6502;
+	const double usecPerTick = 1.e6 / (double)freq.QuadPart;
+
+	LogOutput("Card Update() time (usec per emulated sec):\n");
+	for (UINT i = SLOT0; i < NUM_SLOTS; ++i)
+	{
+		if (m_timeUpdate[i])
+			LogOutput(". Slot %u: %-16s = %8.1f\n", i, m_slot[i]->GetCardName().c_str(), (double)m_timeUpdate[i] * usecPerTick / emulatedSecs);
+		m_timeUpdate[i] = 0;
 	}
+	LogOutput(". Mockingboard mgr  = %8.1f\n", (double)m_timeUpdateMB * usecPerTick / emulatedSecs);
 
-	GetMockingboardCardMgr().Update(nExecutedCycles);
+	m_timeUpdateMB = 0;
+	m_cyclesUpdate = 0;
 }
+#endif
 
 void CardManager::SaveSnapshot(YamlSaveHelper& yamlSaveHelper)
 {
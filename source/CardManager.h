@@ -5,6 +5,7 @@
 #include "LanguageCard.h"
 #include "MockingboardCardManager.h"
 #include "Common.h"
+#include "Core.h"	// LOG_PERF_TIMINGS
 
 class CardManager
 {
@@ -14,7 +15,8 @@ public:
 		m_pSSC(NULL),
 		m_pParallelPrinterCard(NULL),
 		m_pVidHDCard(NULL),
-		m_pZ80Card(NULL)
+		m_pZ80Card(NULL),
+		m_numUpdateSlots(0)
 	{
 		// LoadConfiguration() now sets up default cards for a new install
 		InsertInternal(SLOT0, CT_Empty);
@@ -26,6 +28,12 @@ public:
 		InsertInternal(SLOT6, CT_Empty);
 		InsertInternal(SLOT7, CT_Empty);
 		InsertAuxInternal(CT_Extended80Col);	// For Apple //e and above
+
+#ifdef LOG_PERF_TIMINGS
+		memset(m_timeUpdate, 0, sizeof(m_timeUpdate));
+		m_timeUpdateMB = 0;
+		m_cyclesUpdate = 0;
+#endif
 	}
 	~CardManager()
 	{
@@ -74,6 +82,9 @@ public:
 	void Reset(const bool powerCycle);
 	void Update(const ULONG nExecutedCycles);
 	void SaveSnapshot(YamlSaveHelper& yamlSaveHelper);
+#ifdef LOG_PERF_TIMINGS
+	void LogPerfTimings();
+#endif
 
 private:
 	void InsertInternal(UINT slot, SS_CARDTYPE type);
@@ -81,6 +92,7 @@ private:
 	void RemoveInternal(UINT slot);
 	void RemoveAuxInternal();
 	bool IsSingleInstanceCard(SS_CARDTYPE card);
+	void UpdateSchedule();
 
 	Card* m_slot[NUM_SLOTS];
 	Card* m_aux;
@@ -92,4 +104,16 @@ private:
 	class ParallelPrinterCard* m_pParallelPrinterCard;
 	class VidHDCard* m_pVidHDCard;
 	class Z80Card* m_pZ80Card;
+
+	// Only cards that need a periodic Update() are scheduled
+	UINT m_updateSlot[NUM_SLOTS];
+	UINT m_updateInterval[NUM_SLOTS];
+	ULONG m_updateCycles[NUM_SLOTS];
+	UINT m_numUpdateSlots;
+
+#ifdef LOG_PERF_TIMINGS
+	UINT64 m_timeUpdate[NUM_SLOTS];
+	UINT64 m_timeUpdateMB;
+	UINT64 m_cyclesUpdate;
+#endif
 };
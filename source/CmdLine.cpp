@@ -728,6 +728,25 @@ bool ProcessCmdLine(LPSTR lpCmdLine)
 			lpNextArg = GetNextArg(lpNextArg);
 			g_cmdLine.wavFileMockingboard = lpCmdLine;
 		}
+		else if (strcmp(lpCmdLine, "-wav-stems") == 0)
+		{
+			lpCmdLine = GetCurrArg(lpNextArg);
+			lpNextArg = GetNextArg(lpNextArg);
+			g_cmdLine.wavFileStemsPrefix = lpCmdLine;
+		}
+		else if (strcmp(lpCmdLine, "-video-capture") == 0)
+		{
+			lpCmdLine = GetCurrArg(lpNextArg);
+			lpNextArg = GetNextArg(lpNextArg);
+			g_cmdLine.videoCaptureFile = lpCmdLine;
+		}
+		else if (strcmp(lpCmdLine, "-video-capture-format") == 0)
+		{
+			lpCmdLine = GetCurrArg(lpNextArg);
+			lpNextArg = GetNextArg(lpNextArg);
+			if (!VideoCaptureParseFormat(lpCmdLine, g_cmdLine.videoCaptureFormat))
+				LogFileOutput("Unsupported video capture format: %s\n", lpCmdLine);
+		}
 		else if (strcmp(lpCmdLine, "-mb-audit") == 0)	// enable selection of additional sound cards, eg. for mb-audit
 		{
 			g_cmdLine.supportExtraMBCardTypes = true;
@@ -784,6 +803,14 @@ bool ProcessCmdLine(LPSTR lpCmdLine)
 		{
 			g_cmdLine.useAltCpuEmulation = true;
 		}
+		else if (strcmp(lpCmdLine, "-idle-loop-skip") == 0)
+		{
+			g_cmdLine.idleLoopSkip = true;
+		}
+		else if (strcmp(lpCmdLine, "-video-thread") == 0)
+		{
+			g_cmdLine.videoThread = true;
+		}
 		else if (strcmp(lpCmdLine, "-debugger-auto-run") == 0)
 		{
 			lpCmdLine = GetCurrArg(lpNextArg);
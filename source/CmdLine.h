@@ -6,6 +6,7 @@
 #include "Common.h"
 #include "Card.h"
 #include "MockingboardDefs.h"
+#include "VideoCapture.h"
 
 struct CmdLine
 {
@@ -44,6 +45,8 @@ struct CmdLine
 		enableDumpToRealPrinter = false;
 		supportExtraMBCardTypes = false;
 		noDisk2StepperDefer = false;
+		idleLoopSkip = false;
+		videoThread = false;
 		useHdcFirmwareV1 = false;
 		useHdcFirmwareV2 = false;
 		szSnapshotName = NULL;
@@ -64,6 +67,7 @@ struct CmdLine
 		bestFullScreenResolution = false;
 		userSpecifiedWidth = 0;
 		userSpecifiedHeight = 0;
+		videoCaptureFormat = VIDEO_CAPTURE_PNG;
 		auxSlotCard = CT_Undefined;
 		sBootSectorFileName = "";
 		nBootSectorFileSize = 0;
@@ -93,6 +97,8 @@ struct CmdLine
 	bool useHdcFirmwareV1;	// debug
 	bool useHdcFirmwareV2;
 	bool useAltCpuEmulation;	// debug
+	bool idleLoopSkip;
+	bool videoThread;
 	SlotInfo slotInfo[NUM_SLOTS];
 	LPCSTR szImageName_drive[NUM_SLOTS][NUM_DRIVES];
 	bool driveConnected[NUM_SLOTS][NUM_DRIVES];
@@ -118,6 +124,9 @@ struct CmdLine
 	UINT userSpecifiedHeight;
 	std::string wavFileSpeaker;
 	std::string wavFileMockingboard;
+	std::string wavFileStemsPrefix;
+	std::string videoCaptureFile;
+	VIDEO_CAPTURE_FORMAT videoCaptureFormat;
 	SS_CARDTYPE auxSlotCard;
 	std::string sBootSectorFileName;
 	size_t nBootSectorFileSize;
@@ -123,6 +123,8 @@ void LogPerfTimings()
 		LogOutput(". Other %%      = %6.2f\n", (double)other / (double)g_timeTotal * 100.0);
 		LogOutput(". TOTAL %%      = %6.2f\n", (double)(cpu+video+audio+other) / (double)g_timeTotal * 100.0);
 	}
+
+	GetCardMgr().LogPerfTimings();
 }
 #endif
 
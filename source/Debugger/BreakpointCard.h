@@ -56,6 +56,7 @@ public:
 	virtual void Destroy() {}
 	virtual void Reset(const bool powerCycle);
 	virtual void Update(const ULONG nExecutedCycles) {}
+	virtual UINT GetUpdateInterval() { return kUpdateNever; }
 	virtual void InitializeIO(LPBYTE pCxRomPeripheral);
 
 	static BYTE __stdcall IORead(WORD pc, WORD addr, BYTE bWrite, BYTE value, ULONG nExecutedCycles);
@@ -52,7 +52,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #define MAKE_VERSION(a,b,c,d) ((a<<24) | (b<<16) | (c<<8) | (d))
 
 	// See /docs/Debugger_Changelog.txt for full details
-	const int DEBUGGER_VERSION = MAKE_VERSION(2,9,4,3);
+	const int DEBUGGER_VERSION = MAKE_VERSION(2,9,4,7);
 
 
 // Public _________________________________________________________________________________________
@@ -378,6 +378,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 // Breakpoints
 	static std::string GetFullPrefixAddrForBreakpoint(const AddressPrefix_t& pBP, WORD addr, DEVICE_e device, bool padding);
+	static std::string GetBreakpointHitIdString(int id);
 	Update_t _BP_InfoNone ();
 	void _BWZ_ClearViaArgs ( int nArgs, Breakpoint_t * aBreakWatchZero, const int nMax, int & nTotal );
 	void _BWZ_EnableDisableViaArgs ( int nArgs, Breakpoint_t * aBreakWatchZero, const int nMax, const bool bEnabled );
@@ -2740,6 +2741,66 @@ Update_t CmdTraceLine (int nArgs)
 	return UPDATE_ALL; // TODO: Verify // 0
 }
 
+// Reverse-step using the execution history
+//===========================================================================
+Update_t CmdTraceBack (int nArgs)
+{
+	int nSteps = nArgs ? g_aArgs[1].nValue : 1;
+	int nUndone = 0;
+
+	while (nSteps-- > 0 && History_StepBack())
+		nUndone++;
+
+	if (!nUndone)
+	{
+		ConsoleBufferPush( g_bExecutionHistory ? " Start of execution history." : " Execution history is off. (See: HIST ON)" );
+		return ConsoleUpdate();
+	}
+
+	g_nDisasmCurAddress = regs.pc;
+	DisasmCalcTopBotAddress();
+
+	return UPDATE_ALL;
+}
+
+// Reverse-continue until PC matches an enabled PC breakpoint, or the history is exhausted
+//===========================================================================
+Update_t CmdGoBack (int nArgs)
+{
+	int iBreakpointHit = -1;
+	int nUndone = 0;
+
+	while (iBreakpointHit < 0 && History_StepBack())
+	{
+		nUndone++;
+
+		for (int iBreakpoint = 0; iBreakpoint < MAX_BREAKPOINTS; iBreakpoint++)
+		{
+			Breakpoint_t *pBP = &g_aBreakpoints[iBreakpoint];
+			if (_BreakpointValid( pBP ) && pBP->eSource == BP_SRC_REG_PC && _CheckBreakpointValue( pBP, regs.pc ))
+			{
+				iBreakpointHit = iBreakpoint;
+				break;
+			}
+		}
+	}
+
+	if (iBreakpointHit >= 0)
+	{
+		std::string hitId = GetBreakpointHitIdString(iBreakpointHit);
+		ConsolePrintFormat(CHC_INFO "Stop reason: %s " CHC_DEFAULT "Register " CHC_REGS "PC" CHC_DEFAULT " matches value (%d instructions back)", hitId.c_str(), nUndone);
+	}
+	else
+	{
+		ConsolePrintFormat(CHC_INFO "Stop reason: " CHC_DEFAULT "Start of execution history (%d instructions back)", nUndone);
+	}
+
+	g_nDisasmCurAddress = regs.pc;
+	DisasmCalcTopBotAddress();
+
+	return UPDATE_ALL;
+}
+
 
 
 
@@ -6997,7 +7058,7 @@ bool ParseAssemblyListing ( bool bBytesToMemory, bool bAddSymbols )
 					{
 						char *pAddressEnd;
 						nAddress = (uint32_t) strtol( pAddress, &pAddressEnd, 16 );
-						g_aSymbols[ SYMBOLS_SRC_2 ][ (WORD) nAddress] = sName;
+						SymbolTableAdd( SYMBOLS_SRC_2, (WORD) nAddress, sName );
 						g_nSourceAssemblySymbols++;
 					}
 				}
@@ -9284,6 +9345,12 @@ static void DebugEnd ()
 		ProfileFormat( true, PROFILE_FORMAT_TAB ); // Export in Excel-ready text format.
 		ProfileSave();
 	}
+
+	if (g_bCallProfiling)
+	{
+		// Also allows headless runs (eg. enabled from DebuggerAutoRun.txt) to collect the results
+		CallProfile_SaveDefault();
+	}
 	
 	if (g_hTraceFile)
 	{
@@ -13,6 +13,8 @@
 #include "Debugger_Help.h"
 #include "Debugger_Display.h"
 #include "Debugger_Symbols.h"
+#include "Debugger_CallProfile.h"
+#include "Debugger_History.h"
 #include "Util_MemoryTextFile.h"
 #include "BreakpointCard.h"
 
@@ -0,0 +1,390 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2025, Tom Charlesworth, Michael Pohoreski
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: Debugger Call-graph Cycle Profiler
+ *
+ * Every instruction executed by the debugger's CPU core has its cycles added to the node for the current call path.
+ * The call path is tracked on a shadow stack:
+ * . JSR pushes the target, BRK/IRQ/NMI push the interrupt handler
+ * . RTS/RTI pop every frame whose return address is no longer on the 6502 stack
+ *   (this also re-syncs after code that discards its return address, eg. PLA PLA JMP)
+ */
+
+#include "StdAfx.h"
+
+#include "Debug.h"
+
+#include "../Core.h"
+#include "../CPU.h"
+
+#include <cinttypes>
+#include <unordered_map>
+
+// Globals ________________________________________________________________________________________
+
+	bool g_bCallProfiling = false;
+
+	const std::string g_sFileNameCallProfile = "ProfileCalls"; // .txt (flat) & .folded
+
+// Private ________________________________________________________________________________________
+
+	enum
+	{
+		CALL_KEY_INTERRUPT = 0x10000, // OR'd with the handler's address
+		CALL_NODE_ROOT     = 0,       // code not inside any tracked call
+		CALL_LIST_LINES    = 16       // number of routines for CALLPROF LIST
+	};
+
+	struct CallNode_t
+	{
+		uint32_t nKey;     // routine address | CALL_KEY_INTERRUPT
+		int      iParent;
+		uint64_t nCyclesSelf;
+		uint32_t nCalls;
+		std::unordered_map<uint32_t, int> mChildren;
+	};
+
+	struct CallFrame_t
+	{
+		int  iNode;
+		BYTE nSP;          // SP before the return address was pushed
+	};
+
+	struct CallRoutine_t
+	{
+		uint32_t nKey;
+		uint64_t nCyclesSelf;
+		uint64_t nCyclesTotal; // inclusive of callees, recursion counted once
+		uint32_t nCalls;
+	};
+
+	static std::vector<CallNode_t>  g_vCallNodes;
+	static std::vector<CallFrame_t> g_vCallStack;
+
+//===========================================================================
+static int _CallNodeChild ( const int iParent, const uint32_t nKey )
+{
+	std::unordered_map<uint32_t, int>::const_iterator it = g_vCallNodes[ iParent ].mChildren.find( nKey );
+	if (it != g_vCallNodes[ iParent ].mChildren.end())
+		return it->second;
+
+	const int iNode = (int) g_vCallNodes.size();
+	CallNode_t node;
+	node.nKey        = nKey;
+	node.iParent     = iParent;
+	node.nCyclesSelf = 0;
+	node.nCalls      = 0;
+	g_vCallNodes.push_back( node );
+	g_vCallNodes[ iParent ].mChildren[ nKey ] = iNode;
+	return iNode;
+}
+
+// Pop frames whose return address has been pulled off the 6502 stack
+//===========================================================================
+static void _CallStackUnwind ( const BYTE nSP )
+{
+	while ((g_vCallStack.size() > 1) && ((int)nSP >= (int)g_vCallStack.back().nSP - 1))
+		g_vCallStack.pop_back();
+}
+
+//===========================================================================
+static void _CallStackPush ( const uint32_t nKey, const BYTE nSPBefore )
+{
+	_CallStackUnwind( nSPBefore );
+
+	CallFrame_t frame;
+	frame.iNode = _CallNodeChild( g_vCallStack.back().iNode, nKey );
+	frame.nSP   = nSPBefore;
+	g_vCallNodes[ frame.iNode ].nCalls++;
+	g_vCallStack.push_back( frame );
+}
+
+//===========================================================================
+static std::string _CallKeyName ( const uint32_t nKey )
+{
+	const WORD nAddress = (WORD) nKey;
+
+	std::string sName;
+	std::string const* pSymbol = FindSymbolFromAddress( nAddress );
+	if (pSymbol)
+		sName = *pSymbol;
+	else
+		sName = StrFormat( "$%04X", nAddress );
+
+	if (nKey & CALL_KEY_INTERRUPT)
+		sName = "[INT]" + sName;
+
+	return sName;
+}
+
+//===========================================================================
+static void _CallProfileRoutines ( std::vector<CallRoutine_t> & vRoutines_, uint64_t & nCyclesTotal_ )
+{
+	const int nNodes = (int) g_vCallNodes.size();
+
+	// Nodes are always created after their parent, so a reverse walk accumulates inclusive cycles
+	std::vector<uint64_t> vNodeTotal( nNodes );
+	for (int iNode = nNodes - 1; iNode >= 0; iNode--)
+	{
+		vNodeTotal[ iNode ] += g_vCallNodes[ iNode ].nCyclesSelf;
+		if (iNode != CALL_NODE_ROOT)
+			vNodeTotal[ g_vCallNodes[ iNode ].iParent ] += vNodeTotal[ iNode ];
+	}
+	nCyclesTotal_ = vNodeTotal[ CALL_NODE_ROOT ];
+
+	std::unordered_map<uint32_t, size_t> mRoutine;
+	for (int iNode = 1; iNode < nNodes; iNode++)
+	{
+		const CallNode_t & node = g_vCallNodes[ iNode ];
+
+		std::unordered_map<uint32_t, size_t>::const_iterator it = mRoutine.find( node.nKey );
+		if (it == mRoutine.end())
+		{
+			CallRoutine_t routine;
+			routine.nKey         = node.nKey;
+			routine.nCyclesSelf  = 0;
+			routine.nCyclesTotal = 0;
+			routine.nCalls       = 0;
+			it = mRoutine.insert( std::make_pair( node.nKey, vRoutines_.size() ) ).first;
+			vRoutines_.push_back( routine );
+		}
+
+		CallRoutine_t & routine = vRoutines_[ it->second ];
+		routine.nCyclesSelf += node.nCyclesSelf;
+		routine.nCalls      += node.nCalls;
+
+		// Recursion: only the outermost activation contributes inclusive cycles
+		bool bRecursive = false;
+		for (int iAncestor = node.iParent; iAncestor != CALL_NODE_ROOT; iAncestor = g_vCallNodes[ iAncestor ].iParent)
+		{
+			if (g_vCallNodes[ iAncestor ].nKey == node.nKey)
+			{
+				bRecursive = true;
+				break;
+			}
+		}
+		if (!bRecursive)
+			routine.nCyclesTotal += vNodeTotal[ iNode ];
+	}
+
+	std::sort( vRoutines_.begin(), vRoutines_.end(),
+		[]( const CallRoutine_t & rLHS, const CallRoutine_t & rRHS ) { return rLHS.nCyclesTotal > rRHS.nCyclesTotal; } );
+}
+
+//===========================================================================
+static std::string _CallRoutineLine ( const CallRoutine_t & routine, const uint64_t nCyclesTotal, const char* pSep )
+{
+	const double fTotal = nCyclesTotal ? (100.0 * routine.nCyclesTotal / nCyclesTotal) : 0.0;
+	const double fSelf  = nCyclesTotal ? (100.0 * routine.nCyclesSelf  / nCyclesTotal) : 0.0;
+
+	return StrFormat( "%10" PRIu64 "%s%6.2f%%%s%10" PRIu64 "%s%6.2f%%%s%8u%s$%04X%s%s"
+		, routine.nCyclesTotal, pSep, fTotal, pSep
+		, routine.nCyclesSelf , pSep, fSelf , pSep
+		, routine.nCalls, pSep
+		, (WORD) routine.nKey, pSep
+		, _CallKeyName( routine.nKey ).c_str()
+	);
+}
+
+// Public _________________________________________________________________________________________
+
+//===========================================================================
+bool CallProfile_SaveDefault ()
+{
+	return CallProfile_Save( g_sCurrentDir + g_sFileNameCallProfile );
+}
+
+//===========================================================================
+void CallProfile_Reset ()
+{
+	g_vCallNodes.clear();
+	g_vCallStack.clear();
+
+	CallNode_t root;
+	root.nKey        = 0;
+	root.iParent     = CALL_NODE_ROOT;
+	root.nCyclesSelf = 0;
+	root.nCalls      = 0;
+	g_vCallNodes.push_back( root );
+
+	CallFrame_t frame;
+	frame.iNode = CALL_NODE_ROOT;
+	frame.nSP   = 0xFF;
+	g_vCallStack.push_back( frame );
+}
+
+// Called by the debugger's CPU core after each instruction (or interrupt)
+// @param nOpcode   Opcode just executed (ignored if bInterrupt)
+// @param bInterrupt An IRQ/NMI was taken instead of executing an opcode
+// @param nCycles   Cycles executed by the instruction
+//===========================================================================
+void CallProfile_Step ( const BYTE nOpcode, const bool bInterrupt, const uint32_t nCycles )
+{
+	if (g_vCallStack.empty())
+		CallProfile_Reset();
+
+	g_vCallNodes[ g_vCallStack.back().iNode ].nCyclesSelf += nCycles;
+
+	// SP before the call = SP after it + the bytes it pushed (JSR: PC, BRK/IRQ/NMI: PC & P)
+	if (bInterrupt)
+	{
+		_CallStackPush( regs.pc | CALL_KEY_INTERRUPT, (BYTE) (regs.sp + 3) );
+		return;
+	}
+
+	switch (nOpcode)
+	{
+		case 0x20: // JSR
+			_CallStackPush( regs.pc, (BYTE) (regs.sp + 2) );
+			break;
+		case 0x00: // BRK
+			_CallStackPush( regs.pc | CALL_KEY_INTERRUPT, (BYTE) (regs.sp + 3) );
+			break;
+		case 0x40: // RTI
+		case 0x60: // RTS
+			_CallStackUnwind( (BYTE) regs.sp );
+			break;
+		default:
+			break;
+	}
+}
+
+// @param sPathBaseName Written to sPathBaseName.txt (flat table) and sPathBaseName.folded (folded stacks)
+//===========================================================================
+bool CallProfile_Save ( const std::string & sPathBaseName )
+{
+	bool bStatus = true;
+
+	{
+		FILE *hFile = fopen( (sPathBaseName + ".folded").c_str(), "wt" );
+		if (hFile)
+		{
+			// Brendan Gregg's folded stack format: "root;caller;callee cycles"
+			std::vector<std::string> vPath( g_vCallNodes.size() );
+			for (size_t iNode = 0; iNode < g_vCallNodes.size(); iNode++)
+			{
+				const CallNode_t & node = g_vCallNodes[ iNode ];
+				vPath[ iNode ] = (iNode == CALL_NODE_ROOT)
+					? std::string( "[TOP]" )
+					: vPath[ node.iParent ] + ";" + _CallKeyName( node.nKey );
+
+				if (node.nCyclesSelf)
+					fprintf( hFile, "%s %" PRIu64 "\n", vPath[ iNode ].c_str(), node.nCyclesSelf );
+			}
+			fclose( hFile );
+		}
+		else
+			bStatus = false;
+	}
+
+	{
+		FILE *hFile = fopen( (sPathBaseName + ".txt").c_str(), "wt" );
+		if (hFile)
+		{
+			std::vector<CallRoutine_t> vRoutines;
+			uint64_t nCyclesTotal = 0;
+			_CallProfileRoutines( vRoutines, nCyclesTotal );
+
+			fprintf( hFile, "Total\t%%\tSelf\t%%\tCalls\tAddress\tSymbol\n" );
+			for (size_t iRoutine = 0; iRoutine < vRoutines.size(); iRoutine++)
+				fprintf( hFile, "%s\n", _CallRoutineLine( vRoutines[ iRoutine ], nCyclesTotal, "\t" ).c_str() );
+			fprintf( hFile, "%" PRIu64 "\t\t\t\t\t\tTotal cycles\n", nCyclesTotal );
+			fclose( hFile );
+		}
+		else
+			bStatus = false;
+	}
+
+	return bStatus;
+}
+
+// Syntax:
+//     CALLPROF                  Status
+//     CALLPROF ON | OFF         Start/stop (cycles are only counted while the debugger's CPU core is running)
+//     CALLPROF RESET            Discard collected data
+//     CALLPROF LIST             Top routines by inclusive cycles
+//     CALLPROF SAVE ["file"]    Save flat table & folded stacks (file.txt & file.folded, default: ProfileCalls)
+//===========================================================================
+Update_t CmdProfileCalls (int nArgs)
+{
+	if (!nArgs)
+	{
+		ConsolePrintFormat( " Call profiler: %s%s" CHC_DEFAULT ", nodes: " CHC_NUM_DEC "%d" CHC_DEFAULT ", depth: " CHC_NUM_DEC "%d"
+			, g_bCallProfiling ? CHC_INFO : CHC_WARNING
+			, g_bCallProfiling ? "ON" : "OFF"
+			, (int) g_vCallNodes.size()
+			, (int) g_vCallStack.size()
+		);
+		return ConsoleUpdate();
+	}
+
+	int iParam;
+	int nFound = FindParam( g_aArgs[ 1 ].sArg, MATCH_EXACT, iParam, _PARAM_GENERAL_BEGIN, _PARAM_GENERAL_END );
+	if (!nFound)
+		return Help_Arg_1( CMD_PROFILE_CALLS );
+
+	switch (iParam)
+	{
+		case PARAM_ON:
+			if (g_vCallStack.empty())
+				CallProfile_Reset();
+			g_bCallProfiling = true;
+			ConsoleBufferPush( " Call profiler on." );
+			break;
+		case PARAM_OFF:
+			g_bCallProfiling = false;
+			ConsoleBufferPush( " Call profiler off." );
+			break;
+		case PARAM_RESET:
+			CallProfile_Reset();
+			ConsoleBufferPush( " Resetting call profile data." );
+			break;
+		case PARAM_LIST:
+		{
+			std::vector<CallRoutine_t> vRoutines;
+			uint64_t nCyclesTotal = 0;
+			if (!g_vCallNodes.empty())
+				_CallProfileRoutines( vRoutines, nCyclesTotal );
+
+			ConsolePrintFormat( CHC_USAGE "     Total       %%       Self       %%    Calls Addr  Symbol" );
+			for (size_t iRoutine = 0; iRoutine < vRoutines.size() && iRoutine < CALL_LIST_LINES; iRoutine++)
+				ConsolePrint( _CallRoutineLine( vRoutines[ iRoutine ], nCyclesTotal, " " ).c_str() );
+			ConsolePrintFormat( " Total cycles: " CHC_NUM_DEC "%" PRIu64, nCyclesTotal );
+			break;
+		}
+		case PARAM_SAVE:
+		{
+			const std::string sPathBaseName = g_sCurrentDir + ((nArgs >= 2) ? std::string( g_aArgs[ 2 ].sArg ) : g_sFileNameCallProfile);
+
+			if (CallProfile_Save( sPathBaseName ))
+				ConsoleBufferPushFormat( " Saved: %s.txt, %s.folded", sPathBaseName.c_str(), sPathBaseName.c_str() );
+			else
+				ConsoleBufferPush( " ERROR: Couldn't save file. (In use?)" );
+			break;
+		}
+		default:
+			return Help_Arg_1( CMD_PROFILE_CALLS );
+	}
+
+	return ConsoleUpdate();
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+// Call-graph cycle profiler
+// Cycles are attributed to the current path on a shadow call stack (JSR/RTS, BRK/IRQ/NMI & RTI),
+// and can be exported as folded stacks (for flamegraph.pl) or as a flat per-routine table.
+
+	extern bool g_bCallProfiling;
+
+	void CallProfile_Reset ();
+	void CallProfile_Step ( const BYTE nOpcode, const bool bInterrupt, const uint32_t nCycles );
+	bool CallProfile_Save ( const std::string & sPathBaseName );
+	bool CallProfile_SaveDefault ();
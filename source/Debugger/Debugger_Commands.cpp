@@ -55,6 +55,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 		{"LBR"         , CmdLBR               , CMD_LBR                  , "Show Last Branch Record"    },
 	// CPU - Meta Info
 		{"PROFILE"     , CmdProfile           , CMD_PROFILE              , "List/Save 6502 profiling" },
+		{"CALLPROF"    , CmdProfileCalls      , CMD_PROFILE_CALLS        , "Call-graph cycle profiler" },
 		{"R"           , CmdRegisterSet       , CMD_REGISTER_SET         , "Set register" },
 	// CPU - Stack
 		{"POP"         , CmdStackPop          , CMD_STACK_POP            },
@@ -67,6 +68,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 		{"T"           , CmdTrace             , CMD_TRACE                , "Trace current instruction"  },
 		{"TF"          , CmdTraceFile         , CMD_TRACE_FILE           , "Save trace to filename [with video scanner info]" },
 		{"TL"          , CmdTraceLine         , CMD_TRACE_LINE           , "Trace (with cycle counting)" },
+		{"TB"          , CmdTraceBack         , CMD_TRACE_BACK           , "Trace back (undo) instruction(s) from history" },
+		{"GB"          , CmdGoBack            , CMD_GO_BACK              , "Go back in history until PC breakpoint" },
+		{"HIST"        , CmdHistory           , CMD_HISTORY              , "Execution history for TB/GB" },
 		{"U"           , CmdUnassemble        , CMD_UNASSEMBLE           , "Disassemble instructions"   },
 //		{"WAIT"        , CmdWait              , CMD_WAIT                 , "Run until
 	// Bookmarks
@@ -793,6 +793,18 @@ Update_t CmdHelpSpecific (int nArgs)
 			);
 			ConsoleBufferPush( " No arguments resets the profile." );
 			break;
+		case CMD_PROFILE_CALLS:
+			ConsoleColorizePrintFormat( " Usage: [%s | %s | %s | %s | %s [\"filename\"]]"
+				, g_aParameters[ PARAM_ON    ].m_sName
+				, g_aParameters[ PARAM_OFF   ].m_sName
+				, g_aParameters[ PARAM_RESET ].m_sName
+				, g_aParameters[ PARAM_LIST  ].m_sName
+				, g_aParameters[ PARAM_SAVE  ].m_sName
+			);
+			ConsoleBufferPush( "  Attribute cycles to the JSR/RTS & interrupt call stack while stepping." );
+			ConsoleBufferPush( "  SAVE writes a per-routine table (.txt) and folded stacks for flamegraph.pl (.folded)" );
+			ConsoleBufferPush( " No arguments displays the status." );
+			break;
 	// Registers
 		case CMD_REGISTER_SET:
 			ConsoleColorizePrint( " Usage: <reg> <value | expression | symbol>" );
@@ -839,6 +851,26 @@ Update_t CmdHelpSpecific (int nArgs)
 			ConsoleBufferPush( "  Traces into current instruction" );
 			ConsoleBufferPush( "  with cycle counting." );
 			break;
+		case CMD_TRACE_BACK:
+			ConsoleColorizePrint( " Usage: [#]" );
+			ConsoleBufferPush( "  Undoes the last # traced instruction(s) using the execution history" );
+			ConsoleBufferPush( "  Restores registers & RAM, but not I/O, soft switches or the cycle count" );
+			break;
+		case CMD_GO_BACK:
+			ConsoleBufferPush( "  Undoes traced instructions until PC matches a PC breakpoint" );
+			ConsoleBufferPush( "  or the start of the execution history is reached" );
+			break;
+		case CMD_HISTORY:
+			ConsoleColorizePrintFormat( " Usage: [%s [#] | %s | %s | %s [#]]"
+				, g_aParameters[ PARAM_ON    ].m_sName
+				, g_aParameters[ PARAM_OFF   ].m_sName
+				, g_aParameters[ PARAM_RESET ].m_sName
+				, g_aParameters[ PARAM_LIST  ].m_sName
+			);
+			ConsoleBufferPush( "  Records the last # (default 65536) instructions executed (on by default)" );
+			ConsoleBufferPush( "  LIST shows the newest # instructions (default 16)" );
+			ConsoleBufferPush( " No arguments displays the status." );
+			break;
 	// Bookmarks
 		case CMD_BOOKMARK:
 		case CMD_BOOKMARK_ADD:
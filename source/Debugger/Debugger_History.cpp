@@ -0,0 +1,270 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2025, Tom Charlesworth, Michael Pohoreski
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: Debugger Execution History (reverse-step)
+ *
+ * The CPU core records every opcode (or IRQ/NMI) that it executes, in all run modes:
+ * . the registers, memory mode & RamWorks aux bank before it, in a ring of instructions
+ * . the old value of each RAM byte that it writes (stack pushes included), in a ring of writes
+ * Stepping back restores the paging, then the instruction's writes (newest first), then the registers.
+ *
+ * Only CPU registers, memory paging & RAM are rewound. Other I/O side effects (video soft switches,
+ * the LC's write-enable pre-read, Saturn 16K bank, cards, disk) and the cycle counter are not,
+ * and card DMA writes aren't recorded.
+ * The history is discarded on reset, on loading a save-state, and while the Z80 is running.
+ */
+
+#include "StdAfx.h"
+
+#include "Debug.h"
+
+#include "../Core.h"
+#include "../CPU.h"
+#include "../Memory.h"
+
+#include <cinttypes>
+
+// Globals ________________________________________________________________________________________
+
+	bool g_bExecutionHistory = true;
+
+// Private ________________________________________________________________________________________
+
+	enum
+	{
+		HISTORY_SIZE_DEFAULT = 0x10000, // instructions, must be a power of 2
+		HISTORY_SIZE_MAX     = 0x400000,
+		HISTORY_WRITES       = 4,       // write ring size, per instruction (JSR writes 2, BRK/IRQ 3, most opcodes 0 or 1)
+		HISTORY_LIST_LINES   = 16       // number of instructions for HIST LIST
+	};
+
+	struct HistoryEntry_t
+	{
+		uint64_t nCycle;   // g_nCumulativeCycles before the instruction
+		uint64_t iWrite;   // first write made by the instruction
+		uint32_t nMemMode;
+		regsrec  regs;     // before the instruction
+		BYTE     nAuxBank;
+	};
+
+	struct HistoryWrite_t
+	{
+		WORD nAddress;
+		BYTE nOld;
+	};
+
+	static std::vector<HistoryEntry_t> g_vHistory( HISTORY_SIZE_DEFAULT );
+	static std::vector<HistoryWrite_t> g_vHistoryWrites( HISTORY_SIZE_DEFAULT * HISTORY_WRITES );
+	static uint32_t g_nHistoryMask      = HISTORY_SIZE_DEFAULT - 1;
+	static uint32_t g_nHistoryWriteMask = HISTORY_SIZE_DEFAULT * HISTORY_WRITES - 1;
+	static uint32_t g_iHistoryHead      = 0; // next entry to write
+	static uint32_t g_nHistoryCount     = 0;
+	static uint64_t g_iHistoryWrite     = 0; // next write (ring index = g_iHistoryWrite & g_nHistoryWriteMask)
+	static uint64_t g_iHistoryWriteMax  = 0; // highest g_iHistoryWrite since the last step back: older ring slots may be overwritten
+
+//===========================================================================
+static void _HistoryAlloc ( uint32_t nSize )
+{
+	uint32_t nPow2 = 1;
+	while (nPow2 < nSize && nPow2 < HISTORY_SIZE_MAX)
+		nPow2 <<= 1;
+
+	if (g_vHistory.size() != nPow2)
+	{
+		g_vHistory.clear();
+		g_vHistory.shrink_to_fit();
+		g_vHistory.resize( nPow2 );
+
+		g_vHistoryWrites.clear();
+		g_vHistoryWrites.shrink_to_fit();
+		g_vHistoryWrites.resize( nPow2 * HISTORY_WRITES );
+
+		g_nHistoryMask      = nPow2 - 1;
+		g_nHistoryWriteMask = nPow2 * HISTORY_WRITES - 1;
+	}
+
+	History_Reset();
+}
+
+// NB. The instruction's bytes as they are in memory now
+//===========================================================================
+static std::string _HistoryEntryLine ( const HistoryEntry_t & entry, const int iAge )
+{
+	BYTE aOpcode[ 3 ];
+	for (int iByte = 0; iByte < 3; iByte++)
+		aOpcode[ iByte ] = ReadByteFromMemory( entry.regs.pc + iByte );
+
+	const BYTE nOpcode = aOpcode[ 0 ];
+	const int  nBytes  = g_aOpmodes[ g_aOpcodes[ nOpcode ].nAddressMode ].m_nBytes;
+
+	std::string sBytes;
+	for (int iByte = 0; iByte < 3; iByte++)
+		sBytes += (iByte < nBytes) ? StrFormat( "%02X ", aOpcode[ iByte ] ) : std::string( "   " );
+
+	return StrFormat( " " CHC_NUM_DEC "%5d " CHC_DEFAULT "%12" PRIu64 " " CHC_ADDRESS "%04X" CHC_DEFAULT ":%s" CHC_COMMAND "%-4s"
+		CHC_REGS "A" CHC_DEFAULT "=" CHC_NUM_HEX "%02X "
+		CHC_REGS "X" CHC_DEFAULT "=" CHC_NUM_HEX "%02X "
+		CHC_REGS "Y" CHC_DEFAULT "=" CHC_NUM_HEX "%02X "
+		CHC_REGS "P" CHC_DEFAULT "=" CHC_NUM_HEX "%02X "
+		CHC_REGS "S" CHC_DEFAULT "=" CHC_NUM_HEX "%02X"
+		, -iAge, entry.nCycle, entry.regs.pc, sBytes.c_str(), g_aOpcodes[ nOpcode ].sMnemonic
+		, entry.regs.a, entry.regs.x, entry.regs.y, entry.regs.ps, (BYTE) entry.regs.sp
+	);
+}
+
+// Public _________________________________________________________________________________________
+
+//===========================================================================
+void History_Reset ()
+{
+	g_iHistoryHead     = 0;
+	g_nHistoryCount    = 0;
+	g_iHistoryWriteMax = g_iHistoryWrite;
+}
+
+// Called by the CPU core before each opcode or IRQ/NMI (6502/65C02 only)
+// @param nCycle Cycle count before it
+//===========================================================================
+void History_Record ( const uint64_t nCycle )
+{
+	HistoryEntry_t & entry = g_vHistory[ g_iHistoryHead ];
+	entry.nCycle   = nCycle;
+	entry.iWrite   = g_iHistoryWrite;
+	entry.nMemMode = GetMemMode();
+	entry.regs     = regs;
+	entry.nAuxBank = (BYTE) GetRamWorksActiveBank();
+
+	g_iHistoryHead = (g_iHistoryHead + 1) & g_nHistoryMask;
+	if (g_nHistoryCount <= g_nHistoryMask)
+		g_nHistoryCount++;
+}
+
+// Called by the CPU core before it writes to RAM
+//===========================================================================
+void History_RecordWrite ( const WORD nAddress, const BYTE nOld )
+{
+	HistoryWrite_t & write = g_vHistoryWrites[ g_iHistoryWrite & g_nHistoryWriteMask ];
+	write.nAddress = nAddress;
+	write.nOld     = nOld;
+	g_iHistoryWrite++;
+}
+
+// Undo the newest instruction
+// @return false if the history is empty
+//===========================================================================
+bool History_StepBack ()
+{
+	if (!g_nHistoryCount)
+		return false;
+
+	if (g_iHistoryWriteMax < g_iHistoryWrite)
+		g_iHistoryWriteMax = g_iHistoryWrite;
+
+	const uint32_t iEntry = (g_iHistoryHead - 1) & g_nHistoryMask;
+	const HistoryEntry_t & entry = g_vHistory[ iEntry ];
+
+	// Its writes have been overwritten by newer ones: nothing older can be undone
+	if (g_iHistoryWriteMax - entry.iWrite > g_vHistoryWrites.size())
+	{
+		History_Reset();
+		return false;
+	}
+
+	g_iHistoryHead = iEntry;
+	g_nHistoryCount--;
+
+	MemRestorePaging( entry.nMemMode, entry.nAuxBank );
+
+	while (g_iHistoryWrite != entry.iWrite)
+	{
+		g_iHistoryWrite--;
+		const HistoryWrite_t & write = g_vHistoryWrites[ g_iHistoryWrite & g_nHistoryWriteMask ];
+		WriteByteToMemory( write.nAddress, write.nOld );
+	}
+
+	regs = entry.regs;
+	return true;
+}
+
+// Syntax:
+//     HIST                     Status
+//     HIST ON [#]              Start recording (optionally set ring size in instructions). On by default
+//     HIST OFF                 Stop recording, and discard the recorded history
+//     HIST RESET               Discard the recorded history
+//     HIST LIST [#]            Show the newest # instructions
+//===========================================================================
+Update_t CmdHistory (int nArgs)
+{
+	if (!nArgs)
+	{
+		ConsolePrintFormat( " Execution history: %s%s" CHC_DEFAULT ", instructions: " CHC_NUM_DEC "%u" CHC_DEFAULT " / " CHC_NUM_DEC "%u"
+			, g_bExecutionHistory ? CHC_INFO : CHC_WARNING
+			, g_bExecutionHistory ? "ON" : "OFF"
+			, g_nHistoryCount
+			, (uint32_t) g_vHistory.size()
+		);
+		return ConsoleUpdate();
+	}
+
+	int iParam;
+	int nFound = FindParam( g_aArgs[ 1 ].sArg, MATCH_EXACT, iParam, _PARAM_GENERAL_BEGIN, _PARAM_GENERAL_END );
+	if (!nFound)
+		return Help_Arg_1( CMD_HISTORY );
+
+	switch (iParam)
+	{
+		case PARAM_ON:
+			if (nArgs >= 2)
+				_HistoryAlloc( g_aArgs[ 2 ].nValue ? g_aArgs[ 2 ].nValue : 1 );
+			else if (!g_bExecutionHistory)
+				History_Reset();
+			g_bExecutionHistory = true;
+			ConsoleBufferPushFormat( " Execution history on (%u instructions).", (uint32_t) g_vHistory.size() );
+			break;
+		case PARAM_OFF:
+			g_bExecutionHistory = false;
+			History_Reset();
+			ConsoleBufferPush( " Execution history off." );
+			break;
+		case PARAM_RESET:
+			History_Reset();
+			ConsoleBufferPush( " Resetting execution history." );
+			break;
+		case PARAM_LIST:
+		{
+			uint32_t nLines = (nArgs >= 2) ? g_aArgs[ 2 ].nValue : HISTORY_LIST_LINES;
+			if (nLines > g_nHistoryCount)
+				nLines = g_nHistoryCount;
+
+			ConsolePrintFormat( CHC_USAGE "   Age        Cycle Addr Instr      Registers before" );
+			const uint32_t nMask = (uint32_t) g_vHistory.size() - 1;
+			for (uint32_t iAge = nLines; iAge > 0; iAge--)
+				ConsolePrint( _HistoryEntryLine( g_vHistory[ (g_iHistoryHead - iAge) & nMask ], iAge ).c_str() );
+			break;
+		}
+		default:
+			return Help_Arg_1( CMD_HISTORY );
+	}
+
+	return ConsoleUpdate();
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+// Execution history
+// A ring of the last N instructions executed by the CPU core: registers & memory paging before the instruction,
+// plus a ring of the old values of the RAM bytes it wrote, so that the debugger can step backwards.
+
+	extern bool g_bExecutionHistory;
+
+	void History_Reset ();
+	void History_Record ( const uint64_t nCycle );
+	void History_RecordWrite ( const WORD nAddress, const BYTE nOld );
+	bool History_StepBack ();
@@ -33,6 +33,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "../Windows/AppleWin.h"
 #include "../Core.h"
 
+#include <unordered_map>
+
 	// 2.6.2.13 Added: Can now enable/disable selected symbol table(s) !
 	// Allow the user to disable/enable symbol tables
 	// xxx1xxx symbol table is active (are displayed in disassembly window, etc.)
@@ -73,6 +75,19 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	SymbolTable_t g_aSymbols[ NUM_SYMBOL_TABLES ];
 	int           g_nSymbolsLoaded = 0;  // on Last Load
 
+// Symbol Indexes _________________________________________________________________________________
+
+	// Kept in sync with g_aSymbols[] by SymbolTableAdd(), SymbolTableRemove() and _CmdSymbolsClear()
+	// so that lookups don't have to walk every table.
+
+	// Name (upper-case) -> Address, per table.
+	// The same name can legitimately be defined at multiple addresses in one table.
+	typedef std::unordered_multimap<std::string, WORD> SymbolNameIndex_t;
+	static SymbolNameIndex_t g_aSymbolNameIndex[ NUM_SYMBOL_TABLES ];
+
+	// Address -> bit-flags of the tables that have a symbol at that address. See: SymbolTable_Masks_e
+	static WORD g_aSymbolAddressTables[ _6502_MEM_LEN ];
+
 // Utils _ ________________________________________________________________________________________
 
 	std::string _CmdSymbolsInfoHeader( int iTable, int nDisplaySize = 0 );
@@ -82,6 +97,31 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 // Private ________________________________________________________________________________________
 
+//===========================================================================
+static std::string _SymbolIndexKey ( const char* pSymbol )
+{
+	// Same case folding as _stricmp()
+	std::string sKey( pSymbol );
+	for (size_t i = 0; i < sKey.size(); i++)
+		sKey[i] = (char) toupper( (unsigned char) sKey[i] );
+	return sKey;
+}
+
+//===========================================================================
+static void _SymbolNameIndexRemove ( int iTable, const std::string & sName, WORD nAddress )
+{
+	SymbolNameIndex_t & rIndex = g_aSymbolNameIndex[ iTable ];
+	std::pair<SymbolNameIndex_t::iterator, SymbolNameIndex_t::iterator> range = rIndex.equal_range( _SymbolIndexKey( sName.c_str() ) );
+	for (SymbolNameIndex_t::iterator it = range.first; it != range.second; ++it)
+	{
+		if (it->second == nAddress)
+		{
+			rIndex.erase( it );
+			break;
+		}
+	}
+}
+
 //===========================================================================
 void _PrintCurrentPath()
 {
@@ -146,60 +186,86 @@ std::string const* FindSymbolFromAddress (WORD nAddress, int * iTable_ )
 		*iTable_ = iTable;
 	}
 
-	while (iTable-- > 0)
-	{
-		if (! g_aSymbols[iTable].size())
-			continue;
+	const int bTables = g_aSymbolAddressTables[ nAddress ] & g_bDisplaySymbolTables;
+	if (! bTables)
+		return NULL;
 
-		if (! (g_bDisplaySymbolTables & (1 << iTable)))
-			continue;
+	while (! (bTables & (1 << --iTable)))
+		;
 
-		std::map<WORD, std::string>::iterator iSymbols = g_aSymbols[iTable].find(nAddress);
-		if (g_aSymbols[iTable].find(nAddress) != g_aSymbols[iTable].end())
-		{
-			if (iTable_)
-			{
-				*iTable_ = iTable;
-			}
-			return &iSymbols->second;
-		}
-	}	
-	return NULL;
+	SymbolTable_t::const_iterator iSymbol = g_aSymbols[iTable].find(nAddress);
+	if (iTable_)
+	{
+		*iTable_ = iTable;
+	}
+	return &iSymbol->second;
 }
 
 //===========================================================================
 bool FindAddressFromSymbol ( const char* pSymbol, WORD * pAddress_, int * iTable_ )
 {
+	const std::string sKey = _SymbolIndexKey( pSymbol );
+
 	// Bugfix/User feature: User symbols should be searched first
 	for (int iTable = NUM_SYMBOL_TABLES; iTable-- > 0; )
 	{
-		if (! g_aSymbols[iTable].size())
+		if (! (g_bDisplaySymbolTables & (1 << iTable)))
 			continue;
 
-		if (! (g_bDisplaySymbolTables & (1 << iTable)))
+		std::pair<SymbolNameIndex_t::const_iterator, SymbolNameIndex_t::const_iterator> range = g_aSymbolNameIndex[iTable].equal_range( sKey );
+		if (range.first == range.second)
 			continue;
 
-		SymbolTable_t :: iterator  iSymbol = g_aSymbols[iTable].begin();
-		while (iSymbol != g_aSymbols[iTable].end())
+		// Duplicate names: lowest address wins, as with a walk of the (address ordered) table
+		WORD nAddress = range.first->second;
+		for (SymbolNameIndex_t::const_iterator it = range.first; it != range.second; ++it)
+			nAddress = MIN( nAddress, it->second );
+
+		if (pAddress_)
 		{
-			if (!_stricmp( iSymbol->second.c_str(), pSymbol))
-			{
-				if (pAddress_)
-				{
-					*pAddress_ = iSymbol->first;
-				}
-				if (iTable_)
-				{
-					*iTable_ = iTable;
-				}
-				return true;
-			}
-			iSymbol++;
+			*pAddress_ = nAddress;
+		}
+		if (iTable_)
+		{
+			*iTable_ = iTable;
 		}
+		return true;
 	}
 	return false;
 }
 
+//===========================================================================
+void SymbolTableAdd ( SymbolTable_Index_e eSymbolTable, WORD nAddress, const std::string & sName )
+{
+	SymbolTable_t & rTable = g_aSymbols[ eSymbolTable ];
+	SymbolTable_t::iterator iSymbol = rTable.find( nAddress );
+	if (iSymbol != rTable.end())
+	{
+		_SymbolNameIndexRemove( eSymbolTable, iSymbol->second, nAddress );
+		iSymbol->second = sName;
+	}
+	else
+	{
+		rTable[ nAddress ] = sName;
+	}
+
+	g_aSymbolNameIndex[ eSymbolTable ].emplace( _SymbolIndexKey( sName.c_str() ), nAddress );
+	g_aSymbolAddressTables[ nAddress ] |= (1 << eSymbolTable);
+}
+
+//===========================================================================
+void SymbolTableRemove ( SymbolTable_Index_e eSymbolTable, WORD nAddress )
+{
+	SymbolTable_t & rTable = g_aSymbols[ eSymbolTable ];
+	SymbolTable_t::iterator iSymbol = rTable.find( nAddress );
+	if (iSymbol == rTable.end())
+		return;
+
+	_SymbolNameIndexRemove( eSymbolTable, iSymbol->second, nAddress );
+	rTable.erase( iSymbol );
+	g_aSymbolAddressTables[ nAddress ] &= ~(1 << eSymbolTable);
+}
+
 
 
 // Symbols ________________________________________________________________________________________
@@ -746,7 +812,7 @@ int ParseSymbolTable(const std::string & pPathFileName, SymbolTable_Index_e eSym
 	
 			// else // It is not a bug to have duplicate addresses by different names
 
-			g_aSymbols[ eSymbolTableWrite ] [ (WORD) nAddress ] = sName;
+			SymbolTableAdd( eSymbolTableWrite, (WORD) nAddress, sName );
 			nSymbolsLoaded++; // TODO: FIXME: BUG: This is the total symbols read, not added
 		}
 		fclose(hFile);
@@ -874,6 +940,11 @@ Update_t CmdSymbolsLoad (int nArgs)
 //===========================================================================
 Update_t _CmdSymbolsClear( SymbolTable_Index_e eSymbolTable )
 {
+	for (SymbolTable_t::const_iterator iSymbol = g_aSymbols[ eSymbolTable ].begin(); iSymbol != g_aSymbols[ eSymbolTable ].end(); ++iSymbol)
+	{
+		g_aSymbolAddressTables[ iSymbol->first ] &= ~(1 << eSymbolTable);
+	}
+	g_aSymbolNameIndex[ eSymbolTable ].clear();
 	g_aSymbols[ eSymbolTable ].clear();
 	
 	return UPDATE_SYMBOLS;
@@ -910,7 +981,7 @@ void SymbolUpdate ( SymbolTable_Index_e eSymbolTable, const char *pSymbolName, W
 					ConsoleBufferPush( " Removing symbol." );
 				}
 
-				g_aSymbols[ eSymbolTable ].erase( nAddressPrev );
+				SymbolTableRemove( eSymbolTable, nAddressPrev );
 
 				if (bUpdateSymbol)
 				{
@@ -941,7 +1012,7 @@ void SymbolUpdate ( SymbolTable_Index_e eSymbolTable, const char *pSymbolName, W
 				// TODO: Probably should check if same name?
 			}
 #endif
-			g_aSymbols[ eSymbolTable ][ nAddress ] = pSymbolName;
+			SymbolTableAdd( eSymbolTable, nAddress, pSymbolName );
 
 			// 2.9.1.26: When adding symbols list the address first then the name for readability
 			// Tell user symbol was added
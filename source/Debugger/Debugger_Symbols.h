@@ -19,6 +19,8 @@
 	// Symbol Table / Memory
 	bool FindAddressFromSymbol(const char* pSymbol, WORD* pAddress_ = NULL, int* iTable_ = NULL);
 	WORD GetAddressFromSymbol(const char* symbol); // HACK: returns 0 if symbol not found
+	void SymbolTableAdd ( SymbolTable_Index_e eSymbolTable, WORD nAddress, const std::string & sName );
+	void SymbolTableRemove ( SymbolTable_Index_e eSymbolTable, WORD nAddress );
 	void SymbolUpdate(SymbolTable_Index_e eSymbolTable, const char* pSymbolName, WORD nAddrss, bool bRemoveSymbol, bool bUpdateSymbol);
 	std::string const* FindSymbolFromAddress(WORD nAdress, int* iTable_ = NULL);
 	std::string const& GetSymbol(WORD nAddress, int nBytes, std::string& strAddressBuf);
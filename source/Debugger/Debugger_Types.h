@@ -342,6 +342,7 @@
 		, CMD_LBR
 // CPU - Meta Info
 		, CMD_PROFILE
+		, CMD_PROFILE_CALLS
 		, CMD_REGISTER_SET
 // CPU - Stack
 //		, CMD_STACK_LIST
@@ -355,6 +356,9 @@
 		, CMD_TRACE
 		, CMD_TRACE_FILE
 		, CMD_TRACE_LINE
+		, CMD_TRACE_BACK
+		, CMD_GO_BACK
+		, CMD_HISTORY
 		, CMD_UNASSEMBLE
 // Bookmarks
 		, CMD_BOOKMARK
@@ -675,6 +679,9 @@
 	Update_t CmdTrace              (int nArgs);  // alias for CmdStepIn
 	Update_t CmdTraceFile          (int nArgs);
 	Update_t CmdTraceLine          (int nArgs);
+	Update_t CmdTraceBack          (int nArgs);
+	Update_t CmdGoBack             (int nArgs);
+	Update_t CmdHistory            (int nArgs);
 	Update_t CmdUnassemble         (int nArgs); // code dump, aka, Unassemble
 // Bookmarks
 	Update_t CmdBookmark           (int nArgs);
@@ -708,6 +715,7 @@
 	Update_t CmdBenchmarkStart     (int nArgs); //Update_t CmdSetupBenchmark (int nArgs);
 	Update_t CmdBenchmarkStop      (int nArgs); //Update_t CmdExtBenchmark (int nArgs);
 	Update_t CmdProfile            (int nArgs);
+	Update_t CmdProfileCalls       (int nArgs);
 	Update_t CmdProfileStart       (int nArgs);
 	Update_t CmdProfileStop        (int nArgs);
 // Config
@@ -2115,6 +2115,7 @@ void Disk2InterfaceCard::InitializeIO(LPBYTE pCxRomPeripheral)
 	// . In this case we can patch to compensate for an ADC or EOR checksum but not both (nickw)
 
 	RegisterIoHandler(m_slot, &Disk2InterfaceCard::IORead, &Disk2InterfaceCard::IOWrite, NULL, NULL, this, NULL);
+	RegisterIoHandlerC0x(m_slot, 0xC, &Disk2InterfaceCard::IOReadLatch, NULL);	// the nibble read loop's LDA $C08C,X
 
 	InitFirmware(pCxRomPeripheral);
 }
@@ -2199,6 +2200,28 @@ BYTE __stdcall Disk2InterfaceCard::IORead(WORD pc, WORD addr, BYTE bWrite, BYTE
 	return MemReadFloatingBus(nExecutedCycles);
 }
 
+// Fast-path for reading $C08C,X (Q6L) when the sequencer is already in read mode, ie. the nibble read loop
+// . same as IORead() for this case, but without re-decoding the address
+BYTE __stdcall Disk2InterfaceCard::IOReadLatch(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG nExecutedCycles)
+{
+	UINT uSlot = ((addr & 0xff) >> 4) - 8;
+	Disk2InterfaceCard* pCard = (Disk2InterfaceCard*) MemGetSlotParameters(uSlot);
+
+	if (pCard->m_seqFunc.function != readSequencing)
+		return IORead(pc, addr, bWrite, d, nExecutedCycles);
+
+	CpuCalcCycles(nExecutedCycles);	// g_nCumulativeCycles needed by most Disk I/O functions
+
+	pCard->m_writeStarted = false;	// as SetSequencerFunction()
+
+	if (ImageIsWOZ(pCard->m_floppyDrive[pCard->m_currDrive].m_disk.m_imagehandle))
+		pCard->DataLatchReadWriteWOZ(pc, addr, bWrite, nExecutedCycles);
+	else
+		pCard->ReadWrite(pc, addr, bWrite, d, nExecutedCycles);
+
+	return pCard->m_floppyLatch;
+}
+
 BYTE __stdcall Disk2InterfaceCard::IOWrite(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG nExecutedCycles)
 {
 	CpuCalcCycles(nExecutedCycles);	// g_nCumulativeCycles needed by most Disk I/O functions
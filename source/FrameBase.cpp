@@ -46,8 +46,10 @@ void FrameBase::VideoRedrawScreenDuringFullSpeed(uint32_t dwCyclesThisFrame, boo
 		return;
 	}
 
+	// Only update after every realtime ~17ms of *continuous* full-speed
+	// . or ~17ms per rendered frame when frame-skipping, ie. the same 1 in (N+1) as NTSC_SetFrameSkip()
 	uint32_t dwFullSpeedDuration = GetTickCount() - dwFullSpeedStartTime;
-	if (dwFullSpeedDuration <= 16)	// Only update after every realtime ~17ms of *continuous* full-speed
+	if (dwFullSpeedDuration <= 16 * (1 + NTSC_GetFrameSkip()))
 		return;
 
 	dwFullSpeedStartTime += dwFullSpeedDuration;
@@ -98,8 +100,14 @@ void FrameBase::Video_TakeScreenShot(const Video::VideoScreenShot_e ScreenShotTy
 		g_nLastScreenShot++;
 	}
 
-	Video_SaveScreenShot(ScreenShotType, strScreenShotFileName.c_str());
+	// Written by VideoCapture's writer thread, so the emulation isn't held up by the disk
+	GetVideo().Video_QueueScreenShot(strScreenShotFileName.c_str(), ScreenShotType);
 	g_nLastScreenShot++;
+
+	if (g_bDisplayPrintScreenFileName)
+	{
+		FrameMessageBox(strScreenShotFileName.c_str(), "Screen Captured", MB_OK);
+	}
 }
 
 //===========================================================================
@@ -99,6 +99,7 @@ public:
 
 	virtual void Reset(const bool powerCycle);
 	virtual void Update(const ULONG nExecutedCycles) {}
+	virtual UINT GetUpdateInterval() { return kUpdateNever; }
 
 	virtual void InitializeIO(LPBYTE pCxRomPeripheral);
 	virtual void Destroy();
@@ -434,6 +434,12 @@ BYTE KeybClearStrobe()
 	return ClipboardReadOrPeek(true);
 }
 
+// Reads of $C000 return a pasted char (and advance the paste)
+bool KeybIsClipboardActive()
+{
+	return g_bPasteFromClipboard || g_bClipboardActive;
+}
+
 BYTE KeybReadFlag()
 {
 	_ASSERT(!IS_APPLE2);	// And also not Pravets machines?
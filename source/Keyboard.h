@@ -20,5 +20,6 @@ void    KeybAnyKeyDown(UINT message, WPARAM wparam, bool bIsExtended);
 BYTE    KeybClearStrobe();
 BYTE    KeybReadData();
 BYTE    KeybReadFlag();
+bool    KeybIsClipboardActive();
 void    KeybSaveSnapshot(class YamlSaveHelper& yamlSaveHelper);
 void    KeybLoadSnapshot(class YamlLoadHelper& yamlLoadHelper, UINT version);
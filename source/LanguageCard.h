@@ -17,6 +17,7 @@ public:
 	virtual void Destroy() {}
 	virtual void Reset(const bool powerCycle);
 	virtual void Update(const ULONG nExecutedCycles) {}
+	virtual UINT GetUpdateInterval() { return kUpdateNever; }
 
 	virtual void InitializeIO(LPBYTE pCxRomPeripheral);
 	virtual UINT GetActiveBank() { return 0; }	// Always 0 as only 1x 16K bank
@@ -72,6 +72,21 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #define ALIGNED_FREE(ptr) delete [] ptr
 #endif
 
+// RamWorks III banks: zeroed, and only backed by host pages as they are touched (so a bank that's only partly used,
+// or the all-zeros bank that's only ever read, doesn't become resident)
+#ifdef _WIN32
+#define ZEROED_ALLOC(size) ALIGNED_ALLOC(size)
+#define ZEROED_FREE(ptr, size) ALIGNED_FREE(ptr)
+#else
+static LPBYTE ZeroedAlloc(const size_t size)
+{
+	void* p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	return p == MAP_FAILED ? NULL : (LPBYTE)p;
+}
+#define ZEROED_ALLOC(size) ZeroedAlloc(size)
+#define ZEROED_FREE(ptr, size) munmap(ptr, size)
+#endif
+
 
 // UTAIIe:5-28 (GH#419)
 // . Sather uses INTCXROM instead of SLOTCXROM' (used by the Apple//e Tech Ref Manual), so keep to this
@@ -259,7 +274,9 @@ static CNoSlotClock* g_NoSlotClock = new CNoSlotClock;
 #ifdef RAMWORKS
 static UINT		g_uMaxExBanks = 1;				// user requested ram banks (default to 1 aux bank: so total = 128KB)
 static UINT		g_uActiveBank = 0;				// 0 = aux 64K for: //e extended 80 Col card, or //c -- also RamWorks III aux card
-static LPBYTE	RWpages[kMaxExMemoryBanks];		// pointers to RW memory banks
+static LPBYTE	RWpages[kMaxExMemoryBanks];		// pointers to RW memory banks (NULL = not yet written to)
+static LPBYTE	g_pRamWorksZeroBank = NULL;		// all zeros: paged in for RamWorks III banks that aren't allocated yet
+static bool		g_isRamWorksZeroBankPaged = false;	// memshadow[] or memwrite[] may point into g_pRamWorksZeroBank
 #endif
 
 static const UINT kNumAnnunciators = 4;
@@ -434,6 +451,18 @@ UINT GetRamWorksActiveBank()
 	return g_uActiveBank;
 }
 
+// # of 64KiB aux banks with memory allocated (RamWorks III banks are only allocated once written to)
+UINT GetRamWorksResidentBanks()
+{
+	UINT banks = 0;
+	for (UINT i = 0; i < g_uMaxExBanks; i++)
+	{
+		if (RWpages[i])
+			banks++;
+	}
+	return banks;
+}
+
 //
 
 static BOOL GetLastRamWrite()
@@ -608,6 +637,39 @@ static BYTE __stdcall IORead_C01x(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG
 	return KeybGetKeycode() | (res ? 0x80 : 0);
 }
 
+static BYTE __stdcall IORead_C06x(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG nExecutedCycles);
+
+// For idle-loop detection: # of cycles that reads of soft switch 'addr' return the same value without side-effects (0 = unknown)
+// . bBit7Only: only bit 7 needs to stay the same (eg. the other bits are the floating bus)
+UINT MemGetIdlePollCycles(const WORD addr, const ULONG uExecutedCycles, const bool bVideoUpdate, const bool bBit7Only)
+{
+	const UINT kForever = (UINT)-1;	// until the next keypress, which is only queued between CpuExecute() batches
+
+	switch (addr & 0xFFF0)
+	{
+	case 0xC000:
+		if (IORead[0x00] != IORead_C00x || KeybIsClipboardActive())
+			return 0;
+		return kForever;
+
+	case 0xC010:
+		if (IS_APPLE2 || IORead[0x01] != IORead_C01x)
+			return 0;
+		if ((addr & 0xf) == 0x0)	// $C010 clears the strobe
+			return 0;
+		if ((addr & 0xf) == 0x9)	// VBL: only predictable if the video-scanner is kept up to date
+			return (bVideoUpdate && !g_bFullSpeed) ? NTSC_GetCyclesUntilVblBarChange() : 0;
+		return kForever;
+
+	case 0xC060:
+		if (!bBit7Only || IORead[0x06] != IORead_C06x || (addr & 0x7) != 0x0)	// Only TAPEIN
+			return 0;
+		return TapeGetIdlePollCycles(uExecutedCycles);	// until the next edge on the tape
+	}
+
+	return 0;
+}
+
 static BYTE __stdcall IOWrite_C01x(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG nExecutedCycles)
 {
 	return KeybClearStrobe();
@@ -857,8 +919,10 @@ static UINT	g_uPeripheralRomSlot = 0;
 
 static struct SlotInfo
 {
-	iofunction IOReadCx;
-	iofunction IOWriteCx;
+	iofunction IOReadC0x[16];	// $C0n0..$C0nF: per-address handlers (see RegisterIoHandlerC0x())
+	iofunction IOWriteC0x[16];
+	iofunction IOReadCx[16];	// $Cn00..$CnFF: per 16-byte unit handlers (see RegisterIoHandlerCx())
+	iofunction IOWriteCx[16];
 	LPVOID parameters;
 	BYTE* expansionRom;
 } g_SlotInfo[NUM_SLOTS] = { 0 };
@@ -1140,13 +1204,31 @@ static void InitIoHandlers()
 
 	for (i=0; i<NUM_SLOTS; i++)
 	{
-		g_SlotInfo[i].IOReadCx = IO_Cxxx;
-		g_SlotInfo[i].IOWriteCx = IO_Cxxx;
+		for (UINT j=0; j<16; j++)
+		{
+			g_SlotInfo[i].IOReadC0x[j] = IO_Null;
+			g_SlotInfo[i].IOWriteC0x[j] = IO_Null;
+			g_SlotInfo[i].IOReadCx[j] = IO_Cxxx;
+			g_SlotInfo[i].IOWriteCx[j] = IO_Cxxx;
+		}
 		g_SlotInfo[i].parameters = NULL;
 		g_SlotInfo[i].expansionRom = NULL;
 	}
 }
 
+// For a slot with per-address handlers: dispatch directly on the address, rather than via the card's generic handler
+static BYTE __stdcall IORead_C0x(WORD programcounter, WORD address, BYTE write, BYTE value, ULONG nExecutedCycles)
+{
+	const UINT uSlot = ((address & 0xff) >> 4) - 8;
+	return g_SlotInfo[uSlot].IOReadC0x[address & 0xf](programcounter, address, write, value, nExecutedCycles);
+}
+
+static BYTE __stdcall IOWrite_C0x(WORD programcounter, WORD address, BYTE write, BYTE value, ULONG nExecutedCycles)
+{
+	const UINT uSlot = ((address & 0xff) >> 4) - 8;
+	return g_SlotInfo[uSlot].IOWriteC0x[address & 0xf](programcounter, address, write, value, nExecutedCycles);
+}
+
 // All slots [0..7] must register their handlers
 void RegisterIoHandler(UINT uSlot, iofunction IOReadC0, iofunction IOWriteC0, iofunction IOReadCx, iofunction IOWriteCx, LPVOID lpSlotParameter, BYTE* pExpansionRom)
 {
@@ -1163,6 +1245,12 @@ void RegisterIoHandler(UINT uSlot, iofunction IOReadC0, iofunction IOWriteC0, io
 	IORead[uSlot+8]		= IOReadC0;
 	IOWrite[uSlot+8]	= IOWriteC0;
 
+	for (UINT i=0; i<16; i++)
+	{
+		g_SlotInfo[uSlot].IOReadC0x[i] = IOReadC0;
+		g_SlotInfo[uSlot].IOWriteC0x[i] = IOWriteC0;
+	}
+
 	if (uSlot == SLOT0)		// Don't trash C0xx handlers
 		return;
 
@@ -1175,11 +1263,43 @@ void RegisterIoHandler(UINT uSlot, iofunction IOReadC0, iofunction IOWriteC0, io
 	{
 		IORead[uSlot*16+i]	= IOReadCx;
 		IOWrite[uSlot*16+i]	= IOWriteCx;
+
+		// Saved for when the card's ROM is switched back in (see IoHandlerCardsIn())
+		g_SlotInfo[uSlot].IOReadCx[i] = IOReadCx;
+		g_SlotInfo[uSlot].IOWriteCx[i] = IOWriteCx;
+	}
+}
+
+// Optional per-address handlers for a card's hottest registers at $C0n0+uReg (eg. the Disk II's data latch)
+// . call after RegisterIoHandler(); NULL keeps the card's generic IOReadC0/IOWriteC0 for that address
+void RegisterIoHandlerC0x(UINT uSlot, UINT uReg, iofunction IOReadC0x, iofunction IOWriteC0x)
+{
+	_ASSERT(uSlot < NUM_SLOTS && uReg < 16);
+
+	if (IOReadC0x)	g_SlotInfo[uSlot].IOReadC0x[uReg] = IOReadC0x;
+	if (IOWriteC0x)	g_SlotInfo[uSlot].IOWriteC0x[uReg] = IOWriteC0x;
+
+	if (IOReadC0x)	IORead[uSlot+8] = IORead_C0x;
+	if (IOWriteC0x)	IOWrite[uSlot+8] = IOWrite_C0x;
+}
+
+// Optional per 16-byte unit handlers for a card's hottest registers at $Cn00+uUnit*16 (eg. a Mockingboard's 6522s)
+// . call after RegisterIoHandler(); NULL keeps the card's generic IOReadCx/IOWriteCx for that unit
+void RegisterIoHandlerCx(UINT uSlot, UINT uUnit, iofunction IOReadCx, iofunction IOWriteCx)
+{
+	_ASSERT(uSlot > SLOT0 && uSlot < NUM_SLOTS && uUnit < 16);
+
+	if (IOReadCx)
+	{
+		g_SlotInfo[uSlot].IOReadCx[uUnit] = IOReadCx;
+		IORead[uSlot*16+uUnit] = IOReadCx;
 	}
 
-	// Setup the r/w function pointers for I/O in the range: $C800..CFFF
-	g_SlotInfo[uSlot].IOReadCx = IOReadCx;
-	g_SlotInfo[uSlot].IOWriteCx = IOWriteCx;
+	if (IOWriteCx)
+	{
+		g_SlotInfo[uSlot].IOWriteCx[uUnit] = IOWriteCx;
+		IOWrite[uSlot*16+uUnit] = IOWriteCx;
+	}
 }
 
 void UnregisterIoHandler(UINT uSlot)
@@ -1232,13 +1352,10 @@ static void IoHandlerCardsIn()
 		}
 		else
 		{
-			iofunction ioreadcx = g_SlotInfo[uSlot].IOReadCx;
-			iofunction iowritecx = g_SlotInfo[uSlot].IOWriteCx;
-
 			for (UINT i = 0; i < 16; i++)
 			{
-				IORead[uSlot * 16 + i] = ioreadcx;
-				IOWrite[uSlot * 16 + i] = iowritecx;
+				IORead[uSlot * 16 + i] = g_SlotInfo[uSlot].IOReadCx[i];
+				IOWrite[uSlot * 16 + i] = g_SlotInfo[uSlot].IOWriteCx[i];
 			}
 		}
 	}
@@ -1303,6 +1420,101 @@ void SetMemMode(uint32_t uNewMemMode)
 static void ResetPaging(const UPDATEPAGING updateType);
 static void UpdatePaging(const UPDATEPAGING updateType);
 
+//===========================================================================
+
+#ifdef RAMWORKS
+// RamWorks III banks are allocated lazily (eg. for a 16MB card where software only uses a few banks):
+// . a bank that hasn't been written to has RWpages[bank]==NULL, and is paged in from g_pRamWorksZeroBank
+// . so g_pRamWorksZeroBank must stay all zeros: the active bank is allocated before a write would reach it,
+//   ie. a direct write (memwrite[] points into it), or a dirty page of 'mem' (with non-zero data) being copied back
+
+static bool IsRamWorksZeroBank(const LPBYTE pMem)
+{
+	return g_pRamWorksZeroBank && pMem >= g_pRamWorksZeroBank && pMem < g_pRamWorksZeroBank + _6502_MEM_LEN;
+}
+
+static void CreateRamWorksZeroBank()
+{
+	if (g_pRamWorksZeroBank)
+		return;
+
+	g_pRamWorksZeroBank = ZEROED_ALLOC(_6502_MEM_LEN);
+}
+
+static LPBYTE AllocRamWorksBank(const UINT bank)
+{
+	_ASSERT(bank > 0 && bank < g_uMaxExBanks && !RWpages[bank]);
+
+	LPBYTE pBank = ZEROED_ALLOC(_6502_MEM_LEN);
+	if (!pBank)
+	{
+		GetFrame().FrameMessageBox(
+			"The emulator was unable to allocate the memory it "
+			"requires.  Further execution is not possible.",
+			g_pAppTitle.c_str(),
+			MB_ICONSTOP | MB_SETFOREGROUND);
+		ExitProcess(1);
+	}
+
+	RWpages[bank] = pBank;
+
+	if (bank == g_uActiveBank)
+	{
+		// Re-point the paging tables from the zero bank to the new bank
+		for (UINT page = 0; page < _6502_NUM_PAGES; page++)
+		{
+			if (IsRamWorksZeroBank(memshadow[page]))
+				memshadow[page] = pBank + (memshadow[page] - g_pRamWorksZeroBank);
+			if (IsRamWorksZeroBank(memwrite[page]))
+				memwrite[page] = pBank + (memwrite[page] - g_pRamWorksZeroBank);
+		}
+
+		memaux = pBank;
+		g_isRamWorksZeroBankPaged = false;
+	}
+
+	return pBank;
+}
+
+// Call before any dirty pages of 'mem' are copied back to their shadows
+static void CommitRamWorksCachedWrites()
+{
+	if (!g_isMemCacheValid || !g_isRamWorksZeroBankPaged || memaux != g_pRamWorksZeroBank)
+		return;
+
+	for (UINT page = 0; page < _6502_NUM_PAGES; page++)
+	{
+		if (IsRamWorksZeroBank(memshadow[page]) &&
+			((*(memdirty+page) & 1) || (page <= _6502_STACK_PAGE)) &&
+			memcmp(mem+(page << 8), memshadow[page], _6502_PAGE_SIZE) != 0)
+		{
+			AllocRamWorksBank(g_uActiveBank);
+			return;
+		}
+	}
+}
+
+// Call after the paging tables are updated
+static void CommitRamWorksDirectWrites()
+{
+	// Only these switches page in aux memory (so bank switching with them all off doesn't need to scan the tables)
+	g_isRamWorksZeroBankPaged = g_pRamWorksZeroBank && memaux == g_pRamWorksZeroBank &&
+		(SW_AUXREAD || SW_AUXWRITE || SW_ALTZP || (SW_80STORE && SW_PAGE2));
+
+	if (!g_isRamWorksZeroBankPaged)
+		return;
+
+	for (UINT page = 0; page < _6502_NUM_PAGES; page++)
+	{
+		if (IsRamWorksZeroBank(memwrite[page]))
+		{
+			AllocRamWorksBank(g_uActiveBank);
+			return;
+		}
+	}
+}
+#endif
+
 // Call by:
 // . CtrlReset() Soft-reset (Ctrl+Reset) for //e
 void MemResetPaging()
@@ -1342,6 +1554,11 @@ static void UpdatePaging(const UPDATEPAGING updateType)
 
 	modechanging = false;
 
+#ifdef RAMWORKS
+	if (updateType == PagingUpdateOnly)
+		CommitRamWorksCachedWrites();
+#endif
+
 	// SAVE THE CURRENT PAGING SHADOW TABLE
 	LPBYTE oldshadow[256];
 	if (updateType == PagingUpdateOnly)
@@ -1479,6 +1696,10 @@ static void UpdatePaging(const UPDATEPAGING updateType)
 	{
 		UpdatePagingForAltRW();
 	}
+
+#ifdef RAMWORKS
+	CommitRamWorksDirectWrites();
+#endif
 }
 
 // For Cpu6502_altRW() & Cpu65C02_altRW()
@@ -1594,7 +1815,7 @@ static void UpdatePagingForAltRW()
 
 void MemDestroy()
 {
-	ALIGNED_FREE(memaux);
+	ALIGNED_FREE(RWpages[0]);	// NB. not memaux, which may point to the active RamWorks III bank (or the zero bank)
 	ALIGNED_FREE(memmain);
 	FreeMemImage();
 
@@ -1609,11 +1830,18 @@ void MemDestroy()
 	{
 		if (RWpages[i])
 		{
-			ALIGNED_FREE(RWpages[i]);
+			ZEROED_FREE(RWpages[i], _6502_MEM_LEN);
 			RWpages[i] = NULL;
 		}
 	}
 	RWpages[0]=NULL;
+
+	if (g_pRamWorksZeroBank)
+	{
+		ZEROED_FREE(g_pRamWorksZeroBank, _6502_MEM_LEN);
+		g_pRamWorksZeroBank = NULL;
+		g_isRamWorksZeroBankPaged = false;
+	}
 #endif
 
 	memaux   = NULL;
@@ -1763,6 +1991,10 @@ static void BackMainImage()
 	if (!g_isMemCacheValid)
 		return;
 
+#ifdef RAMWORKS
+	CommitRamWorksCachedWrites();
+#endif
+
 	for (UINT loop = 0; loop < 256; loop++)
 	{
 		if (memshadow[loop] && ((*(memdirty + loop) & 1) || (loop <= 1)))
@@ -1792,6 +2024,9 @@ LPBYTE MemGetBankPtr(const UINT nBank, const bool isSaveSnapshotOrDebugging/*=tr
 	if (nBank == 0)
 		return memmain;
 
+	if (!RWpages[nBank-1] && g_pRamWorksZeroBank)
+		return AllocRamWorksBank(nBank-1);	// Caller may write to it (eg. debugger)
+
 	return RWpages[nBank-1];
 #else
 	return	(nBank == 0) ? memmain :
@@ -2017,12 +2252,10 @@ void MemInitialize()
 #ifdef RAMWORKS
 	if (GetCardMgr().QueryAux() == CT_RamWorksIII)
 	{
-		// allocate memory for RamWorks III - up to 16MB
-		UINT i = 1;
-		while ((i < g_uMaxExBanks) && (RWpages[i] = ALIGNED_ALLOC(_6502_MEM_LEN)))
-			i++;
-		while (i < kMaxExMemoryBanks)
-			RWpages[i++] = NULL;
+		// memory for RamWorks III - up to 16MB - is allocated as each bank is written to
+		for (UINT i = 1; i < kMaxExMemoryBanks; i++)
+			RWpages[i] = NULL;
+		CreateRamWorksZeroBank();
 	}
 #endif
 
@@ -2298,6 +2531,9 @@ void MemReset()
 	memset(memwrite , 0, 256*sizeof(LPBYTE));
 
 	// INITIALIZE THE RAM IMAGES
+#ifdef RAMWORKS
+	memaux = RWpages[0];	// Power-cycle sets RamWorks III to 64KiB bank-0 (see below)
+#endif
 	memset(memaux , 0, 0x10000);
 	memset(memmain, 0, 0x10000);
 
@@ -2455,18 +2691,9 @@ void MemReset()
 
 //===========================================================================
 
-static BYTE ReadFloatingBus(const ULONG uExecutedCycles, const bool fullSpeed, const bool auxEmpty = false)
+static BYTE ReadFloatingBus(const ULONG uExecutedCycles, const bool fullSpeed)
 {
 	BYTE* pMain = MemGetMainPtr(0x0000);
-
-	if (auxEmpty && (SW_AUXREAD || (SW_80STORE && SW_PAGE2)))
-	{
-		// Special case: Aux slot empty and in 80-col mode: video generator reading floating bus. (GH#1341)
-		// Can't rely on using "mem" (ie. the CPU read cache), since "80STORE && PAGE2" will have switched in the non-existent memory from "memaux"!
-		// NB. Only care about $400-7FF (ie. TEXT page 1)
-		pMain = memmain;
-	}
-
 	return pMain[NTSC_VideoGetScannerAddress(uExecutedCycles, fullSpeed)];		// OK: This does the 2-cycle adjust for ANSI STORY (End Credits)
 }
 
@@ -2481,11 +2708,20 @@ BYTE MemReadFloatingBus(const BYTE highbit, const ULONG uExecutedCycles)
 	return (r & ~0x80) | (highbit ? 0x80 : 0);
 }
 
-BYTE MemReadFloatingBusFromNTSC()
+// Pre: addr is the video scanner's address, as NTSC can be rendering behind the CPU (see NTSC_SetVideoThread())
+BYTE MemReadFloatingBusFromNTSC(const WORD addr)
 {
-	// fullspeed=false: to avoid NTSC_VideoGetScannerAddress() calling NTSC_VideoClockResync()
-	// NB. g_bFullSpeed only true when doing NTSC_VideoRedrawWholeScreen()
-	return ReadFloatingBus(0, false, true);
+	BYTE* pMain = MemGetMainPtr(0x0000);
+
+	if (SW_AUXREAD || (SW_80STORE && SW_PAGE2))
+	{
+		// Special case: Aux slot empty and in 80-col mode: video generator reading floating bus. (GH#1341)
+		// Can't rely on using "mem" (ie. the CPU read cache), since "80STORE && PAGE2" will have switched in the non-existent memory from "memaux"!
+		// NB. Only care about $400-7FF (ie. TEXT page 1)
+		pMain = memmain;
+	}
+
+	return pMain[addr];
 }
 
 //===========================================================================
@@ -2520,6 +2756,40 @@ static void DebugFlip(WORD address, ULONG nExecutedCycles)
 }
 #endif
 
+// Page the internal or the peripheral $C800 ROM in, if INTCXROM or SLOTC3ROM has changed
+static void UpdateCxRom(const uint32_t lastmemmode)
+{
+	// NB. Must check MF_SLOTC3ROM too, as IoHandlerCardsIn() depends on both MF_INTCXROM|MF_SLOTC3ROM
+	if ((lastmemmode & (MF_INTCXROM|MF_SLOTC3ROM)) == (g_memmode & (MF_INTCXROM|MF_SLOTC3ROM)))
+		return;
+
+	if (!SW_INTCXROM)
+	{
+		if (!INTC8ROM)	// GH#423
+		{
+			// Disable Internal ROM
+			// . Similar to $CFFF access
+			// . None of the peripheral cards can be driving the bus - so use the null ROM
+			memset(pCxRomPeripheral+0x800, 0, FIRMWARE_EXPANSION_SIZE);
+			if (GetIsMemCacheValid())
+				memset(mem+FIRMWARE_EXPANSION_BEGIN, 0, FIRMWARE_EXPANSION_SIZE);
+			g_eExpansionRomType = eExpRomNull;
+			g_uPeripheralRomSlot = 0;
+		}
+		IoHandlerCardsIn();
+	}
+	else
+	{
+		// Enable Internal ROM
+		memcpy(pCxRomPeripheral+0x800, pCxRomInternal+0x800, FIRMWARE_EXPANSION_SIZE);
+		if (GetIsMemCacheValid())
+			memcpy(mem+FIRMWARE_EXPANSION_BEGIN, pCxRomInternal+0x800, FIRMWARE_EXPANSION_SIZE);
+		g_eExpansionRomType = eExpRomInternal;
+		g_uPeripheralRomSlot = 0;
+		IoHandlerCardsOut();
+	}
+}
+
 BYTE __stdcall MemSetPaging(WORD programcounter, WORD address, BYTE write, BYTE value, ULONG nExecutedCycles)
 {
 	address &= 0xFF;
@@ -2552,10 +2822,11 @@ BYTE __stdcall MemSetPaging(WORD programcounter, WORD address, BYTE write, BYTE
 #ifdef RAMWORKS
 			case 0x71: // extended memory aux page number
 			case 0x73: // Ramworks III set aux page number
-				if ((value < g_uMaxExBanks) && RWpages[value])
+				if ((value < g_uMaxExBanks) && (RWpages[value] || g_pRamWorksZeroBank))
 				{
+					CommitRamWorksCachedWrites();	// Before memaux changes: the current bank may need allocating
 					g_uActiveBank = value;
-					memaux = RWpages[g_uActiveBank];
+					memaux = RWpages[g_uActiveBank] ? RWpages[g_uActiveBank] : g_pRamWorksZeroBank;
 					UpdatePaging(PagingUpdateOnly);
 				}
 				break;
@@ -2596,36 +2867,7 @@ BYTE __stdcall MemSetPaging(WORD programcounter, WORD address, BYTE write, BYTE
 	// WRITE TABLES.
 	if ((lastmemmode != g_memmode) || modechanging)
 	{
-		// NB. Must check MF_SLOTC3ROM too, as IoHandlerCardsIn() depends on both MF_INTCXROM|MF_SLOTC3ROM
-		if ((lastmemmode & (MF_INTCXROM|MF_SLOTC3ROM)) != (g_memmode & (MF_INTCXROM|MF_SLOTC3ROM)))
-		{
-			if (!SW_INTCXROM)
-			{
-				if (!INTC8ROM)	// GH#423
-				{
-					// Disable Internal ROM
-					// . Similar to $CFFF access
-					// . None of the peripheral cards can be driving the bus - so use the null ROM
-					memset(pCxRomPeripheral+0x800, 0, FIRMWARE_EXPANSION_SIZE);
-					if (GetIsMemCacheValid())
-						memset(mem+FIRMWARE_EXPANSION_BEGIN, 0, FIRMWARE_EXPANSION_SIZE);
-					g_eExpansionRomType = eExpRomNull;
-					g_uPeripheralRomSlot = 0;
-				}
-				IoHandlerCardsIn();
-			}
-			else
-			{
-				// Enable Internal ROM
-				memcpy(pCxRomPeripheral+0x800, pCxRomInternal+0x800, FIRMWARE_EXPANSION_SIZE);
-				if (GetIsMemCacheValid())
-					memcpy(mem+FIRMWARE_EXPANSION_BEGIN, pCxRomInternal+0x800, FIRMWARE_EXPANSION_SIZE);
-				g_eExpansionRomType = eExpRomInternal;
-				g_uPeripheralRomSlot = 0;
-				IoHandlerCardsOut();
-			}
-		}
-
+		UpdateCxRom(lastmemmode);
 		UpdatePaging(PagingUpdateOnly);
 	}
 
@@ -2638,6 +2880,39 @@ BYTE __stdcall MemSetPaging(WORD programcounter, WORD address, BYTE write, BYTE
 
 //===========================================================================
 
+// Restore the soft-switch paging & the RamWorks aux bank (debugger's reverse-step)
+// . the language card's mode is set from the LC bits of 'memmode', for the active LC card
+void MemRestorePaging(const uint32_t memmode, const UINT activeAuxBank)
+{
+	const uint32_t lastmemmode = g_memmode;
+	bool bankChanged = false;
+
+#ifdef RAMWORKS
+	if (activeAuxBank != g_uActiveBank && (activeAuxBank < g_uMaxExBanks) && (RWpages[activeAuxBank] || g_pRamWorksZeroBank))
+	{
+		CommitRamWorksCachedWrites();	// Before memaux changes: the current bank may need allocating
+		g_uActiveBank = activeAuxBank;
+		memaux = RWpages[g_uActiveBank] ? RWpages[g_uActiveBank] : g_pRamWorksZeroBank;
+		bankChanged = true;
+	}
+#endif
+
+	if (memmode == lastmemmode && !bankChanged)
+		return;
+
+	SetMemMode(memmode);
+	if (GetCardMgr().GetLanguageCardMgr().GetLanguageCard())
+		GetCardMgr().GetLanguageCardMgr().GetLanguageCard()->SetLCMemMode(memmode & MF_LANGCARD_MASK);
+
+	if (IsAppleIIeOrAbove(GetApple2Type()) && GetCardMgr().GetVidHDCard() && GetCardMgr().QueryAux() == CT_80Col)
+		memVidHD = MemIsWriteAux(g_memmode) ? memaux : NULL;
+
+	UpdateCxRom(lastmemmode);
+	UpdatePaging(PagingUpdateOnly);
+}
+
+//===========================================================================
+
 // NB. Not particularly accurate (but good enough for now)
 // . 80STORE && PAGE2 just means that writes occur to aux $400-7FF (and $2000-$3FFF if HIRES=1), not the entire aux 64K
 
@@ -2760,7 +3035,8 @@ static const UINT kUNIT_AUXSLOT_VER = 2;
 // 2: Added: RGB card state
 // 3: Extended: RGB card state ('80COL changed')
 // 4: Support aux empty or aux 1KiB card
-static const UINT kUNIT_CARD_VER = 4;
+// 5: RamWorks III: banks that were never written to (all zeros) aren't saved
+static const UINT kUNIT_CARD_VER = 5;
 
 #define SS_YAML_KEY_NUMAUXBANKS "Num Aux Banks"
 #define SS_YAML_KEY_ACTIVEAUXBANK "Active Aux Bank"
@@ -3008,8 +3284,12 @@ void MemSaveSnapshotAux(YamlSaveHelper& yamlSaveHelper)
 			yamlSaveHelper.Save("%s: 0x%03X  # [0,1..100] 0=no aux mem, 1=128K system, etc\n", SS_YAML_KEY_NUMAUXBANKS, g_uMaxExBanks);
 			yamlSaveHelper.Save("%s: 0x%02X # [  0..FF] 0=memaux\n", SS_YAML_KEY_ACTIVEAUXBANK, g_uActiveBank);
 
+			BackMainImage();	// Can allocate the active bank, so do before checking RWpages[]
+
 			for(UINT bank = 1; bank <= g_uMaxExBanks; bank++)
 			{
+				if (!RWpages[bank-1])
+					continue;	// Never written to
 				MemSaveSnapshotMemory(yamlSaveHelper, false, bank);
 			}
 
@@ -3018,7 +3298,7 @@ void MemSaveSnapshotAux(YamlSaveHelper& yamlSaveHelper)
 	}
 }
 
-static SS_CARDTYPE MemLoadSnapshotAuxCommon(YamlLoadHelper& yamlLoadHelper, const std::string& card)
+static SS_CARDTYPE MemLoadSnapshotAuxCommon(YamlLoadHelper& yamlLoadHelper, const std::string& card, const UINT cardVersion)
 {
 	g_uMaxExBanks = 1;	// Must be at least 1 (for aux mem) - regardless of Apple2 type!
 	g_uActiveBank = 0;
@@ -3078,29 +3358,50 @@ static SS_CARDTYPE MemLoadSnapshotAuxCommon(YamlLoadHelper& yamlLoadHelper, cons
 		g_uMaxExBanks = numAuxBanks;
 		g_uActiveBank = activeAuxBank;
 
+		if (cardType == CT_RamWorksIII)
+			CreateRamWorksZeroBank();
+
 		//
 
 		for (UINT bank = 1; bank <= g_uMaxExBanks; bank++)
 		{
-			LPBYTE pBank = MemGetBankPtr(bank, false);
-			if (!pBank)
-				pBank = RWpages[bank - 1] = ALIGNED_ALLOC(_6502_MEM_LEN);
-
 			// "Auxiliary Memory Bankxx"
 			std::string auxMemName = MemGetSnapshotAuxMemStructName() + ByteToHexStr(bank - 1);
 
 			if (!yamlLoadHelper.GetSubMap(auxMemName))
-				throw std::runtime_error("Memory: Missing map name: " + auxMemName);
+			{
+				if (cardType != CT_RamWorksIII || cardVersion < 5 || bank == 1 || !g_pRamWorksZeroBank)
+					throw std::runtime_error("Memory: Missing map name: " + auxMemName);
+
+				// Bank was never written to
+				if (RWpages[bank - 1])
+				{
+					ZEROED_FREE(RWpages[bank - 1], _6502_MEM_LEN);
+					RWpages[bank - 1] = NULL;
+				}
+				continue;
+			}
+
+			LPBYTE pBank = RWpages[bank - 1];
+			if (!pBank)
+				pBank = RWpages[bank - 1] = ZEROED_ALLOC(_6502_MEM_LEN);
 
 			yamlLoadHelper.LoadMemory(pBank, _6502_MEM_LEN);
 
 			yamlLoadHelper.PopMap();
+
+			// A bank of all zeros (eg. from an older snapshot, which saved every bank) doesn't need allocating
+			if (bank > 1 && g_pRamWorksZeroBank && memcmp(pBank, g_pRamWorksZeroBank, _6502_MEM_LEN) == 0)
+			{
+				ZEROED_FREE(RWpages[bank - 1], _6502_MEM_LEN);
+				RWpages[bank - 1] = NULL;
+			}
 		}
 	}
 
 	GetCardMgr().InsertAux(cardType);
 
-	memaux = RWpages[g_uActiveBank];
+	memaux = RWpages[g_uActiveBank] ? RWpages[g_uActiveBank] : g_pRamWorksZeroBank;
 	// NB. MemUpdatePaging(PagingFullInitialize) called at end of Snapshot_LoadState_v2()
 
 	return cardType;
@@ -3109,7 +3410,7 @@ static SS_CARDTYPE MemLoadSnapshotAuxCommon(YamlLoadHelper& yamlLoadHelper, cons
 static void MemLoadSnapshotAuxVer1(YamlLoadHelper& yamlLoadHelper)
 {
 	std::string card = yamlLoadHelper.LoadString(SS_YAML_KEY_CARD);
-	MemLoadSnapshotAuxCommon(yamlLoadHelper, card);
+	MemLoadSnapshotAuxCommon(yamlLoadHelper, card, 1);
 }
 
 static void MemLoadSnapshotAuxVer2(YamlLoadHelper& yamlLoadHelper)
@@ -3123,7 +3424,7 @@ static void MemLoadSnapshotAuxVer2(YamlLoadHelper& yamlLoadHelper)
 			throw std::runtime_error(SS_YAML_KEY_UNIT ": Expected sub-map name: " SS_YAML_KEY_STATE);
 	}
 
-	SS_CARDTYPE cardType = MemLoadSnapshotAuxCommon(yamlLoadHelper, card);
+	SS_CARDTYPE cardType = MemLoadSnapshotAuxCommon(yamlLoadHelper, card, cardVersion);
 
 	if (card == MemGetSnapshotCardNameExtended80Col() || card == MemGetSnapshotCardNameRamWorksIII())
 		RGB_LoadSnapshot(yamlLoadHelper, cardVersion);
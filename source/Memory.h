@@ -56,6 +56,8 @@ const UINT kDefaultExMemoryBanksRealRW3 = 16;	// Real RamWorks III would default
 #endif
 
 void	RegisterIoHandler(UINT uSlot, iofunction IOReadC0, iofunction IOWriteC0, iofunction IOReadCx, iofunction IOWriteCx, LPVOID lpSlotParameter, BYTE* pExpansionRom);
+void	RegisterIoHandlerC0x(UINT uSlot, UINT uReg, iofunction IOReadC0x, iofunction IOWriteC0x);
+void	RegisterIoHandlerCx(UINT uSlot, UINT uUnit, iofunction IOReadCx, iofunction IOWriteCx);
 void	UnregisterIoHandler(UINT uSlot);
 
 void    MemDestroy ();
@@ -69,6 +71,7 @@ LPBYTE  MemGetBankPtr(const UINT nBank, const bool isSaveSnapshotOrDebugging = t
 LPBYTE  MemGetCxRomPeripheral();
 uint32_t   GetMemMode();
 void    SetMemMode(uint32_t memmode);
+void    MemRestorePaging(const uint32_t memmode, const UINT activeAuxBank);
 bool    MemIsWriteAux(uint32_t memMode);
 bool    IsIIeWithoutAuxMem();
 bool	MemOptimizeForModeChanging(WORD programcounter, WORD address);
@@ -81,7 +84,7 @@ void    MemInitializeIO();
 void    MemInitializeFromSnapshot();
 BYTE    MemReadFloatingBus(const ULONG uExecutedCycles);
 BYTE    MemReadFloatingBus(const BYTE highbit, const ULONG uExecutedCycles);
-BYTE    MemReadFloatingBusFromNTSC();
+BYTE    MemReadFloatingBusFromNTSC(const WORD addr);
 void    MemReset ();
 void    MemResetPaging ();
 enum UPDATEPAGING { PagingUpdateOnly = 0, PagingFullInitialize };
@@ -115,6 +118,7 @@ SS_CARDTYPE GetCurrentExpansionMemType();
 UINT	GetRamWorksMemorySize();
 void	SetRamWorksMemorySize(UINT banks, bool updateRegistry=true);
 UINT	GetRamWorksActiveBank();
+UINT	GetRamWorksResidentBanks();
 void	SetMemMainLanguageCard(LPBYTE ptr, UINT slot, bool bMemMain=false);
 void	SetRegistryAuxNumberOfBanks();
 
@@ -126,4 +130,5 @@ void WriteByteToMemory(uint16_t addr, uint8_t data);
 void CopyBytesFromMemoryPage(uint8_t* pDst, uint16_t srcAddr, size_t size);
 bool IsZeroPageFloatingBus();
 void ForceAltCpuEmulation();
+UINT MemGetIdlePollCycles(const WORD addr, const ULONG uExecutedCycles, const bool bVideoUpdate, const bool bBit7Only);
 uint8_t ReadByteFromROM(uint16_t addr);
@@ -715,26 +715,19 @@ BYTE __stdcall MockingboardCard::IOWrite(WORD PC, WORD nAddr, BYTE bWrite, BYTE
 	return pCard->IOWriteInternal(PC, nAddr, bWrite, nValue, nExecutedCycles);
 }
 
-BYTE MockingboardCard::IOWriteInternal(WORD PC, WORD nAddr, BYTE bWrite, BYTE nValue, ULONG nExecutedCycles)
+// Support 6502/65C02 false-reads of 6522 (GH#52)
+void MockingboardCard::FalseRead6522(WORD PC, WORD nAddr, ULONG nExecutedCycles)
 {
-	GetCardMgr().GetMockingboardCardMgr().UpdateCycles(nExecutedCycles);
-
-#ifdef _DEBUG
-	if (!IS_APPLE2 && MemCheckINTCXROM())
-	{
-		_ASSERT(0);	// Card ROM disabled, so IO_Cxxx() returns the internal ROM
-		return 0;
-	}
-#endif
+	const BYTE opcode2 = ReadByteFromMemory(PC-2);
+	const BYTE opcode3 = ReadByteFromMemory(PC-3);
 
-	// Support 6502/65C02 false-reads of 6522 (GH#52)
-	if ( ((ReadByteFromMemory(PC-2) == 0x91) && GetMainCpu() == CPU_6502) ||	// sta (zp),y - 6502 only (no-PX variant only) (UTAIIe:4-23)
-		 (ReadByteFromMemory(PC-3) == 0x99) ||		// sta abs16,y - 6502/65C02, but for 65C02 only the no-PX variant that does the false-read (UTAIIe:4-27)
-		 (ReadByteFromMemory(PC-3) == 0x9D) )		// sta abs16,x - 6502/65C02, but for 65C02 only the no-PX variant that does the false-read (UTAIIe:4-27)
+	if ( ((opcode2 == 0x91) && GetMainCpu() == CPU_6502) ||	// sta (zp),y - 6502 only (no-PX variant only) (UTAIIe:4-23)
+		 (opcode3 == 0x99) ||		// sta abs16,y - 6502/65C02, but for 65C02 only the no-PX variant that does the false-read (UTAIIe:4-27)
+		 (opcode3 == 0x9D) )		// sta abs16,x - 6502/65C02, but for 65C02 only the no-PX variant that does the false-read (UTAIIe:4-27)
 	{
 		WORD base;
 		WORD addr16;
-		if (ReadByteFromMemory(PC-2) == 0x91)
+		if (opcode2 == 0x91)
 		{
 			BYTE zp = ReadByteFromMemory(PC-1);
 			base = (ReadByteFromMemory(zp) | (ReadByteFromMemory((zp+1)&0xff)<<8));
@@ -743,7 +736,7 @@ BYTE MockingboardCard::IOWriteInternal(WORD PC, WORD nAddr, BYTE bWrite, BYTE nV
 		else
 		{
 			base = ReadWordFromMemory(PC-2);
-			addr16 = base + ((ReadByteFromMemory(PC-3) == 0x99) ? regs.y : regs.x);
+			addr16 = base + ((opcode3 == 0x99) ? regs.y : regs.x);
 		}
 
 		if (((base ^ addr16) >> 8) == 0)	// Only the no-PX variant does the false read (to the same I/O SELECT page)
@@ -756,6 +749,21 @@ BYTE MockingboardCard::IOWriteInternal(WORD PC, WORD nAddr, BYTE bWrite, BYTE nV
 			}
 		}
 	}
+}
+
+BYTE MockingboardCard::IOWriteInternal(WORD PC, WORD nAddr, BYTE bWrite, BYTE nValue, ULONG nExecutedCycles)
+{
+	GetCardMgr().GetMockingboardCardMgr().UpdateCycles(nExecutedCycles);
+
+#ifdef _DEBUG
+	if (!IS_APPLE2 && MemCheckINTCXROM())
+	{
+		_ASSERT(0);	// Card ROM disabled, so IO_Cxxx() returns the internal ROM
+		return 0;
+	}
+#endif
+
+	FalseRead6522(PC, nAddr, nExecutedCycles);
 
 	if (m_isPhasorCard)
 	{
@@ -832,6 +840,57 @@ BYTE MockingboardCard::IOWriteInternal(WORD PC, WORD nAddr, BYTE bWrite, BYTE nV
 
 //-----------------------------------------------------------------------------
 
+// Fast-paths for a Mockingboard's (or MegaAudio's) 6522s at $Cn00-$Cn0F & $Cn80-$Cn8F, ie. AY register writes & IRQ handlers
+// . same as IORead() & IOWrite() for these addresses, but without re-decoding the card type & address
+// . not for Phasor (its mode changes the decode) or SD Music (a single 6522)
+
+BYTE __stdcall MockingboardCard::IORead6522A(WORD PC, WORD nAddr, BYTE bWrite, BYTE nValue, ULONG nExecutedCycles)
+{
+	MockingboardCard* pCard = (MockingboardCard*)MemGetSlotParameters((nAddr >> 8) & 0xf);
+	return pCard->IORead6522Internal(SY6522_DEVICE_A, nAddr, nExecutedCycles);
+}
+
+BYTE __stdcall MockingboardCard::IORead6522B(WORD PC, WORD nAddr, BYTE bWrite, BYTE nValue, ULONG nExecutedCycles)
+{
+	MockingboardCard* pCard = (MockingboardCard*)MemGetSlotParameters((nAddr >> 8) & 0xf);
+	return pCard->IORead6522Internal(SY6522_DEVICE_B, nAddr, nExecutedCycles);
+}
+
+BYTE __stdcall MockingboardCard::IOWrite6522A(WORD PC, WORD nAddr, BYTE bWrite, BYTE nValue, ULONG nExecutedCycles)
+{
+	MockingboardCard* pCard = (MockingboardCard*)MemGetSlotParameters((nAddr >> 8) & 0xf);
+	return pCard->IOWrite6522Internal(SY6522_DEVICE_A, PC, nAddr, nValue, nExecutedCycles);
+}
+
+BYTE __stdcall MockingboardCard::IOWrite6522B(WORD PC, WORD nAddr, BYTE bWrite, BYTE nValue, ULONG nExecutedCycles)
+{
+	MockingboardCard* pCard = (MockingboardCard*)MemGetSlotParameters((nAddr >> 8) & 0xf);
+	return pCard->IOWrite6522Internal(SY6522_DEVICE_B, PC, nAddr, nValue, nExecutedCycles);
+}
+
+BYTE MockingboardCard::IORead6522Internal(BYTE subunit, WORD nAddr, ULONG nExecutedCycles)
+{
+	GetCardMgr().GetMockingboardCardMgr().UpdateCycles(nExecutedCycles);
+
+	return m_MBSubUnit[subunit].sy6522.Read(nAddr & 0xf);
+}
+
+BYTE MockingboardCard::IOWrite6522Internal(BYTE subunit, WORD PC, WORD nAddr, BYTE nValue, ULONG nExecutedCycles)
+{
+	GetCardMgr().GetMockingboardCardMgr().UpdateCycles(nExecutedCycles);
+
+	FalseRead6522(PC, nAddr, nExecutedCycles);
+
+	const BYTE reg = nAddr & 0xf;
+	m_MBSubUnit[subunit].sy6522.Write(reg, nValue);
+	if (reg == SY6522::rORB)
+		WriteToORB(subunit);
+
+	return 0;
+}
+
+//-----------------------------------------------------------------------------
+
 // Phasor's DEVICE SELECT' logic:
 // . if addr.[b3]==1, then clear the card's mode bits b2:b0
 // . if any of addr.[b2:b0] are a logic 1, then set these bits in the card's mode
@@ -907,6 +966,12 @@ void MockingboardCard::InitializeIO(LPBYTE pCxRomPeripheral)
 	else	// All other Mockingboard variants
 		RegisterIoHandler(m_slot, IO_Null, IO_Null, IORead, IOWrite, this, NULL);
 
+	if (QueryType() == CT_MockingboardC || QueryType() == CT_MegaAudio)
+	{
+		RegisterIoHandlerCx(m_slot, 0x0, IORead6522A, IOWrite6522A);	// $Cn00-$Cn0F
+		RegisterIoHandlerCx(m_slot, 0x8, IORead6522B, IOWrite6522B);	// $Cn80-$Cn8F
+	}
+
 	if (g_bDisableDirectSound || g_bDisableDirectSoundMockingboard)
 		return;
 }
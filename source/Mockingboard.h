@@ -23,6 +23,10 @@ public:
 	static BYTE __stdcall IORead(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG nExecutedCycles);
 	static BYTE __stdcall IOWrite(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG nExecutedCycles);
 	static BYTE __stdcall PhasorIO(WORD PC, WORD nAddr, BYTE bWrite, BYTE nValue, ULONG nExecutedCycles);
+	static BYTE __stdcall IORead6522A(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG nExecutedCycles);
+	static BYTE __stdcall IORead6522B(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG nExecutedCycles);
+	static BYTE __stdcall IOWrite6522A(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG nExecutedCycles);
+	static BYTE __stdcall IOWrite6522B(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG nExecutedCycles);
 
 	BYTE IOReadInternal(WORD PC, WORD nAddr, BYTE bWrite, BYTE nValue, ULONG nExecutedCycles);
 	BYTE IOWriteInternal(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG nExecutedCycles);
@@ -121,6 +125,9 @@ private:
 	};
 
 	void WriteToORB(BYTE subunit, BYTE subunitForAY=0);
+	void FalseRead6522(WORD PC, WORD nAddr, ULONG nExecutedCycles);
+	BYTE IORead6522Internal(BYTE subunit, WORD nAddr, ULONG nExecutedCycles);
+	BYTE IOWrite6522Internal(BYTE subunit, WORD PC, WORD nAddr, BYTE nValue, ULONG nExecutedCycles);
 	void AY8913_Reset(BYTE subunit);
 	void AY8913_Write(BYTE subunit, BYTE ay, BYTE value);
 	void UpdateIFRandIRQ(MB_SUBUNIT* pMB, BYTE clr_mask, BYTE set_mask);
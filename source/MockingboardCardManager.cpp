@@ -40,8 +40,12 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 bool MockingboardCardManager::IsMockingboard(UINT slot)
 {
-	SS_CARDTYPE type = GetCardMgr().QuerySlot(slot);
-	return type == CT_MockingboardC || type == CT_Phasor || IsMockingboardExtraCardType(slot);
+	return IsMockingboardType(GetCardMgr().QuerySlot(slot));
+}
+
+bool MockingboardCardManager::IsMockingboardType(SS_CARDTYPE type)
+{
+	return type == CT_MockingboardC || type == CT_Phasor || type == CT_MegaAudio || type == CT_SDMusic;
 }
 
 bool MockingboardCardManager::IsMockingboardExtraCardType(UINT slot)
@@ -105,23 +109,27 @@ void MockingboardCardManager::SetCumulativeCycles()
 	}
 }
 
+// NB. UpdateCycles() & UpdateIRQ() are called on every 6522 access (or IFR change),
+// so only get the CardManager once, and avoid the dynamic_cast<> (the card type has already been checked)
 void MockingboardCardManager::UpdateCycles(ULONG executedCycles)
 {
+	CardManager& cardMgr = GetCardMgr();
 	for (UINT i = SLOT0; i < NUM_SLOTS; i++)
 	{
-		if (IsMockingboard(i))
-			dynamic_cast<MockingboardCard&>(GetCardMgr().GetRef(i)).UpdateCycles(executedCycles);
+		if (IsMockingboardType(cardMgr.QuerySlot(i)))
+			static_cast<MockingboardCard&>(cardMgr.GetRef(i)).UpdateCycles(executedCycles);
 	}
 }
 
 // Called from class SY6522
 void MockingboardCardManager::UpdateIRQ()
 {
+	CardManager& cardMgr = GetCardMgr();
 	bool irq = false;
 	for (UINT i = SLOT0; i < NUM_SLOTS; i++)
 	{
-		if (IsMockingboard(i))
-			irq |= dynamic_cast<MockingboardCard&>(GetCardMgr().GetRef(i)).Is6522IRQ();
+		if (IsMockingboardType(cardMgr.QuerySlot(i)))
+			irq |= static_cast<MockingboardCard&>(cardMgr.GetRef(i)).Is6522IRQ();
 	}
 
 	if (irq)
@@ -370,19 +378,12 @@ UINT MockingboardCardManager::GenerateAllSoundData()
 	return nNumSamples;
 }
 
-void MockingboardCardManager::MixAllAndCopyToRingBuffer(UINT nNumSamples)
+// Mix the AY voices of each slot with a non-NULL slotAYVoiceBuffers[] into m_mixBuffer
+void MockingboardCardManager::MixAYVoices(short** const slotAYVoiceBuffers[NUM_SLOTS], UINT nNumSamples)
 {
 //	const double fAttenuation = g_bPhasorEnable ? 2.0 / 3.0 : 1.0;
 	const double fAttenuation = true ? 2.0 / 3.0 : 1.0;
 
-	short** slotAYVoiceBuffers[NUM_SLOTS] = {0};
-
-	for (UINT slot = SLOT0; slot < NUM_SLOTS; slot++)
-	{
-		if (IsMockingboard(slot))
-			slotAYVoiceBuffers[slot] = dynamic_cast<MockingboardCard&>(GetCardMgr().GetRef(slot)).GetVoiceBuffers();
-	}
-
 	for (UINT i = 0; i < nNumSamples; i++)
 	{
 		// Mockingboard stereo (all voices on an AY8910 wire-or'ed together)
@@ -422,6 +423,19 @@ void MockingboardCardManager::MixAllAndCopyToRingBuffer(UINT nNumSamples)
 		m_mixBuffer[i * MockingboardCard::NUM_MB_CHANNELS + 0] = (short)nDataL;	// L
 		m_mixBuffer[i * MockingboardCard::NUM_MB_CHANNELS + 1] = (short)nDataR;	// R
 	}
+}
+
+void MockingboardCardManager::MixAllAndCopyToRingBuffer(UINT nNumSamples)
+{
+	short** slotAYVoiceBuffers[NUM_SLOTS] = {0};
+
+	for (UINT slot = SLOT0; slot < NUM_SLOTS; slot++)
+	{
+		if (IsMockingboard(slot))
+			slotAYVoiceBuffers[slot] = dynamic_cast<MockingboardCard&>(GetCardMgr().GetRef(slot)).GetVoiceBuffers();
+	}
+
+	MixAYVoices(slotAYVoiceBuffers, nNumSamples);
 
 	//
 
@@ -445,6 +459,18 @@ void MockingboardCardManager::MixAllAndCopyToRingBuffer(UINT nNumSamples)
 
 	m_byteOffset = (m_byteOffset + (uint32_t)nNumSamples * sizeof(short) * MockingboardCard::NUM_MB_CHANNELS) % SOUNDBUFFER_SIZE;
 
-	if (m_outputToRiff)
-		RiffPutSamples(&m_mixBuffer[0], nNumSamples);
+	RiffPutSamples(RIFF_MOCKINGBOARD, &m_mixBuffer[0], nNumSamples, MockingboardCard::SAMPLE_RATE, MockingboardCard::NUM_MB_CHANNELS);
+
+	// Per-card stems (after m_mixBuffer has been copied to the ring-buffer & RIFF_MOCKINGBOARD, so it can be reused)
+	for (UINT slot = SLOT0; slot < NUM_SLOTS; slot++)
+	{
+		const RIFF_STEM stem = (RIFF_STEM)(RIFF_MOCKINGBOARD_SLOT0 + slot);
+		if (!slotAYVoiceBuffers[slot] || !RiffIsWriting(stem))
+			continue;
+
+		short** stemAYVoiceBuffers[NUM_SLOTS] = {0};
+		stemAYVoiceBuffers[slot] = slotAYVoiceBuffers[slot];
+		MixAYVoices(stemAYVoiceBuffers, nNumSamples);
+		RiffPutSamples(stem, &m_mixBuffer[0], nNumSamples, MockingboardCard::SAMPLE_RATE, MockingboardCard::NUM_MB_CHANNELS);
+	}
 }
@@ -13,7 +13,6 @@ public:
 		m_byteOffset = (uint32_t)-1;
 		m_cyclesThisAudioFrame = 0;
 		m_userVolume = 0;
-		m_outputToRiff = false;
 		m_enableExtraCardTypes = false;
 
 		// NB. Cmd line has already been processed
@@ -23,6 +22,7 @@ public:
 	{}
 
 	bool IsMockingboard(UINT slot);
+	static bool IsMockingboardType(SS_CARDTYPE type);
 	void ReinitializeClock();
 	void InitializeForLoadingSnapshot();
 	void MuteControl(bool mute);
@@ -32,7 +32,6 @@ public:
 	bool IsActiveToPreventFullSpeed();
 	uint32_t GetVolume();
 	void SetVolume(uint32_t volume, uint32_t volumeMax);
-	void OutputToRiff() { m_outputToRiff = true; }
 	void SetEnableExtraCardTypes(bool enable) { m_enableExtraCardTypes = enable; }
 	bool GetEnableExtraCardTypes();
 
@@ -52,6 +51,7 @@ public:
 private:
 	bool Init();
 	UINT GenerateAllSoundData();
+	void MixAYVoices(short** const slotAYVoiceBuffers[NUM_SLOTS], UINT nNumSamples);
 	void MixAllAndCopyToRingBuffer(UINT nNumSamples);
 	bool IsMockingboardExtraCardType(UINT slot);
 
@@ -69,6 +69,5 @@ private:
 	uint32_t m_byteOffset;
 	UINT m_cyclesThisAudioFrame;
 	uint32_t m_userVolume;	// GUI's slide volume
-	bool m_outputToRiff;
 	bool m_enableExtraCardTypes;
 };
@@ -30,17 +30,20 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	#include "VidHD.h"
 
 	#include "NTSC_CharSet.h"
+	#include "NTSC_Chroma.h"
+#ifdef NTSC_GENERATED_CHROMA_TABLES
+	#include "NTSC_ChromaTables.h"	// Generated at build-time by ntscchroma
+#endif
+
+	#include <atomic>
+	#include <condition_variable>
+	#include <mutex>
+	#include <thread>
 
 // Some reference material here from 2000:
 // http://www.kreativekorp.com/miscpages/a2info/munafo.shtml
 //
 
-#define NTSC_REMOVE_WHITE_RINGING  1 // 0 = theoritical dimmed white has chroma, 1 = pure white without chroma tinting
-#define NTSC_REMOVE_BLACK_GHOSTING 1 // 1 = remove black smear/smudges carrying over
-#define NTSC_REMOVE_GRAY_CHROMA    1 // 1 = remove all chroma in gray1 and gray2
-
-#define DEBUG_PHASE_ZERO       0
-
 #define ALT_TABLE 0
 #if ALT_TABLE
 	#include "ntsc_rgb.h"
@@ -55,18 +58,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	#define INLINE inline
 #endif
 
-	#define PI 3.1415926535898f
-	#define DEG_TO_RAD(x) (PI*(x)/180.f) // 2PI=360, PI=180,PI/2=90,PI/4=45
-	#define RAD_45  PI*0.25f
-	#define RAD_90  PI*0.5f
-	#define RAD_360 PI*2.f
-
-	// sadly float64 precision is needed
-	#define real double
-
-	//#define CYCLESTART (PI/4.f) // PI/4 = 45 degrees
-	#define CYCLESTART (DEG_TO_RAD(45))
-
 
 // Globals (Public) ___________________________________________________
 	static uint16_t g_nVideoClockVert = 0; // 9-bit: VC VB VA V5 V4 V3 V2 V1 V0 = 0 .. 262
@@ -78,7 +69,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	static int g_nHiresPage    = 1; // See: getVideoScannerAddressHGR()
 	static int g_nTextPage     = 1;
 
-	static bool g_bDelayVideoMode = false;	// NB. No need to save to save-state, as it will be done immediately after opcode completes in NTSC_VideoUpdateCycles()
 	static uint32_t g_uNewVideoModeFlags = 0;
 
 	// Understanding the Apple II, Timing Generation and the Video Scanner, Pg 3-11
@@ -108,10 +98,73 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	// To maintain the 280x192 aspect ratio for 560px width, we double every scan line -> 560x384
 	// NB. For IIgs SHR, the 320x200 is again doubled (to 640x400), but this gives a ~16:9 ratio, when 4:3 is probably required (ie. stretch height from 200 to 240)
 	static bgra_t* g_pScanLines[VIDEO_SCANNER_Y_DISPLAY_IIGS * 2];
-	static UINT g_kFrameBufferWidth = 0;
+	static int g_nFrameBufferRowStride = 0;	// # pixels from a scanline to the one below it (-ve when bottom-up)
 
 	static unsigned short (*g_pHorzClockOffset)[VIDEO_SCANNER_MAX_HORZ] = 0;
 
+	// Floating bus: the video scanner's address is (scanline's base + horz offset), so cache the scanline's part
+	// . base & horz offset table (TEXT or HGR) only change with g_nVideoClockVert, or the video mode / Apple type / tables
+	#define FLOATING_BUS_LINE_INVALID 0xFFFF
+	static uint16_t g_nFloatingBusLineVert = FLOATING_BUS_LINE_INVALID;	// scanline that the cache is for
+	static uint16_t g_nFloatingBusLineBase = 0;
+	static const unsigned short* g_pFloatingBusLineHorzOffset = 0;
+
+	// The video scanner as the CPU sees it (floating bus, VBL, etc)
+	// . the same as the renderer's g_nVideoClockVert/Horz, g_nVideoMixed, etc, except when the video render thread is behind
+	static uint16_t g_nScannerClockVert = 0;
+	static uint16_t g_nScannerClockHorz = 0;
+	static int g_nScannerMixed     = 0;
+	static int g_nScannerTextPage  = 1;
+	static int g_nScannerHiresPage = 1;
+	static int g_nScannerTextCols  = 40;
+	static uint32_t g_uScannerVideoModeFlags = 0;		// As g_uNewVideoModeFlags, ie. including a delayed mode change
+	static uint32_t g_uScannerActiveVideoModeFlags = 0;	// The mode that the renderer is using
+
+	static bool g_bDelayVideoMode = false;	// NB. No need to save to save-state, as it will be done immediately after opcode completes in NTSC_VideoUpdateCycles()
+
+	// Frame-skip: the renderer only does 1 frame in (g_nFrameSkip+1), but the scanner still runs every cycle (so floating bus & VBL are exact)
+	// . decided as the scanner wraps to line 0, so a frame is either all rendered or all skipped
+	// . while skipping, the renderer is parked at the start of the frame after the last rendered one
+	static UINT g_nFrameSkip = 0;			// Option
+	static UINT g_nFramesSkipped = 0;		// Scanner: since the last rendered frame
+	static bool g_bSkippingFrame = false;	// Scanner: the current frame isn't rendered
+
+	// Video render thread: the CPU thread just logs what the renderer needs (the video memory fetched on each visible cycle,
+	// and the video mode changes), and the thread replays the log through the updateScreen*() funcs
+	// . the log is a single-producer/single-consumer ring of 16-bit words, where a record can't wrap (VIDEO_LOG_WRAP skips to the start)
+	// . NTSC_VideoFlush() waits for the thread to catch up, so the framebuffer is complete after each CpuExecute()
+	// . only the NTSC/TV/monochrome renderers at 60Hz (& no VidHD): the others are always done inline
+	enum VideoLogRecord_e
+	{
+		VIDEO_LOG_UPDATE,	// cycles, then a word (main | aux<<8) per visible cycle
+		VIDEO_LOG_SETMODE,	// (| delay<<8 | charset<<9), flags lo, flags hi
+		VIDEO_LOG_TEXTMODE,	// cols
+		VIDEO_LOG_RESYNC,	// vert, horz
+		VIDEO_LOG_SKIPPED,	// frames
+		VIDEO_LOG_WRAP
+	};
+	static const size_t VIDEO_LOG_SIZE = 1 << 16;	// words
+	static const size_t VIDEO_LOG_PUBLISH = 1024;	// words (~25 scanlines)
+	static const size_t VIDEO_LOG_NONE = (size_t)-1;
+	static uint16_t g_aVideoLog[VIDEO_LOG_SIZE];
+
+	static size_t g_nVideoLogWrite = 0;					// CPU thread: total words logged
+	static size_t g_nVideoLogUpdate = VIDEO_LOG_NONE;	// CPU thread: the unpublished VIDEO_LOG_UPDATE, which can still be extended
+	static bool g_bVideoLogResync = false;				// CPU thread: NTSC_VideoClockResync() not logged yet
+	static std::atomic<size_t> g_nVideoLogHead(0);		// Total words published, CPU thread
+	static std::atomic<size_t> g_nVideoLogTail(0);		// Total words replayed, render thread
+	static std::atomic<bool> g_bVideoLogIdle(false);	// Render thread is waiting for g_nVideoLogHead to move
+
+	static std::thread g_videoThread;
+	static std::mutex g_videoThreadMutex;
+	static std::condition_variable g_videoThreadWake;
+	static std::condition_variable g_videoThreadDrained;
+	static bool g_videoThreadQuit = false;
+	static bool g_bVideoThread = false;			// Option
+	static bool g_bVideoThreadActive = false;	// Option, and the renderers are supported
+
+	static const uint16_t* g_pVideoLogData = 0;	// Renderer: the video memory of the cycles being replayed, else NULL to read memory
+
 	typedef void (*UpdateScreenFunc_t)(long);
 	static UpdateScreenFunc_t g_pFuncUpdateTextScreen     = 0; // updateScreenText40;
 	static UpdateScreenFunc_t g_pFuncUpdateGraphicsScreen = 0; // updateScreenText40;
@@ -127,6 +180,12 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	static unsigned g_aPixelMaskGR       [ 16];
 	static uint16_t g_aPixelDoubleMaskHGR[128]; // hgrbits -> g_aPixelDoubleMaskHGR: 7-bit mono 280 pixels to 560 pixel doubling
 
+	// TEXT's fast path for the monochrome monitors (g_aBnWMonitorCustom only depends on the newest bit of the signal):
+	// . a text cell's 14 pixels are 2 spans of 7 bits, each copied straight from g_aMonoSpan[] to the framebuffer
+	static uint32_t g_aMonoSpan[128][7]; // 7 pixel bits (b0 first) -> 7 monochrome pixels; rebuilt by updateMonochromeTables()
+	static bool     g_bMonoSpanValid = false;
+	static uint8_t  g_aReverse7[128];    // b0..b6 -> b6..b0: a span's bits as they end up in g_nSignalBitsNTSC
+
 	static int g_nLastColumnPixelNTSC;
 	static int g_nColorBurstPixels;
 
@@ -134,9 +193,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	static int g_nColorPhaseNTSC = INITIAL_COLOR_PHASE;
 	static int g_nSignalBitsNTSC = 0;
 
-	#define NTSC_NUM_PHASES     4
-	#define NTSC_NUM_SEQUENCES  4096
-
 /*extern*/ uint32_t g_nChromaSize = 0; // for NTSC_VideoGetChromaTable()
 	static bgra_t   g_aBnWMonitor                 [NTSC_NUM_SEQUENCES];
 	static bgra_t   g_aHueMonitor[NTSC_NUM_PHASES][NTSC_NUM_SEQUENCES];
@@ -148,27 +204,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	static bgra_t g_aBnWMonitorCustom           [NTSC_NUM_SEQUENCES];
 	static bgra_t g_aBnWColorTVCustom           [NTSC_NUM_SEQUENCES];
 
-	#define CHROMA_ZEROS 2
-	#define CHROMA_POLES 2
-	#define CHROMA_GAIN  7.438011255f // Should this be 7.15909 MHz ?
-	#define CHROMA_0    -0.7318893645f
-	#define CHROMA_1     1.2336442711f
-
-	//#define LUMGAIN  1.062635655e+01
-	//#define LUMCOEF1  -0.3412038399
-	//#define LUMCOEF2  0.9647813115
-	#define LUMA_ZEROS  2
-	#define LUMA_POLES  2
-	#define LUMA_GAIN  13.71331570f   // Should this be 14.318180 MHz ?
-	#define LUMA_0     -0.3961075449f
-	#define LUMA_1      1.1044202472f
-
-	#define SIGNAL_ZEROS 2
-	#define SIGNAL_POLES 2
-	#define SIGNAL_GAIN  7.614490548f  // Should this be 7.15909 MHz ?
-	#define SIGNAL_0    -0.2718798058f 
-	#define SIGNAL_1     0.7465656072f 
-
 // Tables
 	// Video scanner tables are now runtime-generated using UTAIIe logic
 	static unsigned short g_aClockVertOffsetsHGR[VIDEO_SCANNER_MAX_VERT_PAL];
@@ -176,8 +211,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	static unsigned short APPLE_IIP_HORZ_CLOCK_OFFSET[5][VIDEO_SCANNER_MAX_HORZ];	// 5 = CEILING(312/64) = CEILING(262/64)
 	static unsigned short APPLE_IIE_HORZ_CLOCK_OFFSET[5][VIDEO_SCANNER_MAX_HORZ];
 
-#ifdef _DEBUG
-	static unsigned short g_kClockVertOffsetsHGR[ VIDEO_SCANNER_MAX_VERT ] =
+	// The NTSC (60Hz) tables are constant, so only the PAL (50Hz) ones need to be generated at run-time
+	// . _DEBUG builds still generate the NTSC ones, and check them against these
+	static const unsigned short g_kClockVertOffsetsHGR[ VIDEO_SCANNER_MAX_VERT ] =
 	{
 		0x0000,0x0400,0x0800,0x0C00,0x1000,0x1400,0x1800,0x1C00,0x0080,0x0480,0x0880,0x0C80,0x1080,0x1480,0x1880,0x1C80,
 		0x0100,0x0500,0x0900,0x0D00,0x1100,0x1500,0x1900,0x1D00,0x0180,0x0580,0x0980,0x0D80,0x1180,0x1580,0x1980,0x1D80,
@@ -202,7 +238,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 		0x0B80,0x0F80,0x1380,0x1780,0x1B80,0x1F80
 	};
 
-	static unsigned short g_kClockVertOffsetsTXT[33] =	// 33 = CEILING(262/8)
+	static const unsigned short g_kClockVertOffsetsTXT[33] =	// 33 = CEILING(262/8)
 	{
 		0x0000,0x0080,0x0100,0x0180,0x0200,0x0280,0x0300,0x0380,
 		0x0000,0x0080,0x0100,0x0180,0x0200,0x0280,0x0300,0x0380,
@@ -212,7 +248,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 		0x380
 	};
 
-	static unsigned short kAPPLE_IIP_HORZ_CLOCK_OFFSET[5][VIDEO_SCANNER_MAX_HORZ] =
+	static const unsigned short kAPPLE_IIP_HORZ_CLOCK_OFFSET[5][VIDEO_SCANNER_MAX_HORZ] =
 	{
 		{0x1068,0x1068,0x1069,0x106A,0x106B,0x106C,0x106D,0x106E,0x106F,
 		 0x1070,0x1071,0x1072,0x1073,0x1074,0x1075,0x1076,0x1077,
@@ -260,7 +296,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 		 0x0018,0x0019,0x001A,0x001B,0x001C,0x001D,0x001E,0x001F}
 	};
 
-	static unsigned short kAPPLE_IIE_HORZ_CLOCK_OFFSET[5][VIDEO_SCANNER_MAX_HORZ] =
+	static const unsigned short kAPPLE_IIE_HORZ_CLOCK_OFFSET[5][VIDEO_SCANNER_MAX_HORZ] =
 	{
 		{0x0068,0x0068,0x0069,0x006A,0x006B,0x006C,0x006D,0x006E,0x006F,
 		 0x0070,0x0071,0x0072,0x0073,0x0074,0x0075,0x0076,0x0077,
@@ -307,7 +343,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 		 0x0010,0x0011,0x0012,0x0013,0x0014,0x0015,0x0016,0x0017,
 		 0x0018,0x0019,0x001A,0x001B,0x001C,0x001D,0x001E,0x001F}
 	};
-#endif
 
 	static csbits_t csbits;		// charset, optionally followed by alt charset
 
@@ -317,14 +352,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	INLINE void      updateFramebufferMonitorSingleScanline( uint16_t signal, bgra_t *pTable );
 	INLINE void      updateFramebufferMonitorDoubleScanline( uint16_t signal, bgra_t *pTable );
 	INLINE void      updatePixels( uint16_t bits );
+	INLINE void      updateTextPixels( uint16_t bits );
 	INLINE void      updateVideoScannerHorzEOL();
 	INLINE void      updateVideoScannerAddress();
 
 	static void initChromaPhaseTables();
-	static real initFilterChroma   (real z);
-	static real initFilterLuma0    (real z);
-	static real initFilterLuma1    (real z);
-	static real initFilterSignal(real z);
 	static void initPixelDoubleMasks();
 	static void updateMonochromeTables( uint16_t r, uint16_t g, uint16_t b );
 
@@ -371,14 +403,6 @@ static void set_csbits()
 	}
 }
 
-//===========================================================================
-inline float clampZeroOne( const float & x )
-{
-	if (x < 0.f) return 0.f;
-	if (x > 1.f) return 1.f;
-	/* ...... */ return x;
-}
-
 //===========================================================================
 inline uint8_t getCharSetBits(int iChar)
 {
@@ -401,24 +425,24 @@ inline uint32_t getScanlineColor( const uint16_t signal, const bgra_t *pTable )
 //===========================================================================
 inline uint32_t* getScanlineNextInbetween()
 {
-	return (uint32_t*) (g_pVideoAddress - 1*g_kFrameBufferWidth);
+	return (uint32_t*) (g_pVideoAddress + 1*g_nFrameBufferRowStride);
 }
 
 #if 0	// don't use this pixel, as it's from the previous video-frame!
 inline uint32_t* getScanlineNext()
 {
-	return (uint32_t*) (g_pVideoAddress - 2*g_kFrameBufferWidth);
+	return (uint32_t*) (g_pVideoAddress + 2*g_nFrameBufferRowStride);
 }
 #endif
 //===========================================================================
 inline uint32_t* getScanlinePreviousInbetween()
 {
-	return (uint32_t*) (g_pVideoAddress + 1*g_kFrameBufferWidth);
+	return (uint32_t*) (g_pVideoAddress - 1*g_nFrameBufferRowStride);
 }
 
 inline uint32_t* getScanlinePrevious()
 {
-	return (uint32_t*) (g_pVideoAddress + 2*g_kFrameBufferWidth);
+	return (uint32_t*) (g_pVideoAddress - 2*g_nFrameBufferRowStride);
 }
 //===========================================================================
 inline uint32_t* getScanlineCurrent()
@@ -656,6 +680,44 @@ inline void updatePixels(uint16_t bits)
 
 //===========================================================================
 
+// Same as updatePixels(), but the monochrome monitors copy the cell's 2 precomputed spans (no NTSC signal per pixel)
+// . the scanner state (signal bits, colour phase, last column pixel) is left exactly as 14 calls to updatePixels() would
+inline void updateTextPixels(uint16_t bits)
+{
+	const UpdatePixelFunc_t func = GetColorBurst() ? g_pFuncUpdateHuePixel : g_pFuncUpdateBnWPixel;
+	const bool doubleScanline = func == updatePixelBnWMonitorDoubleScanline;
+	if (!g_bMonoSpanValid || (!doubleScanline && func != updatePixelBnWMonitorSingleScanline))
+	{
+		updatePixels(bits);
+		return;
+	}
+
+	const uint32_t* pSpan0 = g_aMonoSpan[bits & 0x7F];
+	const uint32_t* pSpan1 = g_aMonoSpan[(bits >> 7) & 0x7F];
+	uint32_t* pLine0Curr = getScanlineCurrent();
+	uint32_t* pLine1Next = getScanlineNextInbetween();
+
+	memcpy(pLine0Curr + 0, pSpan0, 7 * sizeof(uint32_t));
+	memcpy(pLine0Curr + 7, pSpan1, 7 * sizeof(uint32_t));
+	if (doubleScanline)
+	{
+		memcpy(pLine1Next + 0, pSpan0, 7 * sizeof(uint32_t));
+		memcpy(pLine1Next + 7, pSpan1, 7 * sizeof(uint32_t));
+	}
+	else
+	{
+		for (int i = 0; i < 14; i++)
+			pLine1Next[i] = 0 | ALPHA32_MASK;	// See updateFramebufferMonitorSingleScanline()
+	}
+	g_pVideoAddress += 14;
+
+	g_nSignalBitsNTSC = ((g_aReverse7[bits & 0x7F] << 7) | g_aReverse7[(bits >> 7) & 0x7F]) & 0xFFF;
+	g_nColorPhaseNTSC = (g_nColorPhaseNTSC + 14) & 3;
+	g_nLastColumnPixelNTSC = (bits >> 13) & 1;
+}
+
+//===========================================================================
+
 inline void updateVideoScannerHorzEOLSimple()
 {
 	if (VIDEO_SCANNER_MAX_HORZ == ++g_nVideoClockHorz)
@@ -855,19 +917,28 @@ static void ClearOverscanVideoArea()
 }
 
 //===========================================================================
-INLINE uint16_t getVideoScannerAddressTXT()
+INLINE uint16_t getVideoScannerLineBaseTXT(const uint16_t vert, const int textPage)
 {
-	uint16_t nAddress = (g_aClockVertOffsetsTXT[g_nVideoClockVert/8]
-		 + g_pHorzClockOffset         [g_nVideoClockVert/64][g_nVideoClockHorz]
-		 + (g_nTextPage  *  0x400));
+	return g_aClockVertOffsetsTXT[vert/8] + (textPage * 0x400);
+}
+
+INLINE uint16_t getVideoScannerAddressTXT(const uint16_t vert, const uint16_t horz, const int textPage)
+{
+	uint16_t nAddress = (getVideoScannerLineBaseTXT(vert, textPage)
+		 + g_pHorzClockOffset         [vert/64][horz]);
 	return nAddress;
 }
 
+INLINE uint16_t getVideoScannerAddressTXT()
+{
+	return getVideoScannerAddressTXT(g_nVideoClockVert, g_nVideoClockHorz, g_nTextPage);
+}
+
 //===========================================================================
-INLINE uint16_t getVideoScannerAddressHGR()
+INLINE uint16_t getVideoScannerLineBaseHGR(const uint16_t vert, const int hiresPage)
 {
 	// NOTE: Keep in sync: _ViewOutput() getVideoScannerAddressHGR()
-	const uint16_t aPageAddr[9] =
+	static const uint16_t aPageAddr[9] =
 	{
 		  0x0000 // [0]
 		, 0x2000 // [1]
@@ -880,285 +951,146 @@ INLINE uint16_t getVideoScannerAddressHGR()
 		, 0xE000 // [8] LC RAM
 	};
 
+	return g_aClockVertOffsetsHGR[vert] + aPageAddr[hiresPage]; // We can view oddball addresses like LC Bank 1/2/$E000 for VF_PAGE_6, VF_PAGE_7, VF_PAGE_8
+}
+
+INLINE uint16_t getVideoScannerAddressHGR(const uint16_t vert, const uint16_t horz, const int hiresPage)
+{
 	// NB. For both A2 and //e use APPLE_IIE_HORZ_CLOCK_OFFSET - see VideoGetScannerAddress() where only TEXT mode adds $1000
-	uint16_t nAddress = (g_aClockVertOffsetsHGR[g_nVideoClockVert  ]
-		+ APPLE_IIE_HORZ_CLOCK_OFFSET[g_nVideoClockVert/64][g_nVideoClockHorz]
-		+ aPageAddr[g_nHiresPage]); // We can view oddball addresses like LC Bank 1/2/$E000 for VF_PAGE_6, VF_PAGE_7, VF_PAGE_8
+	uint16_t nAddress = (getVideoScannerLineBaseHGR(vert, hiresPage)
+		+ APPLE_IIE_HORZ_CLOCK_OFFSET[vert/64][horz]);
 
 	return nAddress;
 }
 
-//===========================================================================
-INLINE uint16_t getVideoScannerAddressTXTorHGR()
+INLINE uint16_t getVideoScannerAddressHGR()
 {
-	const bool isTextAddr = ((g_nVideoMixed && g_nVideoClockVert >= VIDEO_SCANNER_Y_MIXED) ||
-		(g_uNewVideoModeFlags & VF_TEXT) ||
-		!(g_uNewVideoModeFlags & VF_HIRES));
-
-	if (isTextAddr)
-		return getVideoScannerAddressTXT();
-	else
-		return getVideoScannerAddressHGR();
+	return getVideoScannerAddressHGR(g_nVideoClockVert, g_nVideoClockHorz, g_nHiresPage);
 }
 
 //===========================================================================
-INLINE uint16_t getVideoScannerAddressSHR()
+INLINE bool isVideoScannerAddressTXT(const uint16_t vert, const uint32_t uVideoModeFlags, const int mixed)
 {
-	// 2 pixels per byte in 320-pixel mode = 160 bytes/scanline
-	// 4 pixels per byte in 640-pixel mode = 160 bytes/scanline
-	const UINT kBytesPerScanline = 160;
-	const UINT kBytesPerCycle = 4;
-	return 0x2000 + kBytesPerScanline * g_nVideoClockVert + kBytesPerCycle * (g_nVideoClockHorz - VIDEO_SCANNER_HORZ_START);
+	return (mixed && vert >= VIDEO_SCANNER_Y_MIXED) ||
+		(uVideoModeFlags & VF_TEXT) ||
+		!(uVideoModeFlags & VF_HIRES);
 }
 
-// Non-Inline _________________________________________________________
-
-// Build the 4 phase chroma lookup table
-// The YI'Q' colors are hard-coded
-//===========================================================================
-static void initChromaPhaseTables ()
+INLINE uint16_t getVideoScannerAddressTXTorHGR(const uint16_t vert, const uint16_t horz, const uint32_t uVideoModeFlags, const int mixed, const int textPage, const int hiresPage)
 {
-	int phase,s,t,n;
-	real z,y0,y1,c,i,q;
-	real phi,zz;
-	float brightness;
-	double r64,g64,b64;
-	float  r32,g32,b32;	
+	if (isVideoScannerAddressTXT(vert, uVideoModeFlags, mixed))
+		return getVideoScannerAddressTXT(vert, horz, textPage);
+	else
+		return getVideoScannerAddressHGR(vert, horz, hiresPage);
+}
 
-	for (phase = 0; phase < 4; ++phase)
+// The floating bus is the address for the previous cycle, so only horz=0 is on the previous scanline
+INLINE uint16_t getVideoScannerAddressPrevious(uint16_t vert, uint16_t horz, const uint32_t uVideoModeFlags, const int mixed, const int textPage, const int hiresPage)
+{
+	if (horz == 0)
 	{
-		phi = (phase * RAD_90) + CYCLESTART;
-		for (s = 0; s < NTSC_NUM_SEQUENCES; ++s)
-		{
-			t = s;
-			y0 = y1 = c = i = q = 0.0;
-
-			for (n = 0; n < 12; ++n)
-			{
-				z = (real)(0 != (t & 0x800));
-				t = t << 1;
-
-				for(int k = 0; k < 2; k++ )
-				{
-					//z = z * 1.25;
-					zz = initFilterSignal(z);
-					c  = initFilterChroma(zz); // "Mostly" correct _if_ CYCLESTART = PI/4 = 45 degrees
-					y0 = initFilterLuma0 (zz);
-					y1 = initFilterLuma1 (zz - c);
-
-					c = c * 2.f;
-					i = i + (c * cos(phi) - i) / 8.f;
-					q = q + (c * sin(phi) - q) / 8.f;
-
-					phi += RAD_45;
-				} // k
-			} // samples
-
-			brightness = clampZeroOne( (float)z );
-			g_aBnWMonitor[s].b = (uint8_t)(brightness * 255);
-			g_aBnWMonitor[s].g = (uint8_t)(brightness * 255);
-			g_aBnWMonitor[s].r = (uint8_t)(brightness * 255);
-			g_aBnWMonitor[s].a = 255;
-
-			brightness = clampZeroOne( (float)y1);
-			g_aBnwColorTV[s].b = (uint8_t)(brightness * 255);
-			g_aBnwColorTV[s].g = (uint8_t)(brightness * 255);
-			g_aBnwColorTV[s].r = (uint8_t)(brightness * 255);
-			g_aBnwColorTV[s].a = 255;
-			
-			/*
-				YI'V' to RGB
-
-				[r g b] = [y i v][ 1      1      1    ]
-				                 [0.956  -0.272 -1.105]
-				                 [0.621  -0.647  1.702]
-
-				[r]   [1   0.956  0.621][y]    
-				[g] = [1  -0.272 -0.647][i]
-				[b]   [1  -1.105  1.702][v]
-			*/
-			#define I_TO_R  0.956f
-			#define I_TO_G -0.272f
-			#define I_TO_B -1.105f
-
-			#define Q_TO_R  0.621f
-			#define Q_TO_G -0.647f
-			#define Q_TO_B  1.702f
-
-			r64 = y0 + (I_TO_R * i) + (Q_TO_R * q);
-			g64 = y0 + (I_TO_G * i) + (Q_TO_G * q);
-			b64 = y0 + (I_TO_B * i) + (Q_TO_B * q);
-
-			b32 = clampZeroOne( (float)b64);
-			g32 = clampZeroOne( (float)g64);
-			r32 = clampZeroOne( (float)r64);
-
-			int color = s & 15;
-
-#if NTSC_REMOVE_WHITE_RINGING
-			if( color == 15 ) // white
-			{
-				r32 = 1;
-				g32 = 1;
-				b32 = 1;
-			}
-#endif			
-
-#if NTSC_REMOVE_BLACK_GHOSTING
-			if( color == 0 ) // Black
-			{
-				r32 = 0;
-				g32 = 0;
-				b32 = 0;
-			}
-#endif
-
-#if NTSC_REMOVE_GRAY_CHROMA
-			if( color == 5 ) // Gray1 & Gray2
-			{
-				const float g = (float) 0x83 / (float) 0xFF;
-				r32 = g;
-				g32 = g;
-				b32 = g;
-			}
-
-			if( color == 10 ) // Gray2 & Gray1
-			{
-				const float g = (float) 0x78 / (float) 0xFF;
-				r32 = g;
-				g32 = g;
-				b32 = g;
-			}
-#endif
-
-			g_aHueMonitor[phase][s].b = (uint8_t)(b32 * 255);
-			g_aHueMonitor[phase][s].g = (uint8_t)(g32 * 255);
-			g_aHueMonitor[phase][s].r = (uint8_t)(r32 * 255);
-			g_aHueMonitor[phase][s].a = 255;
-
-			r64 = y1 + (I_TO_R * i) + (Q_TO_R * q);
-			g64 = y1 + (I_TO_G * i) + (Q_TO_G * q);
-			b64 = y1 + (I_TO_B * i) + (Q_TO_B * q);
-
-			b32 = clampZeroOne( (float)b64 );
-			g32 = clampZeroOne( (float)g64 );
-			r32 = clampZeroOne( (float)r64 );
-
-#if NTSC_REMOVE_WHITE_RINGING
-			if( color == 15 ) // white
-			{
-				r32 = 1;
-				g32 = 1;
-				b32 = 1;
-			}
-#endif			
-
-#if NTSC_REMOVE_BLACK_GHOSTING
-			if( color == 0 ) // Black
-			{
-				r32 = 0;
-				g32 = 0;
-				b32 = 0;
-			}
-#endif
-
-			g_aHueColorTV[phase][s].b = (uint8_t)(b32 * 255);
-			g_aHueColorTV[phase][s].g = (uint8_t)(g32 * 255);
-			g_aHueColorTV[phase][s].r = (uint8_t)(r32 * 255);
-			g_aHueColorTV[phase][s].a = 255;
-		}
+		horz = VIDEO_SCANNER_MAX_HORZ;
+		vert = (vert ? vert : g_videoScannerMaxVert) - 1;
 	}
 
-#if DEBUG_PHASE_ZERO
-	uint8_t *p = (uint8_t*)g_aHueMonitor;
-	*p++ = 0xFF;
-	*p++ = 0x00;
-	*p++ = 0x00;
-	*p++ = 0xFF;
-#endif
+	return getVideoScannerAddressTXTorHGR(vert, horz - 1, uVideoModeFlags, mixed, textPage, hiresPage);
+}
 
+// The CPU's view, ie. for the current opcode (the renderer can be behind)
+INLINE uint16_t getScannerAddressTXTorHGR()
+{
+	return getVideoScannerAddressTXTorHGR(g_nScannerClockVert, g_nScannerClockHorz, g_uScannerVideoModeFlags, g_nScannerMixed, g_nScannerTextPage, g_nScannerHiresPage);
 }
 
-/*
-http://www-users.cs.york.ac.uk/~fisher/mkfilter/trad.html
-Sample Rate: ???
-Corner Freq 1: ?
-Corner Freq 2: ?
+INLINE uint16_t getScannerAddressPrevious()
+{
+	return getVideoScannerAddressPrevious(g_nScannerClockVert, g_nScannerClockHorz, g_uScannerVideoModeFlags, g_nScannerMixed, g_nScannerTextPage, g_nScannerHiresPage);
+}
 
-double ButterworthLowPass2( double a, double b, double g, double z )
+//===========================================================================
+INLINE void invalidateFloatingBusLine()
 {
-	const  int      POLES=2;
-	static double x[POLES+1];
-	static double y[POLES+1];
+	g_nFloatingBusLineVert = FLOATING_BUS_LINE_INVALID;
+}
 
-	for( int iPole = 0; iPole < POLES; iPole++ )
+// Pre: g_nScannerClockVert is the scanline to cache
+static void updateFloatingBusLine()
+{
+	if (isVideoScannerAddressTXT(g_nScannerClockVert, g_uScannerVideoModeFlags, g_nScannerMixed))
 	{
-		x[iPole] = x[iPole+1];
-		y[iPole] = y[iPole+1];
+		g_nFloatingBusLineBase = getVideoScannerLineBaseTXT(g_nScannerClockVert, g_nScannerTextPage);
+		g_pFloatingBusLineHorzOffset = g_pHorzClockOffset[g_nScannerClockVert/64];
+	}
+	else
+	{
+		g_nFloatingBusLineBase = getVideoScannerLineBaseHGR(g_nScannerClockVert, g_nScannerHiresPage);
+		g_pFloatingBusLineHorzOffset = APPLE_IIE_HORZ_CLOCK_OFFSET[g_nScannerClockVert/64];
 	}
 
-	x[POLES] = z / g;
-	y[POLES] = x[0] + x[2] + (2.f*x[1]) + (a*y[0]) + (b*y[1]);
-
-	return y[2];
+	g_nFloatingBusLineVert = g_nScannerClockVert;
 }
 
-*/
-
-// What filter is this ??
-// Filter Order: 2 -> poles for low pass
 //===========================================================================
-static real initFilterChroma (real z)
+INLINE uint16_t getVideoScannerAddressSHR(const uint16_t vert, const uint16_t horz)
 {
-	static real x[CHROMA_ZEROS + 1] = {0,0,0};
-	static real y[CHROMA_POLES + 1] = {0,0,0};
-
-	x[0] = x[1];   x[1] = x[2];   x[2] = z / CHROMA_GAIN;
-	y[0] = y[1];   y[1] = y[2];   y[2] = -x[0] + x[2] + (CHROMA_0*y[0]) + (CHROMA_1*y[1]); // inverted x[0]
-
-	return y[2];
+	// 2 pixels per byte in 320-pixel mode = 160 bytes/scanline
+	// 4 pixels per byte in 640-pixel mode = 160 bytes/scanline
+	const UINT kBytesPerScanline = 160;
+	const UINT kBytesPerCycle = 4;
+	return 0x2000 + kBytesPerScanline * vert + kBytesPerCycle * (horz - VIDEO_SCANNER_HORZ_START);
 }
 
-// Butterworth Lowpass digital filter
-// Filter Order: 2 -> poles for low pass
 //===========================================================================
-static real initFilterLuma0 (real z)
-{
-	static real x[LUMA_ZEROS + 1] = { 0,0,0 };
-	static real y[LUMA_POLES + 1] = { 0,0,0 };
+// The video memory for the cycle being rendered: from the video render thread's log, else read it now
 
-	x[0] = x[1];   x[1] = x[2];   x[2] = z / LUMA_GAIN;
-	y[0] = y[1];   y[1] = y[2];   y[2] = x[0] + x[2] + (2.f*x[1]) + (LUMA_0*y[0]) + (LUMA_1*y[1]);
+INLINE uint8_t getVideoMainByte(const uint16_t addr)
+{
+	if (g_pVideoLogData)
+		return (uint8_t) *g_pVideoLogData++;
 
-	return y[2];
+	return *MemGetMainPtr(addr);
 }
 
-// Butterworth Lowpass digital filter
-// Filter Order: 2 -> poles for low pass
-//===========================================================================
-static real initFilterLuma1 (real z)
+INLINE uint8_t getVideoMainByteWithLC(const uint16_t addr)
 {
-	static real x[LUMA_ZEROS + 1] = { 0,0,0};
-	static real y[LUMA_POLES + 1] = { 0,0,0};
+	if (g_pVideoLogData)
+		return (uint8_t) *g_pVideoLogData++;
 
-	x[0] = x[1];   x[1] = x[2];   x[2] = z / LUMA_GAIN;
-	y[0] = y[1];   y[1] = y[2];   y[2] = x[0] + x[2] + (2.f*x[1]) + (LUMA_0*y[0]) + (LUMA_1*y[1]);
+	return *MemGetMainPtrWithLC(addr);
+}
 
-	return y[2];
+INLINE void getVideoMainAuxBytes(const uint16_t addr, uint8_t& m, uint8_t& a)
+{
+	if (g_pVideoLogData)
+	{
+		const uint16_t data = *g_pVideoLogData++;
+		m = (uint8_t) data;
+		a = (uint8_t) (data >> 8);
+		return;
+	}
+
+	m = *MemGetMainPtr(addr);
+	a = *MemGetAuxPtr(addr);
 }
 
-// Butterworth Lowpass digital filter
-// Filter Order: 2 -> poles for low pass
+// Non-Inline _________________________________________________________
+
+// Build the 4 phase chroma lookup table
+// . the default tables are generated at build-time, when available (see NTSC_Chroma.cpp)
 //===========================================================================
-static real initFilterSignal (real z)
+static void initChromaPhaseTables ()
 {
-	static real x[SIGNAL_ZEROS + 1] = { 0,0,0 };
-	static real y[SIGNAL_POLES + 1] = { 0,0,0 };
+	static_assert(sizeof(bgra_t) == sizeof(uint32_t), "bgra_t");
 
-	x[0] = x[1];   x[1] = x[2];   x[2] = z / SIGNAL_GAIN;
-	y[0] = y[1];   y[1] = y[2];   y[2] = x[0] + x[2] + (2.f*x[1]) + (SIGNAL_0*y[0]) + (SIGNAL_1*y[1]);
-
-	return y[2];
+#ifdef NTSC_GENERATED_CHROMA_TABLES
+	memcpy(g_aBnWMonitor, g_kBnWMonitor, sizeof(g_aBnWMonitor));
+	memcpy(g_aHueMonitor, g_kHueMonitor, sizeof(g_aHueMonitor));
+	memcpy(g_aBnwColorTV, g_kBnWColorTV, sizeof(g_aBnwColorTV));
+	memcpy(g_aHueColorTV, g_kHueColorTV, sizeof(g_aHueColorTV));
+#else
+	NTSC_BuildChromaTables((uint32_t*)g_aBnWMonitor, (uint32_t(*)[NTSC_NUM_SEQUENCES])g_aHueMonitor,
+						   (uint32_t*)g_aBnwColorTV, (uint32_t(*)[NTSC_NUM_SEQUENCES])g_aHueColorTV);
+#endif
 }
 
 //===========================================================================
@@ -1181,6 +1113,11 @@ static void initPixelDoubleMasks ()
 
 	for ( uint16_t color = 0; color < 16; color++ )
 		g_aPixelMaskGR[ color ] = (color << 12) | (color << 8) | (color << 4) | (color << 0);
+
+	for (uint8_t byte = 0; byte < 0x80; byte++ )
+		for (uint8_t bits = 0; bits < 7; bits++ )
+			if (byte & (1 << bits))
+				g_aReverse7[byte] |= 1 << (6 - bits);
 }
 
 //===========================================================================
@@ -1198,6 +1135,20 @@ void updateMonochromeTables( uint16_t r, uint16_t g, uint16_t b )
 		g_aBnWColorTVCustom[ iSample ].r = (g_aBnwColorTV[ iSample ].r * r) >> 8;
 		g_aBnWColorTVCustom[ iSample ].a = 0xFF;
 	}
+
+	// TEXT's spans are only exact if the monitor's colour is the newest bit's (ie. on/off) - true of the tables that NTSC_BuildChromaTables() builds
+	const uint32_t off = *(uint32_t*) &g_aBnWMonitorCustom[0];
+	const uint32_t on  = *(uint32_t*) &g_aBnWMonitorCustom[1];
+	g_bMonoSpanValid = true;
+	for( int iSample = 0; iSample < NTSC_NUM_SEQUENCES; iSample++ )
+	{
+		if (*(uint32_t*) &g_aBnWMonitorCustom[ iSample ] != ((iSample & 1) ? on : off))
+			g_bMonoSpanValid = false;
+	}
+
+	for( int byte = 0; byte < 0x80; byte++ )
+		for( int bit = 0; bit < 7; bit++ )
+			g_aMonoSpan[ byte ][ bit ] = (byte & (1 << bit)) ? on : off;
 }
 
 //===========================================================================
@@ -1277,8 +1228,7 @@ void updateScreenDoubleHires40 (long cycles6502) // wsUpdateVideoHires0
 			}
 			else if (g_nVideoClockHorz >= VIDEO_SCANNER_HORZ_START)
 			{
-				uint8_t *pMain = MemGetMainPtr(addr);
-				uint8_t  m     = pMain[0];
+				uint8_t  m     = getVideoMainByte(addr);
 				uint16_t bits  = g_aPixelDoubleMaskHGR[m & 0x7F]; // Optimization: hgrbits second 128 entries are mirror of first 128
 				updatePixels( bits );
 				// NB. No zeroPixel0_14M(), since no color phase shift (or use of g_nLastColumnPixelNTSC)
@@ -1395,11 +1345,8 @@ void updateScreenDoubleHires80 (long cycles6502 ) // wsUpdateVideoDblHires
 			}
 			else if (g_nVideoClockHorz >= VIDEO_SCANNER_HORZ_START)
 			{
-				uint8_t *pMain = MemGetMainPtr(addr);
-				uint8_t *pAux  = MemGetAuxPtr(addr);
-
-				uint8_t m = pMain[0];
-				uint8_t a = pAux [0];
+				uint8_t m, a;
+				getVideoMainAuxBytes(addr, m, a);
 
 				uint16_t bits = ((m & 0x7f) << 7) | (a & 0x7f);
 				bits = (bits << 1) | g_nLastColumnPixelNTSC;
@@ -1432,8 +1379,7 @@ void updateScreenDoubleLores40 (long cycles6502) // wsUpdateVideo7MLores
 			}
 			else if (g_nVideoClockHorz >= VIDEO_SCANNER_HORZ_START)
 			{
-				uint8_t *pMain = MemGetMainPtr(addr);
-				uint8_t  m     = pMain[0];
+				uint8_t  m     = getVideoMainByte(addr);
 				uint16_t lo    = getLoResBits( m ); 
 				uint16_t bits  = g_aPixelDoubleMaskHGR[(0xFF & lo >> ((1 - (g_nVideoClockHorz & 1)) * 2)) & 0x7F]; // Optimization: hgrbits
 				updatePixels( bits );
@@ -1495,11 +1441,8 @@ void updateScreenDoubleLores80 (long cycles6502) // wsUpdateVideoDblLores
 			}
 			else if (g_nVideoClockHorz >= VIDEO_SCANNER_HORZ_START)
 			{
-				uint8_t *pMain = MemGetMainPtr(addr);
-				uint8_t *pAux  = MemGetAuxPtr(addr);
-
-				uint8_t m = pMain[0];
-				uint8_t a = pAux [0];
+				uint8_t m, a;
+				getVideoMainAuxBytes(addr, m, a);
 
 				uint16_t lo = getLoResBits( m );
 				uint16_t hi = getLoResBits( a );
@@ -1624,8 +1567,7 @@ void updateScreenSingleHires40 (long cycles6502)
 			}
 			else if (g_nVideoClockHorz >= VIDEO_SCANNER_HORZ_START)
 			{
-				uint8_t *pMain = MemGetMainPtrWithLC(addr);
-				uint8_t  m     = pMain[0];
+				uint8_t  m     = getVideoMainByteWithLC(addr);
 				uint16_t bits  = g_aPixelDoubleMaskHGR[m & 0x7F]; // Optimization: hgrbits second 128 entries are mirror of first 128
 				if (m & 0x80)
 					bits = (bits << 1) | g_nLastColumnPixelNTSC;
@@ -1694,8 +1636,7 @@ void updateScreenSingleLores40 (long cycles6502)
 			}
 			else if (g_nVideoClockHorz >= VIDEO_SCANNER_HORZ_START)
 			{
-				uint8_t *pMain = MemGetMainPtr(addr);
-				uint8_t  m     = pMain[0];
+				uint8_t  m     = getVideoMainByte(addr);
 				uint16_t lo    = getLoResBits( m ); 
 				uint16_t bits  = lo >> ((1 - (g_nVideoClockHorz & 1)) * 2);
 				updatePixels( bits );
@@ -1721,15 +1662,14 @@ void updateScreenText40 (long cycles6502)
 		{
 			if (g_nVideoClockHorz >= VIDEO_SCANNER_HORZ_START)
 			{
-				uint8_t *pMain = MemGetMainPtr(addr);
-				uint8_t  m     = pMain[0];
+				uint8_t  m     = getVideoMainByte(addr);
 				uint8_t  c     = getCharSetBits(m);
 				uint16_t bits  = g_aPixelDoubleMaskHGR[c & 0x7F]; // Optimization: hgrbits second 128 entries are mirror of first 128
 
 				if (0 == g_nVideoCharSet && 0x40 == (m & 0xC0)) // Flash only if mousetext not active
 					bits ^= g_nTextFlashMask;
 
-				updatePixels( bits );
+				updateTextPixels( bits );
 			}
 		}
 		updateVideoScannerHorzEOL();
@@ -1773,6 +1713,9 @@ void updateScreenText40RGB(long cycles6502)
 //===========================================================================
 void updateScreenText80 (long cycles6502)
 {
+	const bool b14M = (GetVideo().GetVideoType() != VT_COLOR_IDEALIZED)	// No extra 14M bit needed for VT_COLOR_IDEALIZED
+		&& (GetVideo().GetVideoType() != VT_COLOR_VIDEOCARD_RGB);
+
 	for (; cycles6502 > 0; --cycles6502)
 	{
 		uint16_t addr = getVideoScannerAddressTXT();
@@ -1786,14 +1729,11 @@ void updateScreenText80 (long cycles6502)
 		{
 			if (g_nVideoClockHorz >= VIDEO_SCANNER_HORZ_START)
 			{
-				uint8_t *pMain = MemGetMainPtr(addr);
-				uint8_t *pAux  = MemGetAuxPtr(addr);
-
-				uint8_t m = pMain[0];
-				uint8_t a = pAux [0];
+				uint8_t m, a;
+				getVideoMainAuxBytes(addr, m, a);
 
-				if (g_uNewVideoModeFlags & VF_80COL_AUX_EMPTY)
-					a = MemReadFloatingBusFromNTSC();
+				if (!g_pVideoLogData && (g_uNewVideoModeFlags & VF_80COL_AUX_EMPTY))
+					a = MemReadFloatingBusFromNTSC(getVideoScannerAddressPrevious(g_nVideoClockVert, g_nVideoClockHorz, g_uNewVideoModeFlags, g_nVideoMixed, g_nTextPage, g_nHiresPage));
 
 				uint16_t main = getCharSetBits( m );
 				uint16_t aux  = getCharSetBits( a );
@@ -1805,11 +1745,10 @@ void updateScreenText80 (long cycles6502)
 					aux ^= g_nTextFlashMask;
 
 				uint16_t bits = (main << 7) | (aux & 0x7f);
-				if ((GetVideo().GetVideoType() != VT_COLOR_IDEALIZED)			// No extra 14M bit needed for VT_COLOR_IDEALIZED
-					&& (GetVideo().GetVideoType() != VT_COLOR_VIDEOCARD_RGB))
+				if (b14M)
 					bits = (bits << 1) | g_nLastColumnPixelNTSC;	// GH#555: Align TEXT80 chars with DHGR
 
-				updatePixels( bits );
+				updateTextPixels( bits );
 				g_nLastColumnPixelNTSC = (bits >> 14) & 1;
 			}
 		}
@@ -1865,32 +1804,23 @@ void updateScreenText80RGB(long cycles6502)
 //===========================================================================
 void updateScreenSHR(long cycles6502)
 {
-	for (; cycles6502 > 0; --cycles6502)
+	while (cycles6502 > 0)
 	{
-		if (g_nVideoClockVert < VIDEO_SCANNER_Y_DISPLAY_IIGS)
+		if (g_nVideoClockVert < VIDEO_SCANNER_Y_DISPLAY_IIGS && g_nVideoClockHorz >= VIDEO_SCANNER_HORZ_START)
 		{
-			uint16_t addr = getVideoScannerAddressSHR();
+			// All of this call's visible cycles on this scanline in one go (8 pixels (320 mode) / 16 pixels (640 mode) per cycle)
+			const long cyclesToEndOfLine = VIDEO_SCANNER_MAX_HORZ - g_nVideoClockHorz;
+			const long cycles = cycles6502 < cyclesToEndOfLine ? cycles6502 : cyclesToEndOfLine;
 
-			if (g_nVideoClockHorz >= VIDEO_SCANNER_HORZ_START)
-			{
-				uint32_t* pAux = (uint32_t*) MemGetAuxPtr(addr);	// 8 pixels (320 mode) / 16 pixels (640 mode)
-				uint32_t a = pAux[0];
+			VidHDCard::UpdateSHRLine(g_nVideoClockVert, g_nVideoClockHorz - VIDEO_SCANNER_HORZ_START, cycles, g_pVideoAddress);
+			g_pVideoAddress += 16 * cycles;
 
-				uint8_t* pControl = MemGetAuxPtr(0x9D00 + g_nVideoClockVert);	// scan-line control byte
-				uint8_t c = pControl[0];
-
-				bool is640Mode = !!(c & 0x80);
-				bool isColorFillMode = !!(c & 0x20);
-				UINT paletteSelectCode = c & 0xf;
-				const UINT kColorsPerPalette = 16;
-				const UINT kColorSize = 2;
-				uint16_t addrPalette = 0x9E00 + paletteSelectCode * kColorsPerPalette * kColorSize;
-
-				VidHDCard::UpdateSHRCell(is640Mode, isColorFillMode, addrPalette, g_pVideoAddress, a);
-				g_pVideoAddress += 16;
-			}
+			// updateVideoScannerHorzEOL_SHR() does the last cycle
+			g_nVideoClockHorz += cycles - 1;
+			cycles6502 -= cycles - 1;
 		}
 		updateVideoScannerHorzEOL_SHR();
+		cycles6502--;
 	}
 }
 
@@ -1924,8 +1854,19 @@ uint32_t*NTSC_VideoGetChromaTable( bool bHueTypeMonochrome, bool bMonitorTypeCol
 //===========================================================================
 void NTSC_VideoClockResync(const uint32_t dwCyclesThisFrame)
 {
-	g_nVideoClockVert = (uint16_t)(dwCyclesThisFrame / VIDEO_SCANNER_MAX_HORZ) % g_videoScannerMaxVert;
-	g_nVideoClockHorz = (uint16_t)(dwCyclesThisFrame % VIDEO_SCANNER_MAX_HORZ);
+	g_nScannerClockVert = (uint16_t)(dwCyclesThisFrame / VIDEO_SCANNER_MAX_HORZ) % g_videoScannerMaxVert;
+	g_nScannerClockHorz = (uint16_t)(dwCyclesThisFrame % VIDEO_SCANNER_MAX_HORZ);
+
+	if (g_bVideoThreadActive)
+	{
+		g_nVideoLogUpdate = VIDEO_LOG_NONE;
+		g_bVideoLogResync = true;
+	}
+	else
+	{
+		g_nVideoClockVert = g_nScannerClockVert;
+		g_nVideoClockHorz = g_nScannerClockHorz;
+	}
 }
 
 //===========================================================================
@@ -1937,33 +1878,27 @@ uint16_t NTSC_VideoGetScannerAddress(const ULONG uExecutedCycles, const bool ful
 		NTSC_VideoClockResync( CpuGetCyclesThisVideoFrame(uExecutedCycles) );
 	}
 
-	const uint16_t currVideoClockVert = g_nVideoClockVert;
-	const uint16_t currVideoClockHorz = g_nVideoClockHorz;
-
 	// Required for ANSI STORY (end credits) vert scrolling mid-scanline mixed mode: DGR80, TEXT80, DGR80
-	g_nVideoClockHorz -= 1;
-	if ((SHORT)g_nVideoClockHorz < 0)
+	// . ie. the address is for the previous cycle, so only horz=0 is on the previous scanline
+	if (g_nScannerClockHorz != 0)
 	{
-		g_nVideoClockHorz += VIDEO_SCANNER_MAX_HORZ;
-		g_nVideoClockVert -= 1;
-		if ((SHORT)g_nVideoClockVert < 0)
-			g_nVideoClockVert = g_videoScannerMaxVert-1;
-	}
+		if (g_nFloatingBusLineVert != g_nScannerClockVert)
+			updateFloatingBusLine();
 
-	uint16_t addr = getVideoScannerAddressTXTorHGR();
-
-	g_nVideoClockVert = currVideoClockVert;
-	g_nVideoClockHorz = currVideoClockHorz;
+		const uint16_t addr = g_nFloatingBusLineBase + g_pFloatingBusLineHorzOffset[g_nScannerClockHorz - 1];
+		_ASSERT(addr == getScannerAddressPrevious());
+		return addr;
+	}
 
-	return addr;
+	return getScannerAddressPrevious();
 }
 
 void NTSC_GetVideoVertHorzForDebugger(uint16_t& vert, uint16_t& horz)
 {
 	ResetCyclesExecutedForDebugger();		// if in full-speed, then reset cycles so that CpuCalcCycles() doesn't ASSERT
 	NTSC_VideoGetScannerAddress(0, g_bFullSpeed);
-	vert = g_nVideoClockVert;
-	horz = g_nVideoClockHorz;
+	vert = g_nScannerClockVert;
+	horz = g_nScannerClockHorz;
 }
 
 uint16_t NTSC_GetVideoVertForDebugger()
@@ -1974,7 +1909,9 @@ uint16_t NTSC_GetVideoVertForDebugger()
 }
 
 //===========================================================================
-void NTSC_SetVideoTextMode( int cols )
+static uint16_t* logVideoRecord(const size_t size);
+
+static void setRendererVideoTextMode( int cols )
 {
 	if (GetVideo().GetVideoType() == VT_COLOR_VIDEOCARD_RGB)
 	{
@@ -1992,82 +1929,147 @@ void NTSC_SetVideoTextMode( int cols )
 	}
 }
 
-//===========================================================================
-void NTSC_SetVideoMode( uint32_t uVideoModeFlags, bool bDelay/*=false*/ )
+void NTSC_SetVideoTextMode( int cols )
 {
-	g_uNewVideoModeFlags = uVideoModeFlags;
+	g_nScannerTextCols = cols;
 
-	if (uVideoModeFlags & VF_SHR)
+	if (g_bVideoThreadActive)
 	{
-		g_pFuncUpdateGraphicsScreen = updateScreenSHR;
-		g_pFuncUpdateTextScreen = updateScreenSHR;
-		return;
+		uint16_t* pRecord = logVideoRecord(2);
+		pRecord[0] = VIDEO_LOG_TEXTMODE;
+		pRecord[1] = (uint16_t) cols;
 	}
-
-	if (g_pFuncUpdateGraphicsScreen == updateScreenSHR && !(uVideoModeFlags & VF_SHR))
+	else
 	{
-		// Was SHR mode, so clear the framebuffer to remove any SHR residue in the borders
-		GetVideo().ClearFrameBuffer();
+		setRendererVideoTextMode(cols);
 	}
+}
 
-	if (bDelay && !g_bFullSpeed)
-	{
-		// (GH#670) NB. if g_bFullSpeed then NTSC_VideoUpdateCycles() won't be called on the next 6502 opcode.
-		//  - Instead it's called when !g_bFullSpeed (eg. drive motor off), then the stale g_uNewVideoModeFlags will get used for NTSC_SetVideoMode()!
-		g_bDelayVideoMode = true;
-		return;
-	}
-
-	g_nVideoMixed   = uVideoModeFlags & VF_MIXED;
-	g_nVideoCharSet = GetVideo().VideoGetSWAltCharSet() ? 1 : 0;
-
-	RGB_DisableTextFB();
-
-	g_nTextPage  = 1;
-	g_nHiresPage = 1;
+//===========================================================================
+static void getVideoPages(const uint32_t uVideoModeFlags, int& textPage, int& hiresPage)
+{
+	textPage  = 1;
+	hiresPage = 1;
 	if (uVideoModeFlags & VF_PAGE2)
 	{
 		// Apple IIe, Technical Notes, #3: Double High-Resolution Graphics
 		// 80STORE must be OFF to display page 2
 		if (0 == (uVideoModeFlags & VF_80STORE))
 		{
-			g_nTextPage  = 2;
-			g_nHiresPage = 2;
+			textPage  = 2;
+			hiresPage = 2;
 		}
 	}
 
 	if( uVideoModeFlags & VF_PAGE0)   // Pseudo page ($0000)
 	{
-		g_nHiresPage = 0;
+		hiresPage = 0;
 	}
 
 	if( uVideoModeFlags & VF_PAGE3)   // Pseudo page ($6000)
 	{
-		g_nHiresPage = 3;
+		hiresPage = 3;
 	}
 
 	if( uVideoModeFlags & VF_PAGE4)   // Pseudo page ($8000)
 	{
-		g_nHiresPage = 4;
+		hiresPage = 4;
 	}
 
 	if( uVideoModeFlags & VF_PAGE5)   // Pseudo page ($A000)
 	{
-		g_nHiresPage = 5;
+		hiresPage = 5;
 	}
 	if( uVideoModeFlags & VF_PAGE6)   // Pseudo page LC 1/2 ($C000,$D000)
 	{
-		g_nHiresPage = 6; // Keep in sync: getVideoScannerAddressHGR()
+		hiresPage = 6; // Keep in sync: getVideoScannerAddressHGR()
 	}
 	if( uVideoModeFlags & VF_PAGE7)   // Pseudo page LC 2/- ($D000,$E000)
 	{
-		g_nHiresPage = 7; // Keep in sync: getVideoScannerAddressHGR()
+		hiresPage = 7; // Keep in sync: getVideoScannerAddressHGR()
 	}
 	if( uVideoModeFlags & VF_PAGE8)   // Pseudo page LC RAM ($E000,$FFF)
 	{
-		g_nHiresPage = 8; // Keep in sync: getVideoScannerAddressHGR()
+		hiresPage = 8; // Keep in sync: getVideoScannerAddressHGR()
+	}
+}
+
+static void setScannerVideoMode(const uint32_t uVideoModeFlags)
+{
+	g_uScannerActiveVideoModeFlags = uVideoModeFlags;
+	g_nScannerMixed = uVideoModeFlags & VF_MIXED;
+	getVideoPages(uVideoModeFlags, g_nScannerTextPage, g_nScannerHiresPage);
+}
+
+static void setVideoThreadActive(const bool active);
+static void updateVideoThread();
+static void stopVideoThread();
+static void setRendererVideoMode(uint32_t uVideoModeFlags, bool bDelay, int charSet);
+
+void NTSC_SetVideoMode( uint32_t uVideoModeFlags, bool bDelay/*=false*/ )
+{
+	g_uScannerVideoModeFlags = uVideoModeFlags;
+	invalidateFloatingBusLine();
+
+	if (uVideoModeFlags & VF_SHR)
+	{
+		setVideoThreadActive(false);	// VidHD's SHR is always rendered inline
+	}
+	else
+	{
+		// (GH#670) NB. if g_bFullSpeed then NTSC_VideoUpdateCycles() won't be called on the next 6502 opcode.
+		//  - Instead it's called when !g_bFullSpeed (eg. drive motor off), then the stale g_uScannerVideoModeFlags will get used for NTSC_SetVideoMode()!
+		bDelay = bDelay && !g_bFullSpeed;
+
+		if (bDelay)
+			g_bDelayVideoMode = true;
+		else
+			setScannerVideoMode(uVideoModeFlags);
+	}
+
+	const int charSet = GetVideo().VideoGetSWAltCharSet() ? 1 : 0;
+
+	if (g_bVideoThreadActive)
+	{
+		uint16_t* pRecord = logVideoRecord(3);
+		pRecord[0] = VIDEO_LOG_SETMODE | (bDelay ? 1 << 8 : 0) | (charSet << 9);
+		pRecord[1] = (uint16_t) uVideoModeFlags;
+		pRecord[2] = (uint16_t) (uVideoModeFlags >> 16);
+	}
+	else
+	{
+		setRendererVideoMode(uVideoModeFlags, bDelay, charSet);
+	}
+}
+
+// Pre: bDelay is only for a delayed mode change (see NTSC_SetVideoMode()), and then just sets g_uNewVideoModeFlags
+static void setRendererVideoMode( uint32_t uVideoModeFlags, bool bDelay, int charSet )
+{
+	g_uNewVideoModeFlags = uVideoModeFlags;
+
+	if (uVideoModeFlags & VF_SHR)
+	{
+		g_pFuncUpdateGraphicsScreen = updateScreenSHR;
+		g_pFuncUpdateTextScreen = updateScreenSHR;
+		return;
 	}
 
+	if (g_pFuncUpdateGraphicsScreen == updateScreenSHR && !(uVideoModeFlags & VF_SHR))
+	{
+		// Was SHR mode, so clear the framebuffer to remove any SHR residue in the borders
+		GetVideo().ClearFrameBuffer();
+	}
+
+	if (bDelay)
+		return;
+
+	g_nVideoMixed   = uVideoModeFlags & VF_MIXED;
+	g_nVideoCharSet = charSet;
+
+	RGB_DisableTextFB();
+
+	getVideoPages(uVideoModeFlags, g_nTextPage, g_nHiresPage);
+
 	if (GetVideo().GetVideoRefreshRate() == VR_50HZ && g_pVideoAddress)	// GH#763 / NB. g_pVideoAddress==NULL when called via VideoResetState()
 	{
 		if (uVideoModeFlags & VF_TEXT)
@@ -2232,6 +2234,8 @@ void NTSC_SetVideoMode( uint32_t uVideoModeFlags, bool bDelay/*=false*/ )
 
 void NTSC_SetVideoStyle()
 {
+	NTSC_VideoFlush();
+
 	const bool half = GetVideo().IsVideoStyle(VS_HALF_SCANLINES);
 	const VideoRefreshRate_e refresh = GetVideo().GetVideoRefreshRate();
 	uint8_t r, g, b;
@@ -2323,6 +2327,8 @@ _mono:
 	}
 
 	ClearOverscanVideoArea();
+
+	updateVideoThread();
 }
 
 //===========================================================================
@@ -2333,25 +2339,30 @@ void NTSC_Destroy()
 {
 	// After a VM restart, this will point to an old FrameBuffer
 	// - if it's now unmapped then this can cause a crash in NTSC_SetVideoMode()!
+	stopVideoThread();
 	g_pVideoAddress = 0;
-	g_kFrameBufferWidth = 0;
+	g_nFrameBufferRowStride = 0;
 	memset(g_pScanLines, 0, sizeof(g_pScanLines));
 }
 
 void NTSC_VideoInit( uint8_t* pFramebuffer ) // wsVideoInit
 {
+	setVideoThreadActive(false);
+
 	make_csbits();
 	GenerateVideoTables();
 	initPixelDoubleMasks();
 	initChromaPhaseTables();
 	updateMonochromeTables( 0xFF, 0xFF, 0xFF );
 
-	g_kFrameBufferWidth = GetVideo().GetFrameBufferWidth();
+	g_nFrameBufferRowStride = GetVideo().GetFrameBufferRowStride();
 
 	for (int y = 0; y < (VIDEO_SCANNER_Y_DISPLAY_IIGS*2); y++)
 	{
-		uint32_t offset = sizeof(bgra_t) * GetVideo().GetFrameBufferWidth()
-			* ((GetVideo().GetFrameBufferHeight() - 1) - y - GetVideo().GetFrameBufferBorderHeight())
+		const UINT row = GetVideo().IsFrameBufferTopDown()
+			? y + GetVideo().GetFrameBufferBorderHeight()
+			: (GetVideo().GetFrameBufferHeight() - 1) - y - GetVideo().GetFrameBufferBorderHeight();
+		uint32_t offset = sizeof(bgra_t) * GetVideo().GetFrameBufferWidth() * row
 			+ (sizeof(bgra_t) * GetVideo().GetFrameBufferBorderWidth());
 		g_pScanLines[y] = (bgra_t*) (GetVideo().GetFrameBuffer() + offset);
 	}
@@ -2421,6 +2432,7 @@ void NTSC_VideoInit( uint8_t* pFramebuffer ) // wsVideoInit
 	}
 #endif
 
+	updateVideoThread();
 }
 
 //===========================================================================
@@ -2432,8 +2444,12 @@ void NTSC_VideoReinitialize( uint32_t cyclesThisFrame, bool bInitVideoScannerAdd
 		cyclesThisFrame %= g_videoScanner6502Cycles;
 	}
 
+	NTSC_VideoFlush();
+
 	g_nVideoClockVert = (uint16_t) (cyclesThisFrame / VIDEO_SCANNER_MAX_HORZ);
 	g_nVideoClockHorz = cyclesThisFrame % VIDEO_SCANNER_MAX_HORZ;
+	g_nScannerClockVert = g_nVideoClockVert;
+	g_nScannerClockHorz = g_nVideoClockHorz;
 
 	if (bInitVideoScannerAddress)		// GH#611
 		updateVideoScannerAddress();	// Pre-condition: g_nVideoClockVert
@@ -2442,6 +2458,8 @@ void NTSC_VideoReinitialize( uint32_t cyclesThisFrame, bool bInitVideoScannerAdd
 //===========================================================================
 void NTSC_VideoInitAppleType ()
 {
+	NTSC_VideoFlush();
+
 	int model = GetApple2Type();
 
 	// anything other than low bit set means not II/II+ (TC: include Pravets machines too?)
@@ -2450,12 +2468,14 @@ void NTSC_VideoInitAppleType ()
 	else
 		g_pHorzClockOffset = APPLE_IIP_HORZ_CLOCK_OFFSET;
 
+	invalidateFloatingBusLine();
 	set_csbits();
 }
 
 //===========================================================================
 void NTSC_VideoInitChroma()
 {
+	NTSC_VideoFlush();
 	initChromaPhaseTables();
 }
 
@@ -2511,6 +2531,444 @@ static void VideoUpdateCycles( int cyclesLeftToUpdate )
 }
 
 //===========================================================================
+// Video render thread: the log (CPU thread)
+
+static void publishVideoLog()
+{
+	g_nVideoLogUpdate = VIDEO_LOG_NONE;	// Once published it can be replayed, so can't be extended
+	g_nVideoLogHead.store(g_nVideoLogWrite);
+
+	if (g_bVideoLogIdle.load())
+	{
+		std::lock_guard<std::mutex> lock(g_videoThreadMutex);
+		g_videoThreadWake.notify_one();
+	}
+}
+
+// Returns where to write a record of 'size' words (which won't wrap), but doesn't advance g_nVideoLogWrite
+static uint16_t* reserveVideoLog(const size_t size)
+{
+	const size_t pos = g_nVideoLogWrite & (VIDEO_LOG_SIZE - 1);
+	const size_t skip = (pos + size > VIDEO_LOG_SIZE) ? VIDEO_LOG_SIZE - pos : 0;
+
+	while (g_nVideoLogWrite + skip + size - g_nVideoLogTail.load(std::memory_order_acquire) > VIDEO_LOG_SIZE)
+	{
+		// Log is full, so wait for the render thread
+		publishVideoLog();
+		std::this_thread::yield();
+	}
+
+	if (skip)
+	{
+		g_aVideoLog[pos] = VIDEO_LOG_WRAP;
+		g_nVideoLogWrite += skip;
+	}
+
+	return &g_aVideoLog[g_nVideoLogWrite & (VIDEO_LOG_SIZE - 1)];
+}
+
+static void logVideoResync()
+{
+	if (!g_bVideoLogResync)
+		return;
+
+	g_bVideoLogResync = false;
+
+	uint16_t* pRecord = reserveVideoLog(3);
+	pRecord[0] = VIDEO_LOG_RESYNC;
+	pRecord[1] = g_nScannerClockVert;
+	pRecord[2] = g_nScannerClockHorz;
+	g_nVideoLogWrite += 3;
+}
+
+static uint16_t* logVideoRecord(const size_t size)
+{
+	logVideoResync();
+
+	g_nVideoLogUpdate = VIDEO_LOG_NONE;
+	uint16_t* pRecord = reserveVideoLog(size);
+	g_nVideoLogWrite += size;
+	return pRecord;
+}
+
+// Log the video memory that the renderer will fetch for horz=[horzBegin...horzEnd) on a visible scanline
+// . NB. must match the updateScreen*() funcs' getVideoMainByte(), getVideoMainByteWithLC() & getVideoMainAuxBytes()
+static uint16_t* logVideoFetches(uint16_t* pData, const uint16_t vert, const uint16_t horzBegin, const uint16_t horzEnd)
+{
+	const uint32_t uVideoModeFlags = g_uScannerActiveVideoModeFlags;
+	const bool mixedText = g_nScannerMixed && vert >= VIDEO_SCANNER_Y_MIXED;
+	const bool text = mixedText || (uVideoModeFlags & VF_TEXT);
+	const bool hires = !text && (uVideoModeFlags & VF_HIRES);
+
+	const bool col80 = text ? (mixedText ? g_nScannerTextCols == 80 : (uVideoModeFlags & VF_80COL) != 0)
+							: (uVideoModeFlags & VF_DHIRES) && (uVideoModeFlags & VF_80COL);
+
+	uint16_t base;
+	const unsigned short* pHorzOffset;
+	if (hires)
+	{
+		base = getVideoScannerLineBaseHGR(vert, g_nScannerHiresPage);
+		pHorzOffset = APPLE_IIE_HORZ_CLOCK_OFFSET[vert/64];
+	}
+	else
+	{
+		base = getVideoScannerLineBaseTXT(vert, g_nScannerTextPage);
+		pHorzOffset = g_pHorzClockOffset[vert/64];
+	}
+
+	// A scanline's visible bytes are all in the same memory page
+	const uint16_t first = base + pHorzOffset[horzBegin];
+	const uint8_t* pMain = ((hires && !(uVideoModeFlags & VF_DHIRES)) ? MemGetMainPtrWithLC(first) : MemGetMainPtr(first)) - first;
+
+	if (!col80)
+	{
+		for (uint16_t horz = horzBegin; horz < horzEnd; horz++)
+			*pData++ = pMain[base + pHorzOffset[horz]];
+		return pData;
+	}
+
+	const uint8_t* pAux = MemGetAuxPtr(first) - first;
+	const bool auxEmpty = text && (g_uScannerVideoModeFlags & VF_80COL_AUX_EMPTY);
+
+	for (uint16_t horz = horzBegin; horz < horzEnd; horz++)
+	{
+		const uint16_t addr = base + pHorzOffset[horz];
+		const uint8_t a = auxEmpty
+			? MemReadFloatingBusFromNTSC(getVideoScannerAddressPrevious(vert, horz, g_uScannerVideoModeFlags, g_nScannerMixed, g_nScannerTextPage, g_nScannerHiresPage))
+			: pAux[addr];
+		*pData++ = pMain[addr] | (a << 8);
+	}
+
+	return pData;
+}
+
+static void logVideoUpdate(UINT cycles)
+{
+	logVideoResync();
+
+	// Extend the unpublished VIDEO_LOG_UPDATE if possible, else start a new one
+	const size_t pos = g_nVideoLogWrite & (VIDEO_LOG_SIZE - 1);
+	uint16_t* pData;
+
+	if (g_nVideoLogUpdate != VIDEO_LOG_NONE
+		&& g_aVideoLog[(g_nVideoLogUpdate & (VIDEO_LOG_SIZE - 1)) + 1] + cycles < g_videoScanner6502Cycles
+		&& pos != 0 && pos + cycles <= VIDEO_LOG_SIZE
+		&& g_nVideoLogWrite + cycles - g_nVideoLogTail.load(std::memory_order_acquire) <= VIDEO_LOG_SIZE)
+	{
+		g_aVideoLog[(g_nVideoLogUpdate & (VIDEO_LOG_SIZE - 1)) + 1] += cycles;
+		pData = &g_aVideoLog[pos];
+	}
+	else
+	{
+		uint16_t* pRecord = reserveVideoLog(2 + cycles);
+		g_nVideoLogUpdate = g_nVideoLogWrite;
+		g_nVideoLogWrite += 2;
+		pRecord[0] = VIDEO_LOG_UPDATE;
+		pRecord[1] = (uint16_t) cycles;
+		pData = pRecord + 2;
+	}
+
+	const uint16_t* pDataBegin = pData;
+
+	// Advance the scanner, a scanline at a time
+	while (cycles)
+	{
+		const uint16_t vert = g_nScannerClockVert;
+		const uint16_t horz = g_nScannerClockHorz;
+		const UINT cyclesToEndOfLine = VIDEO_SCANNER_MAX_HORZ - horz;
+		const UINT lineCycles = cycles < cyclesToEndOfLine ? cycles : cyclesToEndOfLine;
+		const uint16_t horzEnd = horz + lineCycles;
+
+		if (vert < VIDEO_SCANNER_Y_DISPLAY && horzEnd > VIDEO_SCANNER_HORZ_START)
+			pData = logVideoFetches(pData, vert, horz > VIDEO_SCANNER_HORZ_START ? horz : VIDEO_SCANNER_HORZ_START, horzEnd);
+
+		cycles -= lineCycles;
+		g_nScannerClockHorz = horzEnd;
+		if (g_nScannerClockHorz == VIDEO_SCANNER_MAX_HORZ)
+		{
+			g_nScannerClockHorz = 0;
+			if (++g_nScannerClockVert == g_videoScannerMaxVert)
+				g_nScannerClockVert = 0;
+		}
+	}
+
+	g_nVideoLogWrite += pData - pDataBegin;
+
+	if (g_nVideoLogWrite - g_nVideoLogHead.load(std::memory_order_relaxed) >= VIDEO_LOG_PUBLISH)
+		publishVideoLog();
+}
+
+//===========================================================================
+// Video render thread: replaying the log
+
+static void setRendererVideoTextMode(int cols);
+static void setRendererVideoMode(uint32_t uVideoModeFlags, bool bDelay, int charSet);
+static void skipRendererFrames(UINT frames);
+
+// Replay the records [tail...head), returns the new tail
+static size_t replayVideoLog(size_t tail, const size_t head)
+{
+	while (tail != head)
+	{
+		const size_t pos = tail & (VIDEO_LOG_SIZE - 1);
+		const uint16_t* pRecord = &g_aVideoLog[pos];
+
+		switch (pRecord[0] & 0xFF)
+		{
+		case VIDEO_LOG_UPDATE:
+			g_pVideoLogData = pRecord + 2;
+			VideoUpdateCycles(pRecord[1]);
+			tail += g_pVideoLogData - pRecord;
+			g_pVideoLogData = 0;
+			break;
+		case VIDEO_LOG_SETMODE:
+			setRendererVideoMode(pRecord[1] | ((uint32_t)pRecord[2] << 16), (pRecord[0] & (1 << 8)) != 0, (pRecord[0] >> 9) & 1);
+			tail += 3;
+			break;
+		case VIDEO_LOG_TEXTMODE:
+			setRendererVideoTextMode(pRecord[1]);
+			tail += 2;
+			break;
+		case VIDEO_LOG_RESYNC:
+			g_nVideoClockVert = pRecord[1];
+			g_nVideoClockHorz = pRecord[2];
+			tail += 3;
+			break;
+		case VIDEO_LOG_SKIPPED:
+			skipRendererFrames(pRecord[1]);
+			tail += 2;
+			break;
+		case VIDEO_LOG_WRAP:
+			tail += VIDEO_LOG_SIZE - pos;
+			break;
+		default:
+			_ASSERT(0);
+			tail = head;
+			break;
+		}
+
+		g_nVideoLogTail.store(tail, std::memory_order_release);
+	}
+
+	return tail;
+}
+
+static void VideoRenderThread()
+{
+	size_t tail = g_nVideoLogTail.load();
+
+	for (;;)
+	{
+		const size_t head = g_nVideoLogHead.load(std::memory_order_acquire);
+		if (head != tail)
+		{
+			tail = replayVideoLog(tail, head);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(g_videoThreadMutex);
+		g_videoThreadDrained.notify_all();
+		if (g_videoThreadQuit)
+			break;
+
+		g_bVideoLogIdle = true;
+		g_videoThreadWake.wait(lock, [tail] { return g_videoThreadQuit || g_nVideoLogHead.load() != tail; });
+		g_bVideoLogIdle = false;
+	}
+}
+
+//===========================================================================
+// Video render thread: control (CPU thread)
+
+// Wait for the render thread to replay the whole log, so the framebuffer & renderer's state are up to date
+void NTSC_VideoFlush()
+{
+	if (!g_bVideoThreadActive)
+		return;
+
+	logVideoResync();
+	publishVideoLog();
+
+	std::unique_lock<std::mutex> lock(g_videoThreadMutex);
+	g_videoThreadDrained.wait(lock, [] { return g_nVideoLogTail.load() == g_nVideoLogWrite; });
+}
+
+static void setVideoThreadActive(const bool active)
+{
+	if (active == g_bVideoThreadActive)
+		return;
+
+	if (!active)
+	{
+		NTSC_VideoFlush();
+		g_bVideoThreadActive = false;
+		return;
+	}
+
+	// Pre: inline rendering, so the renderer is in step with the scanner
+	g_nVideoLogUpdate = VIDEO_LOG_NONE;
+	g_bVideoLogResync = false;
+
+	if (!g_videoThread.joinable())
+	{
+		g_videoThreadQuit = false;
+		g_videoThread = std::thread(VideoRenderThread);
+	}
+
+	g_bVideoThreadActive = true;
+}
+
+static void stopVideoThread()
+{
+	setVideoThreadActive(false);
+
+	if (!g_videoThread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(g_videoThreadMutex);
+		g_videoThreadQuit = true;
+		g_videoThreadWake.notify_one();
+	}
+
+	g_videoThread.join();
+}
+
+// Only the NTSC/TV/monochrome renderers: the RGB & idealized ones read memory directly, and VidHD's SHR & 50Hz are always inline
+static void updateVideoThread()
+{
+	const VideoType_e type = GetVideo().GetVideoType();
+	setVideoThreadActive(g_bVideoThread
+		&& type != VT_COLOR_IDEALIZED && type != VT_COLOR_VIDEOCARD_RGB
+		&& GetVideo().GetVideoRefreshRate() == VR_60HZ
+		&& !GetVideo().HasVidHD()
+		&& g_pVideoAddress);
+}
+
+void NTSC_SetVideoThread(const bool enable)
+{
+	g_bVideoThread = enable;
+	updateVideoThread();
+}
+
+bool NTSC_GetVideoThread()
+{
+	return g_bVideoThread;
+}
+
+//===========================================================================
+
+// Update the video scanner, and render (or log for the render thread)
+static void renderVideoScannerCycles(const UINT cycles)
+{
+	if (g_bVideoThreadActive)
+	{
+		logVideoUpdate(cycles);
+		return;
+	}
+
+	VideoUpdateCycles(cycles);
+	g_nScannerClockVert = g_nVideoClockVert;
+	g_nScannerClockHorz = g_nVideoClockHorz;
+}
+
+// Update the video scanner only (a skipped frame), up to at most the end of the frame
+static void advanceVideoScannerCycles(const UINT cycles)
+{
+	const UINT clock = g_nScannerClockVert * VIDEO_SCANNER_MAX_HORZ + g_nScannerClockHorz + cycles;
+	g_nScannerClockVert = (uint16_t)((clock / VIDEO_SCANNER_MAX_HORZ) % g_videoScannerMaxVert);
+	g_nScannerClockHorz = (uint16_t)(clock % VIDEO_SCANNER_MAX_HORZ);
+}
+
+// The renderer didn't do the last 'frames' frames: catch up its per-frame state (text flash), and start at line 0 of this one
+static void skipRendererFrames(const UINT frames)
+{
+	if (g_pFuncUpdateGraphicsScreen != updateScreenSHR)	// As updateVideoScannerHorzEOL_SHR(): no flash
+	{
+		for (UINT i = 0; i < frames; i++)
+			updateFlashRate();
+	}
+
+	g_nVideoClockVert = 0;
+	g_nVideoClockHorz = 0;
+	updateVideoScannerAddress();
+}
+
+// The scanner has just wrapped to line 0: render this frame, or skip it
+static void startVideoFrame()
+{
+	if (g_nFramesSkipped < g_nFrameSkip)
+	{
+		g_nFramesSkipped++;
+		g_bSkippingFrame = true;
+		return;
+	}
+
+	if (g_bSkippingFrame)
+	{
+		g_bSkippingFrame = false;
+
+		if (g_bVideoThreadActive)
+		{
+			uint16_t* pRecord = logVideoRecord(2);
+			pRecord[0] = VIDEO_LOG_SKIPPED;
+			pRecord[1] = (uint16_t) g_nFramesSkipped;
+		}
+		else
+		{
+			skipRendererFrames(g_nFramesSkipped);
+		}
+	}
+
+	g_nFramesSkipped = 0;
+}
+
+static void updateVideoScannerCycles(UINT cycles)
+{
+	if (!g_nFrameSkip && !g_bSkippingFrame)
+	{
+		renderVideoScannerCycles(cycles);
+		return;
+	}
+
+	// Split at the end of each frame, to decide whether the next one is rendered
+	while (cycles)
+	{
+		const UINT cyclesToEndOfFrame = g_videoScanner6502Cycles - (g_nScannerClockVert * VIDEO_SCANNER_MAX_HORZ + g_nScannerClockHorz);
+		const UINT frameCycles = cycles < cyclesToEndOfFrame ? cycles : cyclesToEndOfFrame;
+
+		if (g_bSkippingFrame)
+			advanceVideoScannerCycles(frameCycles);
+		else
+			renderVideoScannerCycles(frameCycles);
+
+		cycles -= frameCycles;
+		if (frameCycles == cyclesToEndOfFrame)
+			startVideoFrame();
+	}
+}
+
+// Render 1 frame in (frames+1): skipped frames do no pixel work, but the video scanner's timing is unchanged
+void NTSC_SetFrameSkip(const UINT frames)
+{
+	g_nFrameSkip = frames < NTSC_MAX_FRAME_SKIP ? frames : NTSC_MAX_FRAME_SKIP;
+}
+
+UINT NTSC_GetFrameSkip()
+{
+	return g_nFrameSkip;
+}
+
+// The per-frame phases (text flash, frame-skip) outlive a machine: restart them as after power-on
+// . only between machines, as the renderer is then re-positioned by NTSC_VideoReinitialize()
+void NTSC_ResetFramePhase()
+{
+	g_nTextFlashCounter = 0;
+	g_nTextFlashMask = 0;
+	g_nFramesSkipped = 0;
+	g_bSkippingFrame = false;
+}
+
 void NTSC_VideoUpdateCycles( UINT cycles6502 )
 {
 #ifdef LOG_PERF_TIMINGS
@@ -2522,22 +2980,24 @@ void NTSC_VideoUpdateCycles( UINT cycles6502 )
 
 	if (g_bDelayVideoMode)
 	{
-		VideoUpdateCycles(1);	// Video mode change is delayed by 1 cycle
+		updateVideoScannerCycles(1);	// Video mode change is delayed by 1 cycle
 
 		g_bDelayVideoMode = false;
-		NTSC_SetVideoMode(g_uNewVideoModeFlags);
+		NTSC_SetVideoMode(g_uScannerVideoModeFlags);
 
 		cycles6502--;
 		if (!cycles6502)
 			return;
 	}
 
-	VideoUpdateCycles(cycles6502);
+	updateVideoScannerCycles(cycles6502);
 }
 
 //===========================================================================
 void NTSC_VideoRedrawWholeScreen()
 {
+	NTSC_VideoFlush();
+
 #ifdef _DEBUG
 	const uint16_t currVideoClockVert = g_nVideoClockVert;
 	const uint16_t currVideoClockHorz = g_nVideoClockHorz;
@@ -2609,6 +3069,18 @@ static bool IsNTSC()
 
 static void GenerateVideoTables()
 {
+#ifndef _DEBUG
+	if (IsNTSC())
+	{
+		memcpy(g_aClockVertOffsetsHGR, g_kClockVertOffsetsHGR, sizeof(g_kClockVertOffsetsHGR));
+		memcpy(g_aClockVertOffsetsTXT, g_kClockVertOffsetsTXT, sizeof(g_kClockVertOffsetsTXT));
+		memcpy(APPLE_IIP_HORZ_CLOCK_OFFSET, kAPPLE_IIP_HORZ_CLOCK_OFFSET, sizeof(kAPPLE_IIP_HORZ_CLOCK_OFFSET));
+		memcpy(APPLE_IIE_HORZ_CLOCK_OFFSET, kAPPLE_IIE_HORZ_CLOCK_OFFSET, sizeof(kAPPLE_IIE_HORZ_CLOCK_OFFSET));
+		invalidateFloatingBusLine();
+		return;
+	}
+#endif
+
 	eApple2Type currentApple2Type = GetApple2Type();
 	uint32_t currentVideoMode = GetVideo().GetVideoMode();
 	int currentHiresPage = g_nHiresPage;
@@ -2692,6 +3164,9 @@ static void GenerateVideoTables()
 	GetVideo().SetVideoMode(currentVideoMode);
 	g_nHiresPage = currentHiresPage;
 	g_nTextPage = currentTextPage;
+	g_nScannerClockVert = g_nVideoClockVert;
+	g_nScannerClockHorz = g_nVideoClockHorz;
+	invalidateFloatingBusLine();
 }
 
 static void GenerateBaseColors(baseColors_t pBaseNtscColors)
@@ -2726,6 +3201,8 @@ static void GenerateBaseColors(baseColors_t pBaseNtscColors)
 
 void NTSC_SetRefreshRate(VideoRefreshRate_e rate)
 {
+	setVideoThreadActive(false);
+
 	if (rate == VR_50HZ)
 	{
 		g_videoScannerMaxVert = VIDEO_SCANNER_MAX_VERT_PAL;
@@ -2738,6 +3215,8 @@ void NTSC_SetRefreshRate(VideoRefreshRate_e rate)
 	}
 
 	GenerateVideoTables();
+
+	updateVideoThread();
 }
 
 UINT NTSC_GetCyclesPerFrame()
@@ -2757,16 +3236,16 @@ UINT NTSC_GetVideoLines()
 
 // Get # cycles until rising Vbl edge: !VBl -> VBl at (0,192)
 // . NB. Called from CMouseInterface::SyncEventCallback(), which occurs *before* NTSC_VideoUpdateCycles()
-//   therefore g_nVideoClockVert/Horz will be behind, so correct 'cycleCurrentPos' by adding 'cycles'.
+//   therefore g_nScannerClockVert/Horz will be behind, so correct 'cycleCurrentPos' by adding 'cycles'.
 UINT NTSC_GetCyclesUntilVBlank(int cycles)
 {
 	const UINT cyclesPerFrames = NTSC_GetCyclesPerFrame();
 
 	if (g_bFullSpeed)
-		return cyclesPerFrames;	// g_nVideoClockVert/Horz not correct & accuracy isn't important: so just wait a frame's worth of cycles
+		return cyclesPerFrames;	// g_nScannerClockVert/Horz not correct & accuracy isn't important: so just wait a frame's worth of cycles
 
 	const UINT cycleVBl = VIDEO_SCANNER_Y_DISPLAY * VIDEO_SCANNER_MAX_HORZ;
-	const UINT cycleCurrentPos = (g_nVideoClockVert * VIDEO_SCANNER_MAX_HORZ + g_nVideoClockHorz + cycles) % cyclesPerFrames;
+	const UINT cycleCurrentPos = (g_nScannerClockVert * VIDEO_SCANNER_MAX_HORZ + g_nScannerClockHorz + cycles) % cyclesPerFrames;
 
 	return (cycleCurrentPos < cycleVBl) ?
 		(cycleVBl - cycleCurrentPos) :
@@ -2775,21 +3254,33 @@ UINT NTSC_GetCyclesUntilVBlank(int cycles)
 
 bool NTSC_GetVblBar()
 {
-	const UINT visibleScanLines = ((g_uNewVideoModeFlags & VF_SHR) == 0) ? VIDEO_SCANNER_Y_DISPLAY : VIDEO_SCANNER_Y_DISPLAY_IIGS;
-	return g_nVideoClockVert < visibleScanLines;
+	const UINT visibleScanLines = ((g_uScannerVideoModeFlags & VF_SHR) == 0) ? VIDEO_SCANNER_Y_DISPLAY : VIDEO_SCANNER_Y_DISPLAY_IIGS;
+	return g_nScannerClockVert < visibleScanLines;
+}
+
+// # of cycles that NTSC_GetVblBar() keeps returning the same value (NB. video-scanner must be kept up to date, ie. not full-speed)
+UINT NTSC_GetCyclesUntilVblBarChange()
+{
+	const UINT visibleScanLines = ((g_uScannerVideoModeFlags & VF_SHR) == 0) ? VIDEO_SCANNER_Y_DISPLAY : VIDEO_SCANNER_Y_DISPLAY_IIGS;
+	const UINT cycleVBl = visibleScanLines * VIDEO_SCANNER_MAX_HORZ;
+	const UINT cycleCurrentPos = g_nScannerClockVert * VIDEO_SCANNER_MAX_HORZ + g_nScannerClockHorz;
+
+	return (cycleCurrentPos < cycleVBl) ?
+		(cycleVBl - cycleCurrentPos) :
+		(g_videoScanner6502Cycles - cycleCurrentPos);
 }
 
 bool NTSC_IsVisible()
 {
-	return NTSC_GetVblBar() && (g_nVideoClockHorz >= VIDEO_SCANNER_HORZ_START);
+	return NTSC_GetVblBar() && (g_nScannerClockHorz >= VIDEO_SCANNER_HORZ_START);
 }
 
 // For debugger
 uint16_t NTSC_GetScannerAddressAndData(uint32_t& data, int& dataSize)
 {
-	if (g_uNewVideoModeFlags & VF_SHR)
+	if (g_uScannerVideoModeFlags & VF_SHR)
 	{
-		uint16_t addr = getVideoScannerAddressSHR();
+		uint16_t addr = getVideoScannerAddressSHR(g_nScannerClockVert, g_nScannerClockHorz);
 		uint32_t* pAux = (uint32_t*)MemGetAuxPtr(addr);	// 8 pixels (320 mode) / 16 pixels (640 mode)
 		data = pAux[0];
 		dataSize = 4;
@@ -2799,18 +3290,18 @@ uint16_t NTSC_GetScannerAddressAndData(uint32_t& data, int& dataSize)
 	//
 
 	// Copy logic from NTSC_SetVideoMode()
-	if (g_uNewVideoModeFlags & VF_TEXT)
+	if (g_uScannerVideoModeFlags & VF_TEXT)
 	{
-		if (g_uNewVideoModeFlags & VF_80COL)
+		if (g_uScannerVideoModeFlags & VF_80COL)
 			dataSize = 2;
 		else
 			dataSize = 1;
 	}
-	else if (g_uNewVideoModeFlags & VF_HIRES)
+	else if (g_uScannerVideoModeFlags & VF_HIRES)
 	{
-		if (g_uNewVideoModeFlags & VF_DHIRES)
+		if (g_uScannerVideoModeFlags & VF_DHIRES)
 		{
-			if (g_uNewVideoModeFlags & VF_80COL)
+			if (g_uScannerVideoModeFlags & VF_80COL)
 				dataSize = 2;
 			else
 				dataSize = 1;
@@ -2822,9 +3313,9 @@ uint16_t NTSC_GetScannerAddressAndData(uint32_t& data, int& dataSize)
 	}
 	else
 	{
-		if (g_uNewVideoModeFlags & VF_DHIRES)
+		if (g_uScannerVideoModeFlags & VF_DHIRES)
 		{
-			if (g_uNewVideoModeFlags & VF_80COL)
+			if (g_uScannerVideoModeFlags & VF_80COL)
 				dataSize = 2;
 			else
 				dataSize = 1;
@@ -2836,18 +3327,18 @@ uint16_t NTSC_GetScannerAddressAndData(uint32_t& data, int& dataSize)
 	}
 
 	// Extra logic for MIXED mode
-	if (g_nVideoMixed && g_nVideoClockVert >= VIDEO_SCANNER_Y_MIXED && (g_uNewVideoModeFlags & VF_80COL))
+	if (g_nScannerMixed && g_nScannerClockVert >= VIDEO_SCANNER_Y_MIXED && (g_uScannerVideoModeFlags & VF_80COL))
 		dataSize = 2;
 
-	uint16_t addr = getVideoScannerAddressTXTorHGR();
+	uint16_t addr = getScannerAddressTXTorHGR();
 	data = 0;
 
 	if (dataSize == 2)
 	{
 		uint8_t* pAux = MemGetAuxPtr(addr);
 		uint8_t a = pAux[0];
-		if (g_uNewVideoModeFlags & VF_80COL_AUX_EMPTY)
-			a = MemReadFloatingBusFromNTSC();
+		if (g_uScannerVideoModeFlags & VF_80COL_AUX_EMPTY)
+			a = MemReadFloatingBusFromNTSC(NTSC_VideoGetScannerAddress(0, false));
 		data = a << 8;
 	}
 	uint8_t* pMain = MemGetMainPtr(addr);
@@ -5,6 +5,8 @@
 // Globals (Public)
 extern uint32_t g_nChromaSize;
 
+#define NTSC_MAX_FRAME_SKIP 59	// ie. render at least 1 frame a second
+
 // Prototypes (Public) ________________________________________________
 void NTSC_SetVideoMode(uint32_t uVideoModeFlags, bool bDelay=false);
 void NTSC_SetVideoStyle();
@@ -21,6 +23,12 @@ void NTSC_VideoInitAppleType();
 void NTSC_VideoInitChroma();
 void NTSC_VideoUpdateCycles(UINT cycles6502);
 void NTSC_VideoRedrawWholeScreen();
+void NTSC_VideoFlush();
+void NTSC_SetVideoThread(const bool enable);
+bool NTSC_GetVideoThread();
+void NTSC_SetFrameSkip(const UINT frames);
+UINT NTSC_GetFrameSkip();
+void NTSC_ResetFramePhase();
 
 void NTSC_SetRefreshRate(VideoRefreshRate_e rate);
 UINT NTSC_GetCyclesPerFrame();
@@ -28,5 +36,6 @@ UINT NTSC_GetCyclesPerLine();
 UINT NTSC_GetVideoLines();
 UINT NTSC_GetCyclesUntilVBlank(int cycles);
 bool NTSC_GetVblBar();
+UINT NTSC_GetCyclesUntilVblBarChange();
 bool NTSC_IsVisible();
 uint16_t NTSC_GetScannerAddressAndData(uint32_t& data, int& dataSize);
@@ -0,0 +1,324 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 2010-2011, William S Simms
+Copyright (C) 2014-2016, Michael Pohoreski, Tom Charlesworth
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+// The NTSC chroma tables' maths, split from NTSC.cpp so that ntscchroma can run it at build-time
+
+// Includes
+	#include "StdAfx.h"
+	#include "NTSC_Chroma.h"
+
+#define NTSC_REMOVE_WHITE_RINGING  1 // 0 = theoritical dimmed white has chroma, 1 = pure white without chroma tinting
+#define NTSC_REMOVE_BLACK_GHOSTING 1 // 1 = remove black smear/smudges carrying over
+#define NTSC_REMOVE_GRAY_CHROMA    1 // 1 = remove all chroma in gray1 and gray2
+
+#define DEBUG_PHASE_ZERO       0
+
+// Defines
+	#define PI 3.1415926535898f
+	#define DEG_TO_RAD(x) (PI*(x)/180.f) // 2PI=360, PI=180,PI/2=90,PI/4=45
+	#define RAD_45  PI*0.25f
+	#define RAD_90  PI*0.5f
+	#define RAD_360 PI*2.f
+
+	// sadly float64 precision is needed
+	#define real double
+
+	//#define CYCLESTART (PI/4.f) // PI/4 = 45 degrees
+	#define CYCLESTART (DEG_TO_RAD(45))
+
+	#define CHROMA_GAIN  7.438011255f // Should this be 7.15909 MHz ?
+	#define CHROMA_0    -0.7318893645f
+	#define CHROMA_1     1.2336442711f
+
+	//#define LUMGAIN  1.062635655e+01
+	//#define LUMCOEF1  -0.3412038399
+	//#define LUMCOEF2  0.9647813115
+	#define LUMA_GAIN  13.71331570f   // Should this be 14.318180 MHz ?
+	#define LUMA_0     -0.3961075449f
+	#define LUMA_1      1.1044202472f
+
+	#define SIGNAL_GAIN  7.614490548f  // Should this be 7.15909 MHz ?
+	#define SIGNAL_0    -0.2718798058f
+	#define SIGNAL_1     0.7465656072f
+
+	// All the filters are order 2: 2 zeros, 2 poles
+	struct FilterState
+	{
+		real x[3];
+		real y[3];
+	};
+
+// Prototypes
+	static real initFilterChroma (FilterState& f, real z);
+	static real initFilterLuma0  (FilterState& f, real z);
+	static real initFilterLuma1  (FilterState& f, real z);
+	static real initFilterSignal (FilterState& f, real z);
+
+//===========================================================================
+inline float clampZeroOne( const float & x )
+{
+	if (x < 0.f) return 0.f;
+	if (x > 1.f) return 1.f;
+	/* ...... */ return x;
+}
+
+//===========================================================================
+inline uint32_t makeColor( float r, float g, float b )
+{
+	return 0xFF000000 | ((uint8_t)(r * 255) << 16) | ((uint8_t)(g * 255) << 8) | (uint8_t)(b * 255);	// bgra_t
+}
+
+// Build the 4 phase chroma lookup table
+// The YI'Q' colors are hard-coded
+//===========================================================================
+void NTSC_BuildChromaTables(uint32_t* pBnWMonitor, uint32_t (*pHueMonitor)[NTSC_NUM_SEQUENCES],
+							uint32_t* pBnWColorTV, uint32_t (*pHueColorTV)[NTSC_NUM_SEQUENCES])
+{
+	int phase,s,t,n;
+	real z,y0,y1,c,i,q;
+	real phi,zz;
+	float brightness;
+	double r64,g64,b64;
+	float  r32,g32,b32;
+
+	// The filters used to keep their state from one build to the next: the tables built at start-up were from zeroed filters,
+	// but a rebuild (debugger's palette reset) differed in one entry (HueColorTV[0][1]). Now every build is the start-up one.
+	FilterState filterSignal = {}, filterChroma = {}, filterLuma0 = {}, filterLuma1 = {};
+
+	for (phase = 0; phase < 4; ++phase)
+	{
+		phi = (phase * RAD_90) + CYCLESTART;
+		for (s = 0; s < NTSC_NUM_SEQUENCES; ++s)
+		{
+			t = s;
+			y0 = y1 = c = i = q = 0.0;
+
+			for (n = 0; n < 12; ++n)
+			{
+				z = (real)(0 != (t & 0x800));
+				t = t << 1;
+
+				for(int k = 0; k < 2; k++ )
+				{
+					//z = z * 1.25;
+					zz = initFilterSignal(filterSignal, z);
+					c  = initFilterChroma(filterChroma, zz); // "Mostly" correct _if_ CYCLESTART = PI/4 = 45 degrees
+					y0 = initFilterLuma0 (filterLuma0, zz);
+					y1 = initFilterLuma1 (filterLuma1, zz - c);
+
+					c = c * 2.f;
+					i = i + (c * cos(phi) - i) / 8.f;
+					q = q + (c * sin(phi) - q) / 8.f;
+
+					phi += RAD_45;
+				} // k
+			} // samples
+
+			brightness = clampZeroOne( (float)z );
+			pBnWMonitor[s] = makeColor(brightness, brightness, brightness);
+
+			brightness = clampZeroOne( (float)y1);
+			pBnWColorTV[s] = makeColor(brightness, brightness, brightness);
+
+			/*
+				YI'V' to RGB
+
+				[r g b] = [y i v][ 1      1      1    ]
+				                 [0.956  -0.272 -1.105]
+				                 [0.621  -0.647  1.702]
+
+				[r]   [1   0.956  0.621][y]
+				[g] = [1  -0.272 -0.647][i]
+				[b]   [1  -1.105  1.702][v]
+			*/
+			#define I_TO_R  0.956f
+			#define I_TO_G -0.272f
+			#define I_TO_B -1.105f
+
+			#define Q_TO_R  0.621f
+			#define Q_TO_G -0.647f
+			#define Q_TO_B  1.702f
+
+			r64 = y0 + (I_TO_R * i) + (Q_TO_R * q);
+			g64 = y0 + (I_TO_G * i) + (Q_TO_G * q);
+			b64 = y0 + (I_TO_B * i) + (Q_TO_B * q);
+
+			b32 = clampZeroOne( (float)b64);
+			g32 = clampZeroOne( (float)g64);
+			r32 = clampZeroOne( (float)r64);
+
+			int color = s & 15;
+
+#if NTSC_REMOVE_WHITE_RINGING
+			if( color == 15 ) // white
+			{
+				r32 = 1;
+				g32 = 1;
+				b32 = 1;
+			}
+#endif
+
+#if NTSC_REMOVE_BLACK_GHOSTING
+			if( color == 0 ) // Black
+			{
+				r32 = 0;
+				g32 = 0;
+				b32 = 0;
+			}
+#endif
+
+#if NTSC_REMOVE_GRAY_CHROMA
+			if( color == 5 ) // Gray1 & Gray2
+			{
+				const float g = (float) 0x83 / (float) 0xFF;
+				r32 = g;
+				g32 = g;
+				b32 = g;
+			}
+
+			if( color == 10 ) // Gray2 & Gray1
+			{
+				const float g = (float) 0x78 / (float) 0xFF;
+				r32 = g;
+				g32 = g;
+				b32 = g;
+			}
+#endif
+
+			pHueMonitor[phase][s] = makeColor(r32, g32, b32);
+
+			r64 = y1 + (I_TO_R * i) + (Q_TO_R * q);
+			g64 = y1 + (I_TO_G * i) + (Q_TO_G * q);
+			b64 = y1 + (I_TO_B * i) + (Q_TO_B * q);
+
+			b32 = clampZeroOne( (float)b64 );
+			g32 = clampZeroOne( (float)g64 );
+			r32 = clampZeroOne( (float)r64 );
+
+#if NTSC_REMOVE_WHITE_RINGING
+			if( color == 15 ) // white
+			{
+				r32 = 1;
+				g32 = 1;
+				b32 = 1;
+			}
+#endif
+
+#if NTSC_REMOVE_BLACK_GHOSTING
+			if( color == 0 ) // Black
+			{
+				r32 = 0;
+				g32 = 0;
+				b32 = 0;
+			}
+#endif
+
+			pHueColorTV[phase][s] = makeColor(r32, g32, b32);
+		}
+	}
+
+#if DEBUG_PHASE_ZERO
+	pHueMonitor[0][0] = 0xFF0000FF;	// b=0xFF, g=0x00, r=0x00, a=0xFF
+#endif
+
+}
+
+/*
+http://www-users.cs.york.ac.uk/~fisher/mkfilter/trad.html
+Sample Rate: ???
+Corner Freq 1: ?
+Corner Freq 2: ?
+
+double ButterworthLowPass2( double a, double b, double g, double z )
+{
+	const  int      POLES=2;
+	static double x[POLES+1];
+	static double y[POLES+1];
+
+	for( int iPole = 0; iPole < POLES; iPole++ )
+	{
+		x[iPole] = x[iPole+1];
+		y[iPole] = y[iPole+1];
+	}
+
+	x[POLES] = z / g;
+	y[POLES] = x[0] + x[2] + (2.f*x[1]) + (a*y[0]) + (b*y[1]);
+
+	return y[2];
+}
+
+*/
+
+// What filter is this ??
+// Filter Order: 2 -> poles for low pass
+//===========================================================================
+static real initFilterChroma (FilterState& f, real z)
+{
+	real* x = f.x;
+	real* y = f.y;
+
+	x[0] = x[1];   x[1] = x[2];   x[2] = z / CHROMA_GAIN;
+	y[0] = y[1];   y[1] = y[2];   y[2] = -x[0] + x[2] + (CHROMA_0*y[0]) + (CHROMA_1*y[1]); // inverted x[0]
+
+	return y[2];
+}
+
+// Butterworth Lowpass digital filter
+// Filter Order: 2 -> poles for low pass
+//===========================================================================
+static real initFilterLuma0 (FilterState& f, real z)
+{
+	real* x = f.x;
+	real* y = f.y;
+
+	x[0] = x[1];   x[1] = x[2];   x[2] = z / LUMA_GAIN;
+	y[0] = y[1];   y[1] = y[2];   y[2] = x[0] + x[2] + (2.f*x[1]) + (LUMA_0*y[0]) + (LUMA_1*y[1]);
+
+	return y[2];
+}
+
+// Butterworth Lowpass digital filter
+// Filter Order: 2 -> poles for low pass
+//===========================================================================
+static real initFilterLuma1 (FilterState& f, real z)
+{
+	real* x = f.x;
+	real* y = f.y;
+
+	x[0] = x[1];   x[1] = x[2];   x[2] = z / LUMA_GAIN;
+	y[0] = y[1];   y[1] = y[2];   y[2] = x[0] + x[2] + (2.f*x[1]) + (LUMA_0*y[0]) + (LUMA_1*y[1]);
+
+	return y[2];
+}
+
+// Butterworth Lowpass digital filter
+// Filter Order: 2 -> poles for low pass
+//===========================================================================
+static real initFilterSignal (FilterState& f, real z)
+{
+	real* x = f.x;
+	real* y = f.y;
+
+	x[0] = x[1];   x[1] = x[2];   x[2] = z / SIGNAL_GAIN;
+	y[0] = y[1];   y[1] = y[2];   y[2] = x[0] + x[2] + (2.f*x[1]) + (SIGNAL_0*y[0]) + (SIGNAL_1*y[1]);
+
+	return y[2];
+}
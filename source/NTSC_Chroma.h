@@ -0,0 +1,10 @@
+#pragma once
+
+// NTSC chroma lookup tables: a 12-bit window of the composite signal -> BGRA (as a uint32_t), for each of the 4 colour phases
+// . CMake builds generate these at build-time (ntscchroma -> NTSC_ChromaTables.h), else NTSC.cpp builds them at run-time
+
+#define NTSC_NUM_PHASES     4
+#define NTSC_NUM_SEQUENCES  4096
+
+void NTSC_BuildChromaTables(uint32_t* pBnWMonitor, uint32_t (*pHueMonitor)[NTSC_NUM_SEQUENCES],
+							uint32_t* pBnWColorTV, uint32_t (*pHueColorTV)[NTSC_NUM_SEQUENCES]);
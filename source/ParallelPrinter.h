@@ -21,6 +21,7 @@ public:
 	virtual void Destroy();
 	virtual void Reset(const bool powerCycle);
 	virtual void Update(const ULONG nExecutedCycles);
+	virtual UINT GetUpdateInterval() { return 0x10000; }	// ~64ms: only checks the idle limit (secs)
 	virtual void InitializeIO(LPBYTE pCxRomPeripheral);
 
 	static BYTE __stdcall IORead(WORD pc, WORD addr, BYTE bWrite, BYTE value, ULONG nExecutedCycles);
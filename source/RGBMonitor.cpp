@@ -522,7 +522,7 @@ static void CopyMixedSource(int x, int y, int sx, int sy, bgra_t *pVideoAddress)
 	}
 
 	const bool bIsHalfScanLines = GetVideo().IsVideoStyle(VS_HALF_SCANLINES);
-	const UINT frameBufferWidth = GetVideo().GetFrameBufferWidth();
+	const int frameBufferRowStride = GetVideo().GetFrameBufferRowStride();
 
 	for (int nBytes=13; nBytes>=0; nBytes--)
 	{
@@ -545,7 +545,7 @@ static void CopyMixedSource(int x, int y, int sx, int sy, bgra_t *pVideoAddress)
 				*(pDst+nBytes) = *reinterpret_cast<const UINT32 *>(&rRGB);
 			}
 
-			pDst -= frameBufferWidth;
+			pDst += frameBufferRowStride;
 		}
 	}
 }
@@ -559,7 +559,7 @@ static void CopySource(int w, int h, int sx, int sy, bgra_t *pVideoAddress, cons
 	const BYTE* const pSrc = g_aSourceStartofLine[ sy ] + sx;
 
 	const bool bIsHalfScanLines = GetVideo().IsVideoStyle(VS_HALF_SCANLINES);
-	const UINT frameBufferWidth = GetVideo().GetFrameBufferWidth();
+	const int frameBufferRowStride = GetVideo().GetFrameBufferRowStride();
 
 	while (h--)
 	{
@@ -578,7 +578,7 @@ static void CopySource(int w, int h, int sx, int sy, bgra_t *pVideoAddress, cons
 			}
 		}
 
-		pDst -= frameBufferWidth;
+		pDst += frameBufferRowStride;
 	}
 }
 
@@ -730,7 +730,7 @@ void UpdateHiResRGBCell(int x, int y, uint16_t addr, bgra_t* pVideoAddress)
 
 	// Second line
 	UINT32* pSrc = (UINT32*)pVideoAddress;
-	pDst = pSrc - GetVideo().GetFrameBufferWidth();
+	pDst = pSrc + GetVideo().GetFrameBufferRowStride();
 	if (bIsHalfScanLines)
 	{
 		// Scanlines
@@ -945,7 +945,7 @@ void UpdateDHiResCellRGB(int x, int y, uint16_t addr, bgra_t* pVideoAddress, boo
 
 	// Second line
 	UINT32* pSrc = (UINT32*)pVideoAddress ;
-	pDst = pSrc - GetVideo().GetFrameBufferWidth();
+	pDst = pSrc + GetVideo().GetFrameBufferRowStride();
 	if (bIsHalfScanLines)
 	{
 		// Scanlines
@@ -1122,7 +1122,7 @@ void UpdateDuochromeCell(int h, int w, bgra_t* pVideoAddress, uint8_t bits, uint
 	UINT32* pDst = (UINT32*)pVideoAddress;
 
 	const bool bIsHalfScanLines = GetVideo().IsVideoStyle(VS_HALF_SCANLINES);
-	const UINT frameBufferWidth = GetVideo().GetFrameBufferWidth();
+	const int frameBufferRowStride = GetVideo().GetFrameBufferRowStride();
 	RGBQUAD colors[2];
 	// use LoRes palette
 	background += 12;
@@ -1156,7 +1156,7 @@ void UpdateDuochromeCell(int h, int w, bgra_t* pVideoAddress, uint8_t bits, uint
 			}
 		}
 
-		pDst -= frameBufferWidth;
+		pDst += frameBufferRowStride;
 	}
 }
 
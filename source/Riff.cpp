@@ -22,6 +22,14 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 */
 
 /* Description: RIFF funcs
+ *
+ * Captures audio sources (stems) to .wav files, without blocking the emulation thread on disk I/O:
+ * . each stem has a bounded, single-producer/single-consumer ring of samples
+ * . RiffPutSamples() (emulation thread) just copies into the ring
+ * . a background writer thread (started by RiffInitWriteFile()/RiffInitWriteStems()) drains the rings to the files,
+ *   and patches the RIFF header sizes on close
+ * If the disk can't keep up for long enough to fill a ring, then RiffPutSamples() drops the whole block rather than
+ * stall emulation. Dropped blocks are counted, and logged by RiffFinishWriteFile().
  *
  * Author: Various
  */
@@ -29,110 +37,341 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "StdAfx.h"
 #include "Riff.h"
 
-static HANDLE g_hRiffFile = INVALID_HANDLE_VALUE;
-static DWORD dwTotalOffset;
-static DWORD dwDataOffset;
-static unsigned int g_NumChannels = 2;
+#include "Log.h"
+#include "StrFormat.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
-bool RiffInitWriteFile(const char* pszFile, unsigned int sample_rate, unsigned int NumChannels)
+struct RiffStream
 {
-	g_hRiffFile = CreateFile(pszFile, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+	RiffStream(void) : writing(false), hFile(INVALID_HANDLE_VALUE), pRing(NULL), sampleRate(0), numChannels(0),
+		head(0), tail(0), droppedBlocks(0), droppedSamples(0), headerWritten(false), failed(false), dataOffset(0) {}
 
-	if(g_hRiffFile == INVALID_HANDLE_VALUE)
-		return false;
+	std::atomic<bool> writing;	// Publishes 'filename' & 'hFile' to the (already running) writer thread
+	std::string filename;
+	HANDLE hFile;				// Writer thread (after Init)
 
-	g_NumChannels = NumChannels;
+	// Set by the producer before the 1st samples are published (by 'head')
+	short* pRing;
+	UINT sampleRate;
+	UINT numChannels;
 
-	//
+	std::atomic<size_t> head;	// Total samples (shorts) put, producer
+	std::atomic<size_t> tail;	// Total samples (shorts) written, writer thread
+
+	// Producer
+	UINT droppedBlocks;
+	size_t droppedSamples;
+
+	// Writer thread
+	bool headerWritten;
+	bool failed;
+	DWORD dataOffset;
+};
+
+static const size_t kRingSize = 1 << 20;	// Shorts (2MB): ~12 secs of 44.1KHz stereo
+static const UINT kWriterPeriodMs = 10;
+
+static RiffStream g_riffStreams[NUM_RIFF_STEMS];
+static std::thread g_riffWriter;
+static std::mutex g_riffMutex;
+static std::condition_variable g_riffWake;
+static bool g_riffQuit = false;
 
+//-----------------------------------------------------------------------------
+
+std::string RiffGetStemName(RIFF_STEM stem)
+{
+	if (stem == RIFF_SPEAKER)
+		return "speaker";
+	if (stem == RIFF_MOCKINGBOARD)
+		return "mockingboard";
+	if (stem < RIFF_SSI263_SLOT0)
+		return StrFormat("mockingboard-s%d", stem - RIFF_MOCKINGBOARD_SLOT0);
+	return StrFormat("ssi263-s%d-%d", (stem - RIFF_SSI263_SLOT0) / 2, (stem - RIFF_SSI263_SLOT0) % 2);
+}
+
+static void RiffWriteHeader(RiffStream& stream)
+{
 	UINT32 temp32;
 	UINT16 temp16;
 
 	DWORD dwNumberOfBytesWritten;
 
-	WriteFile(g_hRiffFile, "RIFF", 4, &dwNumberOfBytesWritten, NULL);
+	WriteFile(stream.hFile, "RIFF", 4, &dwNumberOfBytesWritten, NULL);
 
-	temp32 = 0;				// total size
-	dwTotalOffset = SetFilePointer(g_hRiffFile, 0, NULL, FILE_CURRENT);
-	WriteFile(g_hRiffFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
+	temp32 = 0;				// total size (patched by RiffCloseStream())
+	WriteFile(stream.hFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
 
-	WriteFile(g_hRiffFile, "WAVE", 4, &dwNumberOfBytesWritten, NULL);
+	WriteFile(stream.hFile, "WAVE", 4, &dwNumberOfBytesWritten, NULL);
 
 	//
 
-	WriteFile(g_hRiffFile, "fmt ", 4, &dwNumberOfBytesWritten, NULL);
+	WriteFile(stream.hFile, "fmt ", 4, &dwNumberOfBytesWritten, NULL);
 
 	temp32 = 16;			// format length
-	WriteFile(g_hRiffFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
+	WriteFile(stream.hFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
 
 	temp16 = 1;				// PCM format
-	WriteFile(g_hRiffFile, &temp16, 2, &dwNumberOfBytesWritten, NULL);
+	WriteFile(stream.hFile, &temp16, 2, &dwNumberOfBytesWritten, NULL);
 
-	temp16 = NumChannels;		// channels
-	WriteFile(g_hRiffFile, &temp16, 2, &dwNumberOfBytesWritten, NULL);
+	temp16 = stream.numChannels;	// channels
+	WriteFile(stream.hFile, &temp16, 2, &dwNumberOfBytesWritten, NULL);
 
-	temp32 = sample_rate;	// sample rate
-	WriteFile(g_hRiffFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
+	temp32 = stream.sampleRate;		// sample rate
+	WriteFile(stream.hFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
 
-	temp32 = sample_rate * 2 * NumChannels;	// bytes/second
-	WriteFile(g_hRiffFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
+	temp32 = stream.sampleRate * 2 * stream.numChannels;	// bytes/second
+	WriteFile(stream.hFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
 
-	temp16 = 2 * NumChannels;	// block align
-	WriteFile(g_hRiffFile, &temp16, 2, &dwNumberOfBytesWritten, NULL);
+	temp16 = 2 * stream.numChannels;	// block align
+	WriteFile(stream.hFile, &temp16, 2, &dwNumberOfBytesWritten, NULL);
 
 	temp16 = 16;			// bits/sample
-	WriteFile(g_hRiffFile, &temp16, 2, &dwNumberOfBytesWritten, NULL);
+	WriteFile(stream.hFile, &temp16, 2, &dwNumberOfBytesWritten, NULL);
 
 	//
 
-	WriteFile(g_hRiffFile, "data", 4, &dwNumberOfBytesWritten, NULL);
+	WriteFile(stream.hFile, "data", 4, &dwNumberOfBytesWritten, NULL);
 
-	temp32 = 0;				// data length
-	dwDataOffset = SetFilePointer(g_hRiffFile, 0, NULL, FILE_CURRENT);
-	WriteFile(g_hRiffFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
+	temp32 = 0;				// data length (patched by RiffCloseStream())
+	stream.dataOffset = SetFilePointer(stream.hFile, 0, NULL, FILE_CURRENT);
+	WriteFile(stream.hFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
 
-	return true;
+	stream.headerWritten = true;
 }
 
-bool RiffFinishWriteFile()
+// Writer thread: write all samples published so far
+static void RiffDrainStream(RiffStream& stream)
 {
-	if(g_hRiffFile == INVALID_HANDLE_VALUE)
-		return false;
+	const size_t head = stream.head.load(std::memory_order_acquire);
+	size_t tail = stream.tail.load(std::memory_order_relaxed);
+	if (head == tail)
+		return;
+
+	if (stream.hFile == INVALID_HANDLE_VALUE && !stream.failed)
+	{
+		// Stem's 1st samples
+		stream.hFile = CreateFile(stream.filename.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+		if (stream.hFile == INVALID_HANDLE_VALUE)
+		{
+			LogFileOutput("Riff: Failed to create: %s\n", stream.filename.c_str());
+			stream.failed = true;
+		}
+	}
+
+	if (!stream.failed && !stream.headerWritten)
+		RiffWriteHeader(stream);
+
+	while (tail != head)
+	{
+		const size_t pos = tail & (kRingSize - 1);
+		const size_t size = std::min(head - tail, kRingSize - pos);
+
+		if (!stream.failed)
+		{
+			DWORD dwNumberOfBytesWritten;
+			WriteFile(stream.hFile, &stream.pRing[pos], (DWORD)(size * sizeof(short)), &dwNumberOfBytesWritten, NULL);
+		}
+
+		tail += size;
+		stream.tail.store(tail, std::memory_order_release);
+	}
+}
 
-	//
+static void RiffCloseStream(RiffStream& stream)
+{
+	if (stream.hFile == INVALID_HANDLE_VALUE)
+		return;
+
+	if (!stream.headerWritten)
+	{
+		// No samples: still a valid (empty) .wav, as the file was explicitly requested
+		stream.sampleRate = 44100;
+		stream.numChannels = 1;
+		RiffWriteHeader(stream);
+	}
 
 	UINT32 temp32;
 
 	DWORD dwNumberOfBytesWritten;
-	
-	DWORD fileSize = SetFilePointer(g_hRiffFile, 0, NULL, FILE_END);
 
-	temp32 = fileSize - (dwTotalOffset + 4);
-	SetFilePointer(g_hRiffFile, dwTotalOffset, NULL, FILE_BEGIN);
-	WriteFile(g_hRiffFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
+	DWORD fileSize = SetFilePointer(stream.hFile, 0, NULL, FILE_END);
+
+	temp32 = fileSize - 8;	// total size: all after "RIFF" & this size
+	SetFilePointer(stream.hFile, 4, NULL, FILE_BEGIN);
+	WriteFile(stream.hFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
 
-	temp32 = fileSize - (dwDataOffset + 4);
-	SetFilePointer(g_hRiffFile, dwDataOffset, NULL, FILE_BEGIN);
-	WriteFile(g_hRiffFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
+	temp32 = fileSize - (stream.dataOffset + 4);
+	SetFilePointer(stream.hFile, stream.dataOffset, NULL, FILE_BEGIN);
+	WriteFile(stream.hFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
 
-	return CloseHandle(g_hRiffFile) ? true : false;
+	CloseHandle(stream.hFile);
+	stream.hFile = INVALID_HANDLE_VALUE;
 }
 
-bool RiffPutSamples(const short* buf, unsigned int uSamples)
+static void RiffWriterThread(void)
 {
-	if(g_hRiffFile == INVALID_HANDLE_VALUE)
+	std::unique_lock<std::mutex> lock(g_riffMutex);
+
+	while (true)
+	{
+		// Samples put before RiffFinishWriteFile() set g_riffQuit are drained by this final pass
+		const bool quit = g_riffQuit;
+		lock.unlock();
+
+		for (UINT i = 0; i < NUM_RIFF_STEMS; i++)
+		{
+			if (g_riffStreams[i].writing.load(std::memory_order_acquire))
+				RiffDrainStream(g_riffStreams[i]);
+		}
+
+		lock.lock();
+		if (quit)
+			break;
+
+		g_riffWake.wait_for(lock, std::chrono::milliseconds(kWriterPeriodMs), [] { return g_riffQuit; });
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+// Called by the RiffInit*() functions, so the emulation thread never starts it
+static void RiffStartWriter(void)
+{
+	if (!g_riffWriter.joinable())
+	{
+		g_riffQuit = false;
+		g_riffWriter = std::thread(RiffWriterThread);
+	}
+}
+
+bool RiffInitWriteFile(RIFF_STEM stem, const char* pszFile)
+{
+	RiffStream& stream = g_riffStreams[stem];
+	_ASSERT(!stream.writing);
+
+	// Create it now (rather than on the 1st samples) to report failure
+	stream.hFile = CreateFile(pszFile, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+
+	if(stream.hFile == INVALID_HANDLE_VALUE)
 		return false;
 
+	stream.filename = pszFile;
+	stream.writing.store(true, std::memory_order_release);
+	RiffStartWriter();
+	return true;
+}
+
+// All stems (not already being written) are written to "<prefix>-<stem name>.wav", each created on its 1st samples
+void RiffInitWriteStems(const char* pszPrefix)
+{
+	for (UINT i = 0; i < NUM_RIFF_STEMS; i++)
+	{
+		RiffStream& stream = g_riffStreams[i];
+		if (stream.writing)
+			continue;
+
+		stream.filename = std::string(pszPrefix) + "-" + RiffGetStemName((RIFF_STEM)i) + ".wav";
+		stream.writing.store(true, std::memory_order_release);
+	}
+
+	RiffStartWriter();
+}
+
+bool RiffFinishWriteFile()
+{
+	bool writing = false;
+	for (UINT i = 0; i < NUM_RIFF_STEMS; i++)
+		writing |= g_riffStreams[i].writing;
+
+	if (!writing)
+		return false;
+
+	if (g_riffWriter.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(g_riffMutex);
+			g_riffQuit = true;
+		}
+		g_riffWake.notify_one();
+		g_riffWriter.join();
+	}
+
+	for (UINT i = 0; i < NUM_RIFF_STEMS; i++)
+	{
+		RiffStream& stream = g_riffStreams[i];
+		if (stream.droppedBlocks)
+			LogFileOutput("Riff: %s: %u blocks (%u samples) dropped\n", stream.filename.c_str(), stream.droppedBlocks, (UINT)stream.droppedSamples);
+
+		RiffCloseStream(stream);
+		delete [] stream.pRing;
+		stream.pRing = NULL;
+		stream.writing = false;
+		stream.filename.clear();
+		stream.head = stream.tail = 0;
+		stream.droppedBlocks = 0;
+		stream.droppedSamples = 0;
+		stream.headerWritten = stream.failed = false;
+	}
+
+	return true;
+}
+
+bool RiffIsWriting(RIFF_STEM stem)
+{
+	return g_riffStreams[stem].writing;
+}
+
+UINT RiffGetDroppedBlocks(RIFF_STEM stem)
+{
+	return g_riffStreams[stem].droppedBlocks;
+}
+
+// NB. A stem's sample rate & # channels must be the same for every call
+bool RiffPutSamples(RIFF_STEM stem, const short* buf, unsigned int uSamples, unsigned int sample_rate, unsigned int NumChannels)
+{
+	RiffStream& stream = g_riffStreams[stem];
+	if (!stream.writing)
+		return false;
+
+	if (!stream.pRing)
+	{
+		stream.pRing = new short[kRingSize];
+		stream.sampleRate = sample_rate;
+		stream.numChannels = NumChannels;
+	}
+	_ASSERT(stream.sampleRate == sample_rate && stream.numChannels == NumChannels);
+
 	//
 
-	DWORD dwNumberOfBytesWritten;
+	size_t head = stream.head.load(std::memory_order_relaxed);
+	size_t size = (size_t)uSamples * NumChannels;
 
-	BOOL bRes = WriteFile(
-		g_hRiffFile,
-		buf,
-		uSamples * sizeof(short) * g_NumChannels,
-		&dwNumberOfBytesWritten,
-		NULL);
+	const size_t space = kRingSize - (head - stream.tail.load(std::memory_order_acquire));
+	if (size > space)
+	{
+		// Ring is full, so the disk isn't keeping up: drop the block rather than wait for the writer
+		stream.droppedBlocks++;
+		stream.droppedSamples += uSamples;
+		g_riffWake.notify_one();
+		return false;
+	}
+
+	while (size)
+	{
+		const size_t pos = head & (kRingSize - 1);
+		const size_t chunk = std::min(size, kRingSize - pos);
+		memcpy(&stream.pRing[pos], buf, chunk * sizeof(short));
+
+		buf += chunk;
+		size -= chunk;
+		head += chunk;
+	}
+	stream.head.store(head, std::memory_order_release);
 
 	return true;
 }
@@ -1,5 +1,21 @@
 #pragma once
 
-bool RiffInitWriteFile(const char* pszFile, unsigned int sample_rate, unsigned int NumChannels);
+#include "Card.h"
+
+// Audio sources that can be captured, each to its own .wav file
+enum RIFF_STEM
+{
+	RIFF_SPEAKER,
+	RIFF_MOCKINGBOARD,								// All Mockingboards (mixed, as output)
+	RIFF_MOCKINGBOARD_SLOT0,						// Each Mockingboard: + slot
+	RIFF_SSI263_SLOT0 = RIFF_MOCKINGBOARD_SLOT0 + NUM_SLOTS,	// Each SSI263: + slot*2 + device
+	NUM_RIFF_STEMS = RIFF_SSI263_SLOT0 + NUM_SLOTS * 2
+};
+
+bool RiffInitWriteFile(RIFF_STEM stem, const char* pszFile);
+void RiffInitWriteStems(const char* pszPrefix);
 bool RiffFinishWriteFile();
-bool RiffPutSamples(const short* buf, unsigned int uSamples);
+bool RiffIsWriting(RIFF_STEM stem);
+UINT RiffGetDroppedBlocks(RIFF_STEM stem);	// Blocks RiffPutSamples() dropped, as the writer wasn't keeping up
+bool RiffPutSamples(RIFF_STEM stem, const short* buf, unsigned int uSamples, unsigned int sample_rate, unsigned int NumChannels);
+std::string RiffGetStemName(RIFF_STEM stem);
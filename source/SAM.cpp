@@ -58,7 +58,7 @@ BYTE __stdcall SAMCard::IOWrite(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG n
 	// with the SAM data. The mute gets reset after the speaker code detects
 	// silence.
 
-	// use existing speaker code to bring timing up to date
+	// use existing speaker code to record the edge at this cycle
 	BYTE res = SpkrToggle(pc, addr, bWrite, d, nExecutedCycles);
 
 	// The DAC in the SAM uses unsigned 8 bit samples
@@ -75,7 +75,7 @@ BYTE __stdcall SAMCard::IOWrite(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG n
 	//                                                        
 	// SAM is 8 bit, PC WAV is 16 so shift audio to the MSB (<< 8)
 
-	g_nSpeakerData = (d ^ 0x80) << 8;
+	SpkrSetLevel((short)((d ^ 0x80) << 8));
 
 	// make speaker quieter so eg: a metronome click through the
 	// Apple speaker is softer vs. the analogue SAM output.
@@ -21,6 +21,7 @@ public:
 	virtual void Destroy() {}
 	virtual void Reset(const bool powerCycle) {}
 	virtual void Update(const ULONG nExecutedCycles) {}
+	virtual UINT GetUpdateInterval() { return kUpdateNever; }
 
 	virtual void InitializeIO(LPBYTE pCxRomPeripheral);
 
@@ -52,9 +52,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "CPU.h"
 #include "Log.h"
 #include "Memory.h"
+#include "Riff.h"
 #include "SoundCore.h"
 #include "SSI263.h"
-#include "SSI263Phonemes.h"
 
 #include "YamlHelper.h"
 
@@ -365,7 +365,7 @@ void SSI263::Play(unsigned int nPhoneme)
 	else
 		nPhoneme-=2;	// Missing phoneme-1
 
-	m_phonemeLengthRemaining = g_nPhonemeInfo[nPhoneme].nLength;
+	m_phonemeLengthRemaining = SSI263PhonemeCache::GetLength(nPhoneme);
 
 	m_phonemeAccurateLengthRemaining = m_phonemeLengthRemaining;
 	m_phonemePlaybackAndDebugger = (g_nAppMode == MODE_STEPPING || g_nAppMode == MODE_DEBUG);
@@ -385,7 +385,7 @@ void SSI263::Play(unsigned int nPhoneme)
 	}
 	else
 	{
-		m_pPhonemeData = (const short*) &g_nPhonemeData[g_nPhonemeInfo[nPhoneme].nOffset];
+		m_pPhonemeData = m_phonemeCache.GetSamples(nPhoneme);
 	}
 
 	m_currSampleSum = 0;
@@ -700,6 +700,9 @@ void SSI263::Update()
 
 	m_byteOffset = (m_byteOffset + (uint32_t)nNumSamples*sizeof(short)*m_kNumChannels) % m_kDSBufferByteSize;
 
+	if (m_device <= 1)
+		RiffPutSamples((RIFF_STEM)(RIFF_SSI263_SLOT0 + m_slot * 2 + m_device), &m_mixBufferSSI263[0], nNumSamples, SAMPLE_RATE_SSI263, m_kNumChannels);
+
 	//
 
 	if (bSpeechIRQ)
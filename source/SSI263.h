@@ -1,6 +1,7 @@
 #pragma once
 
 #include "MockingboardDefs.h"
+#include "SSI263Phonemes.h"
 
 class SSI263
 {
@@ -163,6 +164,7 @@ private:
 	PHASOR_MODE m_cardMode;
 	bool m_hasSC01;
 	short* m_pPhonemeData00;
+	SSI263PhonemeCache m_phonemeCache;	// Decoded samples of the last non-pause phoneme played
 
 	// ctor/power-cycle: Set to -1
 	// Play(): Set to [$00-$3F] on a write to DURPHON register.
@@ -0,0 +1,134 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2025, Tom Charlesworth, Michael Pohoreski
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: SSI263 phoneme bank encoder (see SSI263Phonemes.cpp for the format)
+ *
+ * Only built into the ssi263phonemes tool (which generates SSI263PhonemeData.h) & TestSSI263: the emulator just decodes.
+ *
+ * Author: Various
+ */
+
+#include "StdAfx.h"
+
+#include "SSI263PhonemeEncoder.h"
+#include "SSI263Phonemes.h"
+
+class PhonemeBitWriter
+{
+public:
+	PhonemeBitWriter(std::vector<BYTE>& data) : m_data(data), m_bits(0), m_numBits(0) {}
+
+	void Write(UINT value, UINT n)
+	{
+		while (n--)
+			WriteBit((value >> n) & 1);
+	}
+
+	void WriteUnary(UINT n)
+	{
+		while (n--)
+			WriteBit(0);
+		WriteBit(1);
+	}
+
+	void Align(void)
+	{
+		while (m_numBits)
+			WriteBit(0);
+	}
+
+private:
+	void WriteBit(UINT bit)
+	{
+		m_bits = (m_bits << 1) | bit;
+		if (++m_numBits == 8)
+		{
+			m_data.push_back((BYTE)m_bits);
+			m_bits = 0;
+			m_numBits = 0;
+		}
+	}
+
+	std::vector<BYTE>& m_data;
+	UINT m_bits;
+	UINT m_numBits;
+};
+
+//-----------------------------------------------------------------------------
+
+// Encode 'length' samples, byte-aligned, onto the end of 'data'
+// . for each block, the order & k are those giving the fewest bits (ties: the lowest order, then the lowest k)
+void SSI263PhonemeEncode(const short* pSamples, UINT length, std::vector<BYTE>& data)
+{
+	const UINT kBlockSize = SSI263PhonemeCache::kBlockSize;
+	PhonemeBitWriter writer(data);
+
+	int x1 = 0, x2 = 0, x3 = 0;
+	UINT u[kBlockSize];
+
+	for (UINT start = 0; start < length; start += kBlockSize)
+	{
+		const UINT blockSize = (length - start < kBlockSize) ? length - start : kBlockSize;
+		const short* pBlock = &pSamples[start];
+
+		UINT64 bestBits = 0;
+		UINT bestOrder = 0, bestK = 0;
+		for (UINT order = 0; order < 4; order++)
+		{
+			int y1 = x1, y2 = x2, y3 = x3;
+			for (UINT i = 0; i < blockSize; i++)
+			{
+				const int residual = pBlock[i] - SSI263PhonemeCache::Predict(order, y1, y2, y3);
+				u[i] = (residual >= 0) ? (UINT)residual << 1 : (((UINT)-residual) << 1) - 1;
+				y3 = y2; y2 = y1; y1 = pBlock[i];
+			}
+
+			for (UINT k = 0; k < 32; k++)
+			{
+				UINT64 bits = 0;
+				for (UINT i = 0; i < blockSize; i++)
+					bits += (u[i] >> k) + 1 + k;
+
+				if ((order == 0 && k == 0) || bits < bestBits)
+				{
+					bestBits = bits;
+					bestOrder = order;
+					bestK = k;
+				}
+			}
+		}
+
+		writer.Write(bestOrder, 2);
+		writer.Write(bestK, 5);
+		for (UINT i = 0; i < blockSize; i++)
+		{
+			const int residual = pBlock[i] - SSI263PhonemeCache::Predict(bestOrder, x1, x2, x3);
+			const UINT v = (residual >= 0) ? (UINT)residual << 1 : (((UINT)-residual) << 1) - 1;
+			writer.WriteUnary(v >> bestK);
+			writer.Write(v & ((1u << bestK) - 1), bestK);
+			x3 = x2; x2 = x1; x1 = pBlock[i];
+		}
+	}
+
+	writer.Align();
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+// SSI263 phoneme bank encoder: for the ssi263phonemes tool & TestSSI263 (not part of the emulator)
+
+void SSI263PhonemeEncode(const short* pSamples, UINT length, std::vector<BYTE>& data);	// Appends the phoneme, as SSI263PhonemeCache::Decode() reads it
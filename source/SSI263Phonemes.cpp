@@ -0,0 +1,134 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2025, Tom Charlesworth, Michael Pohoreski
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: SSI263 phoneme bank (compressed, decoded on demand)
+ *
+ * The phonemes are 16-bit PCM at the SSI263's output rate, so decoding gives samples that SSI263::Update()
+ * can play directly. Each SSI263 decodes just the phoneme it's playing (a few KB), rather than every binary
+ * carrying (and paging in) the whole uncompressed bank.
+ *
+ * Format (lossless): each phoneme starts on a byte boundary, and is a bitstream (MSB first) of blocks of
+ * kBlockSize samples (the last block may be shorter). Each block is:
+ * . order (2 bits): fixed polynomial predictor from the previous samples (x1 = previous sample, etc):
+ *     0: 0,  1: x1,  2: 2*x1 - x2,  3: 3*x1 - 3*x2 + x3
+ *   (the samples before the start of the phoneme are 0)
+ * . k (5 bits): Rice parameter
+ * . for each sample, its residual (sample - prediction) zigzag-encoded to u, then Rice coded:
+ *   (u >> k) 0-bits, a 1-bit, then the low k bits of u
+ * The encoder (SSI263PhonemeEncoder.cpp) picks the order & k that give each block the fewest bits.
+ * SSI263PhonemeData.h is its output, generated by the ssi263phonemes tool from the original PCM.
+ *
+ * Author: Various
+ */
+
+#include "StdAfx.h"
+
+#include "SSI263Phonemes.h"
+#include "SSI263PhonemeData.h"
+
+class PhonemeBitReader
+{
+public:
+	PhonemeBitReader(const BYTE* pData) : m_pData(pData), m_bits(0), m_numBits(0) {}
+
+	UINT Read(UINT n)
+	{
+		UINT value = 0;
+		while (n--)
+			value = (value << 1) | ReadBit();
+		return value;
+	}
+
+	UINT ReadUnary(void)
+	{
+		UINT n = 0;
+		while (ReadBit() == 0)
+			n++;
+		return n;
+	}
+
+private:
+	UINT ReadBit(void)
+	{
+		if (m_numBits == 0)
+		{
+			m_bits = *m_pData++;
+			m_numBits = 8;
+		}
+		m_numBits--;
+		return (m_bits >> m_numBits) & 1;
+	}
+
+	const BYTE* m_pData;
+	UINT m_bits;
+	UINT m_numBits;
+};
+
+//-----------------------------------------------------------------------------
+
+UINT SSI263PhonemeCache::GetLength(UINT phoneme)
+{
+	_ASSERT(phoneme < kNumPhonemes);
+	return g_nPhonemeInfo[phoneme].nLength;
+}
+
+// Decode all GetLength() samples of 'phoneme' into pOut
+void SSI263PhonemeCache::Decode(UINT phoneme, short* pOut)
+{
+	_ASSERT(phoneme < kNumPhonemes);
+	PhonemeBitReader reader(&g_nPhonemeData[g_nPhonemeInfo[phoneme].nOffset]);
+
+	int x1 = 0, x2 = 0, x3 = 0;
+	UINT remaining = g_nPhonemeInfo[phoneme].nLength;
+
+	while (remaining)
+	{
+		const UINT order = reader.Read(2);
+		const UINT k = reader.Read(5);
+		const UINT blockSize = (remaining < kBlockSize) ? remaining : kBlockSize;
+
+		for (UINT i = 0; i < blockSize; i++)
+		{
+			const UINT u = (reader.ReadUnary() << k) | reader.Read(k);
+			const int residual = (u & 1) ? -(int)((u + 1) >> 1) : (int)(u >> 1);
+
+			const int x = Predict(order, x1, x2, x3) + residual;
+			*pOut++ = (short)x;
+			x3 = x2; x2 = x1; x1 = x;
+		}
+
+		remaining -= blockSize;
+	}
+}
+
+const short* SSI263PhonemeCache::GetSamples(UINT phoneme)
+{
+	if (m_phoneme != (int)phoneme)
+	{
+		m_samples.resize(GetLength(phoneme));
+		Decode(phoneme, &m_samples[0]);
+		m_phoneme = phoneme;
+	}
+
+	return &m_samples[0];
+}
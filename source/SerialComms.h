@@ -28,6 +28,7 @@ public:
 	CSuperSerialCard(UINT slot);
 	virtual ~CSuperSerialCard();
 	virtual void Update(const ULONG nExecutedCycles) {}
+	virtual UINT GetUpdateInterval() { return kUpdateNever; }
 	virtual void InitializeIO(LPBYTE pCxRomPeripheral);
 	virtual void Reset(const bool powerCycle);
 	virtual void Destroy() {}
@@ -29,6 +29,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "StdAfx.h"
 
 #include "Speaker.h"
+#include "BLEPSynth.h"
 #include "Core.h"
 #include "CPU.h"
 #include "Interface.h"
@@ -68,9 +69,8 @@ const short		SPKR_DATA_INIT = (short)0x8000;
 short		g_nSpeakerData	= SPKR_DATA_INIT;
 static UINT		g_nBufferIdx	= 0;		// Frame index (ie. not sample index, as each frame contains g_nSPKR_NumChannels samples)
 
-static short*	g_pRemainderBuffer = NULL;
-static UINT		g_nRemainderBufferSize;		// Setup in SpkrInitialize()
-static UINT		g_nRemainderBufferIdx;		// Setup in SpkrInitialize()
+static BLEPSynth	g_speakerSynth;				// Renders the speaker edges (see SpkrToggle()) to samples
+static short*	g_pSynthBuffer = NULL;		// Mono samples from g_speakerSynth
 
 // Application-wide globals:
 double		    g_fClksPerSpkrSample;		// Setup in SetClksPerSpkrSample()
@@ -95,13 +95,6 @@ static void    Spkr_DSUninit();
 
 //-----------------------------------------------------------------------------
 
-static bool g_bSpkrOutputToRiff = false;
-
-void Spkr_OutputToRiff()
-{
-	g_bSpkrOutputToRiff = true;
-}
-
 UINT Spkr_GetNumChannels()
 {
 	return g_nSPKR_NumChannels;
@@ -133,7 +126,7 @@ static void DisplayBenchmarkResults()
 //
 // The approach works as follows:
 // - SpkrToggle() is called when the speaker state is flipped by accessing $C030
-// - This brings audio up to date then calls ResetDCFilter()
+// - This records the edge then calls ResetDCFilter()
 // - ResetDCFilter() sets a counter to a high value
 // - every audio sample is processed by DCFilter() as follows:
 //   - if the counter is >= 32768, the speaker has been recently toggled
@@ -211,8 +204,7 @@ static void PadNFrames(short* dest, uint32_t sizeBytes)
 		{
 			QueueOneFrame(dest, index, g_nSpeakerData);
 		}
-		if (g_bSpkrOutputToRiff)
-			RiffPutSamples(dest, numFrames);
+		RiffPutSamples(RIFF_SPEAKER, dest, numFrames, SPKR_SAMPLE_RATE, g_nSPKR_NumChannels);
 	}
 }
 
@@ -230,20 +222,12 @@ static void SetClksPerSpkrSample()
 
 //=============================================================================
 
-static void InitRemainderBuffer()
+static void InitSynth()
 {
-	delete [] g_pRemainderBuffer;
-
 	SetClksPerSpkrSample();
 
-	g_nRemainderBufferSize = (UINT) g_fClksPerSpkrSample;
-	if ((double)g_nRemainderBufferSize < g_fClksPerSpkrSample)
-		g_nRemainderBufferSize++;
-
-	g_pRemainderBuffer = new short [g_nRemainderBufferSize];
-	memset(g_pRemainderBuffer, 0, g_nRemainderBufferSize);
-
-	g_nRemainderBufferIdx = 0;
+	g_speakerSynth.Initialize(g_fClksPerSpkrSample);
+	g_speakerSynth.Reset(g_nCumulativeCycles, g_nSpeakerData);
 }
 
 //
@@ -259,10 +243,10 @@ void SpkrDestroy()
 	//
 
 	delete [] g_pSpeakerBuffer;
-	delete [] g_pRemainderBuffer;
+	delete [] g_pSynthBuffer;
 		
 	g_pSpeakerBuffer = NULL;
-	g_pRemainderBuffer = NULL;
+	g_pSynthBuffer = NULL;
 }
 
 //=============================================================================
@@ -294,9 +278,10 @@ void SpkrInitialize()
 
 	//
 
-	InitRemainderBuffer();
+	InitSynth();
 
 	g_pSpeakerBuffer = new short[SPKR_SAMPLE_RATE * g_nSPKR_NumChannels];	// Buffer can hold a max of 1 seconds worth of samples
+	g_pSynthBuffer = new short[SPKR_SAMPLE_RATE];
 }
 
 //=============================================================================
@@ -304,7 +289,7 @@ void SpkrInitialize()
 // NB. Called when /g_fCurrentCLK6502/ changes
 void SpkrReinitialize()
 {
-	InitRemainderBuffer();
+	InitSynth();
 }
 
 //=============================================================================
@@ -315,7 +300,7 @@ void SpkrReset()
 	g_nSpkrQuietCycleCount = 0;
 	g_bSpkrToggleFlag = false;
 
-	InitRemainderBuffer();
+	InitSynth();
 	Spkr_SubmitWaveBuffer(NULL, 0);
 	Spkr_SetActive(false);
 	Spkr_Unmute();
@@ -323,65 +308,23 @@ void SpkrReset()
 
 //=============================================================================
 
-static void ReinitRemainderBuffer(UINT nCyclesRemaining)
-{
-	if(nCyclesRemaining == 0)
-		return;
-
-	for(g_nRemainderBufferIdx=0; g_nRemainderBufferIdx<nCyclesRemaining; g_nRemainderBufferIdx++)
-		g_pRemainderBuffer[g_nRemainderBufferIdx] = g_nSpeakerData;
-
-	_ASSERT(g_nRemainderBufferIdx < g_nRemainderBufferSize);
-}
-
-static void UpdateRemainderBuffer(ULONG* pnCycleDiff)
+// Render the edges recorded since the last update (ie. a whole block at once)
+static void UpdateSpkr()
 {
-	if(g_nRemainderBufferIdx)
+	if (!g_bFullSpeed || SoundCore_GetTimerState())
 	{
-		while((g_nRemainderBufferIdx < g_nRemainderBufferSize) && *pnCycleDiff)
-		{
-			g_pRemainderBuffer[g_nRemainderBufferIdx] = g_nSpeakerData;
-			g_nRemainderBufferIdx++;
-			(*pnCycleDiff)--;
-		}
-
-		if(g_nRemainderBufferIdx == g_nRemainderBufferSize)
-		{
-			g_nRemainderBufferIdx = 0;
-			signed long nSampleMean = 0;
-			for(UINT i=0; i<g_nRemainderBufferSize; i++)
-				nSampleMean += (signed long) g_pRemainderBuffer[i];
-			nSampleMean /= (signed long) g_nRemainderBufferSize;
+		const UINT nMaxSamples = (SPKR_SAMPLE_RATE - 1) - g_nBufferIdx;
+		const UINT nNumSamples = g_speakerSynth.Render(g_nCumulativeCycles, g_pSynthBuffer, nMaxSamples);
 
-			if (g_nBufferIdx < SPKR_SAMPLE_RATE - 1)
-			{
-				QueueOneFrame(g_pSpeakerBuffer, g_nBufferIdx, (short)nSampleMean);
-			}
-		}
+		for (UINT i = 0; i < nNumSamples; i++)
+			QueueOneFrame(g_pSpeakerBuffer, g_nBufferIdx, g_pSynthBuffer[i]);
+	}
+	else
+	{
+		g_speakerSynth.Reset(g_nCumulativeCycles, g_nSpeakerData);
 	}
-}
-
-static void UpdateSpkr()
-{
-  if(!g_bFullSpeed || SoundCore_GetTimerState())
-  {
-	  ULONG nCycleDiff = (ULONG) (g_nCumulativeCycles - g_nSpkrLastCycle);
-
-	  UpdateRemainderBuffer(&nCycleDiff);
-
-	  ULONG nNumSamples = (ULONG) ((double)nCycleDiff / g_fClksPerSpkrSample);
-
-	  ULONG nCyclesRemaining = (ULONG) ((double)nCycleDiff - (double)nNumSamples * g_fClksPerSpkrSample);
-
-	  while ((nNumSamples--) && (g_nBufferIdx < SPKR_SAMPLE_RATE - 1))
-	  {
-			QueueOneFrame(g_pSpeakerBuffer, g_nBufferIdx, (short)g_nSpeakerData);
-	  }
-
-	  ReinitRemainderBuffer(nCyclesRemaining);	// Partially fill 1Mhz sample buffer
-  }
 
-  g_nSpkrLastCycle = g_nCumulativeCycles;
+	g_nSpkrLastCycle = g_nCumulativeCycles;
 }
 
 //=============================================================================
@@ -404,7 +347,8 @@ BYTE __stdcall SpkrToggle(WORD, WORD, BYTE, BYTE, ULONG nExecutedCycles)
 
 	CpuCalcCycles(nExecutedCycles);
 
-	UpdateSpkr();
+	if (g_speakerSynth.IsEdgeListFull())
+		UpdateSpkr();
 
 	short speakerDriveLevel = SPKR_DATA_INIT;
 	if (g_bQuieterSpeaker)	// quieten the speaker if 8 bit DAC in use
@@ -419,9 +363,18 @@ BYTE __stdcall SpkrToggle(WORD, WORD, BYTE, BYTE, ULONG nExecutedCycles)
 	else
 		g_nSpeakerData = speakerDriveLevel;
 
+	g_speakerSynth.AddEdge(g_nCumulativeCycles, g_nSpeakerData);
+
 	return MemReadFloatingBus(nExecutedCycles);
 }
 
+// Set the speaker level directly (eg. from an 8-bit DAC), at the cycle of the preceding SpkrToggle()
+void SpkrSetLevel(short level)
+{
+	g_nSpeakerData = level;
+	g_speakerSynth.SetLevel(g_nCumulativeCycles, level);
+}
+
 //=============================================================================
 
 // Called by ContinueExecution()
@@ -598,15 +551,13 @@ static ULONG Spkr_SubmitWaveBuffer_FullSpeed(short* pSpeakerBuffer, ULONG nNumSa
 			}
 			
 			memcpy(pDSLockedBuffer0, &pSpeakerBuffer[0], dwBufferSize0);
-			if (g_bSpkrOutputToRiff)
-				RiffPutSamples(pDSLockedBuffer0, BytesToFrames(dwBufferSize0));
+			RiffPutSamples(RIFF_SPEAKER, pDSLockedBuffer0, BytesToFrames(dwBufferSize0), SPKR_SAMPLE_RATE, g_nSPKR_NumChannels);
 			nNumSamples = BytesToFrames(dwBufferSize0);
 
 			if(pDSLockedBuffer1 && dwBufferSize1)
 			{
 				memcpy(pDSLockedBuffer1, &pSpeakerBuffer[dwDSLockedBufferSize0/sizeof(short)], dwBufferSize1);
-				if (g_bSpkrOutputToRiff)
-					RiffPutSamples(pDSLockedBuffer1, BytesToFrames(dwBufferSize1));
+				RiffPutSamples(RIFF_SPEAKER, pDSLockedBuffer1, BytesToFrames(dwBufferSize1), SPKR_SAMPLE_RATE, g_nSPKR_NumChannels);
 				nNumSamples += BytesToFrames(dwBufferSize1);
 			}
 		}
@@ -742,14 +693,12 @@ static ULONG Spkr_SubmitWaveBuffer(short* pSpeakerBuffer, ULONG nNumSamples)
 		}
 
 		memcpy(pDSLockedBuffer0, &pSpeakerBuffer[0], dwDSLockedBufferSize0);
-		if (g_bSpkrOutputToRiff)
-			RiffPutSamples(pDSLockedBuffer0, BytesToFrames(dwDSLockedBufferSize0));
+		RiffPutSamples(RIFF_SPEAKER, pDSLockedBuffer0, BytesToFrames(dwDSLockedBufferSize0), SPKR_SAMPLE_RATE, g_nSPKR_NumChannels);
 
 		if(pDSLockedBuffer1)
 		{
 			memcpy(pDSLockedBuffer1, &pSpeakerBuffer[dwDSLockedBufferSize0/sizeof(short)], dwDSLockedBufferSize1);
-			if (g_bSpkrOutputToRiff)
-				RiffPutSamples(pDSLockedBuffer1, BytesToFrames(dwDSLockedBufferSize1));
+			RiffPutSamples(RIFF_SPEAKER, pDSLockedBuffer1, BytesToFrames(dwDSLockedBufferSize1), SPKR_SAMPLE_RATE, g_nSPKR_NumChannels);
 		}
 
 		// Commit sound buffer
@@ -923,6 +872,7 @@ void SpkrLoadSnapshot(YamlLoadHelper& yamlLoadHelper)
 		return;
 
 	g_nSpkrLastCycle = yamlLoadHelper.LoadUint64(SS_YAML_KEY_LASTCYCLE);
+	g_speakerSynth.Reset(g_nSpkrLastCycle, g_nSpeakerData);
 
 	yamlLoadHelper.PopMap();
 }
@@ -16,9 +16,9 @@ void    Spkr_Mute();
 void    Spkr_Unmute();
 bool    Spkr_IsActive();
 bool    Spkr_DSInit();
-void	Spkr_OutputToRiff();
 UINT    Spkr_GetNumChannels();
 void    SpkrSaveSnapshot(class YamlSaveHelper& yamlSaveHelper);
 void    SpkrLoadSnapshot(class YamlLoadHelper& yamlLoadHelper);
 
 BYTE __stdcall SpkrToggle (WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG nExecutedCycles);
+void    SpkrSetLevel (short level);
@@ -49,3 +49,12 @@ BYTE __stdcall TapeWrite(WORD, WORD address, BYTE, BYTE, ULONG nExecutedCycles)
 {
 	return 0;
 }
+
+// For idle-loop detection: # of cycles that TAPEIN reads return the same value without side-effects
+UINT TapeGetIdlePollCycles(ULONG nExecutedCycles)
+{
+	if (g_Apple2Type == A2TYPE_PRAVETS8A)
+		return 0;
+
+	return (UINT)-1;	// Not connected
+}
@@ -83,6 +83,9 @@ typedef int socklen_t;
 // Dest MAC + Source MAC + Ether Type
 #define ETH_MINIMUM_SIZE (6 + 6 + 2)
 
+// Min cycles between the on-demand updates, as reading a packet is 1 access per byte (~1ms, as the old periodic Update())
+#define U2_ACCESS_UPDATE_CYCLES 1000
+
 // #define U2_LOG_VERBOSE
 // #define U2_LOG_TRAFFIC
 // #define U2_LOG_STATE
@@ -92,6 +95,7 @@ typedef int socklen_t;
 #define MAC_DEST(p) p[0], p[1], p[2], p[3], p[4], p[5]
 #define MAC_SOURCE(p) p[6], p[7], p[8], p[9], p[10], p[11]
 
+#include "CPU.h"
 #include "Memory.h"
 #include "Log.h"
 
@@ -1363,6 +1367,7 @@ void Uthernet2::Reset(const bool powerCycle)
 {
     LogFileOutput("U2: Uthernet II initialisation\n");
     myModeRegister = 0;
+    myLastUpdateCycles = g_nCumulativeCycles;
 
     if (powerCycle)
     {
@@ -1414,6 +1419,8 @@ BYTE Uthernet2::IO_C0(WORD programcounter, WORD address, BYTE write, BYTE value,
 {
     BYTE res = write ? 0 : MemReadFloatingBus(nCycles);
 
+    updateOnAccess(nCycles);
+
 #ifdef U2_LOG_VERBOSE
     const uint16_t oldAddress = myDataAddress;
 #endif
@@ -1526,8 +1533,20 @@ void Uthernet2::getMACAddress(const uint32_t address, const MACAddress * & mac)
     }
 }
 
+// The guest only sees the network through the card's registers, so bring the card up to date before they are accessed.
+// Then the periodic Update() (see GetUpdateInterval()) only needs to keep the host side going while the guest is busy elsewhere.
+void Uthernet2::updateOnAccess(const ULONG nExecutedCycles)
+{
+    CpuCalcCycles(nExecutedCycles);
+    if (g_nCumulativeCycles - myLastUpdateCycles >= U2_ACCESS_UPDATE_CYCLES)
+    {
+        Update(0);
+    }
+}
+
 void Uthernet2::Update(const ULONG nExecutedCycles)
 {
+    myLastUpdateCycles = g_nCumulativeCycles;
     myNetworkBackend->update(nExecutedCycles);
     for (Socket &socket : mySockets)
     {
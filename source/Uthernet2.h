@@ -73,6 +73,7 @@ public:
     virtual void InitializeIO(LPBYTE pCxRomPeripheral);
     virtual void Reset(const bool powerCycle);
     virtual void Update(const ULONG nExecutedCycles);
+    virtual UINT GetUpdateInterval() { return 0x4000; } // ~16ms: IO_C0() updates the card on demand
     virtual void SaveSnapshot(YamlSaveHelper &yamlSaveHelper);
     virtual bool LoadSnapshot(YamlLoadHelper &yamlLoadHelper, UINT version);
 
@@ -96,6 +97,7 @@ private:
     uint8_t myModeRegister;
     uint16_t myDataAddress;
     std::shared_ptr<NetworkBackend> myNetworkBackend;
+    unsigned __int64 myLastUpdateCycles;    // g_nCumulativeCycles at the last Update()
 
     // the real Uthernet II card does not have a ARP Cache
     // but in the interest of speeding up the emulator
@@ -135,6 +137,8 @@ private:
 
     void setCommandRegister(const size_t i, const uint8_t value);
 
+    void updateOnAccess(const ULONG nExecutedCycles);
+
     uint8_t readSocketRegister(const uint16_t address);
     uint8_t readValueAt(const uint16_t address);
 
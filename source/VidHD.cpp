@@ -127,48 +127,111 @@ bgra_t ConvertIIgs2RGB(Color color)
 	return rgb;
 }
 
-void VidHDCard::UpdateSHRCell(bool is640Mode, bool isColorFillMode, uint16_t addrPalette, bgra_t* pVideoAddress, uint32_t a)
+// The SHR palette last used, converted to bgra_t (and doubled for 320 mode's 2 framebuffer pixels per pixel)
+// . only re-converted when the palette's 16 entries differ, so normally not for each scanline (or each call)
+static uint16_t g_shrPaletteIIgs[16];
+static bgra_t g_shrPalette[16];
+static uint64_t g_shrPalette2[16];
+static bool g_shrPaletteValid = false;
+
+static void UpdateSHRPalette(const uint8_t* pPalette)
 {
-	_ASSERT(!is640Mode);		// to do: test this mode
+	if (g_shrPaletteValid && memcmp(pPalette, g_shrPaletteIIgs, sizeof(g_shrPaletteIIgs)) == 0)
+		return;
 
-	Color* palette = (Color*) MemGetAuxPtr(addrPalette);
+	memcpy(g_shrPaletteIIgs, pPalette, sizeof(g_shrPaletteIIgs));
 
-	for (UINT i = 0; i < 4; i++)
+	const Color* palette = (const Color*) pPalette;
+	for (UINT i = 0; i < 16; i++)
 	{
-		if (!is640Mode) // 320 mode
-		{
-			BYTE pixel1 = (a >> 4) & 0xf;
-			bgra_t color1 = ConvertIIgs2RGB(palette[pixel1]);
-			if (isColorFillMode && pixel1 == 0) color1 = *(pVideoAddress - 1);
-			*pVideoAddress++ = color1;
-			*pVideoAddress++ = color1;
-
-			BYTE pixel2 = a & 0xf;
-			bgra_t color2 = ConvertIIgs2RGB(palette[pixel2]);
-			if (isColorFillMode && pixel2 == 0) color2 = color1;
-			*pVideoAddress++ = color2;
-			*pVideoAddress++ = color2;
-		}
-		else // 640 mode - see IIgs Hardware Ref, Pg.96, Table4-21 'Color Selection in 640 mode'
-		{
-			BYTE pixel1 = (a >> 6) & 0x3;
-			bgra_t color1 = ConvertIIgs2RGB(palette[0x8 + pixel1]);
-			*pVideoAddress++ = color1;
-
-			BYTE pixel2 = (a >> 4) & 0x3;
-			bgra_t color2 = ConvertIIgs2RGB(palette[0xC + pixel2]);
-			*pVideoAddress++ = color2;
-
-			BYTE pixel3 = (a >> 2) & 0x3;
-			bgra_t color3 = ConvertIIgs2RGB(palette[0x0 + pixel3]);
-			*pVideoAddress++ = color3;
-
-			BYTE pixel4 = a & 0x3;
-			bgra_t color4 = ConvertIIgs2RGB(palette[0x4 + pixel4]);
-			*pVideoAddress++ = color4;
-		}
-
-		a >>= 8;
+		g_shrPalette[i] = ConvertIIgs2RGB(palette[i]);
+
+		bgra_t pair[2] = { g_shrPalette[i], g_shrPalette[i] };
+		memcpy(&g_shrPalette2[i], pair, sizeof(pair));
+	}
+
+	g_shrPaletteValid = true;
+}
+
+// 320 mode: 2 pixels per byte, each is 2 framebuffer pixels
+static bgra_t* UpdateSHRBytes320(const uint8_t* pPixels, UINT bytes, bgra_t* pVideoAddress)
+{
+	for (; bytes; bytes--)
+	{
+		const uint8_t a = *pPixels++;
+		memcpy(pVideoAddress + 0, &g_shrPalette2[a >> 4], sizeof(uint64_t));
+		memcpy(pVideoAddress + 2, &g_shrPalette2[a & 0xf], sizeof(uint64_t));
+		pVideoAddress += 4;
+	}
+
+	return pVideoAddress;
+}
+
+// 640 mode: 4 pixels per byte - see IIgs Hardware Ref, Pg.96, Table4-21 'Color Selection in 640 mode'
+static bgra_t* UpdateSHRBytes640(const uint8_t* pPixels, UINT bytes, bgra_t* pVideoAddress)
+{
+	for (; bytes; bytes--)
+	{
+		const uint8_t a = *pPixels++;
+		pVideoAddress[0] = g_shrPalette[0x8 + ((a >> 6) & 0x3)];
+		pVideoAddress[1] = g_shrPalette[0xC + ((a >> 4) & 0x3)];
+		pVideoAddress[2] = g_shrPalette[0x0 + ((a >> 2) & 0x3)];
+		pVideoAddress[3] = g_shrPalette[0x4 + (a & 0x3)];
+		pVideoAddress += 4;
+	}
+
+	return pVideoAddress;
+}
+
+// 320 fill mode: a pixel of colour 0 repeats the previous pixel (for the 1st, the framebuffer pixel to its left)
+static void UpdateSHRFill320(const uint8_t* pPixels, UINT bytes, bgra_t* pVideoAddress)
+{
+	for (; bytes; bytes--)
+	{
+		const uint8_t a = *pPixels++;
+
+		if ((a & 0xf0) == 0)
+			pVideoAddress[0] = pVideoAddress[1] = pVideoAddress[-1];
+
+		if ((a & 0x0f) == 0)
+			pVideoAddress[2] = pVideoAddress[3] = pVideoAddress[1];
+
+		pVideoAddress += 4;
+	}
+}
+
+// Render 'cells' video cycles (4 bytes each) of SHR scanline 'line', starting at cell [0..39]
+// . the scanline's control byte & palette are the same for all of them, as memory can't change mid-call
+void VidHDCard::UpdateSHRLine(UINT line, UINT cell, UINT cells, bgra_t* pVideoAddress)
+{
+	const uint8_t c = *MemGetAuxPtr(0x9D00 + line);	// scan-line control byte
+
+	const bool is640Mode = !!(c & 0x80);
+	const bool isColorFillMode = !!(c & 0x20) && !is640Mode;
+	const UINT paletteSelectCode = c & 0xf;
+	const UINT kColorsPerPalette = 16;
+	const UINT kColorSize = 2;
+	UpdateSHRPalette(MemGetAuxPtr(0x9E00 + paletteSelectCode * kColorsPerPalette * kColorSize));
+
+	const UINT kBytesPerScanline = 160;
+	const UINT kBytesPerCell = 4;
+	UINT addr = 0x2000 + kBytesPerScanline * line + kBytesPerCell * cell;
+	UINT bytes = kBytesPerCell * cells;
+
+	// A page at a time, as MemGetAuxPtr() is per page (NB. a cell never straddles pages)
+	while (bytes)
+	{
+		const UINT pageBytes = std::min<UINT>(bytes, 0x100 - (addr & 0xFF));
+		const uint8_t* pPixels = MemGetAuxPtr(addr);
+
+		bgra_t* pNext = is640Mode ? UpdateSHRBytes640(pPixels, pageBytes, pVideoAddress)
+								  : UpdateSHRBytes320(pPixels, pageBytes, pVideoAddress);
+		if (isColorFillMode)
+			UpdateSHRFill320(pPixels, pageBytes, pVideoAddress);
+
+		pVideoAddress = pNext;
+		addr += pageBytes;
+		bytes -= pageBytes;
 	}
 }
 
@@ -28,6 +28,7 @@ public:
 	virtual void Destroy() {}
 	virtual void Reset(const bool powerCycle);
 	virtual void Update(const ULONG nExecutedCycles) {}
+	virtual UINT GetUpdateInterval() { return kUpdateNever; }
 	virtual void InitializeIO(LPBYTE pCxRomPeripheral);
 
 	static BYTE __stdcall IORead(WORD pc, WORD addr, BYTE bWrite, BYTE value, ULONG nExecutedCycles);
@@ -38,7 +39,7 @@ public:
 	bool IsDHGRBlackAndWhite() { return (m_NEWVIDEO & (1 << 5)) ? true : false; }
 	bool IsWriteAux();
 
-	static void UpdateSHRCell(bool is640Mode, bool isColorFillMode, uint16_t addrPalette, bgra_t* pVideoAddress, uint32_t a);
+	static void UpdateSHRLine(UINT line, UINT cell, UINT cells, bgra_t* pVideoAddress);
 
 	static const std::string& GetSnapshotCardName();
 	virtual void SaveSnapshot(YamlSaveHelper& yamlSaveHelper);
@@ -37,6 +37,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "NTSC.h"
 #include "RGBMonitor.h"
 #include "VidHD.h"
+#include "VideoCapture.h"
 #include "YamlHelper.h"
 
 #define  SW_80COL         (g_uVideoMode & VF_80COL)
@@ -140,13 +141,19 @@ int Video::GetFrameBufferCentringValue()
 
 	if (HasVidHD())
 	{
-		value -= GetFrameBufferCentringOffsetY() * GetFrameBufferWidth();
+		value += GetFrameBufferCentringOffsetY() * GetFrameBufferRowStride();
 		value += GetFrameBufferCentringOffsetX();
 	}
 
 	return value;
 }
 
+int Video::GetFrameBufferRowStride()
+{
+	const int width = (int)GetFrameBufferWidth();
+	return IsFrameBufferTopDown() ? width : -width;
+}
+
 //===========================================================================
 
 void Video::VideoReinitialize(bool bInitVideoScannerAddress)
@@ -560,17 +567,17 @@ void Video::Video_MakeScreenShot(FILE *pFile, const VideoScreenShot_e ScreenShot
 	// Write Pixel Data
 	// No need to use GetDibBits() since we already have http://msdn.microsoft.com/en-us/library/ms532334.aspx
 	// @reference: "Storing an Image" http://msdn.microsoft.com/en-us/library/ms532340(VS.85).aspx
-	pSrc = (uint32_t*) g_pFramebufferbits;
+	// The .bmp is bottom-up, so start at the bottom row (inside the borders) and go up the screen
+	const int nRowUp = -GetFrameBufferRowStride();
+	const UINT yBottom = GetFrameBufferBorderHeight() + GetFrameBufferBorderlessHeight() - 1;	// from the top of the screen
 
-	int xSrc = GetFrameBufferBorderWidth();
-	int ySrc = GetFrameBufferBorderHeight();
-
-	pSrc += xSrc;								// Skip left border
-	pSrc += ySrc * GetFrameBufferWidth();		// Skip top border
+	pSrc = (uint32_t*) g_pFramebufferbits;
+	pSrc += GetFrameBufferBorderWidth();		// Skip left border
+	pSrc += (IsFrameBufferTopDown() ? yBottom : (GetFrameBufferHeight() - 1 - yBottom)) * GetFrameBufferWidth();
 
 	if( ScreenShotType == SCREENSHOT_280x192 )
 	{
-		pSrc += GetFrameBufferWidth();	// Start on odd scanline (otherwise for 50% scanline mode get an all black image!)
+		pSrc += nRowUp;	// Start on odd scanline (otherwise for 50% scanline mode get an all black image!)
 
 		uint32_t  aScanLine[kVideoWidthIIgs / 2];	// Big enough to contain both a 280 or 320 line
 		uint32_t *pDst;
@@ -580,15 +587,15 @@ void Video::Video_MakeScreenShot(FILE *pFile, const VideoScreenShot_e ScreenShot
 		// NOTE: Keep in sync with _Video_RedrawScreen() & Video_MakeScreenShot()
 		for( UINT y = 0; y < GetFrameBufferBorderlessHeight()/2; y++ )
 		{
+			const uint32_t *pRow = pSrc;
 			pDst = aScanLine;
 			for( UINT x = 0; x < GetFrameBufferBorderlessWidth()/2; x++ )
 			{
-				*pDst++ = pSrc[1]; // correction for left edge loss of scaled scanline [Bill Buckel, B#18928]
-				pSrc += 2; // skip odd pixels
+				*pDst++ = pRow[1]; // correction for left edge loss of scaled scanline [Bill Buckel, B#18928]
+				pRow += 2; // skip odd pixels
 			}
 			fwrite( aScanLine, sizeof(uint32_t), GetFrameBufferBorderlessWidth()/2, pFile );
-			pSrc += GetFrameBufferWidth();			// scan lines doubled - skip odd ones
-			pSrc += GetFrameBufferBorderWidth()*2;	// Skip right border & next line's left border
+			pSrc += 2 * nRowUp;	// scan lines doubled - skip odd ones
 		}
 	}
 	else
@@ -596,7 +603,7 @@ void Video::Video_MakeScreenShot(FILE *pFile, const VideoScreenShot_e ScreenShot
 		for( UINT y = 0; y < GetFrameBufferBorderlessHeight(); y++ )
 		{
 			fwrite( pSrc, sizeof(uint32_t), GetFrameBufferBorderlessWidth(), pFile );
-			pSrc += GetFrameBufferWidth();
+			pSrc += nRowUp;
 		}
 	}
 
@@ -609,6 +616,60 @@ void Video::Video_MakeScreenShot(FILE *pFile, const VideoScreenShot_e ScreenShot
 
 //===========================================================================
 
+// The borderless frame's top-left pixel
+const uint32_t* Video::GetFrameBufferBorderlessTopLeft()
+{
+	const uint32_t* pTopLeft = (const uint32_t*) g_pFramebufferbits;
+	pTopLeft += GetFrameBufferBorderWidth();
+	pTopLeft += (IsFrameBufferTopDown() ? GetFrameBufferBorderHeight() : (GetFrameBufferHeight() - 1 - GetFrameBufferBorderHeight())) * GetFrameBufferWidth();
+	return pTopLeft;
+}
+
+// Same .bmp as Video_MakeScreenShot(), but written by VideoCapture's writer thread
+void Video::Video_QueueScreenShot(const char* pScreenShotFileName, const VideoScreenShot_e ScreenShotType)
+{
+	const uint32_t* pSrc = GetFrameBufferBorderlessTopLeft();
+	const int nRowDown = GetFrameBufferRowStride();
+
+	if( ScreenShotType == SCREENSHOT_280x192 )
+	{
+		// Same pixels as Video_MakeScreenShot(): every other scanline (starting with the top one) & the odd pixels
+		const UINT width = GetFrameBufferBorderlessWidth()/2;
+		const UINT height = GetFrameBufferBorderlessHeight()/2;
+		std::vector<uint32_t> aFrame(width * height);
+		for( UINT y = 0; y < height; y++ )
+		{
+			const uint32_t *pRow = pSrc + 2 * (int)y * nRowDown;
+			for( UINT x = 0; x < width; x++ )
+				aFrame[y * width + x] = pRow[2 * x + 1];
+		}
+		VideoCaptureScreenShot(pScreenShotFileName, &aFrame[0], width, height, width);
+	}
+	else
+	{
+		VideoCaptureScreenShot(pScreenShotFileName, pSrc, GetFrameBufferBorderlessWidth(), GetFrameBufferBorderlessHeight(), nRowDown);
+	}
+}
+
+// Emulation thread: hand the frame being presented to VideoCapture (if capturing), once per emulated frame
+// . AppleWin presents each emulated frame, but the common2 frontends present once per host frame (eg. at 50 or 144Hz)
+// . at full-speed the frames aren't captured, as AppleWin doesn't present them (but they're still counted)
+void Video::Video_CaptureFrame()
+{
+	if (!VideoCaptureIsWriting())
+		return;
+
+	const UINT cyclesPerFrame = NTSC_GetCyclesPerFrame();
+	const UINT frames = VideoCaptureNewFrames(g_nCumulativeCycles, cyclesPerFrame);
+	if (!frames || g_bFullSpeed)
+		return;
+
+	const double fps = g_fCurrentCLK6502 / cyclesPerFrame;
+	VideoCapturePutFrame(GetFrameBufferBorderlessTopLeft(), GetFrameBufferBorderlessWidth(), GetFrameBufferBorderlessHeight(), GetFrameBufferRowStride(), fps, frames);
+}
+
+//===========================================================================
+
 bool Video::ReadVideoRomFile(const char* pRomFile)
 {
 	g_videoRomSize = 0;
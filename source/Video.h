@@ -199,6 +199,7 @@ public:
 		g_videoRomSize = 0;
 		g_videoRomRockerSwitch = false;
 		m_hasVidHD = false;
+		m_frameBufferTopDown = false;
 	}
 
 	~Video() {}
@@ -219,6 +220,12 @@ public:
 	UINT GetFrameBufferCentringOffsetY();
 	int GetFrameBufferCentringValue();
 
+	// The framebuffer's rows are bottom-up (as a Windows DIB), unless the frame asks for top-down before FrameBase::Initialize()
+	bool IsFrameBufferTopDown() { return m_frameBufferTopDown; }
+	void SetFrameBufferTopDown(bool topDown) { m_frameBufferTopDown = topDown; }
+	int GetFrameBufferRowStride();	// # pixels from a row to the row below it on the screen (ie. -ve for bottom-up)
+	const uint32_t* GetFrameBufferBorderlessTopLeft();
+
 	COLORREF GetMonochromeRGB() { return g_nMonochromeRGB; }
 	void SetMonochromeRGB(COLORREF colorRef) { g_nMonochromeRGB = colorRef; }
 
@@ -254,6 +261,8 @@ public:
 	void Video_SetBitmapHeader(WinBmpHeader_t *pBmp, int nWidth, int nHeight, int nBitsPerPixel);
 
 	void Video_MakeScreenShot(FILE* pFile, const VideoScreenShot_e ScreenShotType);
+	void Video_QueueScreenShot(const char* pScreenShotFileName, const VideoScreenShot_e ScreenShotType);
+	void Video_CaptureFrame();
 
 	BYTE VideoSetMode(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG uExecutedCycles);
 
@@ -305,6 +314,7 @@ private:
 	bool g_bVideoScannerNTSC;	// NTSC video scanning (or PAL)
 	COLORREF g_nMonochromeRGB;	// saved to Registry
 	bool m_hasVidHD;
+	bool m_frameBufferTopDown;
 
 	static const UINT kVideoRomSize8K = kVideoRomSize4K*2;
 	static const UINT kVideoRomSize16K = kVideoRomSize8K*2;
@@ -0,0 +1,565 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2025, Tom Charlesworth, Michael Pohoreski
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: Video capture
+ *
+ * Captures frame sequences & screenshots, without blocking the emulation thread on encoding or disk I/O:
+ * . VideoCapturePutFrame() (emulation thread) just copies the frame into a free buffer of a fixed pool
+ * . a background writer thread encodes the buffers (.png, YUV4MPEG2 or raw BGRA) and returns them to the pool
+ * If the writer can't keep up for long enough to use up the pool, then frames are dropped (and counted) rather than
+ * the emulation thread waiting. A stream fills a dropped frame's slot with the previous frame, so its timing is kept.
+ * Frames are numbered in emulated frames (VideoCaptureNewFrames()), not in calls: a frontend may present once per host
+ * frame (eg. at 50 or 144Hz), but the stream is at the emulated frame rate.
+ *
+ * Author: Various
+ */
+
+#include "StdAfx.h"
+#include "VideoCapture.h"
+
+#include "Log.h"
+#include "StrFormat.h"
+
+#include "zlib.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+struct VideoCaptureFrame
+{
+	VideoCaptureFrame(void) : width(0), height(0), number(0) {}
+
+	std::vector<uint32_t> pixels;	// 0xAARRGGBB (ie. bgra_t), top-down
+	UINT width;
+	UINT height;
+	UINT number;					// Frames put before this one (incl. dropped ones)
+	std::string screenShotFile;		// .bmp screenshot, else a captured frame
+};
+
+static const UINT kNumFrameBuffers = 16;	// ~0.25 secs of 60Hz frames (~13MB of 560x384)
+static const int kPngCompression = Z_BEST_SPEED;
+
+static VideoCaptureFrame g_captureFrames[kNumFrameBuffers];
+static std::vector<VideoCaptureFrame*> g_captureFree;	// g_captureMutex
+static std::deque<VideoCaptureFrame*> g_captureReady;	// g_captureMutex
+static std::thread g_captureWriter;
+static std::mutex g_captureMutex;
+static std::condition_variable g_captureWake;
+static bool g_captureQuit = false;
+
+// Set before the writer thread starts
+static bool g_captureWriting = false;
+static VIDEO_CAPTURE_FORMAT g_captureFormat = VIDEO_CAPTURE_PNG;
+static std::string g_capturePath;
+
+// Producer
+static UINT g_captureNumber = 0;
+static bool g_captureCounting = false;
+static UINT64 g_captureCycles = 0;		// At the last VideoCaptureNewFrames()
+static UINT g_captureFrameCycles = 0;	// Into the current emulated frame
+static double g_captureFps = 0.0;	// Published with the 1st frame
+static std::atomic<UINT> g_captureDropped(0);
+
+// Writer thread
+static FILE* g_captureFile = NULL;
+static bool g_captureFailed = false;
+static bool g_captureSizeWarned = false;
+static UINT g_captureStreamWidth = 0;
+static UINT g_captureStreamHeight = 0;
+static UINT g_captureStreamNumber = 0;				// Next frame # to write to the stream
+static std::vector<BYTE> g_captureStreamFrame;		// The last frame written to the stream, encoded
+static std::vector<BYTE> g_capturePngRows;
+static std::vector<BYTE> g_capturePngData;
+
+//-----------------------------------------------------------------------------
+
+static void Write32BE(BYTE* p, UINT value)
+{
+	p[0] = (BYTE)(value >> 24);
+	p[1] = (BYTE)(value >> 16);
+	p[2] = (BYTE)(value >> 8);
+	p[3] = (BYTE)value;
+}
+
+static void Write32LE(BYTE* p, UINT value)
+{
+	p[0] = (BYTE)value;
+	p[1] = (BYTE)(value >> 8);
+	p[2] = (BYTE)(value >> 16);
+	p[3] = (BYTE)(value >> 24);
+}
+
+static void WritePngChunk(FILE* pFile, const char* pType, const BYTE* pData, UINT size)
+{
+	BYTE buf[4];
+	Write32BE(buf, size);
+	fwrite(buf, 1, 4, pFile);
+	fwrite(pType, 1, 4, pFile);
+	if (size)
+		fwrite(pData, 1, size, pFile);
+
+	uLong crc = crc32(0, (const Bytef*)pType, 4);
+	if (size)
+		crc = crc32(crc, pData, size);
+	Write32BE(buf, (UINT)crc);
+	fwrite(buf, 1, 4, pFile);
+}
+
+// 24-bit RGB .png, each row "Up" filtered (so the doubled scanlines cost next to nothing)
+static bool WritePng(const std::string& filename, const VideoCaptureFrame& frame)
+{
+	const size_t rowSize = 1 + frame.width * 3;
+	g_capturePngRows.resize(rowSize * frame.height);
+
+	BYTE* pRow = &g_capturePngRows[0];
+	for (UINT y = 0; y < frame.height; y++, pRow += rowSize)
+	{
+		const uint32_t* pSrc = &frame.pixels[y * frame.width];
+		BYTE* pDst = pRow + 1;
+		for (UINT x = 0; x < frame.width; x++, pDst += 3)
+		{
+			pDst[0] = (BYTE)(pSrc[x] >> 16);	// r
+			pDst[1] = (BYTE)(pSrc[x] >> 8);		// g
+			pDst[2] = (BYTE)pSrc[x];			// b
+		}
+
+		pRow[0] = y ? 2 : 0;	// Up : None
+	}
+
+	// Filter bottom-up, so each row is still unfiltered when the row below it uses it
+	for (UINT y = frame.height - 1; y > 0; y--)
+	{
+		BYTE* pDst = &g_capturePngRows[y * rowSize + 1];
+		const BYTE* pUp = pDst - rowSize;
+		for (size_t i = 0; i < rowSize - 1; i++)
+			pDst[i] -= pUp[i];
+	}
+
+	uLongf size = compressBound((uLong)g_capturePngRows.size());
+	g_capturePngData.resize(size);
+	if (compress2(&g_capturePngData[0], &size, &g_capturePngRows[0], (uLong)g_capturePngRows.size(), kPngCompression) != Z_OK)
+		return false;
+
+	FILE* pFile = fopen(filename.c_str(), "wb");
+	if (!pFile)
+		return false;
+
+	static const BYTE kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	fwrite(kSignature, 1, sizeof(kSignature), pFile);
+
+	BYTE header[13];
+	Write32BE(&header[0], frame.width);
+	Write32BE(&header[4], frame.height);
+	header[8] = 8;		// bit depth
+	header[9] = 2;		// colour type: RGB
+	header[10] = 0;		// compression: deflate
+	header[11] = 0;		// filter method: adaptive
+	header[12] = 0;		// no interlace
+	WritePngChunk(pFile, "IHDR", header, sizeof(header));
+	WritePngChunk(pFile, "IDAT", &g_capturePngData[0], (UINT)size);
+	WritePngChunk(pFile, "IEND", NULL, 0);
+
+	const bool ok = !ferror(pFile);
+	return (fclose(pFile) == 0) && ok;
+}
+
+// 32-bit .bmp (bottom-up), as Video::Video_MakeScreenShot()
+static bool WriteBmp(const std::string& filename, const VideoCaptureFrame& frame)
+{
+	FILE* pFile = fopen(filename.c_str(), "wb");
+	if (!pFile)
+		return false;
+
+	const UINT kHeaderSize = 14 + 40;
+	const UINT imageSize = frame.width * frame.height * sizeof(uint32_t);
+
+	BYTE header[kHeaderSize] = {};
+	header[0] = 'B';
+	header[1] = 'M';
+	Write32LE(&header[0x02], kHeaderSize + imageSize);	// file size
+	Write32LE(&header[0x0A], kHeaderSize);				// offset of the pixels
+	Write32LE(&header[0x0E], 40);						// BITMAPINFOHEADER size
+	Write32LE(&header[0x12], frame.width);
+	Write32LE(&header[0x16], frame.height);
+	header[0x1A] = 1;									// planes
+	header[0x1C] = 32;									// bits per pixel (BI_RGB, no palette)
+	fwrite(header, 1, kHeaderSize, pFile);
+
+	for (UINT y = frame.height; y > 0; y--)
+		fwrite(&frame.pixels[(y - 1) * frame.width], sizeof(uint32_t), frame.width, pFile);
+
+	const bool ok = !ferror(pFile);
+	return (fclose(pFile) == 0) && ok;
+}
+
+//-----------------------------------------------------------------------------
+
+// Encode for the stream into g_captureStreamFrame
+static void EncodeStreamFrame(const VideoCaptureFrame& frame)
+{
+	const size_t numPixels = (size_t)frame.width * frame.height;
+
+	if (g_captureFormat == VIDEO_CAPTURE_RAW)
+	{
+		g_captureStreamFrame.resize(numPixels * sizeof(uint32_t));
+		memcpy(&g_captureStreamFrame[0], &frame.pixels[0], numPixels * sizeof(uint32_t));
+		return;
+	}
+
+	// YUV4MPEG2: "FRAME\n", then the Y, Cb & Cr planes (BT.601, studio range)
+	static const char kFrameHeader[] = "FRAME\n";
+	const size_t kFrameHeaderSize = sizeof(kFrameHeader) - 1;
+	g_captureStreamFrame.resize(kFrameHeaderSize + numPixels * 3);
+	memcpy(&g_captureStreamFrame[0], kFrameHeader, kFrameHeaderSize);
+
+	BYTE* pY = &g_captureStreamFrame[kFrameHeaderSize];
+	BYTE* pCb = pY + numPixels;
+	BYTE* pCr = pCb + numPixels;
+	const uint32_t* pSrc = &frame.pixels[0];
+	for (size_t i = 0; i < numPixels; i++)
+	{
+		const int r = (pSrc[i] >> 16) & 0xFF, g = (pSrc[i] >> 8) & 0xFF, b = pSrc[i] & 0xFF;
+		pY[i]  = (BYTE)(((  66 * r + 129 * g +  25 * b + 128) >> 8) +  16);
+		pCb[i] = (BYTE)((( -38 * r -  74 * g + 112 * b + 128) >> 8) + 128);
+		pCr[i] = (BYTE)((( 112 * r -  94 * g -  18 * b + 128) >> 8) + 128);
+	}
+}
+
+static void WriteStreamFrame(const VideoCaptureFrame& frame)
+{
+	if (!g_captureFile)
+	{
+		// 1st frame: its size is the stream's
+		if (g_capturePath == "-")
+		{
+#ifdef _WIN32
+			_setmode(_fileno(stdout), _O_BINARY);
+#endif
+			g_captureFile = stdout;
+		}
+		else
+		{
+			g_captureFile = fopen(g_capturePath.c_str(), "wb");
+			if (!g_captureFile)
+			{
+				LogFileOutput("VideoCapture: Failed to create: %s\n", g_capturePath.c_str());
+				g_captureFailed = true;
+				return;
+			}
+		}
+
+		g_captureStreamWidth = frame.width;
+		g_captureStreamHeight = frame.height;
+		g_captureStreamNumber = frame.number;
+
+		if (g_captureFormat == VIDEO_CAPTURE_Y4M)
+		{
+			const UINT fps1000 = (UINT)(g_captureFps * 1000.0 + 0.5);
+			const std::string header = StrFormat("YUV4MPEG2 W%u H%u F%u:1000 Ip A1:1 C444\n", frame.width, frame.height, fps1000);
+			fwrite(header.c_str(), 1, header.size(), g_captureFile);
+		}
+	}
+
+	// A stream's frames can't change size (eg. VidHD's SHR), so repeat the previous frame instead
+	const bool sameSize = frame.width == g_captureStreamWidth && frame.height == g_captureStreamHeight;
+	if (!sameSize && !g_captureSizeWarned)
+	{
+		LogFileOutput("VideoCapture: Frame size changed from %ux%u to %ux%u: repeating the previous frame\n",
+			g_captureStreamWidth, g_captureStreamHeight, frame.width, frame.height);
+		g_captureSizeWarned = true;
+	}
+
+	// Fill the slots of dropped frames with the previous frame
+	for (; g_captureStreamNumber < frame.number; g_captureStreamNumber++)
+		fwrite(&g_captureStreamFrame[0], 1, g_captureStreamFrame.size(), g_captureFile);
+
+	if (sameSize)
+		EncodeStreamFrame(frame);
+
+	if (!g_captureStreamFrame.empty())
+		fwrite(&g_captureStreamFrame[0], 1, g_captureStreamFrame.size(), g_captureFile);
+	g_captureStreamNumber++;
+}
+
+static void WriteFrame(const VideoCaptureFrame& frame)
+{
+	if (!frame.screenShotFile.empty())
+	{
+		if (!WriteBmp(frame.screenShotFile, frame))
+			LogFileOutput("VideoCapture: Failed to write: %s\n", frame.screenShotFile.c_str());
+		return;
+	}
+
+	if (g_captureFailed)
+		return;
+
+	if (g_captureFormat == VIDEO_CAPTURE_PNG)
+	{
+		const std::string filename = StrFormat("%s-%06u.png", g_capturePath.c_str(), frame.number);
+		if (!WritePng(filename, frame))
+		{
+			LogFileOutput("VideoCapture: Failed to write: %s\n", filename.c_str());
+			g_captureFailed = true;
+		}
+		return;
+	}
+
+	WriteStreamFrame(frame);
+}
+
+static void VideoCaptureWriterThread(void)
+{
+	std::unique_lock<std::mutex> lock(g_captureMutex);
+
+	while (true)
+	{
+		if (!g_captureReady.empty())
+		{
+			VideoCaptureFrame* pFrame = g_captureReady.front();
+			g_captureReady.pop_front();
+			lock.unlock();
+
+			WriteFrame(*pFrame);
+
+			lock.lock();
+			if (pFrame->screenShotFile.empty())
+				g_captureFree.push_back(pFrame);
+			else
+				delete pFrame;
+			continue;
+		}
+
+		// Frames put before VideoCaptureFinish() set g_captureQuit have all been written
+		if (g_captureQuit)
+			break;
+
+		g_captureWake.wait(lock);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+static void VideoCaptureStartWriter(void)
+{
+	if (!g_captureWriter.joinable())
+	{
+		g_captureQuit = false;
+		g_captureWriter = std::thread(VideoCaptureWriterThread);
+	}
+}
+
+static void CopyFrame(VideoCaptureFrame& frame, const uint32_t* pPixels, UINT width, UINT height, int pitch)
+{
+	frame.width = width;
+	frame.height = height;
+	frame.pixels.resize((size_t)width * height);	// NB. Only allocates for a buffer's 1st (or a bigger) frame
+
+	uint32_t* pDst = &frame.pixels[0];
+	for (UINT y = 0; y < height; y++, pDst += width, pPixels += pitch)
+		memcpy(pDst, pPixels, width * sizeof(uint32_t));
+}
+
+static void QueueFrame(VideoCaptureFrame* pFrame)
+{
+	{
+		std::lock_guard<std::mutex> lock(g_captureMutex);
+		g_captureReady.push_back(pFrame);
+	}
+	g_captureWake.notify_one();
+}
+
+bool VideoCaptureParseFormat(const char* pszFormat, VIDEO_CAPTURE_FORMAT& format)
+{
+	if (strcmp(pszFormat, "png") == 0)
+		format = VIDEO_CAPTURE_PNG;
+	else if (strcmp(pszFormat, "y4m") == 0)
+		format = VIDEO_CAPTURE_Y4M;
+	else if (strcmp(pszFormat, "raw") == 0)
+		format = VIDEO_CAPTURE_RAW;
+	else
+		return false;
+
+	return true;
+}
+
+// PNG: pszPath is the prefix of each frame's filename. Y4M & RAW: pszPath is the stream's file, or "-" for stdout.
+bool VideoCaptureInit(const char* pszPath, VIDEO_CAPTURE_FORMAT format)
+{
+	_ASSERT(!g_captureWriting);
+	if (g_captureWriting || !pszPath || !*pszPath)
+		return false;
+
+	g_capturePath = pszPath;
+	g_captureFormat = format;
+	g_captureNumber = 0;
+	g_captureCounting = false;
+	g_captureDropped = 0;
+	g_captureFps = 0.0;
+
+	{
+		std::lock_guard<std::mutex> lock(g_captureMutex);
+		g_captureFree.clear();
+		for (UINT i = 0; i < kNumFrameBuffers; i++)
+			g_captureFree.push_back(&g_captureFrames[i]);
+	}
+
+	g_captureWriting = true;
+	return true;
+}
+
+// Also waits for any screenshots to be written
+bool VideoCaptureFinish()
+{
+	if (g_captureWriter.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(g_captureMutex);
+			g_captureQuit = true;
+		}
+		g_captureWake.notify_one();
+		g_captureWriter.join();
+	}
+
+	if (!g_captureWriting)
+		return false;
+
+	if (g_captureFile)
+	{
+		// Fill the slots of the last frames, if they were dropped (the writer has finished)
+		for (; g_captureStreamNumber < g_captureNumber; g_captureStreamNumber++)
+			fwrite(&g_captureStreamFrame[0], 1, g_captureStreamFrame.size(), g_captureFile);
+
+		if (g_captureFile == stdout)
+			fflush(stdout);
+		else
+			fclose(g_captureFile);
+		g_captureFile = NULL;
+	}
+
+	if (g_captureDropped)
+		LogFileOutput("VideoCapture: %u of %u frames dropped\n", (UINT)g_captureDropped, g_captureNumber);
+
+	g_captureWriting = false;
+	g_captureFailed = g_captureSizeWarned = false;
+	g_captureStreamFrame.clear();
+	g_capturePath.clear();
+	for (UINT i = 0; i < kNumFrameBuffers; i++)
+		std::vector<uint32_t>().swap(g_captureFrames[i].pixels);
+
+	return true;
+}
+
+bool VideoCaptureIsWriting()
+{
+	return g_captureWriting;
+}
+
+UINT VideoCaptureGetDroppedFrames()
+{
+	return g_captureDropped;
+}
+
+// The emulated frames since the last call, from the emulated cycles: 0 if a host presents more often (eg. at 144Hz),
+// or more than 1 if less often (eg. at 50Hz)
+// . the 1st call (or after a discontinuity, eg. a snapshot load) is 1 frame, and starts half a frame in: so a caller
+//   presenting each emulated frame (give or take an opcode's cycles) gets exactly 1 frame each time
+UINT VideoCaptureNewFrames(UINT64 cycles, UINT cyclesPerFrame)
+{
+	if (!g_captureWriting || !cyclesPerFrame)
+		return 0;
+
+	const UINT kMaxFrames = 60;	// Any more, and it's not a host's refresh rate
+
+	if (!g_captureCounting || cycles < g_captureCycles || cycles - g_captureCycles > (UINT64)kMaxFrames * cyclesPerFrame)
+	{
+		g_captureCounting = true;
+		g_captureCycles = cycles;
+		g_captureFrameCycles = cyclesPerFrame / 2;
+		return 1;
+	}
+
+	g_captureFrameCycles += (UINT)(cycles - g_captureCycles);
+	g_captureCycles = cycles;
+
+	const UINT frames = g_captureFrameCycles / cyclesPerFrame;
+	g_captureFrameCycles %= cyclesPerFrame;
+	return frames;
+}
+
+// NB. Never waits for the writer thread: if all the buffers are still queued, then the frame is dropped
+bool VideoCapturePutFrame(const uint32_t* pPixels, UINT width, UINT height, int pitch, double fps, UINT frames/*=1*/)
+{
+	if (!g_captureWriting || !frames)
+		return false;
+
+	if (!g_captureNumber)
+	{
+		g_captureFps = fps;
+		VideoCaptureStartWriter();
+	}
+
+	// The frames in between weren't presented (eg. by a 50Hz host): a stream repeats the previous frame for them
+	g_captureNumber += frames - 1;
+
+	VideoCaptureFrame* pFrame = NULL;
+	{
+		std::lock_guard<std::mutex> lock(g_captureMutex);
+		if (!g_captureFree.empty())
+		{
+			pFrame = g_captureFree.back();
+			g_captureFree.pop_back();
+		}
+	}
+
+	if (!pFrame)
+	{
+		g_captureDropped++;
+		g_captureNumber++;
+		return true;
+	}
+
+	CopyFrame(*pFrame, pPixels, width, height, pitch);
+	pFrame->number = g_captureNumber++;
+	QueueFrame(pFrame);
+	return true;
+}
+
+// Screenshots aren't from the pool, so are never dropped
+bool VideoCaptureScreenShot(const char* pszFile, const uint32_t* pPixels, UINT width, UINT height, int pitch)
+{
+	VideoCaptureFrame* pFrame = new VideoCaptureFrame;
+	CopyFrame(*pFrame, pPixels, width, height, pitch);
+	pFrame->screenShotFile = pszFile;
+
+	VideoCaptureStartWriter();
+	QueueFrame(pFrame);
+	return true;
+}
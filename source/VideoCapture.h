@@ -0,0 +1,23 @@
+#pragma once
+
+// Video capture (frame sequences & screenshots), encoded and written by a background thread
+enum VIDEO_CAPTURE_FORMAT
+{
+	VIDEO_CAPTURE_PNG,	// <prefix>-<frame #>.png
+	VIDEO_CAPTURE_Y4M,	// YUV4MPEG2 (4:4:4) stream, eg. for piping to an external encoder ("-" = stdout)
+	VIDEO_CAPTURE_RAW,	// 32-bit BGRA frames, back to back ("-" = stdout)
+};
+
+bool VideoCaptureParseFormat(const char* pszFormat, VIDEO_CAPTURE_FORMAT& format);
+bool VideoCaptureInit(const char* pszPath, VIDEO_CAPTURE_FORMAT format);
+bool VideoCaptureFinish();
+bool VideoCaptureIsWriting();
+UINT VideoCaptureGetDroppedFrames();
+
+// Emulated frames since the last call (0 if none): for a caller that doesn't present every emulated frame
+UINT VideoCaptureNewFrames(UINT64 cycles, UINT cyclesPerFrame);
+
+// pPixels: the top-left pixel; pitch: # pixels from a row to the row below it (ie. -ve for bottom-up)
+// frames: the emulated frames since the last frame put, incl. this one
+bool VideoCapturePutFrame(const uint32_t* pPixels, UINT width, UINT height, int pitch, double fps, UINT frames = 1);
+bool VideoCaptureScreenShot(const char* pszFile, const uint32_t* pPixels, UINT width, UINT height, int pitch);
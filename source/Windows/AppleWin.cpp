@@ -33,6 +33,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Interface.h"
 #include "Utilities.h"
 #include "CmdLine.h"
+#include "CPU.h"
 #include "Debug.h"
 #include "Keyboard.h"
 #include "Log.h"
@@ -42,6 +43,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "ParallelPrinter.h"
 #include "Registry.h"
 #include "Riff.h"
+#include "VideoCapture.h"
 #include "SaveState.h"
 #include "SerialComms.h"
 #include "Speaker.h"
@@ -265,6 +267,8 @@ static void ContinueExecution()
 			GetFrame().VideoRedrawScreenDuringFullSpeed(g_dwCyclesThisFrame);
 		else
 			GetFrame().VideoPresentScreen(); // Just copy the output of our Apple framebuffer to the system Back Buffer
+
+		GetVideo().Video_CaptureFrame();	// NB. Also at full-speed, to keep count of the frames that aren't captured
 	}
 
 #ifdef LOG_PERF_TIMINGS
@@ -625,17 +629,20 @@ static void GetAppleWinVersion()
 // DO ONE-TIME INITIALIZATION
 static void OneTimeInitialization(HINSTANCE passinstance)
 {
-	// Currently only support one RIFF file
 	if (!g_cmdLine.wavFileSpeaker.empty())
 	{
-		if (RiffInitWriteFile(g_cmdLine.wavFileSpeaker.c_str(), SPKR_SAMPLE_RATE, Spkr_GetNumChannels()))
-			Spkr_OutputToRiff();
+		if (!RiffInitWriteFile(RIFF_SPEAKER, g_cmdLine.wavFileSpeaker.c_str()))
+			LogFileOutput("Init: Failed to create: %s\n", g_cmdLine.wavFileSpeaker.c_str());
 	}
-	else if (!g_cmdLine.wavFileMockingboard.empty())
+	if (!g_cmdLine.wavFileMockingboard.empty())
 	{
-		if (RiffInitWriteFile(g_cmdLine.wavFileMockingboard.c_str(), MockingboardCard::SAMPLE_RATE, MockingboardCard::NUM_MB_CHANNELS))
-			GetCardMgr().GetMockingboardCardMgr().OutputToRiff();
+		if (!RiffInitWriteFile(RIFF_MOCKINGBOARD, g_cmdLine.wavFileMockingboard.c_str()))
+			LogFileOutput("Init: Failed to create: %s\n", g_cmdLine.wavFileMockingboard.c_str());
 	}
+	if (!g_cmdLine.wavFileStemsPrefix.empty())
+		RiffInitWriteStems(g_cmdLine.wavFileStemsPrefix.c_str());
+	if (!g_cmdLine.videoCaptureFile.empty())
+		VideoCaptureInit(g_cmdLine.videoCaptureFile.c_str(), g_cmdLine.videoCaptureFormat);
 
 	// Initialize COM - so we can use CoCreateInstance
 	// . DSInit() & DIMouse::DirectInputInit are done when g_hFrameWindow is created (WM_CREATE)
@@ -900,6 +907,12 @@ static void RepeatInitialization()
 	if (g_cmdLine.useAltCpuEmulation)
 		ForceAltCpuEmulation();
 
+	if (g_cmdLine.idleLoopSkip)
+		SetIdleLoopSkip(true);
+
+	if (g_cmdLine.videoThread)
+		NTSC_SetVideoThread(true);
+
 	if (!g_cmdLine.debuggerAutoRunScriptFilename.empty())
 		DebugSetAutoRunScript(g_cmdLine.debuggerAutoRunScriptFilename);
 
@@ -1015,6 +1028,8 @@ static void Shutdown()
 	CoUninitialize();
 	LogFileOutput("Exit: CoUninitialize()\n");
 
+	VideoCaptureFinish();	// Before LogDone(), as it logs any dropped frames
+
 	LogDone();
 
 	RiffFinishWriteFile();
@@ -7,6 +7,7 @@
 #include "Joystick.h"
 #include "Log.h"
 #include "Memory.h"
+#include "NTSC.h"
 #include "CardManager.h"
 #include "Debugger/Debug.h"
 #include "Tfe/PCapBackend.h"
@@ -307,20 +308,55 @@ void Win32Frame::Benchmark()
 		totalhiresfps++;
 	} while (GetTickCount() - milliseconds < 1000);
 
+	// AND SUPER HI-RES FRAMES, IF THERE'S A VIDHD CARD: ALTERNATING 320 & 640 SCANLINES, EACH WITH ITS OWN PALETTE
+	uint32_t totalshrfps = 0;
+	if (video.HasVidHD())
+	{
+		const auto fillAux = [](const WORD begin, const WORD end, const UINT frame)
+		{
+			for (UINT addr = begin; addr < end; addr += 0x100)
+			{
+				LPBYTE page = MemGetAuxPtr(addr);
+				for (UINT i = 0; i < 0x100; i++)
+					page[i] = (BYTE)((addr >> 8) + i + frame);
+			}
+		};
+
+		video.SetVideoMode(VF_SHR);
+		fillAux(0x9D00, 0xA000, 0);	// SCBs & palettes
+		for (UINT line = 0; line < 200; line++)
+			*MemGetAuxPtr(0x9D00 + line) = (line & 1) ? (0x80 | (line & 0xf)) : (line & 0xf);
+
+		milliseconds = GetTickCount();
+		while (GetTickCount() == milliseconds);
+		milliseconds = GetTickCount();
+		do {
+			fillAux(0x2000, 0x9D00, totalshrfps);
+			VideoRedrawScreen();
+			totalshrfps++;
+		} while (GetTickCount() - milliseconds < 1000);
+
+		video.SetVideoMode(VF_HIRES);
+	}
+
 	// DETERMINE HOW MANY 65C02 CLOCK CYCLES WE CAN EMULATE PER SECOND WITH
 	// NOTHING ELSE GOING ON
-	uint32_t totalmhz10[2] = { 0,0 };	// bVideoUpdate & !bVideoUpdate
-	for (UINT i = 0; i < 2; i++)
+	// . and again with the video render thread, for the CPU thread's gain
+	const bool videoThread = NTSC_GetVideoThread();
+	uint32_t totalmhz10[3] = { 0,0,0 };	// bVideoUpdate & !bVideoUpdate & bVideoUpdate (video thread)
+	for (UINT i = 0; i < 3; i++)
 	{
+		NTSC_SetVideoThread(i == 2);
 		CpuSetupBenchmark();
 		milliseconds = GetTickCount();
 		while (GetTickCount() == milliseconds);
 		milliseconds = GetTickCount();
 		do {
-			CpuExecute(100000, i == 0 ? true : false);
+			CpuExecute(100000, i == 1 ? false : true);
 			totalmhz10[i]++;
 		} while (GetTickCount() - milliseconds < 1000);
 	}
+	NTSC_SetVideoThread(videoThread);
 
 	// IF THE PROGRAM COUNTER IS NOT IN THE EXPECTED RANGE AT THE END OF THE
 	// CPU BENCHMARK, REPORT AN ERROR AND OPTIONALLY TRACK IT DOWN
@@ -369,6 +405,33 @@ void Win32Frame::Benchmark()
 					MB_ICONINFORMATION | MB_SETFOREGROUND);
 		}
 
+	// DETERMINE HOW MANY 65C02 CLOCK CYCLES WE CAN EMULATE PER SECOND WHEN
+	// DOING NOTHING BUT HAMMERING A CARD'S I/O: THE FLOATING BUS (AN EMPTY SLOT),
+	// A DISK II'S NIBBLE READ LOOP, AND MOCKINGBOARD AY REGISTER WRITES
+	std::string ioStr;
+	for (UINT type = 0; type < NUM_IOBENCH; type++)
+	{
+		const char* name[NUM_IOBENCH] = { "Floating bus MHz:", "Disk II latch MHz:", "Mockingboard MHz:" };
+		uint32_t iomhz10[2] = { 0,0 };	// bVideoUpdate & !bVideoUpdate
+		const bool hasCard = CpuSetupIoBenchmark((IoBenchmark_e)type);
+		for (UINT i = 0; hasCard && i < 2; i++)
+		{
+			CpuSetupIoBenchmark((IoBenchmark_e)type);
+			milliseconds = GetTickCount();
+			while (GetTickCount() == milliseconds);
+			milliseconds = GetTickCount();
+			do {
+				CpuExecute(100000, i == 0 ? true : false);
+				iomhz10[i]++;
+			} while (GetTickCount() - milliseconds < 1000);
+		}
+
+		ioStr += hasCard ? StrFormat("%s\t%u.%u (video update), %u.%u (full-speed)\n", name[type],
+			(unsigned)(iomhz10[0] / 10), (unsigned)(iomhz10[0] % 10), (unsigned)(iomhz10[1] / 10), (unsigned)(iomhz10[1] % 10))
+			: StrFormat("%s\tn/a (no card)\n", name[type]);
+	}
+	CpuSetupBenchmark();
+
 	// DO A REALISTIC TEST OF HOW MANY FRAMES PER SECOND WE CAN PRODUCE
 	// WITH FULL EMULATION OF THE CPU, JOYSTICK, AND DISK HAPPENING AT
 	// THE SAME TIME
@@ -406,17 +469,22 @@ void Win32Frame::Benchmark()
 		"\n"
 		"CPU: %s\n"
 		"\n"
-		"Pure Video FPS:\t%u hires, %u text\n"
+		"Pure Video FPS:\t%u hires, %u text, %u shr\n"
 		"Pure CPU MHz:\t%u.%u%s (video update)\n"
-		"Pure CPU MHz:\t%u.%u%s (full-speed)\n\n"
+		"Pure CPU MHz:\t%u.%u%s (full-speed)\n"
+		"Pure CPU MHz:\t%u.%u%s (video thread)\n"
+		"%s\n"
 		"EXPECTED AVERAGE VIDEO GAME\n"
 		"PERFORMANCE: %u FPS",
 		GetAppleWinVersionAndBuild().c_str(),
 		g_InstructionSet.brand,
 		(unsigned)totalhiresfps,
 		(unsigned)totaltextfps,
+		(unsigned)totalshrfps,
 		(unsigned)(totalmhz10[0] / 10), (unsigned)(totalmhz10[0] % 10), (LPCTSTR)(IS_APPLE2 ? " (6502)" : ""),
 		(unsigned)(totalmhz10[1] / 10), (unsigned)(totalmhz10[1] % 10), (LPCTSTR)(IS_APPLE2 ? " (6502)" : ""),
+		(unsigned)(totalmhz10[2] / 10), (unsigned)(totalmhz10[2] % 10), (LPCTSTR)(IS_APPLE2 ? " (6502)" : ""),
+		ioStr.c_str(),
 		(unsigned)realisticfps);
 
 	FrameMessageBox(
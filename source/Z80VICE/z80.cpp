@@ -26,6 +26,7 @@
 
 #include "../StdAfx.h"
 
+#include "../Core.h"
 #include "../CPU.h"
 #include "../Memory.h"
 #include "../YamlHelper.h"
@@ -134,11 +135,54 @@ void z80_reset()
    } while (0)
 
 
+// [AppleWin-TC]
+// See: http://www.apple2info.net/hardware/softcard/SC-SWHW_a2in.pdf
+static const double uZ80ClockMultiplier = 2;
+
+inline static ULONG ConvertZ80TStatesTo6502Cycles(UINT uTStates)
+{
+	return (uTStates < 0) ? 0 : (ULONG) ((double)uTStates / uZ80ClockMultiplier);
+}
+
+// [AppleWin-TC] Memory access, translated to the 6502's address space by z80mem_translate[]
+// . when running, RAM & ROM are accessed directly (as CpuRead() & CpuWrite() do)
+// . otherwise (I/O, $F800-FFFF for GH#827, or the debugger's heatmap) z80_RDMEM() & z80_WRMEM() are used
+
+static __forceinline BYTE z80_load(WORD Addr)
+{
+	const WORD addr = z80mem_translate[Addr >> 12] | (Addr & 0x0FFF);
+
+	if (g_nAppMode == MODE_RUNNING && (addr & 0xF000) != APPLE_IO_BEGIN && addr < 0xF800)
+		return mem[addr];
+
+	return z80_RDMEM(Addr);
+}
+
+static __forceinline void z80_store(WORD Addr, BYTE Value)
+{
+	const WORD addr = z80mem_translate[Addr >> 12] | (Addr & 0x0FFF);
+
+	if (g_nAppMode == MODE_RUNNING && addr < 0xF800)
+	{
+		LPBYTE page = memwrite[addr >> 8];
+		if (page)
+		{
+			memdirty[addr >> 8] = 0xFF;
+			page[addr & 0xFF] = Value;
+			if (memVidHD)	// GH#997
+				memVidHD[addr] = Value;
+			return;
+		}
+	}
+
+	z80_WRMEM(Addr, Value);
+}
+
 #define LOAD(addr) \
-    (*_z80mem_read_tab_ptr[(addr) >> 8])((WORD)(addr))
+    z80_load((WORD)(addr))
 
 #define STORE(addr, value) \
-    (*_z80mem_write_tab_ptr[(addr) >> 8])((WORD)(addr), (BYTE)(value))
+    z80_store((WORD)(addr), (BYTE)(value))
 
 #define IN(addr) \
     (io_read_tab[(addr) >> 8])((WORD)(addr))
@@ -147,10 +191,22 @@ void z80_reset()
     (io_write_tab[(addr) >> 8])((WORD)(addr), (BYTE)(value))
 
 #define opcode_t DWORD
-#define FETCH_OPCODE(o) ((o) = (LOAD(z80_reg_pc)		\
-                               | (LOAD(z80_reg_pc + 1) << 8)	\
-                               | (LOAD(z80_reg_pc + 2) << 16)	\
-                               | (LOAD(z80_reg_pc + 3) << 24)))
+
+// [AppleWin-TC] The 4 bytes are nearly always in the same 4K block of RAM (or ROM), so read them in one go
+static __forceinline opcode_t z80_fetch_opcode(WORD pc)
+{
+	const WORD addr = z80mem_translate[pc >> 12] | (pc & 0x0FFF);
+
+	if (g_nAppMode == MODE_RUNNING && (pc & 0x0FFF) <= 0x0FFC && (addr & 0xF000) != APPLE_IO_BEGIN && addr <= 0xF7FC)
+	{
+		const BYTE* p = mem + addr;
+		return p[0] | (p[1] << 8) | (p[2] << 16) | ((opcode_t)p[3] << 24);
+	}
+
+	return LOAD(pc) | (LOAD(pc + 1) << 8) | (LOAD(pc + 2) << 16) | ((opcode_t)LOAD(pc + 3) << 24);
+}
+
+#define FETCH_OPCODE(o) ((o) = z80_fetch_opcode((WORD)z80_reg_pc))
 
 #define p0 (opcode & 0xff)
 #define p1 ((opcode >> 8) & 0xff)
@@ -5510,14 +5566,6 @@ static void opcode_fd(BYTE ip1, BYTE ip2, BYTE ip3, WORD ip12, WORD ip23)
 /* Z80 mainloop.  */
 
 // The effective Z-80 clock rate is 2.041MHz
-// See: http://www.apple2info.net/hardware/softcard/SC-SWHW_a2in.pdf
-static const double uZ80ClockMultiplier = 2;
-
-inline static ULONG ConvertZ80TStatesTo6502Cycles(UINT uTStates)
-{
-	return (uTStates < 0) ? 0 : (ULONG) ((double)uTStates / uZ80ClockMultiplier);
-}
-
 //void z80_mainloop(interrupt_cpu_status_t *cpu_int_status,
 //                  alarm_context_t *cpu_alarm_context)
 
@@ -6357,43 +6405,12 @@ DWORD z80_mainloop(ULONG uTotalCycles, ULONG uExecutedCycles)
 /****************************************************************************/
 BYTE z80_RDMEM(WORD Addr)
 {
-	WORD addr;
+	const WORD addr = z80mem_translate[Addr >> 12] | (Addr & 0x0FFF);
 
-	switch (Addr / 0x1000)
-	{
-		case 0x0:
-		case 0x1:
-		case 0x2:
-		case 0x3:
-		case 0x4:
-		case 0x5:
-		case 0x6:
-		case 0x7:
-		case 0x8:
-		case 0x9:
-		case 0xA:
-			addr = (WORD)Addr + 0x1000;
-			return CpuRead( addr, ConvertZ80TStatesTo6502Cycles(maincpu_clk) );
-		break;
-
-		case 0xB:
-		case 0xC:
-		case 0xD:
-			addr = (WORD)Addr + 0x2000;
-			return CpuRead( addr, ConvertZ80TStatesTo6502Cycles(maincpu_clk) );
-		break;
-
-		case 0xE:
-			addr = (WORD)Addr - 0x2000;
-			return IORead[(addr>>4) & 0xFF]( regs.pc, addr, 0, 0, ConvertZ80TStatesTo6502Cycles(maincpu_clk) ); // Maps to 6502 I/O address range: $C000..CFFF
-		break;
-
-		case 0xF:
-			addr = (WORD)Addr - 0xF000;
-			return CpuRead( addr, ConvertZ80TStatesTo6502Cycles(maincpu_clk) );
-		break;
-	}
-	return 255;
+	if ((addr & 0xF000) == APPLE_IO_BEGIN)	// Z80 $E000..EFFF
+		return IORead[(addr>>4) & 0xFF]( regs.pc, addr, 0, 0, ConvertZ80TStatesTo6502Cycles(maincpu_clk) ); // Maps to 6502 I/O address range: $C000..CFFF
+
+	return CpuRead( addr, ConvertZ80TStatesTo6502Cycles(maincpu_clk) );
 }
 
 /****************************************************************************/
@@ -6401,29 +6418,8 @@ BYTE z80_RDMEM(WORD Addr)
 /****************************************************************************/
 void z80_WRMEM(WORD Addr, BYTE Value)
 {
-	unsigned int laddr;
-	WORD addr;
+	const WORD addr = z80mem_translate[Addr >> 12] | (Addr & 0x0FFF);
 
-	laddr = Addr & 0x0FFF;
-	switch (Addr & 0xF000)
-	{
-		case 0x0000: addr = laddr+0x1000; break;
-		case 0x1000: addr = laddr+0x2000; break;
-		case 0x2000: addr = laddr+0x3000; break;
-		case 0x3000: addr = laddr+0x4000; break;
-		case 0x4000: addr = laddr+0x5000; break;
-		case 0x5000: addr = laddr+0x6000; break;
-		case 0x6000: addr = laddr+0x7000; break;
-		case 0x7000: addr = laddr+0x8000; break;
-		case 0x8000: addr = laddr+0x9000; break;
-		case 0x9000: addr = laddr+0xA000; break;
-		case 0xA000: addr = laddr+0xB000; break;
-		case 0xB000: addr = laddr+0xD000; break;
-		case 0xC000: addr = laddr+0xE000; break;
-		case 0xD000: addr = laddr+0xF000; break;
-		case 0xE000: addr = laddr+0xC000; break;
-		case 0xF000: addr = laddr+0x0000; break;
-	}
 	CpuWrite( addr, Value, ConvertZ80TStatesTo6502Cycles(maincpu_clk) );
 }
 
@@ -76,6 +76,9 @@ static int mem_read_limit_tab[NUM_CONFIGS][0x101];
 store_func_ptr_t io_write_tab[0x101];
 read_func_ptr_t io_read_tab[0x101];
 
+/* [AppleWin-TC] SoftCard address translation: the 6502 address of each 4K block of Z80 memory.  */
+WORD z80mem_translate[0x10];
+
 //static const resource_int_t resources_int[] = {	// [AppleWin-TC]
 //    { NULL }
 //};
@@ -145,6 +148,19 @@ void z80mem_initialize()
 {
 	int i, j;
 
+    /* SoftCard address translation.  */	// [AppleWin-TC]
+
+    for (i = 0; i < 0x10; i++) {
+        if (i <= 0xA)
+            z80mem_translate[i] = (i + 0x1) << 12;	// Z80 $0000-AFFF = 6502 $1000-BFFF
+        else if (i <= 0xD)
+            z80mem_translate[i] = (i + 0x2) << 12;	// Z80 $B000-DFFF = 6502 $D000-FFFF
+        else if (i == 0xE)
+            z80mem_translate[i] = 0xC000;			// Z80 $E000-EFFF = 6502 $C000-CFFF (I/O)
+        else
+            z80mem_translate[i] = 0x0000;			// Z80 $F000-FFFF = 6502 $0000-0FFF
+    }
+
     /* Memory addess space.  */
 
     for (j = 0; j < NUM_CONFIGS; j++) {
@@ -54,5 +54,7 @@ extern read_func_ptr_t io_read_tab[];
 
 extern unsigned int z80_old_reg_pc;
 
+extern WORD z80mem_translate[0x10];		// [AppleWin-TC]
+
 #endif
 
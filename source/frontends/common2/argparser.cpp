@@ -5,6 +5,7 @@
 #include "linux/version.h"
 
 #include "Memory.h"
+#include "VideoCapture.h"
 
 #include <getopt.h>
 #include <regex>
@@ -48,6 +49,16 @@ namespace
     constexpr int STATE_FILENAME = 1026;
     constexpr int LOAD_STATE = 1027;
 
+    constexpr int IDLE_LOOP_SKIP = 1028;
+
+    constexpr int WAV_STEMS = 1029;
+
+    constexpr int VIDEO_THREAD = 1030;
+    constexpr int FRAME_SKIP = 1031;
+
+    constexpr int CAPTURE_FILE = 1032;
+    constexpr int CAPTURE_FORMAT = 1033;
+
     struct OptionData_t
     {
         const char *name;
@@ -173,6 +184,9 @@ namespace common2
                  {"log",                     no_argument,          'l',              "Log to AppleWin.log"},
                  {"paused",                  no_argument,          PAUSED,           "Start paused"},
                  {"fixed-speed",             no_argument,          FIXED_SPEED,      "Fixed (non-adaptive) speed"},
+                 {"idle-loop-skip",          no_argument,          IDLE_LOOP_SKIP,   "Fast-forward keyboard & VBL polling loops"},
+                 {"video-thread",            no_argument,          VIDEO_THREAD,     "Render video on a separate thread"},
+                 {"frame-skip",              required_argument,    FRAME_SKIP,       "Render 1 frame in (N+1), timing unchanged", "0"},
                  {"fullscreen",              no_argument,          'f',              "Start in fullscreen mode"},
                  {"headless",                no_argument,          HEADLESS,         "Headless: disable video (freewheel)"},
                  {"benchmark",               no_argument,          'b',              "Benchmark emulator"},
@@ -203,6 +217,12 @@ namespace common2
                  {"audio-buffer",            required_argument,    AUDIO_BUFFER,     "Audio buffer (ms)", audioBufferDefault.c_str()},
                  {"wav-speaker",             required_argument,    WAV_SPEAKER,      "Speaker wav output filename"},
                  {"wav-mockingboard",        required_argument,    WAV_MOCKINGBOARD, "Mockingboard wav output filename"},
+                 {"wav-stems",               required_argument,    WAV_STEMS,        "Per-source wav output filename prefix"},
+             }},
+            {"Capture",
+             {
+                 {"video-capture",           required_argument,    CAPTURE_FILE,     "Frames output: png prefix, or y4m/raw file (- = stdout)"},
+                 {"video-capture-format",    required_argument,    CAPTURE_FORMAT,   "png|y4m|raw", "png"},
              }},
         };
 
@@ -317,6 +337,21 @@ namespace common2
                 options.fixedSpeed = true;
                 break;
             }
+            case IDLE_LOOP_SKIP:
+            {
+                options.idleLoopSkip = true;
+                break;
+            }
+            case VIDEO_THREAD:
+            {
+                options.videoThread = true;
+                break;
+            }
+            case FRAME_SKIP:
+            {
+                options.frameSkip = std::stoul(optarg);
+                break;
+            }
             case HEADLESS:
             {
                 options.headless = true;
@@ -381,6 +416,26 @@ namespace common2
                 options.wavFileMockingboard = optarg;
                 break;
             }
+            case WAV_STEMS:
+            {
+                options.wavFileStemsPrefix = optarg;
+                break;
+            }
+            case CAPTURE_FILE:
+            {
+                options.videoCaptureFile = optarg;
+                break;
+            }
+            case CAPTURE_FORMAT:
+            {
+                VIDEO_CAPTURE_FORMAT format;
+                if (!VideoCaptureParseFormat(optarg, format))
+                {
+                    throw std::runtime_error("Invalid video capture format: " + std::string(optarg));
+                }
+                options.videoCaptureFormat = optarg;
+                break;
+            }
             case SDL_DRIVER:
             {
                 options.sdlDriver = std::stoi(optarg);
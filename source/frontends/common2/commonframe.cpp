@@ -1,6 +1,7 @@
 #include "StdAfx.h"
 #include "frontends/common2/commonframe.h"
 #include "frontends/common2/programoptions.h"
+#include "linux/paddle.h"
 
 #include <thread>
 
@@ -70,6 +71,8 @@ namespace common2
 
     void CommonFrame::ExecuteOneFrame(const int64_t microseconds)
     {
+        Paddle::updateAxes();
+
         // when running in adaptive speed
         // the value msNextFrame is only a hint for when the next frame will arrive
         switch (g_nAppMode)
@@ -200,6 +203,7 @@ namespace common2
             myLastSync = std::chrono::steady_clock::now();
         }
         VideoPresentScreen();
+        GetVideo().Video_CaptureFrame();
     }
 
 } // namespace common2
@@ -0,0 +1,61 @@
+#include "frontends/common2/framediff.h"
+
+#include <cstring>
+
+namespace common2
+{
+
+    void FrameDiff::reset(const size_t width, const size_t height)
+    {
+        myRowSize = width * sizeof(uint32_t);
+        myHeight = height;
+        myPrevious.resize(myRowSize * myHeight);
+        myValid = false;
+        myFramesWithoutDiff = 0;
+    }
+
+    bool FrameDiff::update(const uint8_t *data, const size_t pitch, size_t &first, size_t &last)
+    {
+        first = 0;
+        last = myHeight;
+
+        if (myFramesWithoutDiff)
+        {
+            --myFramesWithoutDiff;
+            return true;
+        }
+
+        if (myValid)
+        {
+            // from the top, then from the bottom, up to the first difference
+            while (first < last && memcmp(data + first * pitch, myPrevious.data() + first * myRowSize, myRowSize) == 0)
+            {
+                ++first;
+            }
+            while (first < last &&
+                   memcmp(data + (last - 1) * pitch, myPrevious.data() + (last - 1) * myRowSize, myRowSize) == 0)
+            {
+                --last;
+            }
+
+            if ((last - first) * 16 > myHeight)
+            {
+                // more than a few rows: upload the frame whole for a while, and then copy it whole again (to probe)
+                myValid = false;
+                myFramesWithoutDiff = ourFramesWithoutDiff;
+                first = 0;
+                last = myHeight;
+                return true;
+            }
+        }
+
+        for (size_t row = first; row < last; ++row)
+        {
+            memcpy(myPrevious.data() + row * myRowSize, data + row * pitch, myRowSize);
+        }
+
+        myValid = true;
+        return first < last;
+    }
+
+} // namespace common2
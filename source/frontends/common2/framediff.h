@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace common2
+{
+
+    // Keeps a copy of the last frame uploaded, to find the band of rows that has changed since.
+    // AppleWin redraws the whole framebuffer every frame, so only comparing the pixels tells
+    // what is new: a static screen then costs no upload at all.
+    // Comparing & copying cost about as much as uploading, so while more than a few rows change
+    // there is no diff (nor copy): the whole frame is uploaded, as before, & the diff only resumes
+    // once a probe finds that the screen has settled.
+    class FrameDiff
+    {
+    public:
+        // width & height in pixels (bgra_t): the next update() returns the whole frame
+        void reset(const size_t width, const size_t height);
+
+        // compare 'data' (pitch in bytes) to the previous frame
+        // returns false if nothing has changed, else the rows [first, last) which have
+        bool update(const uint8_t *data, const size_t pitch, size_t &first, size_t &last);
+
+    private:
+        // frames uploaded whole (without a diff) after one where more than 1/16 of the rows changed,
+        // i.e. about a second: the probe (a full copy) is then too rare to cost anything
+        static constexpr size_t ourFramesWithoutDiff = 60;
+
+        size_t myRowSize = 0; // in bytes
+        size_t myHeight = 0;
+        bool myValid = false;
+        size_t myFramesWithoutDiff = 0;
+
+        std::vector<uint8_t> myPrevious;
+    };
+
+} // namespace common2
@@ -6,8 +6,11 @@
 #include "Disk.h"
 #include "Utilities.h"
 #include "Core.h"
+#include "CPU.h"
+#include "NTSC.h"
 #include "Speaker.h"
 #include "Riff.h"
+#include "VideoCapture.h"
 #include "CardManager.h"
 
 namespace common2
@@ -23,6 +26,9 @@ namespace common2
         g_nMemoryClearType = options.memclear;
         g_bDisableDirectSound = options.noAudio;
         g_bDisableDirectSoundMockingboard = options.noAudio;
+        SetIdleLoopSkip(options.idleLoopSkip);
+        NTSC_SetVideoThread(options.videoThread);
+        NTSC_SetFrameSkip(options.frameSkip);
 
         bool bBoot = false;
         CardManager &cardManager = GetCardMgr();
@@ -102,18 +108,28 @@ namespace common2
 
         if (!options.wavFileSpeaker.empty())
         {
-            if (RiffInitWriteFile(options.wavFileSpeaker.c_str(), SPKR_SAMPLE_RATE, 1))
+            if (!RiffInitWriteFile(RIFF_SPEAKER, options.wavFileSpeaker.c_str()))
             {
-                Spkr_OutputToRiff();
+                LogFileOutput("Init: Failed to create: %s\n", options.wavFileSpeaker.c_str());
             }
         }
-        else if (!options.wavFileMockingboard.empty())
+        if (!options.wavFileMockingboard.empty())
         {
-            if (RiffInitWriteFile(options.wavFileMockingboard.c_str(), MockingboardCard::SAMPLE_RATE, 2))
+            if (!RiffInitWriteFile(RIFF_MOCKINGBOARD, options.wavFileMockingboard.c_str()))
             {
-                GetCardMgr().GetMockingboardCardMgr().OutputToRiff();
+                LogFileOutput("Init: Failed to create: %s\n", options.wavFileMockingboard.c_str());
             }
         }
+        if (!options.wavFileStemsPrefix.empty())
+        {
+            RiffInitWriteStems(options.wavFileStemsPrefix.c_str());
+        }
+        if (!options.videoCaptureFile.empty())
+        {
+            VIDEO_CAPTURE_FORMAT format = VIDEO_CAPTURE_PNG;
+            VideoCaptureParseFormat(options.videoCaptureFormat.c_str(), format);
+            VideoCaptureInit(options.videoCaptureFile.c_str(), format);
+        }
 
         Paddle::setSquaring(options.paddleSquaring);
     }
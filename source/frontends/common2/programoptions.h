@@ -51,6 +51,9 @@ namespace common2
 
         bool autoBoot = true;
         bool fixedSpeed = false; // default adaptive
+        bool idleLoopSkip = false; // fast-forward polling loops (cycle-exact)
+        bool videoThread = false;  // render video on a separate thread
+        size_t frameSkip = 0;      // render 1 frame in (N+1)
         bool syncWithTimer = false;
         size_t audioBuffer = 46; // in ms -> corresponds to 2048 samples (keep below 90ms)
 
@@ -69,6 +72,10 @@ namespace common2
         bool noAudio = false;
         std::string wavFileSpeaker;
         std::string wavFileMockingboard;
+        std::string wavFileStemsPrefix;
+
+        std::string videoCaptureFile;
+        std::string videoCaptureFormat = "png";
 
         std::vector<std::string> registryOptions;
 
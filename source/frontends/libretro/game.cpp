@@ -11,6 +11,7 @@
 #include "Registry.h"
 #include "Interface.h"
 #include "Memory.h"
+#include "NTSC.h"
 
 #include "linux/keyboardbuffer.h"
 #include "linux/paddle.h"
@@ -82,6 +83,9 @@ namespace ra2
 
         myKeyboardType = getKeyboardEmulationType();
         myMouseSpeed = getMouseSpeed();
+
+        NTSC_SetVideoThread(getVideoThread());
+        NTSC_SetFrameSkip(getFrameSkip());
     }
 
     void Game::updateVariables()
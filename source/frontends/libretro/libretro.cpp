@@ -4,6 +4,8 @@
 
 #include "StdAfx.h"
 #include "Video.h"
+#include "Core.h"
+#include "NTSC.h"
 #include "Interface.h"
 #include "Memory.h"
 
@@ -122,6 +124,10 @@ namespace
 
 void retro_init(void)
 {
+    // as a freshly loaded core: the frontend may deinit & init it again, without unloading it
+    // (the video scanner's position & the per-frame phases outlive a machine)
+    g_dwCyclesThisFrame = 0;
+    NTSC_ResetFramePhase();
     ra2::log_cb(RETRO_LOG_INFO, "RA2: %s\n", __FUNCTION__);
 }
 
@@ -30,52 +30,39 @@ namespace ra2
 
     void RetroFrame::VideoPresentScreen()
     {
-        // this should not be necessary
-        // either libretro handles it
-        // or we should change AW
-        // but for now, there is no alternative
-        const size_t offset = myLinePeriod - 1;
-        for (size_t row = 0; row < myHeight; ++row)
-        {
-            // row is in "retro" space, so we need to adjust it
-            // to the original frame buffer space
-            const uint8_t *src = myFrameBuffer + (row * myLinePeriod + offset) * myPitch;
-            uint8_t *dst = myVideoBuffer.data() + (myHeight - row - 1) * myPitch;
-            memcpy(dst, src, myPitch);
-        }
-
-        video_cb(myVideoBuffer.data() + myOffset, myBorderlessWidth, myBorderlessHeight, myPitch);
+        // the frame buffer is top-down (see Initialize()), so it is handed over as it is
+        // with a line period > 1, the pitch skips the rows in between
+        video_cb(myFrameBuffer + myOffset, myBorderlessWidth, myBorderlessHeight, myPitch);
     }
 
     void RetroFrame::Initialize(bool resetVideoState)
     {
+        Video &video = GetVideo();
+
+        // libretro wants the rows top-down, so AW renders them that way and there is no need to flip a copy
+        video.SetFrameBufferTopDown(true);
+
         CommonFrame::Initialize(resetVideoState);
         FrameRefreshStatus(DRAW_TITLE);
 
-        Video &video = GetVideo();
-
         // This initialises the libretro video buffer, so we apply LinePeriod everywhere.
         myBorderlessWidth = video.GetFrameBufferBorderlessWidth();
         myBorderlessHeight = video.GetFrameBufferBorderlessHeight() / myLinePeriod;
         const size_t borderWidth = video.GetFrameBufferBorderWidth();
         const size_t borderHeight = video.GetFrameBufferBorderHeight() / myLinePeriod;
         const size_t width = video.GetFrameBufferWidth();
-        myHeight = video.GetFrameBufferHeight() / myLinePeriod;
 
         myFrameBuffer = video.GetFrameBuffer();
 
-        myPitch = width * sizeof(bgra_t);
-        myOffset = (width * borderHeight + borderWidth) * sizeof(bgra_t);
-
-        const size_t size = myHeight * myPitch;
-        myVideoBuffer.resize(size);
+        // "retro" row i is the frame buffer's row i * LinePeriod
+        myPitch = width * sizeof(bgra_t) * myLinePeriod;
+        myOffset = borderHeight * myPitch + borderWidth * sizeof(bgra_t);
     }
 
     void RetroFrame::Destroy()
     {
         CommonFrame::Destroy();
         myFrameBuffer = nullptr;
-        myVideoBuffer.clear();
     }
 
     int RetroFrame::FrameMessageBox(LPCSTR lpText, LPCSTR lpCaption, UINT uType)
@@ -2,8 +2,6 @@
 
 #include "frontends/common2/gnuframe.h"
 
-#include <vector>
-
 namespace ra2
 {
 
@@ -33,11 +31,8 @@ namespace ra2
     private:
         const size_t myLinePeriod;
 
-        std::vector<uint8_t> myVideoBuffer;
-
         size_t myPitch = 0;
         size_t myOffset = 0;
-        size_t myHeight = 0;
         size_t myBorderlessWidth = 0;
         size_t myBorderlessHeight = 0;
         uint8_t *myFrameBuffer = nullptr;
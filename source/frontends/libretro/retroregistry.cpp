@@ -25,6 +25,8 @@ namespace
     const char *REGVALUE_KEYBOARD_TYPE = "Keyboard type";
     const char *REGVALUE_PLAYLIST_START = "Playlist start";
     const char *REGVALUE_MOUSE_SPEED_00 = "Mouse speed";
+    const char *REGVALUE_VIDEO_THREAD = "Video thread";
+    const char *REGVALUE_FRAME_SKIP = "Frame skip";
 
     const char *CATEGORY_SYSTEM = "system";
     const char *CATEGORY_INPUT = "input";
@@ -293,6 +295,36 @@ namespace
             REG_CONFIG,
             REGVALUE_VIDEO_REFRESH_RATE, // reset required
         },
+        {
+            {
+                "video_thread",
+                "Video Render Thread",
+                CATEGORY_SYSTEM,
+                {
+                    {"Off", 0},
+                    {"On", 1},
+                },
+            },
+            REG_RA2,
+            REGVALUE_VIDEO_THREAD,
+        },
+        {
+            {
+                "frame_skip",
+                "Frame Skip",
+                CATEGORY_SYSTEM,
+                {
+                    {"0", 0},
+                    {"1", 1},
+                    {"2", 2},
+                    {"3", 3},
+                    {"5", 5},
+                    {"7", 7},
+                },
+            },
+            REG_RA2,
+            REGVALUE_FRAME_SKIP,
+        },
         {
             {
                 "playlist_start",
@@ -582,6 +614,20 @@ namespace ra2
         return value / 100.0;
     }
 
+    bool getVideoThread()
+    {
+        uint32_t value = 0;
+        RegLoadValue(REG_RA2, REGVALUE_VIDEO_THREAD, true, &value);
+        return value != 0;
+    }
+
+    uint32_t getFrameSkip()
+    {
+        uint32_t value = 0;
+        RegLoadValue(REG_RA2, REGVALUE_FRAME_SKIP, true, &value);
+        return value;
+    }
+
     bool is280Lines()
     {
         const bool halfLines = GetVideo().IsVideoStyle(VS_280_LINES);
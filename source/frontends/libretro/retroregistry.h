@@ -24,6 +24,8 @@ namespace ra2
     KeyboardType getKeyboardEmulationType();
     PlaylistStartDisk getPlaylistStartDisk();
     double getMouseSpeed();
+    bool getVideoThread();
+    uint32_t getFrameSkip();
     bool is280Lines();
 
 } // namespace ra2
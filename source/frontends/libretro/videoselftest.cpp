@@ -0,0 +1,523 @@
+#include "libretro.h"
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Headless check of the frames that the core hands to video_cb
+// . boots a one-sector disk whose program fills the TEXT & HGR pages (main & aux) with a pattern,
+//   then keeps writing the soft switches listed at $0310 (pairs of $C0xx low byte & value, 0 terminated)
+// . each configuration's frames (for every video mode) are hashed, and must match the frames of the original
+//   VideoPresentScreen() (which copied the bottom-up framebuffer into a top-down buffer) bit for bit
+// . the "racing" modes switch video modes mid-frame & also write to the TEXT & HGR pages (main & aux)
+//   while they are displayed (the loop's BEQ is patched to go via "race"): their hashes are of the inline
+//   renderer's frames
+// . with a VidHD, the racing SHR mode also sets every SCB (320/640, fill & palette) via "shr": its hash is of
+//   the original cycle-at-a-time SHR renderer's frames
+// . then it all runs again with the video render thread, which must give the same frames
+// . frame skip: each level runs (from retro_init(), so they all start from the same state) a loop that toggles
+//   TEXT/GR & reads the floating bus and $C019 (the loop's BEQ is patched to go via "probe"): what the 6502 reads
+//   must not depend on the level, nor must a frame that every level renders (after going back to level 0)
+
+namespace
+{
+
+    // ------------------- helpers -------------------
+
+    [[noreturn]] void fail(const std::string &msg)
+    {
+        std::cerr << "TEST FAILED: " << msg << std::endl;
+        std::exit(1);
+    }
+
+    void pass(const std::string &msg)
+    {
+        std::cout << "ok: " << msg << std::endl;
+    }
+
+    const char *ourDiskPath = "testvideo.dsk";
+
+    const uint16_t LOOP_BRANCH = 0x0821; // BEQ's offset
+    const uint8_t BRANCH_LOOP = 0xF9;
+    const uint8_t BRANCH_RACE = 0x31;
+    const uint8_t BRANCH_SHR = 0x48;
+    const uint8_t BRANCH_PROBE = 0x62;
+    const uint16_t READY = 0x030F;
+    const uint16_t SWITCHES = 0x0310;
+    const uint8_t READY_VALUE = 0xA5;
+    const uint16_t PROBES = 0x6000; // $6000-$62FF: what "probe" reads
+
+    // boot sector: loaded at $0800 by the Disk II firmware, which then jumps to $0801
+    const std::vector<uint8_t> ourBootSector = {
+        0x01,             // $0800: 1 sector
+        0xA9, 0x00,       // $0801: LDA #0
+        0x8D, 0x10, 0x03, //        STA $0310         ; no soft switches yet
+        0x8D, 0x05, 0xC0, //        STA $C005         ; RAMWRT: aux
+        0xA2, 0x5A,       //        LDX #$5A
+        0x20, 0x2E, 0x08, //        JSR fill
+        0x8D, 0x04, 0xC0, //        STA $C004         ; RAMWRT: main
+        0xA2, 0x00,       //        LDX #0
+        0x20, 0x2E, 0x08, //        JSR fill
+        0xA9, 0xA5,       //        LDA #$A5
+        0x8D, 0x0F, 0x03, //        STA $030F         ; ready
+        0xA0, 0x00,       // $081B: LDY #0            ; loop
+        0xBE, 0x10, 0x03, // $081D: LDX $0310,Y       ; next
+        0xF0, 0xF9,       // $0820: BEQ loop          ; or BEQ race / shr
+        0xB9, 0x11, 0x03, //        LDA $0311,Y
+        0x9D, 0x00, 0xC0, //        STA $C000,X
+        0xC8,             //        INY
+        0xC8,             //        INY
+        0xD0, 0xF1,       //        BNE next
+        0xF0, 0xED,       //        BEQ loop
+        0x86, 0x02,       // $082E: STX $02           ; fill: $0400-$07FF & $2000-$5FFF with (lo ^ hi ^ X)
+        0xA9, 0x04,       //        LDA #$04
+        0x85, 0x01,       //        STA $01
+        0xA0, 0x00,       //        LDY #0
+        0x84, 0x00,       //        STY $00
+        0x98,             // $0838: TYA
+        0x45, 0x01,       //        EOR $01
+        0x45, 0x02,       //        EOR $02
+        0x91, 0x00,       //        STA ($00),Y
+        0xC8,             //        INY
+        0xD0, 0xF6,       //        BNE $0838
+        0xE6, 0x01,       //        INC $01
+        0xA5, 0x01,       //        LDA $01
+        0xC9, 0x08,       //        CMP #$08
+        0xD0, 0x04,       //        BNE $084E
+        0xA9, 0x20,       //        LDA #$20          ; skip $0800-$1FFF (this program)
+        0x85, 0x01,       //        STA $01
+        0xC9, 0x60,       // $084E: CMP #$60
+        0xD0, 0xE6,       //        BNE $0838
+        0x60,             //        RTS
+        0xEE, 0x3C, 0x06, // $0853: INC $063C         ; race: TEXT row 12 & HGR line 96, main
+        0xEE, 0x3C, 0x22, //        INC $223C
+        0x8D, 0x05, 0xC0, //        STA $C005         ; RAMWRT: aux
+        0xEE, 0x3C, 0x06, //        INC $063C         ; aux = main + 1
+        0xEE, 0x3C, 0x22, //        INC $223C
+        0x8D, 0x04, 0xC0, //        STA $C004         ; RAMWRT: main
+        0x4C, 0x1B, 0x08, //        JMP loop
+        0x8D, 0x05, 0xC0, // $086A: STA $C005         ; shr: RAMWRT: aux
+        0xA2, 0x00,       //        LDX #0
+        0x8A,             // $086F: TXA
+        0x9D, 0x00, 0x9D, //        STA $9D00,X       ; SCBs: 640 (b7), fill (b5), palette (b3-0)
+        0x9D, 0x00, 0x9E, //        STA $9E00,X       ; palettes
+        0x49, 0xA5,       //        EOR #$A5
+        0x9D, 0x00, 0x9F, //        STA $9F00,X
+        0xE8,             //        INX
+        0xD0, 0xF1,       //        BNE $086F
+        0x8D, 0x04, 0xC0, //        STA $C004         ; RAMWRT: main
+        0x4C, 0x53, 0x08, //        JMP race
+    };
+
+    // not in the boot sector, as the other tests show $0800-$0BFF on TEXT page 2: the frame-skip tests copy it there
+    const uint16_t PROBE = 0x0884;
+    const std::vector<uint8_t> ourProbe = {
+        0xAD, 0x50, 0xC0, // $0884: LDA $C050         ; probe: X = 0 (the terminator), GR & the floating bus
+        0x9D, 0x00, 0x60, //        STA $6000,X
+        0xAD, 0x19, 0xC0, //        LDA $C019         ; VBL (b7) & the floating bus
+        0x9D, 0x00, 0x61, //        STA $6100,X
+        0xAD, 0x51, 0xC0, //        LDA $C051         ; TEXT & the floating bus
+        0x9D, 0x00, 0x62, //        STA $6200,X
+        0xE8,             //        INX
+        0xD0, 0xEB,       //        BNE probe
+        0x4C, 0x1B, 0x08, //        JMP loop
+    };
+
+    struct Mode
+    {
+        const char *name;
+        std::vector<uint8_t> switches; // pairs of $C0xx low byte & value
+        uint8_t branch = BRANCH_LOOP;  // or also write to the TEXT & HGR pages (& SHR's SCBs & palettes)
+    };
+
+    // all the //e video soft switches are written each time, so the modes don't depend on their order
+    const std::vector<Mode> ourModes = {
+        {"TEXT40", {0x0C, 0, 0x0E, 0, 0x51, 0, 0x52, 0, 0x54, 0, 0x56, 0, 0x5F, 0}},
+        {"TEXT40 ALTCHAR", {0x0C, 0, 0x0F, 0, 0x51, 0, 0x52, 0, 0x54, 0, 0x56, 0, 0x5F, 0}},
+        {"TEXT80", {0x0D, 0, 0x0E, 0, 0x51, 0, 0x52, 0, 0x54, 0, 0x56, 0, 0x5F, 0}},
+        {"LORES", {0x0C, 0, 0x0E, 0, 0x50, 0, 0x52, 0, 0x54, 0, 0x56, 0, 0x5F, 0}},
+        {"LORES MIXED", {0x0C, 0, 0x0E, 0, 0x50, 0, 0x53, 0, 0x54, 0, 0x56, 0, 0x5F, 0}},
+        {"HGR", {0x0C, 0, 0x0E, 0, 0x50, 0, 0x52, 0, 0x54, 0, 0x57, 0, 0x5F, 0}},
+        {"HGR PAGE2", {0x0C, 0, 0x0E, 0, 0x50, 0, 0x52, 0, 0x55, 0, 0x57, 0, 0x5F, 0}},
+        {"HGR MIXED80", {0x0D, 0, 0x0E, 0, 0x50, 0, 0x53, 0, 0x54, 0, 0x57, 0, 0x5F, 0}},
+        {"DLORES", {0x0D, 0, 0x0E, 0, 0x50, 0, 0x52, 0, 0x54, 0, 0x56, 0, 0x5E, 0}},
+        {"DHGR", {0x0D, 0, 0x0E, 0, 0x50, 0, 0x52, 0, 0x54, 0, 0x57, 0, 0x5E, 0}},
+    };
+
+    // the loop takes ~300 cycles, so these switch TEXT/MIXED/PAGE2/ALTCHAR/80COL/DHIRES many times a frame
+    const std::vector<Mode> ourRacingModes = {
+        {"RACING 40",
+         {0x0C, 0, 0x0E, 0, 0x5F, 0, 0x54, 0, 0x51, 0, 0x50, 0, 0x57, 0, 0x53, 0, 0x55, 0, 0x52, 0, 0x56, 0, 0x0F, 0,
+          0x54, 0, 0x51, 0},
+         BRANCH_RACE},
+        {"RACING 80",
+         {0x0D, 0, 0x0E, 0, 0x5E, 0, 0x50, 0, 0x57, 0, 0x53, 0, 0x56, 0, 0x52, 0, 0x51, 0, 0x5F, 0, 0x50, 0, 0x0C, 0,
+          0x0D, 0, 0x57, 0},
+         BRANCH_RACE},
+    };
+
+    // VidHD's NEWVIDEO ($C029) bit 7: Super Hi-Res
+    const Mode ourSHRMode = {"SHR", {0x29, 0xC1}};
+    const Mode ourSHROffMode = {"SHR off", {0x29, 0x01}};
+    const Mode ourSHRRacingMode = {"SHR RACING", {0x29, 0xC1}, BRANCH_SHR}; // every SCB: 320/640, fill & palette
+
+    // "probe" toggles TEXT/GR (LORES, with flashing TEXT) every ~16 cycles
+    const Mode ourProbeMode = {"PROBE", {0x0C, 0, 0x0E, 0, 0x52, 0, 0x54, 0, 0x56, 0, 0x5F, 0}, BRANCH_PROBE};
+
+    struct Config
+    {
+        const char *videoStyle;
+        const char *videoMode;
+        bool vidHD;
+        uint32_t hash;       // of the original VideoPresentScreen()'s frames
+        uint32_t racingHash; // of the inline renderer's frames
+    };
+
+    // NB. the core takes the line period (ie. "280 x 192") from the video style when the game is loaded,
+    // which is still the previous configuration's, so the order of these matters
+    const std::vector<Config> ourConfigs = {
+        {"Half Scanlines", "Color (Composite Monitor)", false, 0xD8D7B1D1, 0x6AC2A65C},
+        {"Half Scanlines", "Color (Composite Idealized)", false, 0xFF0727CF, 0x7DDA7EF3},
+        {"Half Scanlines", "Color (RGB Card/Monitor)", false, 0x13A4ED17, 0xE6DF7158},
+        {"Half Scanlines", "Color TV", false, 0x82B3F975, 0xBEFE3339}, // the NTSC tables as built at start-up
+        {"Half Scanlines", "Monochrome (White)", false, 0xA9912BF7, 0xF8773FE5},
+        {"560 x 192", "Color (Composite Monitor)", false, 0x4A659E4B, 0x2AAAA8DF},
+        {"560 x 192", "Color (RGB Card/Monitor)", false, 0x3A14EFE7, 0x8FA9FF1B},
+        {"280 x 192", "Color (Composite Monitor)", false, 0xE919634B, 0x70CEBC0F},
+        {"280 x 192", "Color (Composite Idealized)", false, 0x643A09DF, 0x0ED05583},
+        {"280 x 192", "Color (RGB Card/Monitor)", false, 0x9FE76267, 0xD5BD057B},
+        {"280 x 192", "B&W TV", false, 0x137B95F2, 0x688E32BE},
+        {"Half Scanlines", "Color (Composite Monitor)", true, 0x5A76A22B, 0xF21E251A},
+        {"280 x 192", "Color (Composite Idealized)", true, 0x8440E1ED, 0xA4D92581},
+    };
+
+    // the monochrome monitors' other tints & full scanlines (TEXT's glyph spans)
+    // . run after all of the above, so their FLASH phase doesn't depend on these
+    const std::vector<Config> ourMonochromeConfigs = {
+        {"560 x 192", "Monochrome (Amber)", false, 0x9F255447, 0x4983FC17},
+        {"Half Scanlines", "Monochrome (Green)", false, 0x28FCB187, 0x5E0A6DCE},
+    };
+
+    struct FrameSkip
+    {
+        const char *frameSkip;
+        uint32_t framesHash; // while skipping, ie. different for each level
+    };
+
+    const std::vector<FrameSkip> ourFrameSkips = {
+        {"0", 0xDAE4CDCF},
+        {"1", 0x1B5B6988},
+        {"3", 0x03EC423E},
+        {"7", 0x19F542C8},
+    };
+
+    // the same for every level, inline and with the video thread
+    const uint32_t ourProbesHash = 0x2E36B61B;
+    const uint32_t ourFrameSkipHash = 0x2C562522;
+
+    // ------------------- a minimal libretro frontend -------------------
+
+    std::map<std::string, std::string> ourVariables;
+    bool ourVariablesUpdated = false;
+    uint32_t ourFrameHash = 0;
+    size_t ourFrames = 0;
+
+    void logDiscard(enum retro_log_level level, const char *fmt, ...)
+    {
+        if (level >= RETRO_LOG_WARN)
+        {
+            va_list args;
+            va_start(args, fmt);
+            vfprintf(stderr, fmt, args);
+            va_end(args);
+        }
+    }
+
+    bool environment(unsigned cmd, void *data)
+    {
+        switch (cmd)
+        {
+        case RETRO_ENVIRONMENT_SET_PIXEL_FORMAT:
+            return *static_cast<const retro_pixel_format *>(data) == RETRO_PIXEL_FORMAT_XRGB8888;
+        case RETRO_ENVIRONMENT_GET_LOG_INTERFACE:
+            static_cast<retro_log_callback *>(data)->log = logDiscard;
+            return true;
+        case RETRO_ENVIRONMENT_GET_VARIABLE:
+        {
+            retro_variable *variable = static_cast<retro_variable *>(data);
+            const auto it = ourVariables.find(variable->key);
+            variable->value = it != ourVariables.end() ? it->second.c_str() : nullptr;
+            return true;
+        }
+        case RETRO_ENVIRONMENT_GET_VARIABLE_UPDATE:
+            *static_cast<bool *>(data) = ourVariablesUpdated;
+            ourVariablesUpdated = false;
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // FNV-1a of the visible pixels, ie. independent of the pitch
+    void videoRefresh(const void *data, unsigned width, unsigned height, size_t pitch)
+    {
+        if (!data)
+            fail("duplicate frame");
+
+        uint32_t hash = 2166136261u;
+        for (unsigned y = 0; y < height; ++y)
+        {
+            const uint8_t *row = static_cast<const uint8_t *>(data) + y * pitch;
+            for (size_t i = 0; i < width * sizeof(uint32_t); ++i)
+                hash = (hash ^ row[i]) * 16777619u;
+        }
+        ourFrameHash = hash;
+        ++ourFrames;
+    }
+
+    void audioSample(int16_t, int16_t)
+    {
+    }
+
+    size_t audioSampleBatch(const int16_t *, size_t frames)
+    {
+        return frames;
+    }
+
+    void inputPoll()
+    {
+    }
+
+    int16_t inputState(unsigned, unsigned, unsigned, unsigned)
+    {
+        return 0;
+    }
+
+    void writeBootDisk()
+    {
+        std::vector<uint8_t> disk(35 * 16 * 256);
+        std::copy(ourBootSector.begin(), ourBootSector.end(), disk.begin());
+
+        std::ofstream f(ourDiskPath, std::ios::binary);
+        if (!f.write(reinterpret_cast<const char *>(disk.data()), disk.size()))
+            fail("cannot write test disk");
+    }
+
+    uint8_t *mainRAM()
+    {
+        uint8_t *ram = static_cast<uint8_t *>(retro_get_memory_data(RETRO_MEMORY_SYSTEM_RAM));
+        if (!ram)
+            fail("no system RAM");
+        return ram;
+    }
+
+    void loadGame()
+    {
+        retro_game_info game = {ourDiskPath, nullptr, 0, nullptr};
+        if (!retro_load_game(&game))
+            fail("load game");
+
+        mainRAM()[READY] = 0;
+        for (int frame = 0; mainRAM()[READY] != READY_VALUE; ++frame)
+        {
+            if (frame == 600)
+                fail("boot sector didn't run");
+            retro_run();
+        }
+    }
+
+    void setMode(const Mode &mode)
+    {
+        uint8_t *ram = mainRAM();
+        std::copy(mode.switches.begin(), mode.switches.end(), ram + SWITCHES);
+        ram[SWITCHES + mode.switches.size()] = 0;
+        ram[LOOP_BRANCH] = mode.branch;
+    }
+
+    uint32_t runMode(const Mode &mode)
+    {
+        setMode(mode);
+
+        // the 1st frame can have the previous mode at the top
+        retro_run();
+        retro_run();
+        return ourFrameHash;
+    }
+
+    // ------------------- tests -------------------
+
+    uint32_t test_config(const Config &config, const bool racing)
+    {
+        ourVariables["applewin_video_style"] = config.videoStyle;
+        ourVariables["applewin_video_mode"] = config.videoMode;
+        ourVariables["applewin_slot3"] = config.vidHD ? "Video HD" : "Empty";
+        ourVariables["applewin_slot7"] = "Empty";
+
+        loadGame();
+
+        retro_system_av_info info;
+        retro_get_system_av_info(&info);
+
+        if (racing)
+        {
+            // TEXT page 2 ($0800-$0BFF) past the boot sector is whatever RAM was powered up with
+            uint8_t *ram = mainRAM();
+            for (uint16_t address = 0x0900; address < 0x0C00; ++address)
+                ram[address] = uint8_t(address ^ (address >> 8));
+        }
+
+        const size_t frames = ourFrames;
+        uint32_t hash = 2166136261u;
+        for (const Mode &mode : racing ? ourRacingModes : ourModes)
+        {
+            const uint32_t frameHash = runMode(mode);
+            hash = (hash ^ frameHash) * 16777619u;
+        }
+
+        if (config.vidHD)
+        {
+            hash = (hash ^ runMode(racing ? ourSHRRacingMode : ourSHRMode)) * 16777619u;
+            hash = (hash ^ runMode(ourSHROffMode)) * 16777619u;
+        }
+
+        if (ourFrames == frames)
+            fail("no frames");
+
+        retro_unload_game();
+
+        const std::string name = std::string(config.videoStyle) + ", " + config.videoMode + (config.vidHD ? ", VidHD" : "") +
+                                 " (" + std::to_string(info.geometry.base_width) + "x" +
+                                 std::to_string(info.geometry.base_height) + ")" + (racing ? ", racing" : "");
+        if (hash != (racing ? config.racingHash : config.hash))
+        {
+            char buffer[16];
+            snprintf(buffer, sizeof(buffer), "%08X", hash);
+            fail(name + ": frames hash " + buffer);
+        }
+
+        pass(name);
+        return hash;
+    }
+
+    void run_frame_skip(const FrameSkip &frameSkip)
+    {
+        ourVariables["applewin_video_style"] = "Half Scanlines";
+        ourVariables["applewin_video_mode"] = "Color (Composite Monitor)";
+        ourVariables["applewin_slot3"] = "Empty";
+        ourVariables["applewin_slot7"] = "Empty";
+        ourVariables["applewin_frame_skip"] = frameSkip.frameSkip;
+
+        retro_init();
+        loadGame();
+
+        // the floating bus also reads $1000-$1FFF (in HBL), which is partly random when powered up
+        uint8_t *ram = mainRAM();
+        for (uint16_t address = 0x0900; address < 0x2000; ++address)
+            ram[address] = uint8_t(address ^ (address >> 8));
+        std::copy(ourProbe.begin(), ourProbe.end(), ram + PROBE);
+        setMode(ourProbeMode);
+
+        uint32_t probesHash = 2166136261u;
+        uint32_t framesHash = 2166136261u;
+        for (int frame = 0; frame < 60; ++frame)
+        {
+            retro_run();
+
+            for (uint16_t address = PROBES; address < PROBES + 0x300; ++address)
+                probesHash = (probesHash ^ ram[address]) * 16777619u;
+            framesHash = (framesHash ^ ourFrameHash) * 16777619u;
+        }
+
+        // render every frame again: after a few, the whole frame is from ones that every level renders
+        ourVariables["applewin_frame_skip"] = "0";
+        ourVariablesUpdated = true;
+        for (int frame = 0; frame < 3; ++frame)
+        {
+            retro_run();
+        }
+        const uint32_t frameHash = ourFrameHash;
+
+        retro_unload_game();
+        retro_deinit();
+
+        const std::string name = std::string("frame skip ") + frameSkip.frameSkip;
+        char buffer[32];
+        if (probesHash != ourProbesHash)
+        {
+            snprintf(buffer, sizeof(buffer), "%08X", probesHash);
+            fail(name + ": probes hash " + buffer);
+        }
+        if (framesHash != frameSkip.framesHash)
+        {
+            snprintf(buffer, sizeof(buffer), "%08X", framesHash);
+            fail(name + ": frames hash " + buffer);
+        }
+        if (frameHash != ourFrameSkipHash)
+        {
+            snprintf(buffer, sizeof(buffer), "%08X", frameHash);
+            fail(name + ": frame hash " + buffer);
+        }
+
+        pass(name);
+    }
+
+    // the FLASH & frame-skip phases (and the scanner's position) outlive a game, but retro_init() restarts them:
+    // so each level, and each pass, starts from the same state
+    void test_all(const bool videoThread)
+    {
+        // configurations the video thread can't render (or the VidHD slot) are still rendered inline
+        ourVariables["applewin_video_thread"] = videoThread ? "On" : "Off";
+
+        for (const FrameSkip &frameSkip : ourFrameSkips)
+        {
+            run_frame_skip(frameSkip);
+        }
+
+        retro_init();
+        for (const Config &config : ourConfigs)
+        {
+            test_config(config, false);
+        }
+        // after all the others, as they only add frames: so the FLASH phase of the others doesn't depend on them
+        for (const Config &config : ourConfigs)
+        {
+            test_config(config, true);
+        }
+        for (const bool racing : {false, true})
+        {
+            for (const Config &config : ourMonochromeConfigs)
+            {
+                test_config(config, racing);
+            }
+        }
+        retro_deinit();
+    }
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    writeBootDisk();
+
+    retro_set_environment(environment);
+    retro_set_video_refresh(videoRefresh);
+    retro_set_audio_sample(audioSample);
+    retro_set_audio_sample_batch(audioSampleBatch);
+    retro_set_input_poll(inputPoll);
+    retro_set_input_state(inputState);
+
+    test_all(false);
+    test_all(true);
+
+    std::remove(ourDiskPath);
+
+    std::cout << "all video tests passed" << std::endl;
+    return 0;
+}
@@ -1,5 +1,6 @@
 #include "frontends/ncurses/asciiart.h"
 
+#include <algorithm>
 #include <cfloat>
 #include <memory>
 
@@ -30,6 +31,9 @@ namespace na2
 
         myBlocks.resize(128);
 
+        const int values = PPQ + 1;
+        myBestGlyphs.assign(values * values * values * values, UNKNOWN_GLYPH);
+
         init(1, 1); // normal size
     }
 
@@ -169,37 +173,43 @@ namespace na2
         return myChars;
     }
 
-    const ASCIIArt::Character &ASCIIArt::getCharacter(const Blocks &values)
+    uint8_t ASCIIArt::findBestGlyph(const Blocks &values) const
     {
-        const int zip = values.value;
+        uint8_t best = 0;
+        double bestError = DBL_MAX;
 
-        const std::unordered_map<int, Character>::const_iterator it = myAsciiPixels.find(zip);
-        if (it == myAsciiPixels.end())
+        for (size_t i = 0; i < myGlyphs.size(); ++i)
         {
-            Character &best = myAsciiPixels[zip];
-            best.error = DBL_MAX;
-
-            for (const Unicode &glyph : myGlyphs)
+            double foreground;
+            double background;
+            double error;
+            fit(values, myGlyphs[i], foreground, background, error);
+            if (error < bestError)
             {
-                double foreground;
-                double background;
-                double error;
-                fit(values, glyph, foreground, background, error);
-                if (error < best.error)
-                {
-                    best.error = error;
-                    best.foreground = foreground;
-                    best.background = background;
-                    best.c = glyph.c;
-                }
+                bestError = error;
+                best = i;
             }
-
-            return best;
         }
-        else
+
+        return best;
+    }
+
+    ASCIIArt::Character ASCIIArt::getCharacter(const Blocks &values)
+    {
+        const int base = PPQ + 1;
+        uint8_t &index = myBestGlyphs[((values[0] * base + values[1]) * base + values[2]) * base + values[3]];
+        if (index == UNKNOWN_GLYPH)
         {
-            return it->second;
+            index = findBestGlyph(values);
         }
+
+        // only the best glyph's colours
+        const Unicode &glyph = myGlyphs[index];
+
+        Character best;
+        best.c = glyph.c;
+        fit(values, glyph, best.foreground, best.background, best.error);
+        return best;
     }
 
     void ASCIIArt::fit(const Blocks &art, const Unicode &glyph, double &foreground, double &background, double &error)
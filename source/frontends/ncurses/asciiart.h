@@ -1,6 +1,7 @@
 #pragma once
 
-#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <initializer_list>
 
@@ -79,7 +80,10 @@ namespace na2
     private:
         static const int PPQ; // Pixels per Quadrant
 
-        std::unordered_map<int, Character> myAsciiPixels;
+        // the best glyph for every combination of the 4 quadrants' values [0, PPQ]
+        // filled on first use, as only a few hundred combinations are ever seen
+        static const uint8_t UNKNOWN_GLYPH = 0xff;
+        std::vector<uint8_t> myBestGlyphs;
 
         struct Unicode
         {
@@ -99,7 +103,8 @@ namespace na2
         mutable std::vector<std::vector<Blocks>> myValues; // workspace
         std::vector<std::vector<Character>> myChars;       // workspace
 
-        const Character &getCharacter(const Blocks &values);
+        uint8_t findBestGlyph(const Blocks &values) const;
+        Character getCharacter(const Blocks &values);
         static void fit(const Blocks &art, const Unicode &glyph, double &foreground, double &background, double &error);
     };
 
@@ -115,6 +115,7 @@ namespace na2
         const int left = std::max(0, (COLS - width) / 2);
 
         myFrame.reset(newwin(1 + myRows + 1, width, 0, left), delwin);
+        myCellsValid = false;
         box(myFrame.get(), 0, 0);
         wtimeout(myFrame.get(), 0);
         keypad(myFrame.get(), true);
@@ -171,8 +172,6 @@ namespace na2
         myTextBank1 = MemGetAuxPtr(0x400 << displaypage2);
         myTextBank0 = MemGetMainPtr(0x400 << displaypage2);
 
-        typedef bool (NFrame::*VideoUpdateFuncPtr_t)(Video &, int, int, int, int, int);
-
         VideoUpdateFuncPtr_t update;
 
         int rowFactor, colFactor;
@@ -242,11 +241,31 @@ namespace na2
         Init(24 * rowFactor, 40 * colFactor);
         myAsciiArt->init(rowFactor, colFactor);
 
-        if (g_nAppMode != MODE_RUNNING)
+        const bool dim = g_nAppMode != MODE_RUNNING;
+        if (dim)
         {
             wattron(myFrame.get(), A_DIM);
         }
 
+        VideoUpdateFuncPtr_t mixedUpdate = update;
+        if (video.VideoGetSWMIXED())
+        {
+            mixedUpdate = video.VideoGetSW80COL() ? &NFrame::Update80ColCell : &NFrame::Update40ColCell;
+        }
+
+        // a cell's value only means the same if it is drawn the same way
+        if (update != myCellsUpdate[0] || mixedUpdate != myCellsUpdate[1] || dim != myCellsDim)
+        {
+            myCellsUpdate[0] = update;
+            myCellsUpdate[1] = mixedUpdate;
+            myCellsDim = dim;
+            myCellsValid = false;
+        }
+        if (!myCellsValid)
+        {
+            myCells.assign(40 * 24, 0);
+        }
+
         int y = 0;
         int ypixel = 0;
         while (y < 20)
@@ -264,10 +283,7 @@ namespace na2
             ypixel += 16;
         }
 
-        if (video.VideoGetSWMIXED())
-        {
-            update = video.VideoGetSW80COL() ? &NFrame::Update80ColCell : &NFrame::Update40ColCell;
-        }
+        update = mixedUpdate;
 
         while (y < 24)
         {
@@ -284,14 +300,27 @@ namespace na2
             ypixel += 16;
         }
 
-        if (g_nAppMode != MODE_RUNNING)
+        if (dim)
         {
             wattroff(myFrame.get(), A_DIM);
         }
 
+        myCellsValid = true;
         wrefresh(myFrame.get());
     }
 
+    bool NFrame::CellChanged(int x, int y, uint64_t value)
+    {
+        uint64_t &cell = myCells[y * 40 + x];
+        if (myCellsValid && cell == value)
+        {
+            return false;
+        }
+
+        cell = value;
+        return true;
+    }
+
     void NFrame::FrameRefreshStatus(int /* drawflags */)
     {
         if (myStatus)
@@ -394,6 +423,11 @@ namespace na2
         BYTE ch = *(myTextBank0 + offset);
 
         const chtype ch2 = MapCharacter(video, ch);
+        if (!CellChanged(x, y, ch2))
+        {
+            return false;
+        }
+
         mvwaddch(myFrame.get(), 1 + y, 1 + x, ch2);
 
         return true;
@@ -407,9 +441,13 @@ namespace na2
         WINDOW *win = myFrame.get();
 
         const chtype ch12 = MapCharacter(video, ch1);
-        mvwaddch(win, 1 + y, 1 + 2 * x, ch12);
-
         const chtype ch22 = MapCharacter(video, ch2);
+        if (!CellChanged(x, y, (uint64_t(ch12) << 32) | ch22))
+        {
+            return false;
+        }
+
+        mvwaddch(win, 1 + y, 1 + 2 * x, ch12);
         mvwaddch(win, 1 + y, 1 + 2 * x + 1, ch22);
 
         return true;
@@ -418,6 +456,10 @@ namespace na2
     bool NFrame::UpdateLoResCell(Video &, int x, int y, int xpixel, int ypixel, int offset)
     {
         BYTE val = *(myTextBank0 + offset);
+        if (!CellChanged(x, y, val))
+        {
+            return false;
+        }
 
         const int pair = myNCurses->colors->getPair(val);
 
@@ -439,13 +481,24 @@ namespace na2
 
     bool NFrame::UpdateDLoResCell(Video &, int x, int y, int xpixel, int ypixel, int offset)
     {
-        return true;
+        return false;
     }
 
     bool NFrame::UpdateHiResCell(Video &, int x, int y, int xpixel, int ypixel, int offset)
     {
         const BYTE *base = myHiresBank0 + offset;
 
+        // the cell's 8 bytes: its 7x8 pixels (and their group colour bits)
+        uint64_t pattern = 0;
+        for (size_t i = 0; i < 8; ++i)
+        {
+            pattern |= uint64_t(base[0x0400 * i]) << (8 * i);
+        }
+        if (!CellChanged(x, y, pattern))
+        {
+            return false;
+        }
+
         const ASCIIArt::array_char_t &chs = myAsciiArt->getCharacters(base);
 
         const int rows = chs.size();
@@ -472,7 +525,7 @@ namespace na2
 
     bool NFrame::UpdateDHiResCell(Video &, int x, int y, int xpixel, int ypixel, int offset)
     {
-        return true;
+        return false;
     }
 
     int NFrame::FrameMessageBox(LPCSTR lpText, LPCSTR lpCaption, UINT uType)
@@ -5,6 +5,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace na2
 {
@@ -39,6 +40,9 @@ namespace na2
         void ReInit();
 
     private:
+        // returns true if the cell has been drawn, false if it has not changed
+        typedef bool (NFrame::*VideoUpdateFuncPtr_t)(Video &, int, int, int, int, int);
+
         const std::shared_ptr<EvDevPaddle> myPaddle;
 
         bool myFullscreen;
@@ -61,6 +65,14 @@ namespace na2
         LPBYTE myHiresBank1;
         LPBYTE myHiresBank0;
 
+        // what each of the 40x24 cells was last drawn from, so only the ones which change are drawn again
+        std::vector<uint64_t> myCells;
+        bool myCellsValid = false;
+        VideoUpdateFuncPtr_t myCellsUpdate[2] = {nullptr, nullptr}; // rows 0-19 & 20-23
+        bool myCellsDim = false;
+
+        bool CellChanged(int x, int y, uint64_t value);
+
         void VideoUpdateFlash();
 
         chtype MapCharacter(Video &video, BYTE ch);
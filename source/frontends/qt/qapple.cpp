@@ -198,6 +198,8 @@ void QApple::on_timer()
     const qint64 wallclockTargetMS = elapsed + myOptions.msFullSpeed;
     const UINT dwClksPerFrame = NTSC_GetCyclesPerFrame();
 
+    Paddle::updateAxes();
+
     int count = 0;
     do
     {
@@ -35,7 +35,7 @@ namespace sa2
         glTexImage2D(GL_TEXTURE_2D, 0, SA2_IMAGE_FORMAT_INTERNAL, width, height, 0, SA2_IMAGE_FORMAT, type, nullptr);
     }
 
-    void loadTextureFromData(GLuint texture, const uint8_t *data, size_t width, size_t height, size_t pitch)
+    void loadTextureFromData(GLuint texture, const uint8_t *data, size_t width, size_t height, size_t pitch, size_t y)
     {
         glBindTexture(GL_TEXTURE_2D, texture);
         glPixelStorei(UGL_UNPACK_LENGTH, pitch); // in pixels
@@ -47,7 +47,7 @@ namespace sa2
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
         const GLenum type = GL_UNSIGNED_BYTE;
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, SA2_IMAGE_FORMAT, type, data);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y, width, height, SA2_IMAGE_FORMAT, type, data);
         // reset to default state
         glPixelStorei(UGL_UNPACK_LENGTH, 0);
     }
@@ -7,6 +7,8 @@ namespace sa2
 {
 
     void allocateTexture(GLuint texture, size_t width, size_t height);
-    void loadTextureFromData(GLuint texture, const uint8_t *data, size_t width, size_t height, size_t pitch);
+    // 'height' rows from 'data', to the texture's rows from 'y'
+    void loadTextureFromData(
+        GLuint texture, const uint8_t *data, size_t width, size_t height, size_t pitch, size_t y = 0);
 
 } // namespace sa2
@@ -161,11 +161,19 @@ namespace sa2
         myOffset = (width * borderHeight + borderWidth) * sizeof(bgra_t);
 
         allocateTexture(myTexture, myBorderlessWidth, myBorderlessHeight);
+        myFrameDiff.reset(myBorderlessWidth, myBorderlessHeight);
     }
 
     void SDLImGuiFrame::UpdateTexture()
     {
-        loadTextureFromData(myTexture, myFramebuffer.data() + myOffset, myBorderlessWidth, myBorderlessHeight, myPitch);
+        // only the rows which have changed since the last upload
+        const uint8_t *data = myFramebuffer.data() + myOffset;
+        size_t first, last;
+        if (myFrameDiff.update(data, myPitch * sizeof(bgra_t), first, last))
+        {
+            loadTextureFromData(
+                myTexture, data + first * myPitch * sizeof(bgra_t), myBorderlessWidth, last - first, myPitch, first);
+        }
     }
 
     void SDLImGuiFrame::ClearBackground()
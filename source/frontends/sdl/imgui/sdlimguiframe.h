@@ -3,6 +3,7 @@
 #include "frontends/sdl/sdlframe.h"
 #include "frontends/sdl/imgui/sdlsettings.h"
 #include "frontends/sdl/imgui/glselector.h"
+#include "frontends/common2/framediff.h"
 
 namespace sa2
 {
@@ -43,6 +44,7 @@ namespace sa2
 
         SDL_GLContext myGLContext;
         ImTextureID myTexture;
+        common2::FrameDiff myFrameDiff;
 
         std::string myIniFileLocation;
         ImFont *myDebuggerFont;
@@ -15,6 +15,7 @@
 #include "Registry.h"
 #include "Utilities.h"
 #include "Memory.h"
+#include "NTSC.h"
 #include "ParallelPrinter.h"
 #include "SaveState.h"
 #include "Uthernet2.h"
@@ -258,6 +259,12 @@ namespace sa2
                     if (ImGui::Button("MAX"))
                         setSpeedMultiplier(frame, SPEED_MAX);
 
+                    int frameSkip = NTSC_GetFrameSkip();
+                    if (ImGui::SliderInt("Frame skip", &frameSkip, 0, NTSC_MAX_FRAME_SKIP))
+                    {
+                        NTSC_SetFrameSkip(frameSkip);
+                    }
+
                     ImGui::Separator();
 
                     const common2::Speed::Stats stats = frame->getSpeed().getSpeedStats();
@@ -311,6 +318,10 @@ namespace sa2
                         {
                             SetRamWorksMemorySize(ramWorksMemorySize);
                         }
+                        if (expansion == CT_RamWorksIII)
+                        {
+                            ImGui::LabelText("RamWorks resident", "%u banks", GetRamWorksResidentBanks());
+                        }
                     }
 
                     ImGui::Separator();
@@ -92,6 +92,13 @@ namespace
 
     void insertTape(sa2::SDLFrame *frame, const char *filename)
     {
+        // PCM & float .wav files are streamed from disk
+        if (CassetteTape::instance().openFile(filename))
+        {
+            return;
+        }
+
+        // other formats (eg. ADPCM) are converted by SDL in memory
         SDL_AudioSpec wavSpec;
         Uint32 wavLength;
         Uint8 *tmpBuffer;
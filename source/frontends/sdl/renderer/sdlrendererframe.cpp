@@ -61,11 +61,26 @@ namespace sa2
         myRect.w = sw;
         myRect.h = sh;
         myPitch = width * sizeof(bgra_t);
+        myOffset = video.GetFrameBufferBorderHeight() * myPitch + video.GetFrameBufferBorderWidth() * sizeof(bgra_t);
+
+        myFrameDiff.reset(sw, sh);
+    }
+
+    void SDLRendererFrame::UpdateTexture()
+    {
+        // only the visible rows which have changed
+        const uint8_t *data = myFramebuffer.data() + myOffset;
+        size_t first, last;
+        if (myFrameDiff.update(data, myPitch, first, last))
+        {
+            const SDL_Rect rect = {int(myRect.x), int(myRect.y + first), int(myRect.w), int(last - first)};
+            SDL_UpdateTexture(myTexture.get(), &rect, data + first * myPitch, int(myPitch));
+        }
     }
 
     void SDLRendererFrame::VideoPresentScreen()
     {
-        SDL_UpdateTexture(myTexture.get(), nullptr, myFramebuffer.data(), myPitch);
+        UpdateTexture();
         SDL_RenderClear(myRenderer.get());
         SDL_RenderCopyEx(myRenderer.get(), myTexture.get(), &myRect, nullptr, 0.0, nullptr, SDL_FLIP_VERTICAL);
         SDL_RenderPresent(myRenderer.get());
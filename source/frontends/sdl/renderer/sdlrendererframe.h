@@ -1,6 +1,7 @@
 #pragma once
 
 #include "frontends/sdl/sdlframe.h"
+#include "frontends/common2/framediff.h"
 #include <memory>
 
 namespace sa2
@@ -21,10 +22,15 @@ namespace sa2
         void ToggleMouseCursor() override;
 
     private:
+        void UpdateTexture();
+
         static constexpr PixelFormat_t ourPixelFormat = SDL_PIXELFORMAT_ARGB8888;
 
         Renderer_Rect_t myRect;
-        int myPitch;
+        size_t myPitch;
+        size_t myOffset;
+
+        common2::FrameDiff myFrameDiff;
 
         std::shared_ptr<SDL_Renderer> myRenderer;
         std::shared_ptr<SDL_Texture> myTexture;
@@ -9,10 +9,12 @@
 #include "NTSC.h"
 #include "CPU.h"
 #include "Interface.h"
+#include "VideoCapture.h"
 
 #include "linux/benchmark.h"
 
 #include <chrono>
+#include <thread>
 
 void VideoBenchmark(std::function<void()> redraw, std::function<void()> refresh)
 {
@@ -56,22 +58,80 @@ void VideoBenchmark(std::function<void()> redraw, std::function<void()> refresh)
     // adjust for broken ms
     totalhiresfps = totalhiresfps * onesecond / elapsed;
 
+    // AND SUPER HI-RES FRAMES, IF THERE'S A VIDHD CARD: ALTERNATING 320 & 640 SCANLINES, EACH WITH ITS OWN PALETTE
+    counter_t totalshrfps = 0;
+    if (video.HasVidHD())
+    {
+        const auto fillAux = [](const uint16_t begin, const uint16_t end, const int frame)
+        {
+            for (uint32_t addr = begin; addr < end; addr += 0x100)
+            {
+                uint8_t *page = MemGetAuxPtr(addr);
+                for (uint32_t i = 0; i < 0x100; i++)
+                    page[i] = uint8_t((addr >> 8) + i + frame);
+            }
+        };
+
+        video.SetVideoMode(VF_SHR);
+        fillAux(0x9D00, 0xA000, 0); // SCBs & palettes
+        for (uint32_t line = 0; line < 200; line++)
+            *MemGetAuxPtr(0x9D00 + line) = (line & 1) ? (0x80 | (line & 0xf)) : (line & 0xf);
+
+        start = std::chrono::steady_clock::now();
+        do
+        {
+            fillAux(0x2000, 0x9D00, int(totalshrfps));
+            refresh();
+            totalshrfps++;
+
+            const auto end = std::chrono::steady_clock::now();
+            elapsed = std::chrono::duration_cast<interval_t>(end - start).count();
+        } while (elapsed < onesecond);
+        totalshrfps = totalshrfps * onesecond / elapsed;
+
+        video.SetVideoMode(VF_HIRES);
+    }
+
     // DETERMINE HOW MANY 65C02 CLOCK CYCLES WE CAN EMULATE PER SECOND WITH
     // NOTHING ELSE GOING ON
-    counter_t totalmhz10[2] = {0, 0}; // bVideoUpdate & !bVideoUpdate
-    for (size_t i = 0; i < 2; i++)
+    // . and again with the video render thread, for the CPU thread's gain
+    const bool videoThread = NTSC_GetVideoThread();
+    counter_t totalmhz10[3] = {0, 0, 0}; // bVideoUpdate & !bVideoUpdate & bVideoUpdate (video thread)
+    for (size_t i = 0; i < 3; i++)
     {
+        NTSC_SetVideoThread(i == 2);
         CpuSetupBenchmark();
         start = std::chrono::steady_clock::now();
         do
         {
-            CpuExecute(100000, i == 0 ? true : false);
+            CpuExecute(100000, i == 1 ? false : true);
             totalmhz10[i]++;
             const auto end = std::chrono::steady_clock::now();
             elapsed = std::chrono::duration_cast<interval_t>(end - start).count();
         } while (elapsed < onesecond);
         totalmhz10[i] = totalmhz10[i] * onesecond / elapsed;
     }
+    NTSC_SetVideoThread(videoThread);
+
+    // . and with frame-skip, where the skipped frames only advance the video scanner
+    const UINT frameSkip = NTSC_GetFrameSkip();
+    const UINT skipLevels[3] = {1, 3, 7};
+    counter_t skipmhz10[3] = {0, 0, 0}; // bVideoUpdate, 1 frame in 2, 4 & 8
+    for (size_t i = 0; i < 3; i++)
+    {
+        NTSC_SetFrameSkip(skipLevels[i]);
+        CpuSetupBenchmark();
+        start = std::chrono::steady_clock::now();
+        do
+        {
+            CpuExecute(100000, true);
+            skipmhz10[i]++;
+            const auto end = std::chrono::steady_clock::now();
+            elapsed = std::chrono::duration_cast<interval_t>(end - start).count();
+        } while (elapsed < onesecond);
+        skipmhz10[i] = skipmhz10[i] * onesecond / elapsed;
+    }
+    NTSC_SetFrameSkip(frameSkip);
 
     // IF THE PROGRAM COUNTER IS NOT IN THE EXPECTED RANGE AT THE END OF THE
     // CPU BENCHMARK, REPORT AN ERROR AND OPTIONALLY TRACK IT DOWN
@@ -119,6 +179,36 @@ void VideoBenchmark(std::function<void()> redraw, std::function<void()> refresh)
             }
         }
 
+    // DETERMINE HOW MANY 65C02 CLOCK CYCLES WE CAN EMULATE PER SECOND WHEN
+    // DOING NOTHING BUT HAMMERING A CARD'S I/O: THE FLOATING BUS (AN EMPTY SLOT),
+    // A DISK II'S NIBBLE READ LOOP, AND MOCKINGBOARD AY REGISTER WRITES
+    std::string iostr;
+    for (size_t type = 0; type < NUM_IOBENCH; type++)
+    {
+        const char *name[NUM_IOBENCH] = {"Floating bus MHz:", "Disk II latch MHz:", "Mockingboard MHz:"};
+        counter_t iomhz10[2] = {0, 0}; // bVideoUpdate & !bVideoUpdate
+        const bool hasCard = CpuSetupIoBenchmark((IoBenchmark_e)type);
+        for (size_t i = 0; hasCard && i < 2; i++)
+        {
+            CpuSetupIoBenchmark((IoBenchmark_e)type);
+            start = std::chrono::steady_clock::now();
+            do
+            {
+                CpuExecute(100000, i == 0 ? true : false);
+                iomhz10[i]++;
+                const auto end = std::chrono::steady_clock::now();
+                elapsed = std::chrono::duration_cast<interval_t>(end - start).count();
+            } while (elapsed < onesecond);
+            iomhz10[i] = iomhz10[i] * onesecond / elapsed;
+        }
+
+        iostr += hasCard ? StrFormat(
+                               "%s\t%u.%u (video update), %u.%u (full-speed)\n", name[type], (unsigned)(iomhz10[0] / 10),
+                               (unsigned)(iomhz10[0] % 10), (unsigned)(iomhz10[1] / 10), (unsigned)(iomhz10[1] % 10))
+                         : StrFormat("%s\tn/a (no card)\n", name[type]);
+    }
+    CpuSetupBenchmark();
+
     // DO A REALISTIC TEST OF HOW MANY FRAMES PER SECOND WE CAN PRODUCE
     // WITH FULL EMULATION OF THE CPU, JOYSTICK, AND DISK HAPPENING AT
     // THE SAME TIME
@@ -157,15 +247,77 @@ void VideoBenchmark(std::function<void()> redraw, std::function<void()> refresh)
     } while (elapsed < onesecond);
     realisticfps = realisticfps * onesecond / elapsed;
 
+    // IF FRAMES ARE BEING CAPTURED (--video-capture), RUN THE SAME LOOP AT 1X,
+    // A FRAME EVERY 1/60S, CAPTURING EACH ONE: DOES IT HOLD THE FRAME RATE?
+    std::string capturestr;
+    if (VideoCaptureIsWriting())
+    {
+        const UINT dropped = VideoCaptureGetDroppedFrames();
+        const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(dwClksPerFrame / g_fCurrentCLK6502));
+        counter_t captureframes = 0;
+        counter_t capturelate = 0; // frames that took longer than their period
+        counter_t capturebusy = 0; // us spent emulating, drawing & capturing
+
+        start = std::chrono::steady_clock::now();
+        auto next = start;
+        do
+        {
+            const auto begin = std::chrono::steady_clock::now();
+            for (size_t cycles = 0; cycles < dwClksPerFrame;)
+            {
+                const uint32_t executedcycles = CpuExecute(cyclesPerMs, true);
+                cycles += executedcycles;
+                GetCardMgr().GetDisk2CardMgr().Update(executedcycles);
+            }
+            if (captureframes & 1)
+                memset(mem + 0x2000, 0xAA, 0x2000);
+            else
+                memcpy(mem + 0x2000, mem + ((captureframes & 2) ? 0x4000 : 0x6000), 0x2000);
+            captureframes++;
+            refresh();
+            video.Video_CaptureFrame();
+
+            const auto end = std::chrono::steady_clock::now();
+            capturebusy += std::chrono::duration_cast<interval_t>(end - begin).count();
+            next += period;
+            if (end > next)
+            {
+                capturelate++;
+                next = end;
+            }
+            else
+            {
+                std::this_thread::sleep_until(next);
+            }
+            elapsed = std::chrono::duration_cast<interval_t>(next - start).count();
+        } while (elapsed < 2 * onesecond);
+
+        capturestr = StrFormat(
+            "Capture at 1x:\t%.1f ms per frame (of %.1f), %u late, %u of %u dropped\n",
+            capturebusy / 1000.0 / captureframes, dwClksPerFrame * 1000.0 / g_fCurrentCLK6502, (unsigned)capturelate,
+            VideoCaptureGetDroppedFrames() - dropped, (unsigned)captureframes);
+    }
+
     // DISPLAY THE RESULTS
     const std::string outstr = StrFormat(
         "Pure Video FPS:\t%u\n"
+        "%s"
         "Pure CPU MHz:\t%u.%u%s (video update)\n"
-        "Pure CPU MHz:\t%u.%u%s (full-speed)\n\n"
+        "Pure CPU MHz:\t%u.%u%s (full-speed)\n"
+        "Pure CPU MHz:\t%u.%u%s (video thread)\n"
+        "Pure CPU MHz:\t%u.%u, %u.%u, %u.%u (frame skip 1, 3, 7)\n"
+        "%s"
+        "%s\n"
         "EXPECTED AVERAGE VIDEO GAME\n"
         "PERFORMANCE: %u FPS",
-        (unsigned)totalhiresfps, (unsigned)(totalmhz10[0] / 10), (unsigned)(totalmhz10[0] % 10),
+        (unsigned)totalhiresfps,
+        video.HasVidHD() ? StrFormat("Pure Video FPS:\t%u (SHR)\n", (unsigned)totalshrfps).c_str() : "",
+        (unsigned)(totalmhz10[0] / 10), (unsigned)(totalmhz10[0] % 10),
         (LPCTSTR)(IS_APPLE2 ? " (6502)" : ""), (unsigned)(totalmhz10[1] / 10), (unsigned)(totalmhz10[1] % 10),
-        (LPCTSTR)(IS_APPLE2 ? " (6502)" : ""), (unsigned)realisticfps);
+        (LPCTSTR)(IS_APPLE2 ? " (6502)" : ""), (unsigned)(totalmhz10[2] / 10), (unsigned)(totalmhz10[2] % 10),
+        (LPCTSTR)(IS_APPLE2 ? " (6502)" : ""), (unsigned)(skipmhz10[0] / 10), (unsigned)(skipmhz10[0] % 10),
+        (unsigned)(skipmhz10[1] / 10), (unsigned)(skipmhz10[1] % 10), (unsigned)(skipmhz10[2] / 10),
+        (unsigned)(skipmhz10[2] % 10), iostr.c_str(), capturestr.c_str(), (unsigned)realisticfps);
     frame.FrameMessageBox(outstr.c_str(), "Benchmarks", MB_ICONINFORMATION | MB_SETFOREGROUND);
 }
@@ -8,26 +8,186 @@
 #include "Pravets.h"
 #include "CPU.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <limits>
 
+namespace
+{
+
+    uint16_t read16(const uint8_t *p)
+    {
+        return p[0] | (p[1] << 8);
+    }
+
+    uint32_t read32(const uint8_t *p)
+    {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24);
+    }
+
+    constexpr uint64_t never = std::numeric_limits<uint64_t>::max();
+
+} // namespace
+
 CassetteTape &CassetteTape::instance()
 {
     static CassetteTape tape;
     return tape;
 }
 
-void CassetteTape::setData(const std::string &filename, const std::vector<tape_data_t> &data, const int frequency)
+bool CassetteTape::readWavHeader(std::ifstream &file, WavFormat &wav)
+{
+    uint8_t header[12];
+    if (!file.read(reinterpret_cast<char *>(header), sizeof(header)) || memcmp(header, "RIFF", 4) ||
+        memcmp(header + 8, "WAVE", 4))
+    {
+        return false;
+    }
+
+    bool hasFormat = false;
+    uint8_t chunk[8];
+    while (file.read(reinterpret_cast<char *>(chunk), sizeof(chunk)))
+    {
+        const uint32_t size = read32(chunk + 4);
+        const std::streamoff start = file.tellg();
+
+        if (!memcmp(chunk, "fmt ", 4))
+        {
+            uint8_t fmt[40] = {};
+            if (size < 16 || !file.read(reinterpret_cast<char *>(fmt), std::min<uint32_t>(size, sizeof(fmt))))
+            {
+                return false;
+            }
+            wav.format = read16(fmt);
+            wav.channels = read16(fmt + 2);
+            wav.frequency = read32(fmt + 4);
+            wav.blockAlign = read16(fmt + 12);
+            wav.bitsPerSample = read16(fmt + 14);
+            if (wav.format == 0xFFFE && size >= 26)
+            {
+                // WAVE_FORMAT_EXTENSIBLE: the sub-format GUID starts with the format tag
+                wav.format = read16(fmt + 24);
+            }
+            hasFormat = true;
+        }
+        else if (!memcmp(chunk, "data", 4))
+        {
+            const bool pcm = wav.format == 1 && wav.bitsPerSample % 8 == 0 && wav.bitsPerSample >= 8 &&
+                             wav.bitsPerSample <= 32;
+            const bool ieeeFloat = wav.format == 3 && wav.bitsPerSample == 32;
+            if (!hasFormat || !(pcm || ieeeFloat) || !wav.channels || wav.frequency <= 0 ||
+                wav.blockAlign != wav.channels * wav.bitsPerSample / 8)
+            {
+                return false;
+            }
+
+            // a truncated file (eg. a recording that was interrupted) plays as far as it goes
+            file.seekg(0, std::ios::end);
+            const std::streamoff available = std::max<std::streamoff>(file.tellg() - start, 0);
+
+            wav.dataOffset = start;
+            wav.numFrames = std::min<std::streamoff>(size, available) / wav.blockAlign;
+            return true;
+        }
+
+        file.seekg(start + size + (size & 1)); // chunks are word aligned
+    }
+
+    return false;
+}
+
+CassetteTape::tape_data_t CassetteTape::convertFrame(const uint8_t *frame) const
+{
+    // same conversion to S8 as SDL, and mono is the average of the channels
+    const size_t bytesPerSample = myWav.bitsPerSample / 8;
+    int sum = 0;
+    for (size_t channel = 0; channel < myWav.channels; ++channel)
+    {
+        const uint8_t *p = frame + channel * bytesPerSample;
+        if (myWav.format == 3)
+        {
+            float value;
+            memcpy(&value, p, sizeof(value));
+            sum += int(std::clamp(value, -1.0f, 1.0f) * 127.0f);
+        }
+        else if (bytesPerSample == 1)
+        {
+            sum += int(p[0]) - 128; // unsigned
+        }
+        else
+        {
+            sum += int8_t(p[bytesPerSample - 1]); // the most significant byte
+        }
+    }
+    return sum / int(myWav.channels);
+}
+
+void CassetteTape::loadChunk(const size_t pos)
+{
+    const size_t frames = std::min(myChunkFrames, mySize - pos);
+    myRawChunk.resize(frames * myWav.blockAlign);
+
+    myFile.clear();
+    myFile.seekg(myWav.dataOffset + std::streamoff(pos) * myWav.blockAlign);
+    myFile.read(reinterpret_cast<char *>(myRawChunk.data()), myRawChunk.size());
+    const size_t framesRead = myFile.gcount() / myWav.blockAlign;
+
+    myChunk.resize(frames);
+    for (size_t i = 0; i < framesRead; ++i)
+    {
+        myChunk[i] = convertFrame(myRawChunk.data() + i * myWav.blockAlign);
+    }
+    std::fill(myChunk.begin() + framesRead, myChunk.end(), 0); // read error: silence
+    myChunkStart = pos;
+}
+
+CassetteTape::tape_data_t CassetteTape::getSample(const size_t pos)
 {
+    if (pos - myChunkStart >= myChunk.size())
+    {
+        loadChunk(pos);
+    }
+    return myChunk[pos - myChunkStart];
+}
+
+bool CassetteTape::openFile(const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    WavFormat wav;
+    if (!file || !readWavHeader(file, wav) || !wav.numFrames)
+    {
+        return false;
+    }
+
+    eject();
+    myFile = std::move(file);
+    myWav = wav;
+    mySize = wav.numFrames;
+    myFrequency = wav.frequency;
     myFilename = filename;
-    myData = data;
+    rewind();
+    return true;
+}
+
+void CassetteTape::setData(const std::string &filename, const std::vector<tape_data_t> &data, const int frequency)
+{
+    eject();
+    myChunk = data;
+    mySize = data.size();
     myFrequency = frequency;
+    myFilename = filename;
     rewind();
 }
 
 void CassetteTape::eject()
 {
     rewind();
-    myData.clear();
+    myFile.close();
+    myChunk = std::vector<tape_data_t>();
+    myRawChunk = std::vector<uint8_t>();
+    myChunkStart = 0;
+    mySize = 0;
 }
 
 void CassetteTape::rewind()
@@ -39,9 +199,15 @@ void CassetteTape::rewind()
     }
     myBaseCycles = std::nullopt;
     myReachedEnd = false;
+    myLastBit = 1;
+
+    myScanPos = 0;
+    myScanPrevious = 0;
+    myScanBit = 1;
+    myNextEdge = -1;
 }
 
-BYTE CassetteTape::getBitValue(const tape_data_t val)
+void CassetteTape::findNextEdge()
 {
     // threshold not needed for https://asciiexpress.net
     // but probably necessary for a real audio file
@@ -51,47 +217,95 @@ BYTE CassetteTape::getBitValue(const tape_data_t val)
     // we are extracting the sign bit (set for negative numbers)
     // this is really important for the asymmetric wave in https://asciiexpress.net/diskserver/
     // not so much for the other cases
-    if (val > myThreshold)
+    //
+    // the wave is linearly interpolated between samples and rounded,
+    // so it crosses the threshold at +/-(myThreshold + 0.5)
+    const double level = myThreshold + 0.5;
+
+    while (myScanPos < mySize)
     {
-        myLastBit = 0;
+        const size_t pos = myScanPos;
+        const int a = myScanPrevious;
+        const int b = getSample(pos);
+        myScanPrevious = b;
+        ++myScanPos;
+
+        if (myScanBit ? (b > myThreshold) : (b < -myThreshold))
+        {
+            // a is always on the other side of the threshold (or 0 before the first sample)
+            const double crossing = myScanBit ? level : -level;
+            const double position = double(pos) - 1.0 + (crossing - a) / (b - a);
+            myNextEdge = std::max(position, 0.0);
+            myScanBit ^= 1;
+            return;
+        }
     }
-    else if (val < -myThreshold)
+
+    if (myScanBit == 0)
     {
-        myLastBit = 1;
+        // past the end the wave is negative
+        myNextEdge = double(mySize - 1);
+        myScanBit = 1;
+        return;
     }
-    // else leave it unchanged to the previous value
-    return myLastBit;
+
+    myNextEdge = -1;
+}
+
+uint64_t CassetteTape::getCycle(const double position) const
+{
+    // the first cycle that reads (at least) this position
+    return *myBaseCycles + uint64_t(std::ceil(position * myClock / myFrequency));
+}
+
+void CassetteTape::updateEventCycles()
+{
+    myClock = g_fCurrentCLK6502;
+    myNextEdgeCycle = (myNextEdge >= 0) ? getCycle(myNextEdge) : never;
+
+    // getValue() isn't called all the way through the end of the tape,
+    // presumably because it read all the data it cared about, so we fudge it at 99%.
+    const double endPosition = std::min(std::floor(mySize * 0.99) + 1.0, double(mySize - 1));
+    myEndCycle = myReachedEnd ? never : getCycle(endPosition);
+
+    myNextEventCycle = std::min(myNextEdgeCycle, myEndCycle);
 }
 
-CassetteTape::tape_data_t CassetteTape::getCurrentWave(size_t &pos) const
+void CassetteTape::advance(const uint64_t cycles)
 {
-    if (myBaseCycles)
+    if (myClock != g_fCurrentCLK6502)
     {
-        const double delta = g_nCumulativeCycles - *myBaseCycles;
-        const double position = delta / g_fCurrentCLK6502 * myFrequency;
-        pos = static_cast<size_t>(position);
+        updateEventCycles();
+    }
 
-        if (pos + 1 < myData.size())
-        {
-            // linear interpolation
-            const double reminder = position - pos;
-            const double value = (1.0 - reminder) * myData[pos] + reminder * myData[pos + 1];
-            return lround(value);
-        }
-        else
-        {
-            pos = myData.size() - 1;
-        }
+    while (cycles >= myNextEdgeCycle)
+    {
+        myLastBit ^= 1;
+        findNextEdge();
+        myNextEdgeCycle = (myNextEdge >= 0) ? getCycle(myNextEdge) : never;
     }
-    else
+
+    if (cycles >= myEndCycle)
     {
-        pos = 0;
+        // playback ended, notify playback stop
+        myReachedEnd = true; // avoid invoking callback again
+        myEndCycle = never;
+        if (playbackRateChangeCallback)
+        {
+            playbackRateChangeCallback(0);
+        }
     }
-    return std::numeric_limits<tape_data_t>::min();
+
+    myNextEventCycle = std::min(myNextEdgeCycle, myEndCycle);
 }
 
 BYTE CassetteTape::getValue(const ULONG nExecutedCycles)
 {
+    if (!mySize)
+    {
+        return myLastBit;
+    }
+
     CpuCalcCycles(nExecutedCycles);
 
     if (!myBaseCycles)
@@ -102,38 +316,58 @@ BYTE CassetteTape::getValue(const ULONG nExecutedCycles)
         {
             playbackRateChangeCallback(1);
         }
+        findNextEdge();
+        updateEventCycles();
+    }
+
+    if (g_nCumulativeCycles >= myNextEventCycle || myClock != g_fCurrentCLK6502)
+    {
+        advance(g_nCumulativeCycles);
     }
 
-    size_t pos;
-    const tape_data_t val = getCurrentWave(pos);
-    const BYTE highBit = getBitValue(val);
+    return myLastBit;
+}
 
-    if (pos > (myData.size() * 0.99) && !myReachedEnd)
+UINT CassetteTape::getIdlePollCycles(const ULONG nExecutedCycles) const
+{
+    if (!mySize)
     {
-        // playback ended, notify playback stop
-        // - getValue() isn't called all the way through pos == myData.size() - 1,
-        //   presumably because it read all the data it cared about, so we fudge it
-        //   at 99%.
-        myReachedEnd = true; // avoid invoking callback again
-        if (playbackRateChangeCallback)
-        {
-            playbackRateChangeCallback(0);
-        }
+        return std::numeric_limits<UINT>::max(); // no tape
     }
 
-    return highBit;
+    if (!myBaseCycles || myClock != g_fCurrentCLK6502)
+    {
+        return 0; // next read starts play, or recomputes the edges
+    }
+
+    const uint64_t cycles = CpuGetCumulativeCycles(nExecutedCycles); // a query: mustn't update g_nCumulativeCycles
+    if (cycles >= myNextEventCycle)
+    {
+        return 0;
+    }
+
+    return UINT(std::min<uint64_t>(myNextEventCycle - cycles, std::numeric_limits<UINT>::max()));
+}
+
+double CassetteTape::getPosition() const
+{
+    if (!myBaseCycles || !mySize)
+    {
+        return 0;
+    }
+    const double delta = g_nCumulativeCycles - *myBaseCycles;
+    const double position = delta / g_fCurrentCLK6502 * myFrequency;
+    return std::min(position, double(mySize - 1));
 }
 
 void CassetteTape::getTapeInfo(TapeInfo &info) const
 {
     info.filename = myFilename;
-    size_t pos;
-    getCurrentWave(pos);
-    const size_t size = myData.size();
+    const double position = getPosition();
     info.bit = myLastBit;
-    info.duration = (size * 1000.0) / myFrequency;
-    info.position = (pos * 1000.0) / myFrequency;
-    info.playbackRate = (!myReachedEnd && myBaseCycles && pos < size - 1) ? 1 : 0;
+    info.duration = myFrequency ? (mySize * 1000.0) / myFrequency : 0;
+    info.position = myFrequency ? (position * 1000.0) / myFrequency : 0;
+    info.playbackRate = (!myReachedEnd && myBaseCycles && position < mySize - 1) ? 1 : 0;
     info.frequency = myFrequency;
 }
 
@@ -151,3 +385,11 @@ BYTE __stdcall TapeWrite(WORD, WORD address, BYTE, BYTE, ULONG nExecutedCycles)
 {
     return 0;
 }
+
+UINT TapeGetIdlePollCycles(ULONG nExecutedCycles)
+{
+    if (g_Apple2Type == A2TYPE_PRAVETS8A)
+        return 0;
+
+    return CassetteTape::instance().getIdlePollCycles(nExecutedCycles);
+}
@@ -2,17 +2,26 @@
 
 #include <vector>
 #include <cstdint>
+#include <fstream>
 #include <functional>
 #include <optional>
 
+// TAPEIN is a list of edges (threshold crossings, with hysteresis) extracted from the wave
+// - the wave is read (and converted to 8 bit mono) a chunk at a time, so memory use doesn't depend on its length
+// - edges are extracted as the tape plays, and each is turned into the cycle it happens at
+// - a read of TAPEIN is a cycle comparison against the next edge
 class CassetteTape
 {
 public:
     typedef int8_t tape_data_t;
 
+    bool openFile(const std::string &filename); // .wav (PCM or float), streamed from disk
     void setData(const std::string &filename, const std::vector<tape_data_t> &data, const int frequency);
     BYTE getValue(const ULONG nExecutedCycles);
 
+    // # of cycles that getValue() returns the same value without side-effects (0 = don't know)
+    UINT getIdlePollCycles(const ULONG nExecutedCycles) const;
+
     struct TapeInfo
     {
         std::string_view filename;
@@ -32,16 +41,53 @@ public:
     static CassetteTape &instance();
 
 private:
-    BYTE getBitValue(const tape_data_t val);
-    tape_data_t getCurrentWave(size_t &pos) const;
+    struct WavFormat
+    {
+        uint16_t format; // 1 = PCM, 3 = IEEE float
+        uint16_t channels;
+        uint16_t bitsPerSample;
+        uint16_t blockAlign;
+        int frequency;
+        std::streamoff dataOffset;
+        size_t numFrames;
+    };
 
-    std::vector<tape_data_t> myData;
+    static bool readWavHeader(std::ifstream &file, WavFormat &wav);
+    tape_data_t convertFrame(const uint8_t *frame) const;
+
+    tape_data_t getSample(const size_t pos);
+    void loadChunk(const size_t pos);
+    void findNextEdge();
+    uint64_t getCycle(const double position) const;
+    void updateEventCycles();
+    void advance(const uint64_t cycles);
+    double getPosition() const;
+
+    // the wave: either all in myChunk (setData), or streamed from myFile
+    std::ifstream myFile;
+    WavFormat myWav = {};
+    std::vector<uint8_t> myRawChunk;
+    std::vector<tape_data_t> myChunk;
+    size_t myChunkStart = 0;
+    size_t mySize = 0;
+
+    // edge extraction: the pair of samples (myScanPos - 1, myScanPos) is the next to check
+    size_t myScanPos = 0;
+    tape_data_t myScanPrevious = 0;
+    BYTE myScanBit = 1;
+    double myNextEdge = 0; // position (in samples) of the next edge, < 0 if there are no more
 
     std::optional<int64_t> myBaseCycles;
+    double myClock = 0;              // the 6502 clock that the cycles below were computed with
+    uint64_t myNextEdgeCycle = 0;
+    uint64_t myEndCycle = 0;         // when to notify the end of playback
+    uint64_t myNextEventCycle = 0;   // min(myNextEdgeCycle, myEndCycle)
+
     bool myReachedEnd = false;
-    int myFrequency;
+    int myFrequency = 0;
     BYTE myLastBit = 1;     // negative wave
     std::string myFilename; // just for info
 
     static constexpr tape_data_t myThreshold = 5;
+    static constexpr size_t myChunkFrames = 0x10000;
 };
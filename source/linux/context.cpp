@@ -15,6 +15,7 @@
 #include "Keyboard.h"
 #include "CPU.h"
 #include "Riff.h"
+#include "VideoCapture.h"
 #include "SaveState.h"
 #include "Memory.h"
 #include "Speaker.h"
@@ -61,6 +62,7 @@ Initialisation::~Initialisation()
     Paddle::instance.reset();
 
     RiffFinishWriteFile();
+    VideoCaptureFinish();
 
     CloseHandle(g_hCustomRomF8);
     g_hCustomRomF8 = INVALID_HANDLE_VALUE;
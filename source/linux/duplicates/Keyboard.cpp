@@ -66,6 +66,12 @@ BYTE KeybReadData()
     return keycode;
 }
 
+// No clipboard paste: keys are only queued between CpuExecute() batches
+bool KeybIsClipboardActive()
+{
+    return false;
+}
+
 // $C010: read (!IS_APPLE2)
 BYTE KeybReadFlag()
 {
@@ -91,8 +91,14 @@ HANDLE WINAPI CreateThread(LPSECURITY_ATTRIBUTES, SIZE_T, LPTHREAD_START_ROUTINE
 BOOL WINAPI QueryPerformanceCounter(LARGE_INTEGER *counter)
 {
     const auto now = std::chrono::steady_clock::now();
-    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch());
-    counter->QuadPart = ms.count();
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch());
+    counter->QuadPart = us.count();
+    return TRUE;
+}
+
+BOOL WINAPI QueryPerformanceFrequency(LARGE_INTEGER *frequency)
+{
+    frequency->QuadPart = 1000000; // QueryPerformanceCounter() is in microseconds
     return TRUE;
 }
 
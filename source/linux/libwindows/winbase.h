@@ -50,6 +50,7 @@ typedef union _LARGE_INTEGER
 } LARGE_INTEGER;
 
 BOOL WINAPI QueryPerformanceCounter(LARGE_INTEGER *);
+BOOL WINAPI QueryPerformanceFrequency(LARGE_INTEGER *);
 
 HANDLE CreateSemaphore(
     LPSECURITY_ATTRIBUTES lpSemaphoreAttributes, LONG lInitialCount, LONG lMaximumCount, LPCSTR lpName);
@@ -0,0 +1,80 @@
+#include "StdAfx.h"
+
+#include "NTSC_Chroma.h"
+
+#include <cstdio>
+
+// Build-time generator for NTSC_ChromaTables.h: the default NTSC chroma tables, as built at run-time by NTSC_BuildChromaTables()
+
+namespace
+{
+
+    uint32_t bnwMonitor[NTSC_NUM_SEQUENCES];
+    uint32_t hueMonitor[NTSC_NUM_PHASES][NTSC_NUM_SEQUENCES];
+    uint32_t bnwColorTV[NTSC_NUM_SEQUENCES];
+    uint32_t hueColorTV[NTSC_NUM_PHASES][NTSC_NUM_SEQUENCES];
+
+    void writeRow(FILE *f, const uint32_t *table, const char *indent)
+    {
+        fprintf(f, "%s{", indent);
+        for (size_t i = 0; i < NTSC_NUM_SEQUENCES; ++i)
+        {
+            fprintf(f, "%s0x%08X,", (i % 8) ? " " : "\n\t\t", table[i]);
+        }
+        fprintf(f, "\n%s}", indent);
+    }
+
+    void writeTable(FILE *f, const char *name, const uint32_t *table)
+    {
+        fprintf(f, "\tstatic const uint32_t %s[NTSC_NUM_SEQUENCES] =\n", name);
+        writeRow(f, table, "\t");
+        fprintf(f, ";\n\n");
+    }
+
+    void writeTable(FILE *f, const char *name, const uint32_t (*table)[NTSC_NUM_SEQUENCES])
+    {
+        fprintf(f, "\tstatic const uint32_t %s[NTSC_NUM_PHASES][NTSC_NUM_SEQUENCES] =\n\t{\n", name);
+        for (size_t phase = 0; phase < NTSC_NUM_PHASES; ++phase)
+        {
+            writeRow(f, table[phase], "\t");
+            fprintf(f, ",\n");
+        }
+        fprintf(f, "\t};\n\n");
+    }
+
+} // namespace
+
+int main(int argc, const char *argv[])
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s NTSC_ChromaTables.h\n", argv[0]);
+        return 1;
+    }
+
+    NTSC_BuildChromaTables(bnwMonitor, hueMonitor, bnwColorTV, hueColorTV);
+
+    FILE *f = fopen(argv[1], "w");
+    if (!f)
+    {
+        fprintf(stderr, "%s: cannot write %s\n", argv[0], argv[1]);
+        return 1;
+    }
+
+    fprintf(f, "#pragma once\n\n");
+    fprintf(f, "// Generated by ntscchroma from NTSC_Chroma.cpp: do not edit\n\n");
+    fprintf(f, "#include \"NTSC_Chroma.h\"\n\n");
+    writeTable(f, "g_kBnWMonitor", bnwMonitor);
+    writeTable(f, "g_kHueMonitor", hueMonitor);
+    writeTable(f, "g_kBnWColorTV", bnwColorTV);
+    writeTable(f, "g_kHueColorTV", hueColorTV);
+
+    const bool ok = !ferror(f);
+    if (fclose(f) != 0 || !ok)
+    {
+        fprintf(stderr, "%s: cannot write %s\n", argv[0], argv[1]);
+        return 1;
+    }
+
+    return 0;
+}
@@ -12,9 +12,19 @@ namespace
 {
     unsigned __int64 g_nJoyCntrResetCycle = 0;       // Abs cycle that joystick counters were reset
     const double PDL_CNTR_INTERVAL = 2816.0 / 255.0; // 11.04 (From KEGS)
+
+    // Abs cycle until which each paddle's counter is active: set by JoyResetPosition()
+    // . ~0 if nothing is connected (so always active)
+    unsigned __int64 g_nJoyCntrActiveUntilCycle[4] = {0, 0, ~0ULL, ~0ULL};
+
+    unsigned __int64 getPdlCntrActiveUntilCycle(const int pos)
+    {
+        return g_nJoyCntrResetCycle + (unsigned __int64)((double)pos * PDL_CNTR_INTERVAL);
+    }
 } // namespace
 
 std::shared_ptr<Paddle> Paddle::instance;
+int Paddle::ourAxisValues[2] = {0, 0};
 
 std::set<int> Paddle::ourButtons;
 bool Paddle::ourSquaring = true;
@@ -34,6 +44,15 @@ void Paddle::setSquaring(bool value)
     ourSquaring = value;
 }
 
+void Paddle::updateAxes()
+{
+    if (instance)
+    {
+        ourAxisValues[0] = instance->getAxisValue(0);
+        ourAxisValues[1] = instance->getAxisValue(1);
+    }
+}
+
 bool Paddle::getButton(int i) const
 {
     return false;
@@ -125,41 +144,42 @@ BYTE __stdcall JoyReadPosition(WORD pc, WORD address, BYTE bWrite, BYTE d, ULONG
     const int pdl = address & 3; // 11: joy number & axis
     const int copyProtection = CopyProtectionDonglePDL(pdl);
 
-    // if nothing is connected, set it to TRUE
-    BOOL nPdlCntrActive = TRUE;
-
-    const auto setPdlPos = [&nPdlCntrActive](const int pos)
-    {
-        nPdlCntrActive =
-            g_nCumulativeCycles <= (g_nJoyCntrResetCycle + (unsigned __int64)((double)pos * PDL_CNTR_INTERVAL));
-    };
+    BOOL nPdlCntrActive;
 
     if (copyProtection >= 0)
     {
-        // if active, this has the highest priority
-        setPdlPos(copyProtection);
+        // if active, this has the highest priority (and depends on the current annunciators)
+        nPdlCntrActive = g_nCumulativeCycles <= getPdlCntrActiveUntilCycle(copyProtection);
     }
-    else if (Paddle::instance)
+    else
     {
-        const int nJoyNum = (address & 2) ? 1 : 0; // $C064..$C067
-        if (nJoyNum == 0)
-        {
-            int axis = address & 1;
-            int pos = Paddle::instance->getAxisValue(axis);
-            // This is from KEGS. It helps games like Championship Lode Runner, Boulderdash & Learning with
-            // Leeper(GH#1128)
-            if (pos >= 255)
-                pos = 287;
-
-            setPdlPos(pos);
-        }
+        nPdlCntrActive = g_nCumulativeCycles <= g_nJoyCntrActiveUntilCycle[pdl];
     }
 
     return MemReadFloatingBus(nPdlCntrActive, uExecutedCycles);
 }
 
+// The axes (sampled by Paddle::updateAxes()) are latched here, so each read of $C064-$C067 is just a compare
 void JoyResetPosition(ULONG uExecutedCycles)
 {
     CpuCalcCycles(uExecutedCycles);
     g_nJoyCntrResetCycle = g_nCumulativeCycles;
+
+    for (int pdl = 0; pdl < 4; ++pdl)
+    {
+        // if nothing is connected, set it to TRUE
+        g_nJoyCntrActiveUntilCycle[pdl] = ~0ULL;
+
+        const int nJoyNum = (pdl & 2) ? 1 : 0; // $C064..$C067
+        if (Paddle::instance && nJoyNum == 0)
+        {
+            int pos = Paddle::ourAxisValues[pdl & 1];
+            // This is from KEGS. It helps games like Championship Lode Runner, Boulderdash & Learning with
+            // Leeper(GH#1128)
+            if (pos >= 255)
+                pos = 287;
+
+            g_nJoyCntrActiveUntilCycle[pdl] = getPdlCntrActiveUntilCycle(pos);
+        }
+    }
 }
@@ -13,6 +13,10 @@ public:
 
     int getAxisValue(int i) const;
 
+    // Sample the host axes: called once per frame (by the frontend's input update), not on every $C064-$C067 read
+    static void updateAxes();
+    static int ourAxisValues[2];
+
     static constexpr int ourOpenApple = 0x61;
     static constexpr int ourSolidApple = 0x62;
     static constexpr int ourThirdApple = 0x63;
@@ -0,0 +1,129 @@
+#include "StdAfx.h"
+
+#include "SSI263PhonemeEncoder.h"
+#include "SSI263Phonemes.h"
+#include "SSI263PhonemeData.h"
+
+#include <cstdio>
+
+// Tool for SSI263PhonemeData.h: the compressed phoneme bank, as decoded by SSI263PhonemeCache
+// . dump: decode the bank to 16-bit little-endian mono PCM (all phonemes back to back)
+// . encode: compress such a PCM file into SSI263PhonemeData.h (the phoneme lengths are the current bank's)
+
+namespace
+{
+
+    int dump(const char *pcmFile)
+    {
+        FILE *f = fopen(pcmFile, "wb");
+        if (!f)
+        {
+            fprintf(stderr, "cannot write %s\n", pcmFile);
+            return 1;
+        }
+
+        for (UINT phoneme = 0; phoneme < SSI263PhonemeCache::kNumPhonemes; ++phoneme)
+        {
+            std::vector<short> samples(SSI263PhonemeCache::GetLength(phoneme));
+            SSI263PhonemeCache::Decode(phoneme, samples.data());
+            for (const short sample : samples)
+            {
+                fputc(sample & 0xFF, f);
+                fputc((sample >> 8) & 0xFF, f);
+            }
+        }
+
+        const bool ok = !ferror(f);
+        if (fclose(f) != 0 || !ok)
+        {
+            fprintf(stderr, "cannot write %s\n", pcmFile);
+            return 1;
+        }
+        return 0;
+    }
+
+    int encode(const char *pcmFile, const char *headerFile)
+    {
+        FILE *f = fopen(pcmFile, "rb");
+        if (!f)
+        {
+            fprintf(stderr, "cannot read %s\n", pcmFile);
+            return 1;
+        }
+
+        std::vector<short> pcm;
+        int lo, hi;
+        while ((lo = fgetc(f)) != EOF && (hi = fgetc(f)) != EOF)
+        {
+            pcm.push_back((short)(lo | (hi << 8)));
+        }
+        fclose(f);
+
+        std::vector<BYTE> data;
+        std::vector<PHONEME_INFO> info;
+        size_t start = 0;
+        for (UINT phoneme = 0; phoneme < SSI263PhonemeCache::kNumPhonemes; ++phoneme)
+        {
+            const UINT length = SSI263PhonemeCache::GetLength(phoneme);
+            if (start + length > pcm.size())
+            {
+                fprintf(stderr, "%s: %zu samples, too short for phoneme %u\n", pcmFile, pcm.size(), phoneme);
+                return 1;
+            }
+            info.push_back({(unsigned int)data.size(), length});
+            SSI263PhonemeEncode(&pcm[start], length, data);
+            start += length;
+        }
+
+        f = fopen(headerFile, "w");
+        if (!f)
+        {
+            fprintf(stderr, "cannot write %s\n", headerFile);
+            return 1;
+        }
+
+        fprintf(f, "#pragma once\n\n");
+        fprintf(f, "// SSI263 phoneme bank: 62 phonemes of 16-bit mono PCM @ 22050Hz (SAMPLE_RATE_SSI263), losslessly compressed.\n");
+        fprintf(f, "// Decoded by SSI263PhonemeCache (see SSI263Phonemes.cpp for the format).\n\n");
+        fprintf(f, "typedef struct\n{\n\tunsigned int nOffset;\t// Byte offset into g_nPhonemeData\n\tunsigned int nLength;\t// Length in samples\n} PHONEME_INFO, *PPHONEME_INFO;\n\n");
+
+        fprintf(f, "static const PHONEME_INFO g_nPhonemeInfo[%zu] = \n{\n", info.size());
+        for (size_t i = 0; i < info.size(); ++i)
+        {
+            fprintf(f, "%s{0x%08X,0x%08X}%s", (i % 2) ? "" : "\t", info[i].nOffset, info[i].nLength, (i % 2 || i + 1 == info.size()) ? ",\n" : ",");
+        }
+        fprintf(f, "};\n\n");
+
+        fprintf(f, "static const unsigned char g_nPhonemeData[%zu] = \n{\n", data.size());
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            fprintf(f, "%s0x%02X,%s", (i % 16) ? "" : "\t", data[i], (i % 16 == 15 || i + 1 == data.size()) ? "\n" : "");
+        }
+        fprintf(f, "};\n");
+
+        const bool ok = !ferror(f);
+        if (fclose(f) != 0 || !ok)
+        {
+            fprintf(stderr, "cannot write %s\n", headerFile);
+            return 1;
+        }
+        return 0;
+    }
+
+} // namespace
+
+int main(int argc, const char *argv[])
+{
+    if (argc == 3 && std::string(argv[1]) == "--dump")
+    {
+        return dump(argv[2]);
+    }
+    if (argc == 3)
+    {
+        return encode(argv[1], argv[2]);
+    }
+
+    fprintf(stderr, "Usage: %s --dump phonemes.pcm\n", argv[0]);
+    fprintf(stderr, "       %s phonemes.pcm SSI263PhonemeData.h\n", argv[0]);
+    return 1;
+}
@@ -0,0 +1,254 @@
+#include "stdafx.h"
+
+#include "../../source/AY8910.h"
+
+#include <chrono>
+
+// Stubs for AY8910.cpp's dependencies
+double g_fCurrentCLK6502 = 1020484.0;	// CLK_6502_NTSC
+void LogOutput(const char* format, ...) {}
+void LogFileOutput(const char* format, ...) {}
+
+static const double kClk = 1020484.0;
+static const int kSampleRate = 44100;	// SPKR_SAMPLE_RATE, as set by AY8913::sound_init()
+static const int kMaxFrameSamples = 2048;
+
+//-----------------------------------------------------------------------------
+
+// A synthetic register log (see MakeRegisterLog()): for each MB_Update() period, the AY register writes (with cycle offsets) & the # of samples
+struct RegWrite
+{
+	UINT cycle;
+	int reg, val;
+};
+
+struct Frame
+{
+	int numSamples;
+	std::vector<RegWrite> writes;
+};
+
+static UINT g_seed;
+
+static UINT Rand(void)
+{
+	g_seed = g_seed * 1103515245 + 12345;
+	return g_seed >> 8;
+}
+
+// Pseudo-random register writes, biased towards the interesting values:
+// muted & env-mode channels, tone/noise-only mixers, zero noise & envelope periods, and frames without any writes
+static std::vector<Frame> MakeRegisterLog(UINT seed, int numFrames, bool sparse)
+{
+	g_seed = seed;
+	std::vector<Frame> log;
+
+	for (int i = 0; i < numFrames; i++)
+	{
+		Frame frame;
+		frame.numSamples = 1 + Rand() % 1500;
+		const UINT cycles = (UINT)(frame.numSamples * kClk / kSampleRate);
+
+		const int numWrites = (Rand() % (sparse ? 2 : 4) == 0) ? 0 : Rand() % (sparse ? 4 : 40);
+		UINT cycle = 0;
+		for (int w = 0; w < numWrites; w++)
+		{
+			RegWrite write;
+			cycle += Rand() % (cycles / numWrites + 2);
+			write.cycle = cycle;
+			write.reg = Rand() % 16;
+
+			switch (write.reg)
+			{
+			case 6:  write.val = (Rand() % 3 == 0) ? 0 : Rand() & 31; break;
+			case 7:  write.val = (Rand() % 3 == 0) ? 0x3F : Rand() & 0x3F; break;
+			case 8: case 9: case 10:
+				write.val = (Rand() % 4 == 0) ? 0x10 : (Rand() % 3 == 0) ? 0 : Rand() & 15;
+				break;
+			case 11: write.val = (Rand() % 4 == 0) ? 0 : Rand() & 0xFF; break;
+			case 12: write.val = (Rand() % 2) ? 0 : Rand() & 3; break;
+			case 13: write.val = Rand() & 15; break;
+			default: write.val = (Rand() % 5 == 0) ? 0 : Rand() & 0xFF; break;
+			}
+
+			frame.writes.push_back(write);
+		}
+
+		log.push_back(frame);
+	}
+
+	return log;
+}
+
+static void RenderFrame(AY8913& ay, const Frame& frame, INT16** buffers)
+{
+	for (size_t i = 0; i < frame.writes.size(); i++)
+		ay.sound_ay_write(frame.writes[i].reg, frame.writes[i].val, frame.writes[i].cycle);
+
+	ay.SetFramesize(frame.numSamples);
+	ay.SetSoundBuffers(buffers);
+	ay.sound_frame();
+}
+
+// FNV-1a of all 3 channels' samples
+static UINT HashRegisterLog(const std::vector<Frame>& log, double clk)
+{
+	AY8913* pAY = new AY8913;	// NB. Sets the CLK to g_fCurrentCLK6502
+	AY8913::SetCLK(clk);
+	pAY->sound_init(NULL);
+	pAY->sound_ay_reset();
+
+	std::vector<INT16> buffer(3 * kMaxFrameSamples);
+	INT16* buffers[3] = { &buffer[0], &buffer[kMaxFrameSamples], &buffer[2 * kMaxFrameSamples] };
+
+	UINT hash = 2166136261u;
+	for (size_t i = 0; i < log.size(); i++)
+	{
+		RenderFrame(*pAY, log[i], buffers);
+		for (int s = 0; s < log[i].numSamples; s++)
+		{
+			for (int c = 0; c < 3; c++)
+			{
+				const USHORT sample = (USHORT)buffers[c][s];
+				hash = (hash ^ (sample & 0xFF)) * 16777619u;
+				hash = (hash ^ (sample >> 8)) * 16777619u;
+			}
+		}
+	}
+
+	delete pAY;
+	return hash;
+}
+
+//-----------------------------------------------------------------------------
+
+// Output must be sample-identical to the original (per-sample) FUSE synthesis
+// . the logs are synthetic (pseudo-random), not captured from real Mockingboard software
+// . golden hashes were taken from the per-sample implementation
+int TestRegisterLogs(void)
+{
+	struct
+	{
+		UINT seed;
+		bool sparse;
+		double clk;
+		UINT hash;
+	} const kLogs[] =
+	{
+		{ 1, false, kClk,		0x503B6DAB },
+		{ 2, true,  kClk,		0x07CCF660 },
+		{ 3, false, kClk * 1.5,	0x64F5F9FC },	// Phasor
+		{ 4, true,  kClk * 1.5,	0x5176BF3F },
+		{ 5, false, kClk * 2.0,	0xACC87E4F },
+		{ 6, true,  kClk * 2.0,	0x30846BF7 },
+		{ 7, false, 1023000.0,	0xD3B6A644 },
+		{ 8, true,  1023000.0,	0x87B935A5 },
+	};
+
+	for (size_t i = 0; i < sizeof(kLogs) / sizeof(kLogs[0]); i++)
+	{
+		const UINT hash = HashRegisterLog(MakeRegisterLog(kLogs[i].seed, 120, kLogs[i].sparse), kLogs[i].clk);
+		if (hash != kLogs[i].hash)
+		{
+			printf("Register log %u: hash %08X, expected %08X\n", kLogs[i].seed, hash, kLogs[i].hash);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+// A tune's register writes: tone on channels [0..numVoices), with noise on A & the envelope on C
+static std::vector<Frame> MakeTuneLog(int numVoices, int frameSamples)
+{
+	std::vector<Frame> log(60);
+	for (int i = 0; i < 60; i++)
+	{
+		const RegWrite writes[] = {
+			{ 0, 0, 0x40 + i }, { 10, 2, 0x80 - i }, { 20, 4, 0xC0 }, { 30, 5, i & 1 },
+			{ 40, 6, 0x08 }, { 50, 7, 0x30 | (0x07 & ~((1 << numVoices) - 1)) },
+			{ 60, 8, 15 - (i & 7) }, { 70, 9, (numVoices > 1) ? 12 : 0 }, { 80, 10, (numVoices > 2) ? 0x10 : 0 },
+			{ 90, 11, 0x40 }, { 100, 12, 0 },
+		};
+		log[i].numSamples = frameSamples;
+		log[i].writes.assign(writes, writes + sizeof(writes) / sizeof(writes[0]));
+		if (i % 15 == 0)
+		{
+			const RegWrite envShape = { 110, 13, 0x0E };
+			log[i].writes.push_back(envShape);
+		}
+	}
+
+	return log;
+}
+
+// Time to synthesise 1 emulated second of 1 or 4 Mockingboards (4 AYs each)
+int Benchmark(void)
+{
+	const int kFrameSamples = kSampleRate / 60;	// MB_Update() period @ 60Hz
+	const int kSeconds = 5;
+	const int kRuns = 5;
+
+	const char* const kTuneNames[] = { "idle", "1 voice", "3 voices" };
+	std::vector<Frame> tunes[3];
+	tunes[0].resize(60);	// After reset (all channels muted) & no writes
+	for (int i = 0; i < 60; i++)
+		tunes[0][i].numSamples = kFrameSamples;
+	tunes[1] = MakeTuneLog(1, kFrameSamples);
+	tunes[2] = MakeTuneLog(3, kFrameSamples);
+
+	std::vector<INT16> buffer(3 * kMaxFrameSamples);
+	INT16* buffers[3] = { &buffer[0], &buffer[kMaxFrameSamples], &buffer[2 * kMaxFrameSamples] };
+
+	const int kNumCards[] = { 1, 4 };
+	for (int c = 0; c < 2; c++)
+	{
+		for (int t = 0; t < 3; t++)
+		{
+			const std::vector<Frame>& log = tunes[t];
+
+			std::vector<AY8913> ay(4 * kNumCards[c]);
+			AY8913::SetCLK(kClk);
+			for (size_t i = 0; i < ay.size(); i++)
+			{
+				ay[i].sound_init(NULL);
+				ay[i].sound_ay_reset();
+			}
+
+			double secs = 0.0;
+			for (int run = 0; run < kRuns; run++)	// Best of kRuns
+			{
+				const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+				for (int s = 0; s < kSeconds; s++)
+					for (size_t f = 0; f < log.size(); f++)
+						for (size_t i = 0; i < ay.size(); i++)
+							RenderFrame(ay[i], log[f], buffers);
+
+				const double runSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				if (run == 0 || runSecs < secs)
+					secs = runSecs;
+			}
+
+			printf("Benchmark: %d Mockingboard%s (%2d AYs), %-8s: %7.1f us per emulated second\n",
+				kNumCards[c], kNumCards[c] > 1 ? "s" : " ", (int)ay.size(), kTuneNames[t], secs * 1e6 / kSeconds);
+		}
+	}
+
+	return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+	int res = 1;
+
+	res = TestRegisterLogs();
+	if (res) return res;
+
+	res = Benchmark();
+	if (res) return res;
+
+	return 0;
+}
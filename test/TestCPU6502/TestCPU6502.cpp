@@ -108,9 +108,24 @@ void NTSC_VideoUpdateCycles( long cycles6502 )
 {
 }
 
+// From CPU.cpp
+bool g_bIdleLoopSkip = false;
+
+static __forceinline UINT IdleLoop_GetPollCycles(WORD addr, ULONG uExecutedCycles, bool bVideoUpdate, bool bBit7Only)
+{
+	return ((addr & 0xFFF0) == 0xC000) ? (UINT)-1 : 0;	// Keyboard
+}
+
+#include "../../source/CPU/cpu_idleloop.inl"
+
 //-------------------------------------
 
 #define HEATMAP_X(address)
+#define CALL_PROFILE(opcode, interrupt)
+#define HISTORY_X(uExecutedCycles)
+#define HISTORY_W(addr, pMem)
+#define HISTORY_RESET
+#define IDLE_LOOP if (g_bIdleLoopSkip) IdleLoop(uExecutedCycles, uTotalCycles, bVideoUpdate, flagn, flagv, flagz);
 
 // 6502 & no debugger
 #define READ(addr) _READ_WITH_IO_F8xx(addr)
@@ -153,6 +168,11 @@ void NTSC_VideoUpdateCycles( long cycles6502 )
 #undef Fetch
 
 #undef HEATMAP_X
+#undef CALL_PROFILE
+#undef HISTORY_X
+#undef HISTORY_W
+#undef HISTORY_RESET
+#undef IDLE_LOOP
 
 //-------------------------------------
 
@@ -1365,6 +1385,103 @@ int GH1257_test()
 
 //-------------------------------------
 
+// Idle-loop detection must be cycle-exact: same cycles, registers & flags as executing every iteration
+
+BYTE g_C000_value = 0;
+bool g_C000_floatingBus = false;	// bits 0-6 change every cycle (eg. TAPEIN)
+
+BYTE __stdcall fn_C000_value(WORD, WORD, BYTE, BYTE, ULONG uExecutedCycles)
+{
+	g_fn_C000_count++;
+	if (g_C000_floatingBus)
+		return (g_C000_value & 0x80) | (uExecutedCycles & 0x7F);
+	return g_C000_value;
+}
+
+int IdleLoop_Sub(const BYTE* code, WORD org, BYTE value, uint32_t uTotalCycles, size_t codeSize = 5)
+{
+	regsrec resRegs[2];
+	uint32_t resCycles[2];
+	int resCount[2];
+
+	for (UINT cpu = 0; cpu < 2; cpu++)
+	{
+		for (UINT skip = 0; skip < 2; skip++)
+		{
+			memcpy(mem + org, code, codeSize);
+			reset();
+			regs.pc = org;
+			g_C000_value = value;
+			g_fn_C000_count = 0;
+			g_bIdleLoopSkip = skip ? true : false;
+
+			resCycles[skip] = cpu ? TestCpu65C02(uTotalCycles) : TestCpu6502(uTotalCycles);
+			resRegs[skip] = regs;
+			resCount[skip] = g_fn_C000_count;
+		}
+
+		g_bIdleLoopSkip = false;
+
+		if (resCycles[0] != resCycles[1]) return 1;
+		if (memcmp(&resRegs[0], &resRegs[1], sizeof(regsrec)) != 0) return 1;
+		if (GetIsMemCacheValid() && resCount[1] >= resCount[0] / 16) return 1;	// iterations were skipped (alt CPU emulation doesn't skip)
+	}
+
+	return 0;
+}
+
+int IdleLoop_test()
+{
+	IORead[0] = fn_C000_value;
+
+	// LDA $C000; BPL *-3
+	const BYTE codeLDA[] = { 0xAD, 0x00, 0xC0, 0x10, 0xFB };
+	if (IdleLoop_Sub(codeLDA, 0x300, 0x41, 10000)) return 1;
+	if (IdleLoop_Sub(codeLDA, 0x300, 0x41, 10001)) return 1;
+
+	// BIT $C000; BVC *-3 (A=0, so Z=1)
+	const BYTE codeBIT[] = { 0x2C, 0x00, 0xC0, 0x50, 0xFB };
+	if (IdleLoop_Sub(codeBIT, 0x300, 0x81, 10000)) return 1;
+
+	// LDX $C000; BNE *-3 (branch crosses a page)
+	const BYTE codeLDX[] = { 0xAE, 0x00, 0xC0, 0xD0, 0xFB };
+	if (IdleLoop_Sub(codeLDX, 0x3FB, 0x01, 10003)) return 1;
+
+	// LDY $C000; BEQ *-3
+	const BYTE codeLDY[] = { 0xAC, 0x00, 0xC0, 0xF0, 0xFB };
+	if (IdleLoop_Sub(codeLDY, 0x300, 0x00, 10002)) return 1;
+
+	// DEY; LDA $C000; EOR $2F; BPL *-6 (as the Monitor's RDBIT, with the floating bus in bits 0-6)
+	const BYTE codeRDBIT[] = { 0x88, 0xAD, 0x00, 0xC0, 0x45, 0x2F, 0x10, 0xF8 };
+	mem[0x2F] = 0x80;
+	g_C000_floatingBus = true;
+	for (uint32_t uTotalCycles = 10000; uTotalCycles < 10013; uTotalCycles++)	// batch ends at each cycle of an iteration
+		if (IdleLoop_Sub(codeRDBIT, 0x300, 0x80, uTotalCycles, sizeof(codeRDBIT))) return 1;
+
+	// INX; LDA $C000; EOR $2F; BMI *-6 (branch crosses a page)
+	const BYTE codeRDBITX[] = { 0xE8, 0xAD, 0x00, 0xC0, 0x45, 0x2F, 0x30, 0xF8 };
+	if (IdleLoop_Sub(codeRDBITX, 0x3FA, 0x00, 10005, sizeof(codeRDBITX))) return 1;
+
+	// A counted skip leaves A as the last skipped EOR, so N & Z must be too
+	// (the next DEY overwrites them, so they're only visible between the skip & the DEY, eg. to an interrupt)
+	memcpy(mem + 0x300, codeRDBIT, sizeof(codeRDBIT));
+	reset();
+	regs.pc = 0x300;
+	g_C000_value = 0x80;	// bit 7 = $2F's, so BPL is taken
+	regs.a = 0x00;	// as if the last read's bits 0-6 were all 0
+	BOOL flagn = 0, flagz = 1;
+	ULONG uExecutedCycles = 1;
+	IdleLoop(uExecutedCycles, 10000, false, flagn, 0, flagz);
+	if (uExecutedCycles == 1 || regs.a == 0x00) return 1;	// iterations were skipped, and A changed
+	if (flagn != (regs.a & 0x80) || flagz != !regs.a) return 1;
+	g_C000_floatingBus = false;
+
+	IORead[0] = NULL;
+	return 0;
+}
+
+//-------------------------------------
+
 int testCB(int id, int cycles, ULONG uExecutedCycles)
 {
 	return 0;
@@ -1448,6 +1565,9 @@ int DoTest()
 	res = GH1257_test();
 	if (res) return res;
 
+	res = IdleLoop_test();
+	if (res) return res;
+
 	res = SyncEvents_test();
 	if (res) return res;
 
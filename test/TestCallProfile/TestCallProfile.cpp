@@ -0,0 +1,409 @@
+#include "stdafx.h"
+
+#include "../../source/Windows/AppleWin.h"
+#include "../../source/CPU.h"
+#include "../../source/Memory.h"
+#include "../../source/Debugger/Debug.h"
+#include "../../source/Core.h"
+
+#include "../../source/CPU/cpu_general.inl"
+#include "../../source/CPU/cpu_instructions.inl"
+
+#include <chrono>
+#include <cinttypes>
+
+// From Applewin.cpp
+bool g_bFullSpeed = false;
+enum AppMode_e g_nAppMode = MODE_STEPPING;
+
+// From Core.cpp
+std::string g_sCurrentDir;
+
+// From Memory.cpp
+LPBYTE         memshadow[0x100];	// init() just sets to mem pointers
+LPBYTE         memwrite[0x100];		// init() just sets to mem pointers
+BYTE           memreadPageType[0x100];
+LPBYTE         mem          = NULL;	// TODO: Init
+LPBYTE         memdirty     = NULL;	// TODO: Init
+LPBYTE         memVidHD     = NULL;	// TODO: Init
+iofunction		IORead[256] = {0};	// TODO: Init
+iofunction		IOWrite[256] = {0};	// TODO: Init
+
+BYTE __stdcall IO_F8xx(WORD programcounter, WORD address, BYTE write, BYTE value, ULONG nCycles)
+{
+	return 0;
+}
+
+BYTE MemReadFloatingBus(const ULONG uExecutedCycles)
+{
+	return 0;
+}
+
+regsrec regs;
+
+bool g_irqOnLastOpcodeCycle = false;
+
+eCpuType GetActiveCpu()
+{
+	return CPU_65C02;
+}
+
+void SetIrqOnLastOpcodeCycle()
+{
+}
+
+static __forceinline int Fetch(BYTE& iOpcode, ULONG uExecutedCycles)
+{
+	iOpcode = *(mem+regs.pc);
+	regs.pc++;
+	return 1;
+}
+
+static __forceinline void DoIrqProfiling(uint32_t uCycles)
+{
+}
+
+static __forceinline void CheckSynchronousInterruptSources(UINT cycles, ULONG uExecutedCycles)
+{
+}
+
+static __forceinline bool NMI(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn, BOOL& flagv, BOOL& flagz)
+{
+	return false;
+}
+
+static __forceinline bool IRQ(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn, BOOL& flagv, BOOL& flagz)
+{
+	return false;
+}
+
+// From z80.cpp
+uint32_t z80_mainloop(ULONG uTotalCycles, ULONG uExecutedCycles)
+{
+	return 0;
+}
+
+// From NTSC.cpp
+void NTSC_VideoUpdateCycles( long cycles6502 )
+{
+}
+
+// From Debugger_Console.cpp
+ConsoleOutputLevel_e g_eConsoleOutputLevel = ConsoleOutputLevel_e::CONSOLE_OUTPUT_LEVEL_ERROR;
+
+void ConsolePrint(const char* pText)
+{
+}
+
+void ConsoleBufferPush(const char* pText)
+{
+}
+
+Update_t ConsoleUpdate()
+{
+	return 0;
+}
+
+// From Debugger_Help.cpp
+int FindParam(LPCTSTR pLookupName, Match_e eMatch, int& iParam_, const int iParamBegin, const int iParamEnd, const bool bCaseSensitive)
+{
+	return 0;
+}
+
+Update_t Help_Arg_1(int iCommandHelp)
+{
+	return 0;
+}
+
+// From Debugger_Parser.cpp
+Arg_t g_aArgs[MAX_ARGS];
+
+// From Debugger_Symbols.cpp
+std::string const* FindSymbolFromAddress(WORD nAddress, int* iTable_)
+{
+	return NULL;
+}
+
+//-------------------------------------
+
+#define HEATMAP_X(address)
+#define HISTORY_X(uExecutedCycles)
+#define HISTORY_W(addr, pMem)
+#define HISTORY_RESET
+#define IDLE_LOOP
+
+// 65C02 & no debugger
+#define CALL_PROFILE(opcode, interrupt)
+#define READ(addr) _READ(addr)
+#define WRITE(value) _WRITE(value)
+
+#include "../../source/CPU/cpu65C02.h" // WDC 65C02
+
+#undef CALL_PROFILE
+
+//-------
+
+// 6502 & debugger (as CPU.cpp, but without the heatmap)
+#define CALL_PROFILE(opcode, interrupt) if (g_bCallProfiling) CallProfile_Step(opcode, interrupt, uExecutedCycles - uPreviousCycles);
+#define READ(addr) _READ(addr)
+#define WRITE(value) _WRITE(value)
+
+#define Cpu6502 Cpu6502_debug
+#include "../../source/CPU/cpu6502.h"  // MOS 6502
+#undef Cpu6502
+
+//-------
+
+// 65C02 & debugger (as CPU.cpp, but without the heatmap)
+#define READ(addr) _READ(addr)
+#define WRITE(value) _WRITE(value)
+
+#define Cpu65C02 Cpu65C02_debug
+#include "../../source/CPU/cpu65C02.h" // WDC 65C02
+#undef Cpu65C02
+
+#undef CALL_PROFILE
+#undef HEATMAP_X
+#undef HISTORY_X
+#undef HISTORY_W
+#undef HISTORY_RESET
+#undef IDLE_LOOP
+
+//-------------------------------------
+
+void init()
+{
+	mem = (LPBYTE)calloc(64, 1024);
+
+	for (UINT i=0; i<256; i++)
+		memshadow[i] = mem+i*256;
+
+	for (UINT i=0; i<256; i++)
+		memwrite[i] = mem+i*256;
+
+	memdirty = new BYTE[256];
+
+	memset(memreadPageType, MEM_Normal, sizeof(memreadPageType));
+	for (UINT i = 0xC0; i < 0xD0; i++)
+		memreadPageType[i] = MEM_IORead;
+}
+
+void reset()
+{
+	regs.a  = 0;
+	regs.x  = 0;
+	regs.y  = 0;
+	regs.pc = 0x300;
+	regs.sp = 0x1FF;
+	regs.ps = 0;
+	regs.bJammed = 0;
+}
+
+//-------------------------------------
+
+struct Routine
+{
+	uint64_t nCyclesTotal;
+	uint64_t nCyclesSelf;
+	UINT nCalls;
+};
+
+const char* kProfileFile = "testcallprofile";
+
+// Read back the flat table (CALLPROF SAVE) as: address -> routine
+static bool ReadProfile(std::map<WORD, Routine>& routines, uint64_t& nCyclesTotal)
+{
+	if (!CallProfile_Save(kProfileFile))
+		return false;
+
+	const std::string sFlat = std::string(kProfileFile) + ".txt";
+	FILE* fp = fopen(sFlat.c_str(), "rt");
+	if (!fp) return false;
+
+	bool bTotal = false;
+	char line[256];
+	while (fgets(line, sizeof(line), fp))
+	{
+		Routine routine;
+		double fTotal, fSelf;
+		UINT nAddress;
+		if (sscanf(line, "%" SCNu64 "\t%lf%%\t%" SCNu64 "\t%lf%%\t%u\t$%x", &routine.nCyclesTotal, &fTotal, &routine.nCyclesSelf, &fSelf, &routine.nCalls, &nAddress) == 6)
+			routines[(WORD)nAddress] = routine;
+		else if (sscanf(line, "%" SCNu64 "\t\t\t\t\t\tTotal cycles", &nCyclesTotal) == 1)
+			bTotal = true;
+	}
+	fclose(fp);
+
+	remove(sFlat.c_str());
+	remove((std::string(kProfileFile) + ".folded").c_str());
+	return bTotal;
+}
+
+static bool CheckRoutine(std::map<WORD, Routine>& routines, WORD addr, uint64_t nCyclesTotal, uint64_t nCyclesSelf, UINT nCalls)
+{
+	std::map<WORD, Routine>::const_iterator it = routines.find(addr);
+	if (it == routines.end()) return false;
+	return it->second.nCyclesTotal == nCyclesTotal && it->second.nCyclesSelf == nCyclesSelf && it->second.nCalls == nCalls;
+}
+
+//-------------------------------------
+
+// Nested calls:
+// $300: JSR $310 ; JSR $310 ; JMP $306
+// $310: JSR $320 ; RTS
+// $320: NOP ; RTS
+const BYTE kNested300[] = { 0x20,0x10,0x03, 0x20,0x10,0x03, 0x4C,0x06,0x03 };
+const BYTE kNested310[] = { 0x20,0x20,0x03, 0x60 };
+const BYTE kNested320[] = { 0xEA, 0x60 };
+
+// JSR's cycles are the caller's, RTS's cycles are the callee's
+const UINT kNestedCycles = 2*6 + 2*(6+6) + 2*(2+6);
+
+int Nested_Run(bool bSingleStep, bool b6502)
+{
+	memcpy(mem+0x300, kNested300, sizeof(kNested300));
+	memcpy(mem+0x310, kNested310, sizeof(kNested310));
+	memcpy(mem+0x320, kNested320, sizeof(kNested320));
+	reset();
+	CallProfile_Reset();
+	g_bCallProfiling = true;
+
+	UINT uCycles = 0;
+	if (bSingleStep)
+	{
+		// As the debugger does: 1 opcode per call
+		while (regs.pc != 0x306 && uCycles < 1000)
+			uCycles += b6502 ? Cpu6502_debug(0, true) : Cpu65C02_debug(0, true);
+	}
+	else
+	{
+		uCycles = b6502 ? Cpu6502_debug(kNestedCycles, true) : Cpu65C02_debug(kNestedCycles, true);
+	}
+
+	g_bCallProfiling = false;
+	if (uCycles != kNestedCycles || regs.pc != 0x306) return 1;
+
+	std::map<WORD, Routine> routines;
+	uint64_t nCyclesTotal = 0;
+	if (!ReadProfile(routines, nCyclesTotal)) return 1;
+
+	if (routines.size() != 2) return 1;
+	if (!CheckRoutine(routines, 0x310, 2*(6+6) + 2*(2+6), 2*(6+6), 2)) return 1;
+	if (!CheckRoutine(routines, 0x320, 2*(2+6), 2*(2+6), 2)) return 1;
+	if (nCyclesTotal != kNestedCycles) return 1;
+
+	return 0;
+}
+
+int Nested_test()
+{
+	int res = Nested_Run(true, false);
+	if (res) return res;
+
+	res = Nested_Run(false, false);
+	if (res) return res;
+
+	res = Nested_Run(true, true);
+	if (res) return res;
+
+	res = Nested_Run(false, true);
+	if (res) return res;
+
+	return 0;
+}
+
+// A callee that discards its return address returns straight to its caller's caller:
+// $300: JSR $340 ; JMP $303
+// $340: JSR $350 ; RTS (never reached)
+// $350: PLA ; PLA ; RTS
+int DiscardReturn_test()
+{
+	const BYTE code300[] = { 0x20,0x40,0x03, 0x4C,0x03,0x03 };
+	const BYTE code340[] = { 0x20,0x50,0x03, 0x60 };
+	const BYTE code350[] = { 0x68, 0x68, 0x60 };
+	memcpy(mem+0x300, code300, sizeof(code300));
+	memcpy(mem+0x340, code340, sizeof(code340));
+	memcpy(mem+0x350, code350, sizeof(code350));
+	reset();
+	CallProfile_Reset();
+	g_bCallProfiling = true;
+
+	const UINT kCycles = 6 + 6 + (4+4+6) + 3;	// ... and 1 JMP back at the top level
+	const UINT uCycles = Cpu65C02_debug(kCycles, true);
+
+	g_bCallProfiling = false;
+	if (uCycles != kCycles || regs.pc != 0x303) return 1;
+
+	std::map<WORD, Routine> routines;
+	uint64_t nCyclesTotal = 0;
+	if (!ReadProfile(routines, nCyclesTotal)) return 1;
+
+	if (!CheckRoutine(routines, 0x340, 6 + (4+4+6), 6, 1)) return 1;
+	if (!CheckRoutine(routines, 0x350, 4+4+6, 4+4+6, 1)) return 1;
+	if (nCyclesTotal != kCycles) return 1;
+
+	return 0;
+}
+
+//-------------------------------------
+
+// Cost of the hook, on a JSR/RTS heavy loop:
+// $300: JSR $310 ; JMP $300
+// $310: NOP ; RTS
+int Overhead_test()
+{
+	const BYTE code300[] = { 0x20,0x10,0x03, 0x4C,0x00,0x03 };
+	const BYTE code310[] = { 0xEA, 0x60 };
+	memcpy(mem+0x300, code300, sizeof(code300));
+	memcpy(mem+0x310, code310, sizeof(code310));
+
+	const UINT kLoopCycles = 6 + 3 + 2 + 6;
+	const UINT kLoops = 2000000;
+	const UINT kOpcodes = kLoops * 4;
+
+	double secs[3];
+	for (UINT i = 0; i < 3; i++)
+	{
+		reset();
+		CallProfile_Reset();
+		g_bCallProfiling = (i == 2);
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		const UINT uCycles = (i == 0) ? Cpu65C02(kLoops * kLoopCycles, true) : Cpu65C02_debug(kLoops * kLoopCycles, true);
+		secs[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		g_bCallProfiling = false;
+		if (uCycles != kLoops * kLoopCycles) return 1;
+	}
+
+	std::map<WORD, Routine> routines;
+	uint64_t nCyclesTotal = 0;
+	if (!ReadProfile(routines, nCyclesTotal)) return 1;
+	if (!CheckRoutine(routines, 0x310, (uint64_t)kLoops * (2+6), (uint64_t)kLoops * (2+6), kLoops)) return 1;
+
+	printf("65C02 core: %.1f ns per opcode\n", secs[0] * 1e9 / kOpcodes);
+	printf("65C02 debugger core, call profiler off: %.1f ns per opcode\n", secs[1] * 1e9 / kOpcodes);
+	printf("65C02 debugger core, call profiler on: %.1f ns per opcode\n", secs[2] * 1e9 / kOpcodes);
+
+	return 0;
+}
+
+//-------------------------------------
+
+int main(int argc, char* argv[])
+{
+	int res = 1;
+
+	init();
+
+	res = Nested_test();
+	if (res) return res;
+
+	res = DiscardReturn_test();
+	if (res) return res;
+
+	res = Overhead_test();
+	if (res) return res;
+
+	return 0;
+}
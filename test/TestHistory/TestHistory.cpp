@@ -0,0 +1,440 @@
+#include "stdafx.h"
+
+#include "../../source/Windows/AppleWin.h"
+#include "../../source/CPU.h"
+#include "../../source/Memory.h"
+#include "../../source/Debugger/Debug.h"
+#include "../../source/Core.h"
+
+#include "../../source/CPU/cpu_general.inl"
+#include "../../source/CPU/cpu_instructions.inl"
+
+#include <chrono>
+
+// From Applewin.cpp
+bool g_bFullSpeed = false;
+enum AppMode_e g_nAppMode = MODE_RUNNING;
+
+// From Memory.cpp
+LPBYTE         memshadow[0x100];	// init() just sets to mem pointers
+LPBYTE         memwrite[0x100];		// init() just sets to mem pointers
+BYTE           memreadPageType[0x100];
+LPBYTE         mem          = NULL;	// TODO: Init
+LPBYTE         memdirty     = NULL;	// TODO: Init
+LPBYTE         memVidHD     = NULL;	// TODO: Init
+iofunction		IORead[256] = {0};	// TODO: Init
+iofunction		IOWrite[256] = {0};	// TODO: Init
+
+// Memory paging: just the mode, set by the $C004/$C005 soft switches (AUXWRITE)
+static uint32_t g_memmode = 0;
+static UINT g_uActiveBank = 0;
+static UINT g_nRestorePaging = 0;
+
+uint32_t GetMemMode()
+{
+	return g_memmode;
+}
+
+UINT GetRamWorksActiveBank()
+{
+	return g_uActiveBank;
+}
+
+void MemRestorePaging(const uint32_t memmode, const UINT activeAuxBank)
+{
+	g_memmode = memmode;
+	g_uActiveBank = activeAuxBank;
+	g_nRestorePaging++;
+}
+
+uint8_t ReadByteFromMemory(uint16_t addr)
+{
+	return mem[addr];
+}
+
+void WriteByteToMemory(uint16_t addr, uint8_t data)
+{
+	mem[addr] = data;
+}
+
+BYTE __stdcall IO_Null(WORD programcounter, WORD address, BYTE write, BYTE value, ULONG nCycles)
+{
+	return 0;
+}
+
+BYTE __stdcall IO_SoftSwitch(WORD programcounter, WORD address, BYTE write, BYTE value, ULONG nCycles)
+{
+	if ((address & 0xFF) == 0x04) g_memmode &= ~MF_AUXWRITE;
+	if ((address & 0xFF) == 0x05) g_memmode |= MF_AUXWRITE;
+	return 0;
+}
+
+BYTE __stdcall IO_F8xx(WORD programcounter, WORD address, BYTE write, BYTE value, ULONG nCycles)
+{
+	return 0;
+}
+
+BYTE MemReadFloatingBus(const ULONG uExecutedCycles)
+{
+	return 0;
+}
+
+regsrec regs;
+
+bool g_irqOnLastOpcodeCycle = false;
+
+eCpuType GetActiveCpu()
+{
+	return CPU_65C02;
+}
+
+void SetIrqOnLastOpcodeCycle()
+{
+}
+
+static __forceinline int Fetch(BYTE& iOpcode, ULONG uExecutedCycles)
+{
+	iOpcode = *(mem+regs.pc);
+	regs.pc++;
+	return 1;
+}
+
+static __forceinline void DoIrqProfiling(uint32_t uCycles)
+{
+}
+
+static __forceinline void CheckSynchronousInterruptSources(UINT cycles, ULONG uExecutedCycles)
+{
+}
+
+static __forceinline bool NMI(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn, BOOL& flagv, BOOL& flagz)
+{
+	return false;
+}
+
+static __forceinline bool IRQ(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn, BOOL& flagv, BOOL& flagz)
+{
+	return false;
+}
+
+// From z80.cpp
+uint32_t z80_mainloop(ULONG uTotalCycles, ULONG uExecutedCycles)
+{
+	return 0;
+}
+
+// From NTSC.cpp
+void NTSC_VideoUpdateCycles( long cycles6502 )
+{
+}
+
+// From Debugger_Assembler.cpp
+const Opcodes_t* g_aOpcodes = NULL;
+AddressingMode_t g_aOpmodes[NUM_ADDRESSING_MODES];
+
+// From Debugger_Console.cpp
+ConsoleOutputLevel_e g_eConsoleOutputLevel = ConsoleOutputLevel_e::CONSOLE_OUTPUT_LEVEL_ERROR;
+
+void ConsolePrint(const char* pText)
+{
+}
+
+void ConsoleBufferPush(const char* pText)
+{
+}
+
+Update_t ConsoleUpdate()
+{
+	return 0;
+}
+
+// From Debugger_Help.cpp
+int FindParam(LPCTSTR pLookupName, Match_e eMatch, int& iParam_, const int iParamBegin, const int iParamEnd, const bool bCaseSensitive)
+{
+	return 0;
+}
+
+Update_t Help_Arg_1(int iCommandHelp)
+{
+	return 0;
+}
+
+// From Debugger_Parser.cpp
+Arg_t g_aArgs[MAX_ARGS];
+
+//-------------------------------------
+
+#define HEATMAP_X(address)
+#define CALL_PROFILE(opcode, interrupt)
+#define IDLE_LOOP
+
+// 65C02 & no debugger, without the execution history
+#define HISTORY_X(uExecutedCycles)
+#define HISTORY_W(addr, pMem)
+#define HISTORY_RESET
+#define READ(addr) _READ(addr)
+#define WRITE(value) _WRITE(value)
+
+#define Cpu65C02 Cpu65C02_noHistory
+#include "../../source/CPU/cpu65C02.h" // WDC 65C02
+#undef Cpu65C02
+
+#undef HISTORY_X
+#undef HISTORY_W
+#undef HISTORY_RESET
+
+//-------
+
+// 65C02 & no debugger (as CPU.cpp)
+#define HISTORY_X(uExecutedCycles) if (g_bExecutionHistory) History_Record(uExecutedCycles);
+#define HISTORY_W(addr, pMem) if (g_bExecutionHistory) History_RecordWrite(addr, *(pMem));
+#define HISTORY_RESET if (g_bExecutionHistory) History_Reset();
+#define READ(addr) _READ(addr)
+#define WRITE(value) _WRITE(value)
+
+#include "../../source/CPU/cpu65C02.h" // WDC 65C02
+
+#undef HISTORY_X
+#undef HISTORY_W
+#undef HISTORY_RESET
+
+#undef HEATMAP_X
+#undef CALL_PROFILE
+#undef IDLE_LOOP
+
+//-------------------------------------
+
+void init()
+{
+	mem = (LPBYTE)calloc(64, 1024);
+
+	for (UINT i=0; i<256; i++)
+		memshadow[i] = mem+i*256;
+
+	for (UINT i=0; i<256; i++)
+		memwrite[i] = mem+i*256;
+
+	memdirty = new BYTE[256];
+
+	memset(memreadPageType, MEM_Normal, sizeof(memreadPageType));
+	for (UINT i = 0xC0; i < 0xD0; i++)
+	{
+		memreadPageType[i] = MEM_IORead;
+		memwrite[i] = NULL;
+	}
+
+	for (UINT i = 0; i < 256; i++)
+	{
+		IORead[i] = IO_Null;
+		IOWrite[i] = IO_Null;
+	}
+	IOWrite[0x00] = IO_SoftSwitch;
+}
+
+void reset()
+{
+	regs.a  = 0;
+	regs.x  = 0;
+	regs.y  = 0;
+	regs.pc = 0x300;
+	regs.sp = 0x1FF;
+	regs.ps = 0;
+	regs.bJammed = 0;
+
+	g_memmode = 0;
+	g_uActiveBank = 0;
+	g_nRestorePaging = 0;
+	History_Reset();
+}
+
+//-------------------------------------
+
+// Writes of every kind (zp, abs, indexed, RMW, JSR/PHA/PHP/BRK pushes), and a soft switch on & off:
+// $300: LDA #$07 ; STA $C005 ; STA $10 ; INC $10 ; STA $2000,X ; INX ; JSR $320
+// $310: STA $C004 ; PHA ; PHP ; PLA ; PLP ; BRK ; JMP $300
+// $320: INC A ; INC $2100 ; RTS
+// $330: RTI
+const BYTE kLoop300[] = { 0xA9,0x07, 0x8D,0x05,0xC0, 0x85,0x10, 0xE6,0x10, 0x9D,0x00,0x20, 0xE8, 0x20,0x20,0x03 };
+const BYTE kLoop310[] = { 0x8D,0x04,0xC0, 0x48, 0x08, 0x68, 0x28, 0x00,0xEA, 0x4C,0x00,0x03 };
+const BYTE kLoop320[] = { 0x1A, 0xEE,0x00,0x21, 0x60 };
+const BYTE kLoop330[] = { 0x40 };
+const UINT kLoopOpcodes = 18;
+const UINT kLoopCycles = 2+4+3+5+5+2+6 + 4+3+3+4+4+7+3 + 2+6+6 + 6;
+
+void LoadLoop()
+{
+	memcpy(mem+0x300, kLoop300, sizeof(kLoop300));
+	memcpy(mem+0x310, kLoop310, sizeof(kLoop310));
+	memcpy(mem+0x320, kLoop320, sizeof(kLoop320));
+	memcpy(mem+0x330, kLoop330, sizeof(kLoop330));
+	mem[0xFFFE] = 0x30;	// BRK vector
+	mem[0xFFFF] = 0x03;
+}
+
+struct MachineState
+{
+	std::vector<BYTE> mem;
+	regsrec regs;
+	uint32_t memmode;
+};
+
+static MachineState SaveState()
+{
+	MachineState state;
+	state.mem.assign(mem, mem + 64*1024);
+	state.regs = regs;
+	state.memmode = g_memmode;
+	return state;
+}
+
+static bool IsState(const MachineState& state)
+{
+	return memcmp(state.mem.data(), mem, 64*1024) == 0
+		&& memcmp(&state.regs, &regs, sizeof(regs)) == 0
+		&& state.memmode == g_memmode;
+}
+
+//-------------------------------------
+
+// Single-step, then step back: each undo gives back the state before that step
+int StepBack_test()
+{
+	LoadLoop();
+	reset();
+
+	const UINT kSteps = 10 * kLoopOpcodes;
+	std::vector<MachineState> states;
+	states.push_back(SaveState());
+
+	UINT uCycles = 0;
+	for (UINT i = 0; i < kSteps; i++)
+	{
+		uCycles += Cpu65C02(0, true);
+		states.push_back(SaveState());
+
+		if (i == 1 && !(g_memmode & MF_AUXWRITE)) return 1;	// STA $C005
+	}
+	if (uCycles != 10 * kLoopCycles || regs.pc != 0x300) return 1;
+
+	for (UINT i = kSteps; i > 0; i--)
+	{
+		if (!History_StepBack()) return 1;
+		if (!IsState(states[i - 1])) return 1;
+	}
+	if (History_StepBack()) return 1;
+	if (g_nRestorePaging != kSteps) return 1;
+
+	// Run forwards again, from the start of the history
+	for (UINT i = 0; i < kSteps; i++)
+		Cpu65C02(0, true);
+	if (!IsState(states[kSteps])) return 1;
+
+	return 0;
+}
+
+// Run in a batch (as the emulator does), then undo it all
+int Batch_test()
+{
+	LoadLoop();
+	reset();
+	const MachineState start = SaveState();
+
+	const UINT kLoops = 1000;
+	const UINT uCycles = Cpu65C02(kLoops * kLoopCycles, true);
+	if (uCycles != kLoops * kLoopCycles || regs.pc != 0x300) return 1;
+
+	UINT nUndone = 0;
+	while (History_StepBack())
+		nUndone++;
+
+	if (nUndone != kLoops * kLoopOpcodes) return 1;
+	if (!IsState(start)) return 1;
+
+	return 0;
+}
+
+// The ring keeps the newest 65536 instructions
+int RingFull_test()
+{
+	LoadLoop();
+	reset();
+
+	const UINT kHistorySize = 0x10000;
+	const UINT kSteps = kHistorySize + 1000;
+	MachineState oldest;
+
+	for (UINT i = 0; i < kSteps; i++)
+	{
+		if (i == kSteps - kHistorySize)
+			oldest = SaveState();
+		Cpu65C02(0, true);
+	}
+
+	UINT nUndone = 0;
+	while (History_StepBack())
+		nUndone++;
+
+	if (nUndone != kHistorySize) return 1;
+	if (!IsState(oldest)) return 1;
+
+	return 0;
+}
+
+//-------------------------------------
+
+// Cost of recording the history, for the 65C02 core (no debugger)
+int Overhead_test()
+{
+	LoadLoop();
+
+	const UINT kLoops = 500000;
+
+	double secs[3];
+	for (UINT i = 0; i < 3; i++)
+	{
+		reset();
+		g_bExecutionHistory = (i == 2);
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		const UINT uCycles = (i == 0) ? Cpu65C02_noHistory(kLoops * kLoopCycles, true) : Cpu65C02(kLoops * kLoopCycles, true);
+		secs[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if (uCycles != kLoops * kLoopCycles) return 1;
+	}
+
+	const double kOpcodes = (double)kLoops * kLoopOpcodes;
+	printf("65C02 core without history: %.1f ns per opcode\n", secs[0] * 1e9 / kOpcodes);
+	printf("65C02 core, history off: %.1f ns per opcode\n", secs[1] * 1e9 / kOpcodes);
+	printf("65C02 core, history on: %.1f ns per opcode\n", secs[2] * 1e9 / kOpcodes);
+
+	// At 1MHz, with this loop's mix of opcodes & writes
+	const double kOpcodesPerSec = 1020484.0 * kLoopOpcodes / kLoopCycles;
+	printf("History on: +%.1f ms per emulated second\n", (secs[2] - secs[0]) * 1e3 * kOpcodesPerSec / kOpcodes);
+
+	return 0;
+}
+
+//-------------------------------------
+
+int main(int argc, char* argv[])
+{
+	int res = 1;
+
+	init();
+
+	if (!g_bExecutionHistory) return 1;	// on by default
+
+	res = StepBack_test();
+	if (res) return res;
+
+	res = Batch_test();
+	if (res) return res;
+
+	res = RingFull_test();
+	if (res) return res;
+
+	res = Overhead_test();
+	if (res) return res;
+
+	return 0;
+}
@@ -0,0 +1,342 @@
+#include "stdafx.h"
+
+#include "CPU.h"
+#include "Core.h"
+#include "Interface.h"
+#include "Memory.h"
+#include "Video.h"
+
+#include "linux/cassettetape.h"
+#include "linux/context.h"
+#include "linux/keyboardbuffer.h"
+#include "linux/paddle.h"
+#include "frontends/common2/commoncontext.h"
+#include "frontends/common2/gnuframe.h"
+#include "frontends/common2/programoptions.h"
+#include "frontends/common2/ptreeregistry.h"
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <random>
+
+// Idle-loop skipping must be invisible: the whole machine (CPU, RAM, video, cards) runs the same
+// polling loops with & without it, and must end up in the same state after the same # of frames
+
+// A headless frame: the video is still rendered into the frame buffer, just never presented
+class TestFrame : public common2::GNUFrame
+{
+public:
+	TestFrame(const common2::EmulatorOptions& options) : common2::GNUFrame(options) {}
+
+	void VideoPresentScreen() override {}
+
+	int FrameMessageBox(LPCSTR lpText, LPCSTR lpCaption, UINT uType) override
+	{
+		return IDOK;
+	}
+
+	std::shared_ptr<SoundBuffer> CreateSoundBuffer(uint32_t dwBufferSize, uint32_t nSampleRate, int nChannels, const char* pszVoiceName) override
+	{
+		return nullptr;
+	}
+};
+
+struct MachineState
+{
+	regsrec regs;
+	unsigned __int64 nCumulativeCycles;
+	std::vector<BYTE> mainMem;
+	std::vector<BYTE> auxMem;
+	std::vector<uint8_t> frameBuffer;
+};
+
+const UINT kRunFrames = 600;
+const UINT kKeyFrames = 37;			// frames between keypresses
+const int64_t kFrameTime = 1000000 / 60;	// us, as per libretro
+
+const WORD kOrg = 0x0300;
+const WORD kCount = 0x1000;
+
+// Wait for VBL to start & then end, and count frames
+const BYTE kCodeVBL[] = {
+	0xAD, 0x19, 0xC0,	// LDA $C019
+	0x10, 0xFB,			// BPL *-3
+	0xAD, 0x19, 0xC0,	// LDA $C019
+	0x30, 0xFB,			// BMI *-3
+	0xEE, 0x00, 0x10,	// INC $1000
+	0x4C, 0x00, 0x03,	// JMP $0300
+};
+
+// Wait for a key, and count & keep the keys
+const BYTE kCodeKey[] = {
+	0xAD, 0x00, 0xC0,	// LDA $C000
+	0x10, 0xFB,			// BPL *-3
+	0x8D, 0x10, 0xC0,	// STA $C010
+	0x8D, 0x01, 0x10,	// STA $1001
+	0xEE, 0x00, 0x10,	// INC $1000
+	0x4C, 0x00, 0x03,	// JMP $0300
+};
+
+// Wait for each tape edge with the Monitor's RDBIT loop, and keep the counts (Y) & the last A
+const BYTE kCodeTape[] = {
+	0xA2, 0x00,			// LDX #0
+	0xA0, 0x00,			// LDY #0
+	0x88,				// DEY
+	0xAD, 0x60, 0xC0,	// LDA $C060
+	0x45, 0x2F,			// EOR $2F
+	0x10, 0xF8,			// BPL *-6
+	0x45, 0x2F,			// EOR $2F
+	0x85, 0x2F,			// STA $2F
+	0x8D, 0x01, 0x10,	// STA $1001
+	0x98,				// TYA
+	0x9D, 0x00, 0x40,	// STA $4000,X
+	0xE8,				// INX
+	0xD0, 0xE8,			// BNE *-22 (LDY #0)
+	0xEE, 0x00, 0x10,	// INC $1000
+	0x4C, 0x02, 0x03,	// JMP $0302
+};
+
+const int kTapeFrequency = 22050;
+const size_t kTapeSamples = 200000;	// ~9s
+const char* kTapeFile = "testidleloop.wav";
+
+// A noisy sine, alternating between ~440Hz & ~880Hz
+static std::vector<CassetteTape::tape_data_t> MakeTape(void)
+{
+	std::mt19937 rng(1);
+	std::vector<CassetteTape::tape_data_t> data(kTapeSamples);
+	double phase = 0.0;
+	for (size_t i = 0; i < data.size(); i++)
+	{
+		phase += ((i / 5000) & 1) ? 0.25 : 0.125;
+		const double v = 100.0 * sin(phase) + (int)(rng() % 15) - 7;
+		data[i] = (CassetteTape::tape_data_t)std::max(-128.0, std::min(127.0, v));
+	}
+	return data;
+}
+
+// The same tape as a 16-bit stereo .wav
+static bool WriteTapeFile(const std::vector<CassetteTape::tape_data_t>& data)
+{
+	std::ofstream file(kTapeFile, std::ios::binary);
+	const auto write32 = [&file](uint32_t v) { file.write((const char*)&v, 4); };
+	const auto write16 = [&file](uint16_t v) { file.write((const char*)&v, 2); };
+
+	file.write("RIFF", 4);
+	write32(36 + (uint32_t)data.size() * 4);
+	file.write("WAVEfmt ", 8);
+	write32(16);
+	write16(1);		// PCM
+	write16(2);		// channels
+	write32(kTapeFrequency);
+	write32(kTapeFrequency * 4);
+	write16(4);		// block align
+	write16(16);	// bits per sample
+	file.write("data", 4);
+	write32((uint32_t)data.size() * 4);
+	for (size_t i = 0; i < data.size(); i++)
+	{
+		write16((uint16_t)(data[i] * 256));
+		write16((uint16_t)(data[i] * 256));
+	}
+	return file.good();
+}
+
+//-----------------------------------------------------------------------------
+
+static void RunMachine(const BYTE* code, size_t codeSize, bool bKeys, bool bTape, bool bIdleLoopSkip, MachineState& state, double& msPerFrame)
+{
+	common2::EmulatorOptions options;
+	options.fixedSpeed = true;
+	options.noAudio = true;
+	options.memclear = 0;
+	options.autoBoot = false;	// else the Disk II spins (with no disk), & runs at full speed without video updates
+
+	// Not reset by a new machine (& the video scanner is positioned from them)
+	g_nCumulativeCycles = 0;
+	g_dwCyclesThisFrame = 0;
+
+	const LoggerContext loggerContext(false);
+	const RegistryContext registryContext(std::make_shared<common2::PTreeRegistry>());
+	const std::shared_ptr<TestFrame> frame = std::make_shared<TestFrame>(options);
+	const common2::CommonInitialisation init(frame, std::make_shared<Paddle>(), options);
+
+	for (size_t i = 0; i < codeSize; i++)
+		WriteByteToMemory(kOrg + (WORD)i, code[i]);
+	WriteByteToMemory(kCount, 0);
+	WriteByteToMemory(0x4E, 0x20);	// RNDL & RNDH are seeded from the time
+	WriteByteToMemory(0x4F, 0x20);
+	regs.pc = kOrg;
+
+	if (bTape)
+		CassetteTape::instance().setData("test", MakeTape(), kTapeFrequency);	// plays from the first read
+
+	SetIdleLoopSkip(bIdleLoopSkip);
+	frame->ChangeMode(MODE_RUNNING);
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (UINT i = 0; i < kRunFrames; i++)
+	{
+		if (bKeys && (i % kKeyFrames) == 0)
+			addKeyToBuffer((BYTE)('A' + (i / kKeyFrames) % 26));
+		frame->ExecuteOneFrame(kFrameTime);
+	}
+	msPerFrame = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1000.0 / kRunFrames;
+
+	SetIdleLoopSkip(false);
+	CassetteTape::instance().eject();
+
+	state.regs = regs;
+	state.nCumulativeCycles = g_nCumulativeCycles;
+	state.mainMem.assign(MemGetBankPtr(0), MemGetBankPtr(0) + 0x10000);
+	state.auxMem.assign(MemGetBankPtr(1), MemGetBankPtr(1) + 0x10000);
+	Video& video = GetVideo();
+	state.frameBuffer.assign(video.GetFrameBuffer(), video.GetFrameBuffer() + video.GetFrameBufferWidth() * video.GetFrameBufferHeight() * sizeof(bgra_t));
+}
+
+static int TestLoop(const char* name, const BYTE* code, size_t codeSize, bool bKeys, bool bTape)
+{
+	MachineState stateOff, stateOn;
+	double msOff, msOn;
+	RunMachine(code, codeSize, bKeys, bTape, false, stateOff, msOff);
+	RunMachine(code, codeSize, bKeys, bTape, true, stateOn, msOn);
+
+	printf("%s: %.3f ms per frame, %.3f ms with idle-loop skipping\n", name, msOff, msOn);
+
+	// The loop did count frames or keys
+	if (stateOff.mainMem[kCount] == 0) return 1;
+
+	if (memcmp(&stateOff.regs, &stateOn.regs, sizeof(regsrec)) != 0) return 1;
+	if (stateOff.nCumulativeCycles != stateOn.nCumulativeCycles) return 1;
+	if (stateOff.mainMem != stateOn.mainMem) return 1;
+	if (stateOff.auxMem != stateOn.auxMem) return 1;
+	if (stateOff.frameBuffer != stateOn.frameBuffer) return 1;
+
+	return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+// The per-read algorithm that the edge list replaced: interpolate the wave at the read's cycle, with hysteresis
+class TapeReference
+{
+public:
+	TapeReference(const std::vector<CassetteTape::tape_data_t>& data) : m_data(data), m_baseCycles(0), m_bStarted(false), m_lastBit(1) {}
+
+	BYTE GetValue(unsigned __int64 cycles)
+	{
+		if (!m_bStarted)
+		{
+			m_baseCycles = cycles;
+			m_bStarted = true;
+		}
+
+		const double position = (cycles - m_baseCycles) / g_fCurrentCLK6502 * kTapeFrequency;
+		const size_t pos = (size_t)position;
+		int value = -128;
+		if (pos + 1 < m_data.size())
+		{
+			const double r = position - pos;
+			value = lround((1.0 - r) * m_data[pos] + r * m_data[pos + 1]);
+		}
+
+		if (value > 5)
+			m_lastBit = 0;
+		else if (value < -5)
+			m_lastBit = 1;
+		return m_lastBit;
+	}
+
+private:
+	const std::vector<CassetteTape::tape_data_t>& m_data;
+	unsigned __int64 m_baseCycles;
+	bool m_bStarted;
+	BYTE m_lastBit;
+};
+
+// TAPEIN read on every cycle (past the end of the tape) must be bit-identical to the per-read algorithm,
+// and each getIdlePollCycles() must leave the cycle count alone & be a promise that the value doesn't change
+static int TestTapeRead(const char* name, const std::vector<CassetteTape::tape_data_t>& data, bool bStream)
+{
+	CassetteTape& tape = CassetteTape::instance();
+	if (bStream)
+	{
+		if (!tape.openFile(kTapeFile)) return 1;
+	}
+	else
+	{
+		tape.setData("test", data, kTapeFrequency);
+	}
+
+	TapeReference reference(data);
+
+	CpuCalcCycles(0);	// a new CpuExecute() batch (nExecutedCycles is monotonic from here)
+	g_nCumulativeCycles = 12345;
+
+	const unsigned __int64 kCycles = (unsigned __int64)(data.size() / (double)kTapeFrequency * g_fCurrentCLK6502) + 1000;
+	unsigned __int64 promiseEnd = 0;
+	BYTE promiseBit = 0;
+	ULONG nExecutedCycles = 0;
+	UINT numSkippable = 0;
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned __int64 cycle = 0; cycle < kCycles; cycle++)
+	{
+		nExecutedCycles++;
+
+		const unsigned __int64 cumulativeCycles = g_nCumulativeCycles;
+		const UINT pollCycles = tape.getIdlePollCycles(nExecutedCycles);
+		if (g_nCumulativeCycles != cumulativeCycles) return 1;
+
+		const BYTE bit = tape.getValue(nExecutedCycles);
+		if (bit != reference.GetValue(g_nCumulativeCycles))
+		{
+			printf("%s: cycle %llu differs\n", name, (unsigned long long)cycle);
+			return 1;
+		}
+
+		if (g_nCumulativeCycles < promiseEnd && bit != promiseBit) return 1;
+		if (pollCycles && g_nCumulativeCycles >= promiseEnd)
+		{
+			promiseEnd = g_nCumulativeCycles + pollCycles;
+			promiseBit = bit;
+		}
+		if (pollCycles > 1)
+			numSkippable++;
+	}
+	const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	tape.eject();
+
+	printf("%s: %llu reads identical, %.1f ns per read (with getIdlePollCycles())\n", name, (unsigned long long)kCycles, secs * 1e9 / kCycles);
+
+	if (numSkippable < kCycles / 2) return 1;	// the polls did allow skipping
+	return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+	int res = 1;
+
+	const std::vector<CassetteTape::tape_data_t> tape = MakeTape();
+	if (!WriteTapeFile(tape)) return 1;
+
+	res = TestTapeRead("Tape read (in memory)", tape, false);
+	if (!res) res = TestTapeRead("Tape read (streamed .wav)", tape, true);
+	remove(kTapeFile);
+	if (res) return res;
+
+	res = TestLoop("VBL wait", kCodeVBL, sizeof(kCodeVBL), false, false);
+	if (res) return res;
+
+	res = TestLoop("Key wait", kCodeKey, sizeof(kCodeKey), true, false);
+	if (res) return res;
+
+	res = TestLoop("Tape RDBIT", kCodeTape, sizeof(kCodeTape), false, true);
+	if (res) return res;
+
+	return 0;
+}
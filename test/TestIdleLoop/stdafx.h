@@ -0,0 +1,9 @@
+// stdafx.h : include file for standard system include files,
+// or project specific include files that are used frequently, but
+// are changed infrequently
+//
+
+#pragma once
+
+// The whole emulator is linked in, so use its own precompiled header
+#include "../../source/StdAfx.h"
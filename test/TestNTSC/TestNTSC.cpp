@@ -0,0 +1,136 @@
+#include "stdafx.h"
+
+#include "../../source/NTSC_Chroma.h"
+#ifdef NTSC_GENERATED_CHROMA_TABLES
+	#include "NTSC_ChromaTables.h"	// Generated at build-time by ntscchroma (CMake only)
+#endif
+
+#include <chrono>
+#include <cstdio>
+
+static uint32_t g_aBnWMonitor[NTSC_NUM_SEQUENCES];
+static uint32_t g_aHueMonitor[NTSC_NUM_PHASES][NTSC_NUM_SEQUENCES];
+static uint32_t g_aBnWColorTV[NTSC_NUM_SEQUENCES];
+static uint32_t g_aHueColorTV[NTSC_NUM_PHASES][NTSC_NUM_SEQUENCES];
+
+//-----------------------------------------------------------------------------
+
+// FNV-1a of the tables that NTSC.cpp built at start-up before they were split out to NTSC_Chroma.cpp
+// . a rebuild (debugger's palette reset) then gave HueColorTV 0x56D95BB6, as the filters kept their state
+static const uint32_t kGoldenBnWMonitor = 0x60531DC5;
+static const uint32_t kGoldenHueMonitor = 0xAB137D5E;
+static const uint32_t kGoldenBnWColorTV = 0x2B104238;
+static const uint32_t kGoldenHueColorTV = 0x6E15A4BA;
+
+static uint32_t Fnv(const uint32_t* pTable, size_t size)
+{
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < size; i++)
+		for (UINT byte = 0; byte < 4; byte++)
+			hash = (hash ^ ((pTable[i] >> (byte * 8)) & 0xFF)) * 16777619u;
+	return hash;
+}
+
+static int CheckHash(const char* name, const uint32_t* pTable, size_t size, uint32_t golden)
+{
+	const uint32_t hash = Fnv(pTable, size);
+	if (hash != golden)
+	{
+		printf("%s: hash 0x%08X != golden 0x%08X\n", name, hash, golden);
+		return 1;
+	}
+
+	return 0;
+}
+
+#ifdef NTSC_GENERATED_CHROMA_TABLES
+static int CheckTable(const char* name, const uint32_t* pTable, const uint32_t* pGenerated, size_t size)
+{
+	for (size_t i = 0; i < size; i++)
+	{
+		if (pTable[i] != pGenerated[i])
+		{
+			printf("%s[%u]: run-time 0x%08X != generated 0x%08X\n", name, (UINT)i, pTable[i], pGenerated[i]);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+#endif
+
+// The tables built at run-time must be the ones from before NTSC_Chroma.cpp (and identical to the generated ones),
+// and rebuilding (eg. debugger's palette reset) must not change them
+int TestChromaTables(void)
+{
+	for (int pass = 0; pass < 2; pass++)
+	{
+		memset(g_aBnWMonitor, 0, sizeof(g_aBnWMonitor));
+		memset(g_aHueMonitor, 0, sizeof(g_aHueMonitor));
+		memset(g_aBnWColorTV, 0, sizeof(g_aBnWColorTV));
+		memset(g_aHueColorTV, 0, sizeof(g_aHueColorTV));
+
+		NTSC_BuildChromaTables(g_aBnWMonitor, g_aHueMonitor, g_aBnWColorTV, g_aHueColorTV);
+
+		int res = 0;
+		res |= CheckHash("BnWMonitor", g_aBnWMonitor, NTSC_NUM_SEQUENCES, kGoldenBnWMonitor);
+		res |= CheckHash("HueMonitor", &g_aHueMonitor[0][0], NTSC_NUM_PHASES * NTSC_NUM_SEQUENCES, kGoldenHueMonitor);
+		res |= CheckHash("BnWColorTV", g_aBnWColorTV, NTSC_NUM_SEQUENCES, kGoldenBnWColorTV);
+		res |= CheckHash("HueColorTV", &g_aHueColorTV[0][0], NTSC_NUM_PHASES * NTSC_NUM_SEQUENCES, kGoldenHueColorTV);
+#ifdef NTSC_GENERATED_CHROMA_TABLES
+		res |= CheckTable("BnWMonitor", g_aBnWMonitor, g_kBnWMonitor, NTSC_NUM_SEQUENCES);
+		res |= CheckTable("HueMonitor", &g_aHueMonitor[0][0], &g_kHueMonitor[0][0], NTSC_NUM_PHASES * NTSC_NUM_SEQUENCES);
+		res |= CheckTable("BnWColorTV", g_aBnWColorTV, g_kBnWColorTV, NTSC_NUM_SEQUENCES);
+		res |= CheckTable("HueColorTV", &g_aHueColorTV[0][0], &g_kHueColorTV[0][0], NTSC_NUM_PHASES * NTSC_NUM_SEQUENCES);
+#endif
+		if (res) return res;
+	}
+
+	return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+int Benchmark(void)
+{
+	const UINT kRuns = 20;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (UINT i = 0; i < kRuns; i++)
+		NTSC_BuildChromaTables(g_aBnWMonitor, g_aHueMonitor, g_aBnWColorTV, g_aHueColorTV);
+	const double buildSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+#ifdef NTSC_GENERATED_CHROMA_TABLES
+	start = std::chrono::steady_clock::now();
+	for (UINT i = 0; i < kRuns; i++)
+	{
+		memcpy(g_aBnWMonitor, g_kBnWMonitor, sizeof(g_aBnWMonitor));
+		memcpy(g_aHueMonitor, g_kHueMonitor, sizeof(g_aHueMonitor));
+		memcpy(g_aBnWColorTV, g_kBnWColorTV, sizeof(g_aBnWColorTV));
+		memcpy(g_aHueColorTV, g_kHueColorTV, sizeof(g_aHueColorTV));
+	}
+	const double copySecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	printf("Benchmark: NTSC chroma tables: %.2f ms built at run-time, %.1f us copied from the generated tables\n",
+		buildSecs * 1e3 / kRuns, copySecs * 1e6 / kRuns);
+#else
+	printf("Benchmark: NTSC chroma tables: %.2f ms built at run-time\n", buildSecs * 1e3 / kRuns);
+#endif
+
+	return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+	int res = 1;
+
+	res = TestChromaTables();
+	if (res) return res;
+
+	res = Benchmark();
+	if (res) return res;
+
+	return 0;
+}
@@ -0,0 +1,200 @@
+#include "stdafx.h"
+
+#include "../../source/Riff.h"
+
+#include <chrono>
+#include <cstdio>
+
+// Stubs for Riff.cpp's dependencies
+void LogFileOutput(const char* format, ...) {}
+
+static const UINT kSpeakerRate = 44100;	// SPKR_SAMPLE_RATE
+static const UINT kSSI263Rate = 22050;	// SAMPLE_RATE_SSI263
+static const UINT kFrameSamples = 735;	// 44.1KHz @ 60Hz
+
+//-----------------------------------------------------------------------------
+
+static short Pattern(UINT stem, size_t i)
+{
+	return (short)((i * 7 + stem * 1000) ^ (i >> 8));
+}
+
+static void PutPattern(RIFF_STEM stem, UINT numSamples, UINT sampleRate, UINT numChannels, size_t& pos)
+{
+	std::vector<short> buf(numSamples * numChannels);
+	for (size_t i = 0; i < buf.size(); i++)
+		buf[i] = Pattern(stem, pos + i);
+	pos += buf.size();
+
+	RiffPutSamples(stem, &buf[0], numSamples, sampleRate, numChannels);
+}
+
+static UINT Read32(const BYTE* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((UINT)p[3] << 24); }
+static UINT Read16(const BYTE* p) { return p[0] | (p[1] << 8); }
+
+// Check the .wav's header & that its data is the stem's pattern
+static int CheckWavFile(const char* pszFile, RIFF_STEM stem, UINT sampleRate, UINT numChannels, size_t numShorts)
+{
+	FILE* fp = fopen(pszFile, "rb");
+	if (!fp)
+	{
+		printf("%s: missing\n", pszFile);
+		return 1;
+	}
+
+	std::vector<BYTE> file;
+	BYTE buf[0x1000];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), fp)) != 0)
+		file.insert(file.end(), buf, buf + n);
+	fclose(fp);
+	remove(pszFile);
+
+	const size_t kHeaderSize = 44;
+	if (file.size() != kHeaderSize + numShorts * sizeof(short)) return 1;
+
+	const BYTE* p = &file[0];
+	if (memcmp(p + 0, "RIFF", 4) || Read32(p + 4) != file.size() - 8) return 1;
+	if (memcmp(p + 8, "WAVEfmt ", 8) || Read32(p + 16) != 16 || Read16(p + 20) != 1) return 1;
+	if (Read16(p + 22) != numChannels || Read32(p + 24) != sampleRate) return 1;
+	if (Read32(p + 28) != sampleRate * 2 * numChannels || Read16(p + 32) != 2 * numChannels || Read16(p + 34) != 16) return 1;
+	if (memcmp(p + 36, "data", 4) || Read32(p + 40) != numShorts * sizeof(short)) return 1;
+
+	for (size_t i = 0; i < numShorts; i++)
+	{
+		if ((short)Read16(p + kHeaderSize + i * 2) != Pattern(stem, i))
+		{
+			printf("%s: sample %u is wrong\n", pszFile, (UINT)i);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+// An explicit file & stems, with a put larger than the writer's ring (which can never fit, so is dropped & counted)
+int TestStems(void)
+{
+	const RIFF_STEM kMockingboardSlot4 = (RIFF_STEM)(RIFF_MOCKINGBOARD_SLOT0 + SLOT4);
+	const RIFF_STEM kSSI263Slot4Device1 = (RIFF_STEM)(RIFF_SSI263_SLOT0 + SLOT4 * 2 + 1);
+
+	if (RiffGetStemName(kMockingboardSlot4) != "mockingboard-s4") return 1;
+	if (RiffGetStemName(kSSI263Slot4Device1) != "ssi263-s4-1") return 1;
+
+	if (!RiffInitWriteFile(RIFF_SPEAKER, "testriff.wav")) return 1;
+	RiffInitWriteStems("testriff");
+
+	for (UINT i = 0; i < NUM_RIFF_STEMS; i++)
+		if (!RiffIsWriting((RIFF_STEM)i)) return 1;
+
+	size_t speakerPos = 0, mockingboardPos = 0, ssi263Pos = 0;
+	for (UINT frame = 0; frame < 60; frame++)
+	{
+		PutPattern(RIFF_SPEAKER, kFrameSamples, kSpeakerRate, 2, speakerPos);
+		PutPattern(kMockingboardSlot4, kFrameSamples + frame, kSpeakerRate, 2, mockingboardPos);
+		if (frame >= 20 && frame < 30)
+			PutPattern(kSSI263Slot4Device1, kFrameSamples / 2, kSSI263Rate, 1, ssi263Pos);
+	}
+	if (RiffGetDroppedBlocks(RIFF_SPEAKER)) return 1;
+
+	size_t droppedPos = speakerPos;
+	PutPattern(RIFF_SPEAKER, 700000, kSpeakerRate, 2, droppedPos);	// 1.4M shorts
+	if (RiffGetDroppedBlocks(RIFF_SPEAKER) != 1) return 1;
+
+	PutPattern(RIFF_SPEAKER, 1, kSpeakerRate, 2, speakerPos);
+
+	if (!RiffFinishWriteFile()) return 1;
+	if (RiffIsWriting(RIFF_SPEAKER)) return 1;
+
+	if (CheckWavFile("testriff.wav", RIFF_SPEAKER, kSpeakerRate, 2, speakerPos)) return 1;
+	if (CheckWavFile("testriff-mockingboard-s4.wav", kMockingboardSlot4, kSpeakerRate, 2, mockingboardPos)) return 1;
+	if (CheckWavFile("testriff-ssi263-s4-1.wav", kSSI263Slot4Device1, kSSI263Rate, 1, ssi263Pos)) return 1;
+
+	// Stems without any samples aren't created
+	FILE* fp = fopen("testriff-mockingboard.wav", "rb");
+	if (fp)
+	{
+		fclose(fp);
+		return 1;
+	}
+
+	return 0;
+}
+
+// Cost to the emulation thread of capturing the speaker & a Mockingboard, per emulated second
+// . each emulated second's samples are put as fast as possible, then the writer thread is given (untimed) real time to catch up
+int Benchmark(void)
+{
+	const UINT kSeconds = 20;
+	const UINT kRealTimeMs = 50;
+	std::vector<short> buf(kFrameSamples * 2);
+	for (size_t i = 0; i < buf.size(); i++)
+		buf[i] = Pattern(0, i);
+
+	// Previously: a blocking write per buffer (as RiffPutSamples() did)
+	HANDLE hFile[2];
+	hFile[0] = CreateFile("testriff-speaker.wav", GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+	hFile[1] = CreateFile("testriff-mockingboard.wav", GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+	if (hFile[0] == INVALID_HANDLE_VALUE || hFile[1] == INVALID_HANDLE_VALUE) return 1;
+
+	double syncSecs = 0.0;
+	for (UINT s = 0; s < kSeconds; s++)
+	{
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (UINT frame = 0; frame < 60; frame++)
+		{
+			DWORD dwNumberOfBytesWritten;
+			WriteFile(hFile[0], &buf[0], (DWORD)(buf.size() * sizeof(short)), &dwNumberOfBytesWritten, NULL);
+			WriteFile(hFile[1], &buf[0], (DWORD)(buf.size() * sizeof(short)), &dwNumberOfBytesWritten, NULL);
+		}
+		syncSecs += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		Sleep(kRealTimeMs);
+	}
+
+	CloseHandle(hFile[0]);
+	CloseHandle(hFile[1]);
+
+	//
+
+	if (!RiffInitWriteFile(RIFF_SPEAKER, "testriff-speaker.wav")) return 1;
+	if (!RiffInitWriteFile(RIFF_MOCKINGBOARD, "testriff-mockingboard.wav")) return 1;
+
+	double asyncSecs = 0.0;
+	for (UINT s = 0; s < kSeconds; s++)
+	{
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (UINT frame = 0; frame < 60; frame++)
+		{
+			RiffPutSamples(RIFF_SPEAKER, &buf[0], kFrameSamples, kSpeakerRate, 2);
+			RiffPutSamples(RIFF_MOCKINGBOARD, &buf[0], kFrameSamples, kSpeakerRate, 2);
+		}
+		asyncSecs += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		Sleep(kRealTimeMs);
+	}
+
+	RiffFinishWriteFile();
+	remove("testriff-speaker.wav");
+	remove("testriff-mockingboard.wav");
+
+	printf("Benchmark: capture speaker & Mockingboard: %.1f us per emulated second (blocking writes: %.1f us)\n",
+		asyncSecs * 1e6 / kSeconds, syncSecs * 1e6 / kSeconds);
+
+	return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+	int res = 1;
+
+	res = TestStems();
+	if (res) return res;
+
+	res = Benchmark();
+	if (res) return res;
+
+	return 0;
+}
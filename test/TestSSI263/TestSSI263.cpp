@@ -0,0 +1,155 @@
+#include "stdafx.h"
+
+#include "../../source/SSI263Phonemes.h"
+#include "../../source/SSI263PhonemeEncoder.h"
+#include "../../source/SSI263PhonemeData.h"
+
+#include <chrono>
+
+// FNV-1a of the samples (as little-endian 16-bit)
+static UINT HashSamples(const short* pSamples, UINT numSamples, UINT hash = 2166136261u)
+{
+	for (UINT i = 0; i < numSamples; i++)
+	{
+		const USHORT sample = (USHORT)pSamples[i];
+		hash = (hash ^ (sample & 0xFF)) * 16777619u;
+		hash = (hash ^ (sample >> 8)) * 16777619u;
+	}
+	return hash;
+}
+
+//-----------------------------------------------------------------------------
+
+// Decoding must be lossless
+// . golden hashes were recorded from the original (uncompressed) 16-bit PCM phoneme bank
+int TestDecodeAll(void)
+{
+	const UINT kNumSamples = 156566;
+	const UINT kHash = 0x696D8F20;
+
+	UINT numSamples = 0;
+	UINT hash = 2166136261u;
+	for (UINT phoneme = 0; phoneme < SSI263PhonemeCache::kNumPhonemes; phoneme++)
+	{
+		const UINT length = SSI263PhonemeCache::GetLength(phoneme);
+		std::vector<short> samples(length);
+		SSI263PhonemeCache::Decode(phoneme, &samples[0]);
+		hash = HashSamples(&samples[0], length, hash);
+		numSamples += length;
+	}
+
+	if (numSamples != kNumSamples) return 1;
+	if (hash != kHash)
+	{
+		printf("Phoneme bank: hash %08X, expected %08X\n", hash, kHash);
+		return 1;
+	}
+
+	return 0;
+}
+
+// SSI263PhonemeData.h must be exactly the encoder's output for the (losslessly decoded, see above) original PCM,
+// ie. the table can be regenerated by the ssi263phonemes tool
+int TestEncodeAll(void)
+{
+	std::vector<BYTE> data;
+	for (UINT phoneme = 0; phoneme < SSI263PhonemeCache::kNumPhonemes; phoneme++)
+	{
+		if (g_nPhonemeInfo[phoneme].nOffset != data.size()) return 1;
+
+		const UINT length = SSI263PhonemeCache::GetLength(phoneme);
+		std::vector<short> samples(length);
+		SSI263PhonemeCache::Decode(phoneme, &samples[0]);
+		SSI263PhonemeEncode(&samples[0], length, data);
+	}
+
+	if (data.size() != sizeof(g_nPhonemeData) || memcmp(&data[0], g_nPhonemeData, data.size()))
+	{
+		printf("Phoneme bank: re-encoded to %u bytes, differs from SSI263PhonemeData.h (%u bytes)\n", (UINT)data.size(), (UINT)sizeof(g_nPhonemeData));
+		return 1;
+	}
+
+	return 0;
+}
+
+// Play a phoneme sequence (with pauses & repeats) as SSI263::Play() does, ie. via a single cache
+int TestPhonemeSequence(void)
+{
+	const UINT kSequence[] = { 25, 0, 3, 30, 44, 40, 3, 3, 61, 12, 0 };	// SSI263::Play() has already subtracted 2
+	const UINT kNumSamples = 28767;
+	const UINT kHash = 0x514503F0;
+
+	SSI263PhonemeCache cache;
+	UINT numSamples = 0;
+	UINT hash = 2166136261u;
+	const short* pPrevSamples = NULL;
+
+	for (size_t i = 0; i < sizeof(kSequence) / sizeof(kSequence[0]); i++)
+	{
+		const UINT length = SSI263PhonemeCache::GetLength(kSequence[i]);
+		const short* pSamples = cache.GetSamples(kSequence[i]);
+
+		// A repeated phoneme isn't decoded again
+		if (i > 0 && kSequence[i] == kSequence[i - 1] && pSamples != pPrevSamples) return 1;
+		if (cache.GetSamples(kSequence[i]) != pSamples) return 1;
+
+		hash = HashSamples(pSamples, length, hash);
+		numSamples += length;
+		pPrevSamples = pSamples;
+	}
+
+	if (numSamples != kNumSamples) return 1;
+	if (hash != kHash)
+	{
+		printf("Phoneme sequence: hash %08X, expected %08X\n", hash, kHash);
+		return 1;
+	}
+
+	return 0;
+}
+
+// Time to decode a phoneme (ie. the one-off cost per SSI263::Play() of a new phoneme)
+int Benchmark(void)
+{
+	const UINT kRuns = 20;
+	std::vector<short> samples(0x1000);
+
+	UINT numSamples = 0;
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (UINT run = 0; run < kRuns; run++)
+	{
+		for (UINT phoneme = 0; phoneme < SSI263PhonemeCache::kNumPhonemes; phoneme++)
+		{
+			SSI263PhonemeCache::Decode(phoneme, &samples[0]);
+			numSamples += SSI263PhonemeCache::GetLength(phoneme);
+		}
+	}
+
+	const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	printf("Benchmark: %.1f us per phoneme decode (%.1f M samples/sec)\n",
+		secs * 1e6 / (kRuns * SSI263PhonemeCache::kNumPhonemes), numSamples / secs / 1e6);
+
+	return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+	int res = 1;
+
+	res = TestDecodeAll();
+	if (res) return res;
+
+	res = TestEncodeAll();
+	if (res) return res;
+
+	res = TestPhonemeSequence();
+	if (res) return res;
+
+	res = Benchmark();
+	if (res) return res;
+
+	return 0;
+}
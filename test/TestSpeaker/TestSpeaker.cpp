@@ -0,0 +1,484 @@
+#include "stdafx.h"
+
+#include "../../source/BLEPSynth.h"
+#include "../../source/Core.h"
+#include "../../source/CPU.h"
+#include "../../source/Log.h"
+#include "../../source/Memory.h"
+#include "../../source/Riff.h"
+#include "../../source/SoundCore.h"
+#include "../../source/Speaker.h"
+
+#include <chrono>
+#include <complex>
+
+// Stubs for Speaker.cpp's dependencies
+bool g_bFullSpeed = false;
+bool g_bDisableDirectSound = false;
+double g_fCurrentCLK6502 = CLK_6502_NTSC;
+int g_nCpuCyclesFeedback = 0;
+unsigned __int64 g_nCumulativeCycles = 0;
+uint32_t extbench = 0;	// From Debug.cpp
+
+static unsigned __int64 g_nCyclesBase = 0;	// g_nCumulativeCycles at the start of this 1ms block
+void CpuCalcCycles(const ULONG nExecutedCycles) { g_nCumulativeCycles = g_nCyclesBase + nExecutedCycles; }
+BYTE MemReadFloatingBus(const ULONG uExecutedCycles) { return 0; }
+
+void LogOutput(const char* format, ...) {}
+void LogFileOutput(const char* format, ...) {}
+bool RiffPutSamples(RIFF_STEM stem, const short* buf, unsigned int uSamples, unsigned int sample_rate, unsigned int NumChannels) { return true; }
+
+// From FrameBase
+class FrameBase
+{
+public:
+	void VideoRedrawScreen();
+};
+
+void FrameBase::VideoRedrawScreen() {}
+
+FrameBase& GetFrame()
+{
+	static FrameBase sg_frame;
+	return sg_frame;
+}
+
+// A DirectSound buffer that keeps the fill level constant (3/8, as per Spkr_SubmitWaveBuffer()) & captures every frame written
+class CaptureSoundBuffer : public SoundBuffer
+{
+public:
+	CaptureSoundBuffer(DWORD size) : m_buffer(size), m_writeCursor(size / 8 * 3) {}
+
+	virtual HRESULT SetCurrentPosition(DWORD dwNewPosition) { return DS_OK; }
+	virtual HRESULT GetCurrentPosition(LPDWORD lpdwCurrentPlayCursor, LPDWORD lpdwCurrentWriteCursor)
+	{
+		const DWORD size = (DWORD)m_buffer.size();
+		*lpdwCurrentPlayCursor = (m_writeCursor + size - size / 8 * 3) % size;
+		*lpdwCurrentWriteCursor = (*lpdwCurrentPlayCursor + 4) % size;
+		return DS_OK;
+	}
+
+	virtual HRESULT Lock(DWORD dwWriteCursor, DWORD dwWriteBytes, LPVOID* lplpvAudioPtr1, DWORD* lpdwAudioBytes1, LPVOID* lplpvAudioPtr2, DWORD* lpdwAudioBytes2, DWORD dwFlags)
+	{
+		const DWORD size = (DWORD)m_buffer.size();
+		if (dwFlags & DSBLOCK_ENTIREBUFFER)
+		{
+			dwWriteCursor = 0;
+			dwWriteBytes = size;
+		}
+
+		*lplpvAudioPtr1 = &m_buffer[dwWriteCursor];
+		*lpdwAudioBytes1 = std::min(dwWriteBytes, size - dwWriteCursor);
+		if (lplpvAudioPtr2)
+		{
+			*lplpvAudioPtr2 = (dwWriteBytes > *lpdwAudioBytes1) ? &m_buffer[0] : NULL;
+			*lpdwAudioBytes2 = dwWriteBytes - *lpdwAudioBytes1;
+		}
+		return DS_OK;
+	}
+
+	virtual HRESULT Unlock(LPVOID lpvAudioPtr1, DWORD dwAudioBytes1, LPVOID lpvAudioPtr2, DWORD dwAudioBytes2)
+	{
+		if (dwAudioBytes1 == m_buffer.size())
+			return DS_OK;	// DSZeroVoiceBuffer()
+
+		Capture((const short*)lpvAudioPtr1, dwAudioBytes1);
+		if (lpvAudioPtr2)
+			Capture((const short*)lpvAudioPtr2, dwAudioBytes2);
+		m_writeCursor = (m_writeCursor + dwAudioBytes1 + dwAudioBytes2) % m_buffer.size();
+		return DS_OK;
+	}
+
+	virtual HRESULT Stop() { return DS_OK; }
+	virtual HRESULT Play(DWORD dwReserved1, DWORD dwReserved2, DWORD dwFlags) { return DS_OK; }
+	virtual HRESULT SetVolume(LONG lVolume) { return DS_OK; }
+	virtual HRESULT GetVolume(LONG* lplVolume) { *lplVolume = 0; return DS_OK; }
+	virtual HRESULT GetStatus(LPDWORD lpdwStatus) { *lpdwStatus = DSBSTATUS_PLAYING; return DS_OK; }
+	virtual HRESULT Restore() { return DS_OK; }
+
+	std::vector<short> m_left;		// Captured samples (left channel)
+	bool m_channelsDiffer = false;
+
+private:
+	void Capture(const short* pFrames, DWORD bytes)
+	{
+		for (DWORD i = 0; i < bytes / (2 * sizeof(short)); i++)
+		{
+			m_left.push_back(pFrames[i * 2]);
+			m_channelsDiffer |= pFrames[i * 2] != pFrames[i * 2 + 1];
+		}
+	}
+
+	std::vector<BYTE> m_buffer;
+	DWORD m_writeCursor;
+};
+
+static std::shared_ptr<CaptureSoundBuffer> g_pCaptureBuffer;
+
+bool DSAvailable() { return true; }
+HRESULT DSGetSoundBuffer(VOICE* pVoice, uint32_t dwBufferSize, uint32_t nSampleRate, int nChannels, const char* pszVoiceName)
+{
+	g_pCaptureBuffer = std::make_shared<CaptureSoundBuffer>(dwBufferSize);
+	pVoice->lpDSBvoice = g_pCaptureBuffer;
+	pVoice->bActive = true;
+	return DS_OK;
+}
+void DSReleaseSoundBuffer(VOICE* pVoice) { pVoice->lpDSBvoice.reset(); pVoice->bActive = false; }
+HRESULT DSGetLock(const std::shared_ptr<SoundBuffer>& pVoice, uint32_t dwOffset, uint32_t dwBytes,
+	SHORT** ppDSLockedBuffer0, DWORD* pdwDSLockedBufferSize0, SHORT** ppDSLockedBuffer1, DWORD* pdwDSLockedBufferSize1)
+{
+	return pVoice->Lock(dwOffset, dwBytes, (void**)ppDSLockedBuffer0, pdwDSLockedBufferSize0, (void**)ppDSLockedBuffer1, pdwDSLockedBufferSize1, dwBytes ? 0 : DSBLOCK_ENTIREBUFFER);
+}
+bool DSVoiceStop(PVOICE Voice) { return true; }
+bool DSZeroVoiceBuffer(PVOICE Voice, uint32_t dwBufferSize) { return true; }
+bool DSZeroVoiceWritableBuffer(PVOICE Voice, uint32_t dwBufferSize) { return true; }
+VOICE::~VOICE() {}
+bool SoundCore_GetTimerState() { return false; }
+int SoundCore_GetErrorInc() { return 1; }
+int SoundCore_GetErrorMax() { return 1; }
+bool SoundCore_ValidateAndAlignWriteOffset(uint32_t& rByteOffset, DWORD dwCurrentPlayCursor, DWORD dwCurrentWriteCursor) { return false; }
+LONG NewVolume(uint32_t dwVolume, uint32_t dwVolumeMax) { return 0; }
+
+// Speaker: 23 clks per sample @ 1.023MHz (see SetClksPerSpkrSample())
+static const double kClk = 1023000.0;
+static const double kClksPerSample = 23.0;
+static const double kSampleRate = kClk / kClksPerSample;
+static const UINT kBlockCycles = 1023;	// 1ms, as per CommonFrame::Execute() / ContinueExecution()
+
+static const short kLevelHi = (short)0x7FFF;	// As per SpkrToggle()
+static const short kLevelLo = (short)0x8000;
+
+//-----------------------------------------------------------------------------
+
+// Render a square wave (toggled every 'halfPeriod' cycles) with the synthesiser, in 1ms blocks
+static std::vector<short> RenderBLEP(double halfPeriod, UINT numSamples)
+{
+	BLEPSynth synth;
+	synth.Initialize(kClksPerSample);
+	synth.Reset(0, kLevelLo);
+
+	std::vector<short> out(numSamples + kBlockCycles);
+	UINT numOut = 0;
+
+	short level = kLevelLo;
+	double nextToggle = halfPeriod;
+	for (UINT64 blockEnd = kBlockCycles; numOut < numSamples; blockEnd += kBlockCycles)
+	{
+		for (; nextToggle < blockEnd; nextToggle += halfPeriod)
+		{
+			level = (level == kLevelLo) ? kLevelHi : kLevelLo;
+			synth.AddEdge((UINT64)nextToggle, level);
+		}
+		numOut += synth.Render(blockEnd, &out[numOut], (UINT)out.size() - numOut);
+	}
+
+	out.resize(numSamples);
+	return out;
+}
+
+// Reference: the previous speaker resampler, ie. each sample is the mean level over its 23 cycles
+static std::vector<short> RenderBoxAverage(double halfPeriod, UINT numSamples)
+{
+	std::vector<short> out(numSamples);
+
+	short level = kLevelLo;
+	double nextToggle = halfPeriod;
+	UINT64 cycle = 0;
+	for (UINT i = 0; i < numSamples; i++)
+	{
+		int sum = 0;
+		for (UINT c = 0; c < (UINT)kClksPerSample; c++, cycle++)
+		{
+			if (cycle >= (UINT64)nextToggle)
+			{
+				level = (level == kLevelLo) ? kLevelHi : kLevelLo;
+				nextToggle += halfPeriod;
+			}
+			sum += level;
+		}
+		out[i] = (short)(sum / (int)kClksPerSample);
+	}
+
+	return out;
+}
+
+//-----------------------------------------------------------------------------
+
+static void FFT(std::vector< std::complex<double> >& x)
+{
+	const size_t n = x.size();
+
+	for (size_t i = 1, j = 0; i < n; i++)
+	{
+		size_t bit = n >> 1;
+		for (; j & bit; bit >>= 1)
+			j ^= bit;
+		j ^= bit;
+		if (i < j)
+			std::swap(x[i], x[j]);
+	}
+
+	for (size_t len = 2; len <= n; len <<= 1)
+	{
+		const double a = -2.0 * 3.14159265358979323846 / len;
+		const std::complex<double> wlen(cos(a), sin(a));
+		for (size_t i = 0; i < n; i += len)
+		{
+			std::complex<double> w(1.0);
+			for (size_t j = 0; j < len / 2; j++, w *= wlen)
+			{
+				const std::complex<double> u = x[i + j];
+				const std::complex<double> v = x[i + j + len / 2] * w;
+				x[i + j] = u + v;
+				x[i + j + len / 2] = u - v;
+			}
+		}
+	}
+}
+
+// Ratio (dB) of the power in all audible bins except the fundamental, to the fundamental's power
+// . for a fundamental above SampleRate/3 every harmonic is above Nyquist, so all this power is aliasing
+// . 'signal' is the fundamental's power (dB)
+static double AliasRatio_dB(const std::vector<short>& wave, double freq, double& signal_dB)
+{
+	const size_t kSkip = 256;	// Ignore the start-up transient
+	const size_t kSize = 8192;
+
+	std::vector< std::complex<double> > x(kSize);
+	for (size_t i = 0; i < kSize; i++)
+	{
+		const double hann = 0.5 - 0.5 * cos(2.0 * 3.14159265358979323846 * i / kSize);
+		x[i] = hann * wave[kSkip + i];
+	}
+
+	FFT(x);
+
+	const size_t kDCBins = 4;
+	const size_t kLeakBins = 4;	// Hann main lobe
+	const size_t fundamental = (size_t)(freq / kSampleRate * kSize + 0.5);
+	const size_t audible = (size_t)(20000.0 / kSampleRate * kSize);
+
+	double signal = 0.0, alias = 0.0;
+	for (size_t bin = kDCBins; bin < audible; bin++)
+	{
+		const double power = std::norm(x[bin]);
+		if (bin + kLeakBins >= fundamental && bin <= fundamental + kLeakBins)
+			signal += power;
+		else
+			alias += power;
+	}
+
+	signal_dB = 10.0 * log10(signal);
+	return 10.0 * log10(alias / signal);
+}
+
+//-----------------------------------------------------------------------------
+
+// Square waves with a fundamental between 14 & 16KHz, ie. all harmonics fold back into the audible range
+int TestAliasing(void)
+{
+	const double kHalfPeriods[] = { 32.0, 33.0, 35.0, 37.0 };
+
+	for (size_t i = 0; i < sizeof(kHalfPeriods) / sizeof(kHalfPeriods[0]); i++)
+	{
+		const double halfPeriod = kHalfPeriods[i];
+		const double freq = kClk / (2.0 * halfPeriod);
+
+		double blepSignal = 0.0, boxSignal = 0.0;
+		const double blep = AliasRatio_dB(RenderBLEP(halfPeriod, 8192 + 256), freq, blepSignal);
+		const double box = AliasRatio_dB(RenderBoxAverage(halfPeriod, 8192 + 256), freq, boxSignal);
+		printf("Square wave %5.0f Hz: alias/signal = %6.1f dB (BLEP), %6.1f dB (box average); BLEP signal %+.1f dB\n", freq, blep, box, blepSignal - boxSignal);
+
+		if (blep > -45.0) return 1;
+		if (blep > box - 20.0) return 1;
+		if (blepSignal < boxSignal - 1.0) return 1;	// The limiter mustn't make the speaker noticeably quieter
+	}
+
+	return 0;
+}
+
+// The integrated level must settle to exactly the last edge's level (once the limiter's gain is back to unity), ie. no drift
+int TestSteadyLevel(void)
+{
+	BLEPSynth synth;
+	synth.Initialize(kClksPerSample);
+	synth.Reset(0, 0);
+
+	std::vector<short> out(kBlockCycles);
+	UINT64 cycle = 0;
+	short level = 0;
+
+	for (UINT block = 0; block < 10000; block++)
+	{
+		// Pseudo-random (8-bit DAC) levels at pseudo-random cycles
+		for (UINT i = 0; i < 50; i++)
+		{
+			cycle += 1 + ((block * 7 + i * 13) % 37);
+			level = (short)((((block * 31 + i * 17) & 0xFF) ^ 0x80) << 8);
+			synth.AddEdge(cycle, level);
+			if (i & 1)
+				synth.SetLevel(cycle, level = (short)~level);	// eg. SAM's write after SpkrToggle()
+		}
+		synth.Render(cycle, &out[0], (UINT)out.size());
+	}
+
+	// Flush the kernel tail & the limiter (each of its last kLookahead gains is the min over the kLookahead before)
+	const UINT kSettle = BLEPSynth::kTaps + 2 * BLEPSynth::kLookahead;
+	const UINT numOut = synth.Render(cycle + (UINT64)(kClksPerSample * (kSettle + 2)), &out[0], (UINT)out.size());
+	if (numOut < kSettle) return 1;
+	const short outLevel = level;
+	if (out[numOut - 1] != outLevel) return 1;
+
+	// Silence
+	const UINT numSilent = synth.Render(cycle + 100000, &out[0], (UINT)out.size());
+	if (numSilent != out.size()) return 1;	// Limited by maxSamples
+	for (UINT i = 0; i < numSilent; i++)
+		if (out[i] != outLevel) return 1;
+
+	return 0;
+}
+
+// Speaker.cpp's edges (from SpkrToggle() & SpkrSetLevel()), rendered by SpkrUpdate() in 1ms blocks and submitted to the
+// sound buffer, must be exactly the standalone synthesiser's output for the same edges rendered in one go
+int TestSpeakerUpdate(void)
+{
+	struct Edge
+	{
+		UINT64 cycle;
+		short level;
+		bool setLevel;
+	};
+	std::vector<Edge> edges;
+
+	g_nCyclesBase = g_nCumulativeCycles = 1000000;
+	SpkrInitialize();
+	SpkrReset();
+	if (!g_pCaptureBuffer) return 1;
+
+	const UINT64 startCycle = g_nCumulativeCycles;
+	const short startLevel = g_nSpeakerData;
+
+	UINT seed = 1;
+	for (UINT block = 0; block < 300; block++)
+	{
+		// NB. block 100 is long and dense enough to fill the edge list, so SpkrToggle() renders mid-block
+		const bool bFull = block == 100;
+		const UINT blockCycles = bFull ? BLEPSynth::kMaxEdges * 3 + kBlockCycles : kBlockCycles;
+
+		for (UINT cycle = 0; ; )
+		{
+			seed = seed * 1103515245 + 12345;
+			cycle += bFull ? 3 : 4 + ((seed >> 16) % 60);
+			if (cycle >= blockCycles)
+				break;
+
+			SpkrToggle(0, 0xC030, 0, 0, cycle);
+			edges.push_back({ g_nCumulativeCycles, g_nSpeakerData, false });
+
+			if (!bFull && (seed & 0x300) == 0)
+			{
+				// eg. SAM's 8-bit DAC
+				SpkrSetLevel((short)(seed & 0xFF00));
+				edges.push_back({ g_nCumulativeCycles, g_nSpeakerData, true });
+			}
+		}
+
+		g_nCyclesBase += blockCycles;
+		g_nCumulativeCycles = g_nCyclesBase;
+		SpkrUpdate(blockCycles);
+	}
+
+	// Drain the speaker buffer (shorter than the DC filter's 10000 samples of full gain)
+	for (UINT block = 0; block < 50; block++)
+	{
+		g_nCyclesBase += kBlockCycles;
+		g_nCumulativeCycles = g_nCyclesBase;
+		SpkrUpdate(kBlockCycles);
+	}
+
+	SpkrDestroy();
+
+	BLEPSynth synth;
+	synth.Initialize(g_fClksPerSpkrSample);
+	synth.Reset(startCycle, startLevel);
+	for (size_t i = 0; i < edges.size(); i++)
+	{
+		if (edges[i].setLevel)
+			synth.SetLevel(edges[i].cycle, edges[i].level);
+		else
+			synth.AddEdge(edges[i].cycle, edges[i].level);
+	}
+	std::vector<short> expected((size_t)((g_nCumulativeCycles - startCycle) / g_fClksPerSpkrSample) + 1);
+	expected.resize(synth.Render(g_nCumulativeCycles, &expected[0], (UINT)expected.size()));
+
+	const std::vector<short>& actual = g_pCaptureBuffer->m_left;
+	printf("Speaker: %u edges, %u samples submitted (%u expected)\n", (UINT)edges.size(), (UINT)actual.size(), (UINT)expected.size());
+
+	if (g_pCaptureBuffer->m_channelsDiffer) return 1;
+	if (actual.size() != expected.size()) return 1;
+	for (size_t i = 0; i < actual.size(); i++)
+	{
+		if (actual[i] != expected[i])
+		{
+			printf("Speaker: sample %u = %d, expected %d\n", (UINT)i, actual[i], expected[i]);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+// How many toggles/sec can be recorded & rendered
+int Benchmark(void)
+{
+	BLEPSynth synth;
+	synth.Initialize(kClksPerSample);
+	synth.Reset(0, kLevelLo);
+
+	std::vector<short> out(kBlockCycles);
+	const UINT kHalfPeriod = 4;	// STA $C030 every 4 cycles: fastest possible toggle rate
+	const UINT kBlocks = 20000;
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	UINT64 cycle = 0;
+	short level = kLevelLo;
+	UINT64 numToggles = 0;
+	for (UINT block = 0; block < kBlocks; block++)
+	{
+		const UINT64 blockEnd = cycle + kBlockCycles;
+		for (; cycle < blockEnd; cycle += kHalfPeriod, numToggles++)
+		{
+			level = ~level;
+			synth.AddEdge(cycle, level);
+		}
+		synth.Render(blockEnd, &out[0], (UINT)out.size());
+	}
+
+	const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	printf("Benchmark: %.1f M toggles/sec (%.0fx real-time at a toggle every %u cycles)\n",
+		numToggles / secs / 1e6, (kBlocks / 1000.0) / secs, kHalfPeriod);
+
+	return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+	int res = 1;
+
+	res = TestSteadyLevel();
+	if (res) return res;
+
+	res = TestAliasing();
+	if (res) return res;
+
+	res = TestSpeakerUpdate();
+	if (res) return res;
+
+	res = Benchmark();
+	if (res) return res;
+
+	return 0;
+}
@@ -0,0 +1,258 @@
+#include "stdafx.h"
+
+#include "../../source/Debugger/Debug.h"
+#include "../../source/Core.h"
+
+#include <chrono>
+
+// From Core.cpp
+std::string g_sProgramDir;
+std::string g_sBuiltinSymbolsDir;
+
+// From Debug.cpp
+int g_iCommand;
+Command_t g_aParameters[NUM_PARAMS];
+
+Update_t DebuggerProcessCommand(const bool bEchoConsoleInput)
+{
+	return 0;
+}
+
+// From Debugger_Console.cpp
+ConsoleOutputLevel_e g_eConsoleOutputLevel = ConsoleOutputLevel_e::CONSOLE_OUTPUT_LEVEL_ERROR;
+int g_nConsoleInputChars = 0;
+char* g_pConsoleInput = 0;
+
+void ConsolePrint(const char* pText)
+{
+}
+
+void ConsoleBufferPush(const char* pText)
+{
+}
+
+Update_t ConsoleDisplayError(const char* pTextError)
+{
+	return 0;
+}
+
+Update_t ConsoleUpdate()
+{
+	return 0;
+}
+
+// From Debugger_Disassembler.cpp
+std::string FormatAddress(WORD nAddress, int nBytes)
+{
+	return std::string();
+}
+
+// From Debugger_Help.cpp
+int FindParam(LPCTSTR pLookupName, Match_e eMatch, int& iParam_, const int iParamBegin, const int iParamEnd, const bool bCaseSensitive)
+{
+	return 0;
+}
+
+// From Debugger_Parser.cpp
+Arg_t g_aArgRaw[MAX_ARGS];
+Arg_t g_aArgs[MAX_ARGS];
+
+Update_t Help_Arg_1(int iCommandHelp)
+{
+	return 0;
+}
+
+int _Arg_Shift(int iSrc, int iEnd, int iDst)
+{
+	return 0;
+}
+
+// From Debugger_Symbols.cpp
+extern int g_bDisplaySymbolTables;
+
+//-----------------------------------------------------------------------------
+
+const char* kSymbolFile = "testsymbols.sym";
+const UINT kNumSymbols = 50000;
+
+// Distinct addresses (40503 is odd, so i -> i*40503 is a bijection mod 64K)
+static WORD SymbolAddress(UINT i)
+{
+	return (WORD)(i * 40503 + 0x1234);
+}
+
+static std::string SymbolName(UINT i)
+{
+	char name[16];
+	sprintf(name, "Sym_%05u", i);
+	return name;
+}
+
+// The lookup that the indexes replaced: walk each enabled table, user tables first
+static bool FindAddressFromSymbolByWalk(const char* pSymbol, WORD* pAddress_, int* iTable_)
+{
+	for (int iTable = NUM_SYMBOL_TABLES; iTable-- > 0; )
+	{
+		if (!(g_bDisplaySymbolTables & (1 << iTable)))
+			continue;
+
+		for (SymbolTable_t::const_iterator iSymbol = g_aSymbols[iTable].begin(); iSymbol != g_aSymbols[iTable].end(); ++iSymbol)
+		{
+			if (!_stricmp(iSymbol->second.c_str(), pSymbol))
+			{
+				*pAddress_ = iSymbol->first;
+				*iTable_ = iTable;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+
+// Load a large user symbol file (both file formats), then look every symbol up by name & by address
+int TestLoad(void)
+{
+	FILE* fp = fopen(kSymbolFile, "wt");
+	if (!fp) return 1;
+	for (UINT i = 0; i < kNumSymbols; i++)
+	{
+		if (i & 1)
+			fprintf(fp, "%s =$%04X ; ACME\n", SymbolName(i).c_str(), SymbolAddress(i));
+		else
+			fprintf(fp, "%04X %s\n", SymbolAddress(i), SymbolName(i).c_str());
+	}
+	fclose(fp);
+
+	const std::chrono::steady_clock::time_point loadStart = std::chrono::steady_clock::now();
+	const int nLoaded = ParseSymbolTable(kSymbolFile, SYMBOLS_USER_1);
+	const double loadSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStart).count();
+	remove(kSymbolFile);
+
+	if (nLoaded != (int)kNumSymbols) return 1;
+	if (g_aSymbols[SYMBOLS_USER_1].size() != kNumSymbols) return 1;
+
+	// Name -> Address: case-insensitive
+	const std::chrono::steady_clock::time_point nameStart = std::chrono::steady_clock::now();
+	for (UINT i = 0; i < kNumSymbols; i++)
+	{
+		std::string name = SymbolName(i);
+		name[0] = 's';
+		WORD nAddress = 0;
+		int iTable = -1;
+		if (!FindAddressFromSymbol(name.c_str(), &nAddress, &iTable)) return 1;
+		if (nAddress != SymbolAddress(i) || iTable != SYMBOLS_USER_1) return 1;
+	}
+	const double nameSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - nameStart).count();
+
+	// Address -> Name
+	const std::chrono::steady_clock::time_point addrStart = std::chrono::steady_clock::now();
+	for (UINT i = 0; i < kNumSymbols; i++)
+	{
+		int iTable = -1;
+		std::string const* pSymbol = FindSymbolFromAddress(SymbolAddress(i), &iTable);
+		if (!pSymbol || *pSymbol != SymbolName(i) || iTable != SYMBOLS_USER_1) return 1;
+	}
+	const double addrSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - addrStart).count();
+
+	if (FindAddressFromSymbol("Sym_99999")) return 1;
+
+	// The walk is ~50K compares per lookup, so only time a sample of it
+	const UINT kWalkLookups = 200;
+	const std::chrono::steady_clock::time_point walkStart = std::chrono::steady_clock::now();
+	for (UINT i = 0; i < kWalkLookups; i++)
+	{
+		const UINT n = i * (kNumSymbols / kWalkLookups);
+		WORD nAddress = 0;
+		int iTable = -1;
+		if (!FindAddressFromSymbolByWalk(SymbolName(n).c_str(), &nAddress, &iTable)) return 1;
+		if (nAddress != SymbolAddress(n) || iTable != SYMBOLS_USER_1) return 1;
+	}
+	const double walkSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - walkStart).count();
+
+	printf("Load %u symbols: %.3f s\n", kNumSymbols, loadSecs);
+	printf("Name -> Address: %.2f us per lookup (by walking the tables: %.1f us)\n", nameSecs * 1e6 / kNumSymbols, walkSecs * 1e6 / kWalkLookups);
+	printf("Address -> Name: %.2f us per lookup\n", addrSecs * 1e6 / kNumSymbols);
+
+	return 0;
+}
+
+// The indexes must give the same answers as walking the tables, as symbols are added, renamed, removed & cleared
+int TestIndexes(void)
+{
+	const WORD kShared = SymbolAddress(7);	// has Sym_00007 in User1
+
+	// Same name in 2 tables: User1 is searched before Main, unless it's disabled
+	SymbolTableAdd(SYMBOLS_MAIN, 0x0300, "SYM_00007");
+	// Same address in 2 tables: the highest enabled table's symbol
+	SymbolTableAdd(SYMBOLS_MAIN, kShared, "MAINSYM");
+
+	WORD nAddress = 0;
+	int iTable = -1;
+	if (!FindAddressFromSymbol("sym_00007", &nAddress, &iTable) || nAddress != kShared || iTable != SYMBOLS_USER_1) return 1;
+	std::string const* pSymbol = FindSymbolFromAddress(kShared, &iTable);
+	if (!pSymbol || *pSymbol != "Sym_00007" || iTable != SYMBOLS_USER_1) return 1;
+
+	const int bTables = g_bDisplaySymbolTables;
+	g_bDisplaySymbolTables &= ~SYMBOL_TABLE_USER_1;
+	if (!FindAddressFromSymbol("sym_00007", &nAddress, &iTable) || nAddress != 0x0300 || iTable != SYMBOLS_MAIN) return 1;
+	pSymbol = FindSymbolFromAddress(kShared, &iTable);
+	if (!pSymbol || *pSymbol != "MAINSYM" || iTable != SYMBOLS_MAIN) return 1;
+	g_bDisplaySymbolTables = bTables;
+
+	// Same name twice in a table: the lowest address, as when walking the (address ordered) table
+	SymbolTableAdd(SYMBOLS_USER_2, 0x2000, "TWICE");
+	SymbolTableAdd(SYMBOLS_USER_2, 0x1000, "Twice");
+	if (!FindAddressFromSymbol("twice", &nAddress, &iTable) || nAddress != 0x1000 || iTable != SYMBOLS_USER_2) return 1;
+
+	// Renaming the symbol at an address drops the old name
+	SymbolTableAdd(SYMBOLS_USER_2, 0x1000, "ONCE");
+	if (!FindAddressFromSymbol("twice", &nAddress, &iTable) || nAddress != 0x2000) return 1;
+	if (!FindAddressFromSymbol("once", &nAddress, &iTable) || nAddress != 0x1000) return 1;
+
+	SymbolTableRemove(SYMBOLS_USER_2, 0x2000);
+	if (FindAddressFromSymbol("twice")) return 1;
+	pSymbol = FindSymbolFromAddress(0x2000, &iTable);	// User1 may have one there too
+	if (pSymbol && iTable == SYMBOLS_USER_2) return 1;
+
+	// Clearing a table drops it from both indexes
+	_CmdSymbolsClear(SYMBOLS_USER_1);
+	if (FindAddressFromSymbol("sym_00008")) return 1;
+	if (FindSymbolFromAddress(SymbolAddress(8))) return 1;
+	if (!FindAddressFromSymbol("sym_00007", &nAddress, &iTable) || nAddress != 0x0300 || iTable != SYMBOLS_MAIN) return 1;
+	pSymbol = FindSymbolFromAddress(kShared, &iTable);
+	if (!pSymbol || *pSymbol != "MAINSYM" || iTable != SYMBOLS_MAIN) return 1;
+
+	// And every remaining name agrees with a walk
+	for (int iTableCheck = 0; iTableCheck < NUM_SYMBOL_TABLES; iTableCheck++)
+	{
+		for (SymbolTable_t::const_iterator it = g_aSymbols[iTableCheck].begin(); it != g_aSymbols[iTableCheck].end(); ++it)
+		{
+			WORD nAddressWalk = 0;
+			int iTableWalk = -1;
+			const bool bWalk = FindAddressFromSymbolByWalk(it->second.c_str(), &nAddressWalk, &iTableWalk);
+			if (!bWalk || !FindAddressFromSymbol(it->second.c_str(), &nAddress, &iTable)) return 1;
+			if (nAddress != nAddressWalk || iTable != iTableWalk) return 1;
+		}
+	}
+
+	return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+	int res = 1;
+
+	g_bSymbolsDisplayMissingFile = false;
+
+	res = TestLoad();
+	if (res) return res;
+
+	res = TestIndexes();
+	if (res) return res;
+
+	return 0;
+}
@@ -0,0 +1,502 @@
+#include "stdafx.h"
+
+#include "../../source/VideoCapture.h"
+#include "zlib.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+// Stubs for VideoCapture.cpp's dependencies
+void LogFileOutput(const char* format, ...) {}
+
+static const UINT kWidth = 560;
+static const UINT kHeight = 384;
+static const double kFps = 59.92;
+
+//-----------------------------------------------------------------------------
+
+static uint32_t Pattern(UINT frame, UINT x, UINT y)
+{
+	return 0xFF000000 | ((x * 3 + frame) & 0xFF) << 16 | ((y * 5 + frame * 7) & 0xFF) << 8 | ((x ^ y ^ frame) & 0xFF);
+}
+
+// Frame buffer as the emulator's: 2 borders around the frame, & bottom-up (pitch < 0) or top-down
+struct TestFrameBuffer
+{
+	TestFrameBuffer(bool topDown) : pixels((kWidth + 2 * kBorder) * (kHeight + 2 * kBorder)), topDown(topDown) {}
+
+	static const UINT kBorder = 8;
+	std::vector<uint32_t> pixels;
+	bool topDown;
+
+	int Pitch(void) { return topDown ? (int)(kWidth + 2 * kBorder) : -(int)(kWidth + 2 * kBorder); }
+
+	uint32_t* TopLeft(void)
+	{
+		const UINT row = topDown ? kBorder : kHeight + kBorder - 1;
+		return &pixels[row * (kWidth + 2 * kBorder) + kBorder];
+	}
+
+	void Draw(UINT frame)
+	{
+		for (UINT y = 0; y < kHeight; y++)
+			for (UINT x = 0; x < kWidth; x++)
+				TopLeft()[(int)y * Pitch() + (int)x] = Pattern(frame, x, y);
+	}
+};
+
+static bool ReadFile(const std::string& filename, std::vector<BYTE>& file)
+{
+	file.clear();
+	FILE* fp = fopen(filename.c_str(), "rb");
+	if (!fp)
+		return false;
+
+	BYTE buf[0x10000];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), fp)) != 0)
+		file.insert(file.end(), buf, buf + n);
+	fclose(fp);
+	remove(filename.c_str());
+	return true;
+}
+
+static UINT Read32BE(const BYTE* p) { return ((UINT)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3]; }
+static UINT Read32LE(const BYTE* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((UINT)p[3] << 24); }
+
+// Y4M (BT.601) of the pattern's pixel
+static void PatternYCbCr(UINT frame, UINT x, UINT y, BYTE& Y, BYTE& Cb, BYTE& Cr)
+{
+	const uint32_t pixel = Pattern(frame, x, y);
+	const int r = (pixel >> 16) & 0xFF, g = (pixel >> 8) & 0xFF, b = pixel & 0xFF;
+	Y  = (BYTE)(((  66 * r + 129 * g +  25 * b + 128) >> 8) +  16);
+	Cb = (BYTE)((( -38 * r -  74 * g + 112 * b + 128) >> 8) + 128);
+	Cr = (BYTE)((( 112 * r -  94 * g -  18 * b + 128) >> 8) + 128);
+}
+
+static bool IsStreamFrame(const BYTE* p, VIDEO_CAPTURE_FORMAT format, UINT frame)
+{
+	for (UINT y = 0; y < kHeight; y++)
+	{
+		for (UINT x = 0; x < kWidth; x++)
+		{
+			const size_t i = y * kWidth + x;
+			if (format == VIDEO_CAPTURE_RAW)
+			{
+				if (Read32LE(p + i * 4) != Pattern(frame, x, y))
+					return false;
+				continue;
+			}
+
+			BYTE Y, Cb, Cr;
+			PatternYCbCr(frame, x, y, Y, Cb, Cr);
+			if (p[i] != Y || p[kWidth * kHeight + i] != Cb || p[2 * kWidth * kHeight + i] != Cr)
+				return false;
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+
+// Every frame put is in the stream: either itself, or (if it was dropped) the previous frame again
+static int TestStream(VIDEO_CAPTURE_FORMAT format, bool topDown)
+{
+	const UINT kFrames = 40;
+	const char* pszFile = "testvideocapture.stream";
+
+	if (!VideoCaptureInit(pszFile, format)) return 1;
+	if (!VideoCaptureIsWriting()) return 1;
+
+	TestFrameBuffer frameBuffer(topDown);
+	for (UINT frame = 0; frame < kFrames; frame++)
+	{
+		frameBuffer.Draw(frame);
+		if (!VideoCapturePutFrame(frameBuffer.TopLeft(), kWidth, kHeight, frameBuffer.Pitch(), kFps)) return 1;
+	}
+
+	const UINT dropped = VideoCaptureGetDroppedFrames();
+	if (!VideoCaptureFinish()) return 1;
+	if (VideoCaptureIsWriting()) return 1;
+
+	std::vector<BYTE> file;
+	if (!ReadFile(pszFile, file)) return 1;
+
+	size_t pos = 0;
+	size_t frameSize = kWidth * kHeight * 4;
+	if (format == VIDEO_CAPTURE_Y4M)
+	{
+		const char kHeader[] = "YUV4MPEG2 W560 H384 F59920:1000 Ip A1:1 C444\n";
+		if (file.size() < sizeof(kHeader) - 1 || memcmp(&file[0], kHeader, sizeof(kHeader) - 1)) return 1;
+		pos = sizeof(kHeader) - 1;
+		frameSize = 6 + kWidth * kHeight * 3;
+	}
+
+	if (file.size() != pos + kFrames * frameSize)
+	{
+		printf("Stream: %u bytes, expected %u frames\n", (UINT)file.size(), kFrames);
+		return 1;
+	}
+
+	UINT repeated = 0;
+	UINT previous = 0;
+	for (UINT frame = 0; frame < kFrames; frame++, pos += frameSize)
+	{
+		const BYTE* p = &file[pos];
+		if (format == VIDEO_CAPTURE_Y4M)
+		{
+			if (memcmp(p, "FRAME\n", 6)) return 1;
+			p += 6;
+		}
+
+		if (IsStreamFrame(p, format, frame))
+		{
+			previous = frame;
+		}
+		else if (frame && IsStreamFrame(p, format, previous))
+		{
+			repeated++;
+		}
+		else
+		{
+			printf("Stream: frame %u is wrong\n", frame);
+			return 1;
+		}
+	}
+
+	if (repeated != dropped)
+	{
+		printf("Stream: %u frames repeated, but %u dropped\n", repeated, dropped);
+		return 1;
+	}
+
+	return 0;
+}
+
+// A host that presents at hostHz (not the emulated ~60Hz): the stream still has 1 frame per emulated frame
+// . at 144Hz, ~2 in 5 presents are new emulated frames; at 50Hz, a present can be 2 emulated frames (so 1 is repeated)
+static int TestHostRate(double hostHz)
+{
+	const UINT kPresents = 60;
+	const UINT kCyclesPerFrame = 17030;
+	const char* pszFile = "testvideocapture.stream";
+
+	if (!VideoCaptureInit(pszFile, VIDEO_CAPTURE_Y4M)) return 1;
+
+	TestFrameBuffer frameBuffer(false);
+	std::vector<UINT> expected;	// Each stream frame's present
+	UINT64 cycles = 12345;
+	UINT64 firstCycles = 0;
+	for (UINT present = 0; present < kPresents; present++)
+	{
+		// A host frame's worth of emulated cycles, give or take an opcode's
+		cycles += (UINT64)(kFps * kCyclesPerFrame / hostHz) + present % 4;
+		const UINT frames = VideoCaptureNewFrames(cycles, kCyclesPerFrame);
+		if (!present)
+		{
+			firstCycles = cycles;
+			if (frames != 1) return 1;
+		}
+		if (!frames)
+			continue;
+
+		frameBuffer.Draw(present);
+		if (!VideoCapturePutFrame(frameBuffer.TopLeft(), kWidth, kHeight, frameBuffer.Pitch(), kFps, frames)) return 1;
+
+		for (UINT i = 1; i < frames; i++)
+			expected.push_back(expected.back());
+		expected.push_back(present);
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));	// Let the writer keep up
+	}
+
+	const UINT dropped = VideoCaptureGetDroppedFrames();
+	if (!VideoCaptureFinish()) return 1;
+
+	// The 1st present starts half a frame in
+	const UINT emulatedFrames = 1 + (UINT)((kCyclesPerFrame / 2 + cycles - firstCycles) / kCyclesPerFrame);
+	if (expected.size() != emulatedFrames)
+	{
+		printf("Host @ %.2fHz: %u frames put, for %u emulated frames\n", hostHz, (UINT)expected.size(), emulatedFrames);
+		return 1;
+	}
+
+	std::vector<BYTE> file;
+	if (!ReadFile(pszFile, file)) return 1;
+
+	const char kHeader[] = "YUV4MPEG2 W560 H384 F59920:1000 Ip A1:1 C444\n";
+	const size_t frameSize = 6 + kWidth * kHeight * 3;
+	size_t pos = sizeof(kHeader) - 1;
+	if (file.size() < pos || memcmp(&file[0], kHeader, pos)) return 1;
+	if (file.size() != pos + emulatedFrames * frameSize)
+	{
+		printf("Host @ %.2fHz: %u bytes, expected %u frames\n", hostHz, (UINT)file.size(), emulatedFrames);
+		return 1;
+	}
+
+	// Only a dropped frame can make it differ: then it's the previous stream frame again
+	for (UINT frame = 0; frame < emulatedFrames; frame++, pos += frameSize)
+	{
+		const BYTE* p = &file[pos + 6];
+		if (IsStreamFrame(p, VIDEO_CAPTURE_Y4M, expected[frame]))
+			continue;
+
+		if (!dropped || !frame || memcmp(p, p - frameSize, frameSize - 6))
+		{
+			printf("Host @ %.2fHz: frame %u is wrong\n", hostHz, frame);
+			return 1;
+		}
+	}
+
+	if (hostHz == kFps && emulatedFrames != kPresents)	// AppleWin: each present is an emulated frame
+		return 1;
+
+	return 0;
+}
+
+// Decode a .png written by VideoCapture (RGB, 1 IDAT) & check it's the frame
+static int CheckPng(const std::string& filename, UINT frame)
+{
+	std::vector<BYTE> file;
+	if (!ReadFile(filename, file)) return 1;
+
+	static const BYTE kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	if (file.size() < 8 || memcmp(&file[0], kSignature, 8)) return 1;
+
+	std::vector<BYTE> idat;
+	size_t pos = 8;
+	while (pos + 12 <= file.size())
+	{
+		const UINT size = Read32BE(&file[pos]);
+		const BYTE* pType = &file[pos + 4];
+		if (pos + 12 + size > file.size()) return 1;
+		if (crc32(crc32(0, pType, 4), pType + 4, size) != Read32BE(pType + 4 + size)) return 1;
+
+		if (!memcmp(pType, "IHDR", 4))
+		{
+			const BYTE* p = pType + 4;
+			if (Read32BE(p) != kWidth || Read32BE(p + 4) != kHeight || p[8] != 8 || p[9] != 2) return 1;
+		}
+		else if (!memcmp(pType, "IDAT", 4))
+		{
+			idat.insert(idat.end(), pType + 4, pType + 4 + size);
+		}
+		else if (!memcmp(pType, "IEND", 4))
+		{
+			break;
+		}
+		pos += 12 + size;
+	}
+
+	const size_t rowSize = 1 + kWidth * 3;
+	std::vector<BYTE> rows(rowSize * kHeight);
+	uLongf size = (uLongf)rows.size();
+	if (idat.empty() || uncompress(&rows[0], &size, &idat[0], (uLong)idat.size()) != Z_OK || size != rows.size()) return 1;
+
+	for (UINT y = 0; y < kHeight; y++)
+	{
+		BYTE* pRow = &rows[y * rowSize];
+		if (pRow[0] == 2)	// Up
+		{
+			for (size_t i = 1; i < rowSize; i++)
+				pRow[i] += pRow[i - rowSize];
+		}
+		else if (pRow[0] != 0)
+		{
+			return 1;
+		}
+
+		for (UINT x = 0; x < kWidth; x++)
+		{
+			const uint32_t pixel = Pattern(frame, x, y);
+			const BYTE* p = pRow + 1 + x * 3;
+			if (p[0] != (BYTE)(pixel >> 16) || p[1] != (BYTE)(pixel >> 8) || p[2] != (BYTE)pixel)
+			{
+				printf("%s: pixel %u,%u is wrong\n", filename.c_str(), x, y);
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+// Each frame put is a .png, unless it was dropped
+static int TestPng(void)
+{
+	const UINT kFrames = 10;
+
+	if (!VideoCaptureInit("testvideocapture", VIDEO_CAPTURE_PNG)) return 1;
+
+	TestFrameBuffer frameBuffer(false);
+	for (UINT frame = 0; frame < kFrames; frame++)
+	{
+		frameBuffer.Draw(frame);
+		VideoCapturePutFrame(frameBuffer.TopLeft(), kWidth, kHeight, frameBuffer.Pitch(), kFps);
+	}
+
+	if (!VideoCaptureFinish()) return 1;
+
+	UINT missing = 0;
+	for (UINT frame = 0; frame < kFrames; frame++)
+	{
+		char filename[64];
+		sprintf(filename, "testvideocapture-%06u.png", frame);
+
+		FILE* fp = fopen(filename, "rb");
+		if (!fp)
+		{
+			missing++;
+			continue;
+		}
+		fclose(fp);
+
+		if (CheckPng(filename, frame))
+		{
+			printf("%s is wrong\n", filename);
+			return 1;
+		}
+	}
+
+	return missing == VideoCaptureGetDroppedFrames() ? 0 : 1;
+}
+
+// A 32-bit .bmp, bottom-up: also written (& waited for) without a capture
+static int TestScreenShot(void)
+{
+	const char* pszFile = "testvideocapture.bmp";
+
+	TestFrameBuffer frameBuffer(true);
+	frameBuffer.Draw(1);
+	if (!VideoCaptureScreenShot(pszFile, frameBuffer.TopLeft(), kWidth, kHeight, frameBuffer.Pitch())) return 1;
+	frameBuffer.Draw(2);	// The screenshot is a copy
+
+	if (VideoCaptureFinish()) return 1;	// Not capturing
+
+	std::vector<BYTE> file;
+	if (!ReadFile(pszFile, file)) return 1;
+
+	const UINT kHeaderSize = 54;
+	if (file.size() != kHeaderSize + kWidth * kHeight * 4) return 1;
+	if (file[0] != 'B' || file[1] != 'M' || Read32LE(&file[2]) != file.size() || Read32LE(&file[10]) != kHeaderSize) return 1;
+	if (Read32LE(&file[14]) != 40 || Read32LE(&file[18]) != kWidth || Read32LE(&file[22]) != kHeight) return 1;
+	if (file[26] != 1 || file[28] != 32 || Read32LE(&file[30]) != 0) return 1;
+
+	for (UINT y = 0; y < kHeight; y++)
+		for (UINT x = 0; x < kWidth; x++)
+			if (Read32LE(&file[kHeaderSize + ((kHeight - 1 - y) * kWidth + x) * 4]) != Pattern(1, x, y)) return 1;
+
+	return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+// Cost to the emulation thread of capturing each frame, at 60 frames per (real) second
+// . previously: a screenshot-style synchronous write of each frame (the .bmp's pixels)
+// . only with --benchmark, as it takes seconds & writes hundreds of frames: for an emulated run, see the
+//   linux VideoBenchmark() with --video-capture
+int Benchmark(void)
+{
+	const UINT kFrames = 120;
+	const std::chrono::microseconds kFramePeriod(16667);
+	TestFrameBuffer frameBuffer(false);
+	frameBuffer.Draw(0);
+
+	double syncSecs = 0.0;
+	for (UINT frame = 0; frame < kFrames; frame++)
+	{
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		FILE* fp = fopen("testvideocapture.bmp", "wb");
+		if (!fp) return 1;
+		const uint32_t* pRow = frameBuffer.TopLeft() + (int)(kHeight - 1) * frameBuffer.Pitch();
+		for (UINT y = 0; y < kHeight; y++, pRow -= frameBuffer.Pitch())
+			fwrite(pRow, sizeof(uint32_t), kWidth, fp);
+		fclose(fp);
+		syncSecs += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+	remove("testvideocapture.bmp");
+
+	const VIDEO_CAPTURE_FORMAT kFormats[] = { VIDEO_CAPTURE_PNG, VIDEO_CAPTURE_Y4M, VIDEO_CAPTURE_RAW };
+	const char* kNames[] = { "png", "y4m", "raw" };
+	for (UINT i = 0; i < 3; i++)
+	{
+		const char* pszPath = kFormats[i] == VIDEO_CAPTURE_PNG ? "testvideocapture" : "testvideocapture.stream";
+		if (!VideoCaptureInit(pszPath, kFormats[i])) return 1;
+
+		double asyncSecs = 0.0;
+		std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+		for (UINT frame = 0; frame < kFrames; frame++)
+		{
+			frameBuffer.Draw(frame);
+
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			VideoCapturePutFrame(frameBuffer.TopLeft(), kWidth, kHeight, frameBuffer.Pitch(), kFps);
+			asyncSecs += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			next += kFramePeriod;
+			std::this_thread::sleep_until(next);
+		}
+
+		const UINT dropped = VideoCaptureGetDroppedFrames();
+		VideoCaptureFinish();
+
+		if (kFormats[i] == VIDEO_CAPTURE_PNG)
+		{
+			for (UINT frame = 0; frame < kFrames; frame++)
+			{
+				char filename[64];
+				sprintf(filename, "testvideocapture-%06u.png", frame);
+				remove(filename);
+			}
+		}
+		else
+		{
+			remove(pszPath);
+		}
+
+		printf("Benchmark: capture %s @ 60Hz: %.1f us per frame, %u of %u frames dropped (synchronous .bmp write: %.1f us)\n",
+			kNames[i], asyncSecs * 1e6 / kFrames, dropped, kFrames, syncSecs * 1e6 / kFrames);
+	}
+
+	return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+	int res = 1;
+
+	VIDEO_CAPTURE_FORMAT format;
+	if (!VideoCaptureParseFormat("y4m", format) || format != VIDEO_CAPTURE_Y4M) return 1;
+	if (VideoCaptureParseFormat("avi", format)) return 1;
+
+	res = TestStream(VIDEO_CAPTURE_Y4M, false);
+	if (res) return res;
+
+	res = TestStream(VIDEO_CAPTURE_RAW, true);
+	if (res) return res;
+
+	const double kHostHz[] = { 144.0, 50.0, kFps };
+	for (UINT i = 0; i < 3; i++)
+	{
+		res = TestHostRate(kHostHz[i]);
+		if (res) return res;
+	}
+
+	res = TestPng();
+	if (res) return res;
+
+	res = TestScreenShot();
+	if (res) return res;
+
+	if (argc > 1 && strcmp(argv[1], "--benchmark") == 0)
+	{
+		res = Benchmark();
+		if (res) return res;
+	}
+
+	return 0;
+}
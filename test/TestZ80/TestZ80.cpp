@@ -0,0 +1,510 @@
+#include "stdafx.h"
+
+#include "../../source/Core.h"
+#include "../../source/Card.h"
+#include "../../source/CPU.h"
+#include "../../source/Memory.h"
+#include "../../source/Z80VICE/z80.h"
+#include "../../source/Z80VICE/z80mem.h"
+#include "../../source/Z80VICE/z80regs.h"
+
+#include "../../source/CPU/cpu_general.inl"
+
+#include <chrono>
+
+// Stubs for z80.cpp's dependencies
+enum AppMode_e g_nAppMode = MODE_RUNNING;
+regsrec regs;
+
+LPBYTE         memwrite[0x100];
+LPBYTE         mem          = NULL;
+LPBYTE         memdirty     = NULL;
+LPBYTE         memVidHD     = NULL;
+iofunction		IORead[256] = {0};
+iofunction		IOWrite[256] = {0};
+
+eCpuType GetActiveCpu() { return CPU_Z80; }
+void SetActiveCpu(eCpuType cpu) {}
+void LogOutput(const char* format, ...) {}
+void LogFileOutput(const char* format, ...) {}
+void Card::ThrowErrorInvalidSlot(SS_CARDTYPE type, UINT slot) {}
+void Card::ThrowErrorInvalidVersion(SS_CARDTYPE type, UINT version) {}
+
+// As CPU.cpp (when running, but also used here when stepping), without the execution history
+#define HISTORY_W(addr, pMem)
+
+BYTE CpuRead(USHORT addr, ULONG uExecutedCycles)
+{
+	return _READ_WITH_IO_F8xx(addr);
+}
+
+void CpuWrite(USHORT addr, BYTE value, ULONG uExecutedCycles)
+{
+	_WRITE_WITH_IO_F8xx(value);
+}
+
+extern z80_regs_t z80_regs;
+
+//-----------------------------------------------------------------------------
+
+// The SoftCard's address translation (Z80 4K block -> 6502 4K block)
+static WORD Z80To6502(WORD addr)
+{
+	static const BYTE kMap[16] = { 0x1,0x2,0x3,0x4,0x5,0x6,0x7,0x8,0x9,0xA,0xB, 0xD,0xE,0xF, 0xC, 0x0 };
+	return (kMap[addr >> 12] << 12) | (addr & 0x0FFF);
+}
+
+static UINT Fnv(UINT hash, UINT value)
+{
+	for (UINT i = 0; i < 4; i++, value >>= 8)
+		hash = (hash ^ (value & 0xFF)) * 16777619u;
+	return hash;
+}
+
+static UINT g_seed;
+
+static UINT Rand(void)
+{
+	g_seed = g_seed * 1103515245 + 12345;
+	return g_seed >> 8;
+}
+
+// I/O: $C0xx (Z80 $E0xx) is hashed, and $C0F0/$C0F1 are the CP/M harness's console & warm boot
+static const WORD kConsoleOut = 0xC0F0;
+static const WORD kWarmBoot = 0xC0F1;
+
+static UINT g_ioHash;
+static std::string g_console;
+static bool g_warmBoot;
+
+static BYTE __stdcall TestIORead(WORD pc, WORD addr, BYTE bWrite, BYTE value, ULONG nExecutedCycles)
+{
+	g_ioHash = Fnv(g_ioHash, addr);
+	return (BYTE)(addr ^ (addr >> 8) ^ 0x5A);
+}
+
+static BYTE __stdcall TestIOWrite(WORD pc, WORD addr, BYTE bWrite, BYTE value, ULONG nExecutedCycles)
+{
+	g_ioHash = Fnv(g_ioHash, (addr << 8) | value);
+	if (addr == kConsoleOut)
+		g_console += (char)value;
+	else if (addr == kWarmBoot)
+		g_warmBoot = true;
+	return 0;
+}
+
+// $F800-FFFF (Z80 $D800-DFFF) behaves as RAM here
+BYTE __stdcall IO_F8xx(WORD programcounter, WORD address, BYTE write, BYTE value, ULONG nCycles)
+{
+	if (write)
+		mem[address] = value;
+	return mem[address];
+}
+
+static void InitMemory(void)
+{
+	static BYTE memory[_6502_MEM_LEN];
+	static BYTE dirty[_6502_NUM_PAGES];
+	mem = memory;
+	memdirty = dirty;
+
+	for (UINT page = 0; page < _6502_NUM_PAGES; page++)
+		memwrite[page] = (page >= 0xC0 && page < 0xD0) ? NULL : mem + (page << 8);
+
+	for (UINT i = 0; i < 256; i++)
+	{
+		IORead[i] = TestIORead;
+		IOWrite[i] = TestIOWrite;
+	}
+
+	z80mem_initialize();
+}
+
+//-----------------------------------------------------------------------------
+
+// Instruction exerciser: each opcode (of each prefix) is run from pseudo-random machine states
+// . the resulting registers, memory & I/O are hashed
+// . golden hashes were recorded with the original (switch-decoded, per-byte translated) Z80 core
+struct OpcodeTable
+{
+	const char* name;
+	BYTE prefix[2];
+	UINT prefixLen;
+	bool displacement;	// DDCB/FDCB: the displacement precedes the opcode
+	UINT hash;
+};
+
+static UINT RunInstruction(const BYTE* pInstruction, UINT len, const std::vector<BYTE>& pristine)
+{
+	z80_regs.reg_af = Rand();
+	z80_regs.reg_bc = Rand();
+	z80_regs.reg_de = Rand();
+	z80_regs.reg_hl = Rand();
+	z80_regs.reg_ix = 0x80 + Rand() % 0xFF00;	// (IX+d) & (IY+d) don't wrap (which the original core didn't handle)
+	z80_regs.reg_iy = 0x80 + Rand() % 0xFF00;
+	z80_regs.reg_sp = Rand();
+	z80_regs.reg_pc = 0x0100 + Rand() % 0xAE00;
+	z80_regs.reg_i = Rand();
+	z80_regs.reg_r = Rand();
+	z80_regs.reg_af2 = Rand();
+	z80_regs.reg_bc2 = Rand();
+	z80_regs.reg_de2 = Rand();
+	z80_regs.reg_hl2 = Rand();
+
+	for (UINT i = 0; i < len; i++)
+		mem[Z80To6502(z80_regs.reg_pc + i)] = pInstruction[i];
+
+	const ULONG cycles = z80_mainloop(1, 0);	// 1 instruction
+
+	UINT hash = Fnv(g_ioHash, cycles);
+	const WORD* pRegs = &z80_regs.reg_af;
+	for (UINT i = 0; i < 8; i++)
+		hash = Fnv(hash, pRegs[i]);
+	hash = Fnv(hash, (z80_regs.reg_i << 8) | z80_regs.reg_r);
+	hash = Fnv(hash, (z80_regs.reg_af2 << 16) | z80_regs.reg_bc2);
+	hash = Fnv(hash, (z80_regs.reg_de2 << 16) | z80_regs.reg_hl2);
+
+	for (UINT page = 0; page < _6502_NUM_PAGES; page++)
+	{
+		if (memcmp(mem + (page << 8), &pristine[page << 8], _6502_PAGE_SIZE) == 0)
+			continue;
+		for (UINT addr = page << 8; addr < (page + 1) << 8; addr++)
+		{
+			if (mem[addr] != pristine[addr])
+			{
+				hash = Fnv(hash, (addr << 8) | mem[addr]);
+				mem[addr] = pristine[addr];
+			}
+		}
+	}
+
+	g_ioHash = 2166136261u;
+	return hash;
+}
+
+int TestInstructions(void)
+{
+	OpcodeTable kTables[] =
+	{
+		{ "base", { 0 },          0, false, 0xA05666E9 },
+		{ "CB",   { 0xCB },       1, false, 0x6114938B },
+		{ "ED",   { 0xED },       1, false, 0xD23617BA },
+		{ "DD",   { 0xDD },       1, false, 0xCA404487 },
+		{ "FD",   { 0xFD },       1, false, 0x891C826E },
+		{ "DDCB", { 0xDD, 0xCB }, 2, true,  0x111FDD42 },
+		{ "FDCB", { 0xFD, 0xCB }, 2, true,  0xE5A6E4E9 },
+	};
+	const UINT kStatesPerOpcode = 8;
+
+	g_seed = 1;
+	std::vector<BYTE> pristine(_6502_MEM_LEN);
+	for (UINT i = 0; i < _6502_MEM_LEN; i++)
+		mem[i] = pristine[i] = (BYTE)Rand();
+
+	int res = 0;
+	for (size_t t = 0; t < sizeof(kTables) / sizeof(kTables[0]); t++)
+	{
+		const OpcodeTable& table = kTables[t];
+		UINT hash = 2166136261u;
+		g_ioHash = 2166136261u;
+
+		for (UINT opcode = 0; opcode < 256; opcode++)
+		{
+			// Prefixes are covered by their own tables
+			if (table.prefixLen == 0 && (opcode == 0xCB || opcode == 0xDD || opcode == 0xED || opcode == 0xFD))
+				continue;
+			if (table.prefixLen == 1 && (table.prefix[0] == 0xDD || table.prefix[0] == 0xFD) && opcode == 0xCB)
+				continue;
+
+			for (UINT state = 0; state < kStatesPerOpcode; state++)
+			{
+				BYTE instruction[6];
+				UINT len = 0;
+				for (UINT i = 0; i < table.prefixLen; i++)
+					instruction[len++] = table.prefix[i];
+				if (table.displacement)
+					instruction[len++] = (BYTE)Rand();
+				instruction[len++] = (BYTE)opcode;
+				while (len < sizeof(instruction))
+					instruction[len++] = (BYTE)Rand();	// operands
+
+				hash = Fnv(hash, RunInstruction(instruction, len, pristine));
+			}
+		}
+
+		if (hash != table.hash)
+		{
+			printf("Opcodes %s: hash %08X, expected %08X\n", table.name, hash, table.hash);
+			res = 1;
+		}
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+
+// CP/M 2.2 just enough to run eg. zexdoc.com & zexall.com (BDOS functions 2 & 9)
+static void InitCPM(void)
+{
+	const WORD kBDOS = 0xDF00;
+
+	const BYTE kPageZero[] =
+	{
+		0x32, 0xF1, 0xE0,	// 0000: LD ($E0F1),A	; warm boot
+		0x76,				// 0003: HALT
+		0x00,				// 0004:
+		0xC3, 0x00, 0xDF,	// 0005: JP BDOS		; NB. ($0006) is the top of the TPA
+	};
+	const BYTE kBDOSCode[] =
+	{
+		0x79,				// DF00: LD A,C
+		0xFE, 0x02,			// DF01: CP 2
+		0x28, 0x0F,			// DF03: JR Z,DF14
+		0xFE, 0x09,			// DF05: CP 9
+		0xC0,				// DF07: RET NZ
+		0x1A,				// DF08: LD A,(DE)
+		0xFE, 0x24,			// DF09: CP '$'
+		0xC8,				// DF0B: RET Z
+		0x32, 0xF0, 0xE0,	// DF0C: LD ($E0F0),A	; console
+		0x13,				// DF0F: INC DE
+		0x18, 0xF6,			// DF10: JR DF08
+		0x00, 0x00,			// DF12:
+		0x7B,				// DF14: LD A,E
+		0x32, 0xF0, 0xE0,	// DF15: LD ($E0F0),A
+		0xC9,				// DF18: RET
+	};
+
+	for (UINT i = 0; i < sizeof(kPageZero); i++)
+		mem[Z80To6502(i)] = kPageZero[i];
+	for (UINT i = 0; i < sizeof(kBDOSCode); i++)
+		mem[Z80To6502(kBDOS + i)] = kBDOSCode[i];
+
+	memset(&z80_regs, 0, sizeof(z80_regs));
+	z80_regs.reg_pc = 0x0100;
+	z80_regs.reg_sp = kBDOS - 2;	// return address (to warm boot) is $0000
+	mem[Z80To6502(kBDOS - 2)] = mem[Z80To6502(kBDOS - 1)] = 0x00;
+
+	g_console.clear();
+	g_warmBoot = false;
+}
+
+// Run a .com file (eg. zexdoc.com or zexall.com) until it warm boots
+static int RunComFile(const char* pszFile)
+{
+	FILE* fp = fopen(pszFile, "rb");
+	if (!fp)
+	{
+		printf("%s: can't open\n", pszFile);
+		return 1;
+	}
+
+	memset(mem, 0, _6502_MEM_LEN);
+	InitCPM();
+
+	WORD addr = 0x0100;
+	int c;
+	while ((c = fgetc(fp)) != EOF && addr < 0xD800)
+		mem[Z80To6502(addr++)] = (BYTE)c;
+	fclose(fp);
+
+	printf("%s:\n", pszFile);
+
+	double tstates = 0;
+	size_t printed = 0;
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	while (!g_warmBoot)
+	{
+		tstates += 2.0 * z80_mainloop(1000000, 0);
+
+		fputs(g_console.c_str() + printed, stdout);
+		fflush(stdout);
+		printed = g_console.size();
+	}
+
+	const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	printf("\n%s: %.0f M T-states in %.1f secs (%.1f MHz, %.0fx a 2.04MHz SoftCard)\n",
+		pszFile, tstates / 1e6, secs, tstates / secs / 1e6, tstates / secs / 2.04e6);
+
+	return (g_console.find("ERROR") != std::string::npos) ? 1 : 0;
+}
+
+//-----------------------------------------------------------------------------
+
+// Emulated T-states per second of a CRC-16 loop (IX indexed loads & CB shifts) and LDIR block copy
+int Benchmark(void)
+{
+	const BYTE kProgram[] =
+	{
+		0xDD, 0x21, 0x00, 0x20,	// 0100: LD IX,$2000
+		0x01, 0x00, 0x10,		// 0104: LD BC,$1000
+		0x11, 0xFF, 0xFF,		// 0107: LD DE,$FFFF	; CRC
+		0xDD, 0x7E, 0x00,		// 010A: LD A,(IX+0)
+		0xAA,					// 010D: XOR D
+		0x57,					// 010E: LD D,A
+		0x2E, 0x08,				// 010F: LD L,8
+		0xCB, 0x23,				// 0111: SLA E
+		0xCB, 0x12,				// 0113: RL D
+		0x30, 0x08,				// 0115: JR NC,011F
+		0x7A,					// 0117: LD A,D
+		0xEE, 0x10,				// 0118: XOR $10
+		0x57,					// 011A: LD D,A
+		0x7B,					// 011B: LD A,E
+		0xEE, 0x21,				// 011C: XOR $21
+		0x5F,					// 011E: LD E,A
+		0x2D,					// 011F: DEC L
+		0x20, 0xEF,				// 0120: JR NZ,0111
+		0xDD, 0x23,				// 0122: INC IX
+		0x0B,					// 0124: DEC BC
+		0x78,					// 0125: LD A,B
+		0xB1,					// 0126: OR C
+		0x20, 0xE1,				// 0127: JR NZ,010A
+		0xED, 0x53, 0x00, 0x30,	// 0129: LD ($3000),DE
+		0x21, 0x00, 0x20,		// 012D: LD HL,$2000
+		0x11, 0x00, 0x40,		// 0130: LD DE,$4000
+		0x01, 0x00, 0x10,		// 0133: LD BC,$1000
+		0xED, 0xB0,				// 0136: LDIR
+		0xC3, 0x00, 0x01,		// 0138: JP $0100
+	};
+	const UINT kTStates = 20000000;	// ~10 emulated seconds
+	const int kRuns = 3;
+
+	g_seed = 2;
+	for (UINT i = 0; i < _6502_MEM_LEN; i++)
+		mem[i] = (BYTE)Rand();
+	for (UINT i = 0; i < sizeof(kProgram); i++)
+		mem[Z80To6502(0x0100 + i)] = kProgram[i];
+
+	USHORT crc = 0xFFFF;
+	for (UINT i = 0; i < 0x1000; i++)
+	{
+		crc ^= mem[Z80To6502(0x2000 + i)] << 8;
+		for (UINT bit = 0; bit < 8; bit++)
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+	}
+
+	double secs = 0.0;
+	for (int run = 0; run < kRuns; run++)	// Best of kRuns
+	{
+		memset(&z80_regs, 0, sizeof(z80_regs));
+		z80_regs.reg_pc = 0x0100;
+		z80_regs.reg_sp = 0xD000;
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		UINT tstates = 0;
+		while (tstates < kTStates)
+			tstates += 2 * z80_mainloop(100000, 0);
+
+		const double runSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (run == 0 || runSecs < secs)
+			secs = runSecs;
+	}
+
+	if ((mem[Z80To6502(0x3000)] | (mem[Z80To6502(0x3001)] << 8)) != crc)
+	{
+		printf("Benchmark: wrong CRC\n");
+		return 1;
+	}
+
+	printf("Benchmark: CRC-16 & LDIR loop: %.1f MHz (%.0fx a 2.04MHz SoftCard)\n",
+		kTStates / secs / 1e6, kTStates / secs / 2.04e6);
+
+	return 0;
+}
+
+// Host time per instruction for a straight-line run of one instruction: compares the cost of each prefix's decode
+static double NsPerInstruction(const BYTE* pInstruction, UINT len, UINT tstatesPerInstruction)
+{
+	const UINT kCount = 64;
+	const UINT kTStates = 10000000;
+
+	WORD addr = 0x0100;
+	for (UINT i = 0; i < kCount; i++)
+		for (UINT j = 0; j < len; j++)
+			mem[Z80To6502(addr++)] = pInstruction[j];
+	mem[Z80To6502(addr++)] = 0xC3;	// JP $0100
+	mem[Z80To6502(addr++)] = 0x00;
+	mem[Z80To6502(addr++)] = 0x01;
+
+	double secs = 0.0;
+	UINT tstates = 0;
+	for (int run = 0; run < 3; run++)	// Best of 3
+	{
+		memset(&z80_regs, 0, sizeof(z80_regs));
+		z80_regs.reg_pc = 0x0100;
+		z80_regs.reg_sp = 0xD000;
+		z80_regs.reg_ix = z80_regs.reg_hl = 0x2000;
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		tstates = 0;
+		while (tstates < kTStates)
+			tstates += 2 * z80_mainloop(100000, 0);
+
+		const double runSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (run == 0 || runSecs < secs)
+			secs = runSecs;
+	}
+
+	const double instructions = (double)tstates / (kCount * tstatesPerInstruction + 10) * (kCount + 1);
+	return secs * 1e9 / instructions;
+}
+
+void BenchmarkDecode(void)
+{
+	struct Instruction
+	{
+		const char* name;
+		BYTE bytes[4];
+		UINT len;
+		UINT tstates;
+	};
+	const Instruction kInstructions[] =
+	{
+		{ "LD A,(HL)",		{ 0x7E },					1, 7 },
+		{ "RLC E",			{ 0xCB, 0x03 },				2, 8 },
+		{ "LD A,(IX+0)",	{ 0xDD, 0x7E, 0x00 },		3, 19 },
+		{ "NEG",			{ 0xED, 0x44 },				2, 8 },
+		{ "BIT 0,(IX+0)",	{ 0xDD, 0xCB, 0x00, 0x46 },	4, 20 },
+	};
+
+	printf("Benchmark: ns per instruction:");
+	for (UINT i = 0; i < sizeof(kInstructions) / sizeof(kInstructions[0]); i++)
+		printf("%s %s %.2f", i ? "," : "", kInstructions[i].name,
+			NsPerInstruction(kInstructions[i].bytes, kInstructions[i].len, kInstructions[i].tstates));
+	printf("\n");
+}
+
+//-----------------------------------------------------------------------------
+
+// Usage: TestZ80 [file.com ...]
+// . eg. zexdoc.com & zexall.com (not included): each is run headlessly, with its speed reported
+int main(int argc, char* argv[])
+{
+	int res = 1;
+
+	InitMemory();
+
+	res = TestInstructions();
+	if (res) return res;
+
+	g_nAppMode = MODE_STEPPING;	// Debugger: all accesses go via z80_RDMEM() & z80_WRMEM()
+	res = TestInstructions();
+	g_nAppMode = MODE_RUNNING;
+	if (res) return res;
+
+	res = Benchmark();
+	if (res) return res;
+
+	BenchmarkDecode();
+
+	for (int i = 1; i < argc; i++)
+	{
+		res = RunComFile(argv[i]);
+		if (res) return res;
+	}
+
+	return 0;
+}
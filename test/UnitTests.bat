@@ -5,6 +5,46 @@
 .\%1\TestCPU6502.exe
 @IF errorlevel 1 GOTO failed
 
+@ECHO Performing unit-test: TestSpeaker
+.\%1\TestSpeaker.exe
+@IF errorlevel 1 GOTO failed
+
+@ECHO Performing unit-test: TestAY8910
+.\%1\TestAY8910.exe
+@IF errorlevel 1 GOTO failed
+
+@ECHO Performing unit-test: TestSSI263
+.\%1\TestSSI263.exe
+@IF errorlevel 1 GOTO failed
+
+@ECHO Performing unit-test: TestRiff
+.\%1\TestRiff.exe
+@IF errorlevel 1 GOTO failed
+
+@ECHO Performing unit-test: TestVideoCapture
+.\%1\TestVideoCapture.exe
+@IF errorlevel 1 GOTO failed
+
+@ECHO Performing unit-test: TestZ80
+.\%1\TestZ80.exe
+@IF errorlevel 1 GOTO failed
+
+@ECHO Performing unit-test: TestNTSC
+.\%1\TestNTSC.exe
+@IF errorlevel 1 GOTO failed
+
+@ECHO Performing unit-test: TestSymbols
+.\%1\TestSymbols.exe
+@IF errorlevel 1 GOTO failed
+
+@ECHO Performing unit-test: TestCallProfile
+.\%1\TestCallProfile.exe
+@IF errorlevel 1 GOTO failed
+
+@ECHO Performing unit-test: TestHistory
+.\%1\TestHistory.exe
+@IF errorlevel 1 GOTO failed
+
 @ECHO Performing unit-test: TestDebugger
 .\%1\TestDebugger.exe
 @if errorlevel 1 GOTO failed